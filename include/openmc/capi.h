@@ -26,12 +26,18 @@ extern "C" {
 #endif
 
   int openmc_calculate_volumes();
+  int openmc_check_overlaps();
   int openmc_cell_filter_get_bins(int32_t index, int32_t** cells, int32_t* n);
   int openmc_cell_get_fill(int32_t index, int* type, int32_t** indices, int32_t* n);
   int openmc_cell_get_id(int32_t index, int32_t* id);
   int openmc_cell_set_fill(int32_t index, int type, int32_t n, const int32_t* indices);
   int openmc_cell_set_id(int32_t index, int32_t id);
   int openmc_cell_set_temperature(int32_t index, double T, const int32_t* instance);
+  int openmc_cylindrical_mesh_get_grid(int32_t index, double** grid_r, int* nr,
+    double** grid_phi, int* nphi, double** grid_z, int* nz, double* origin);
+  int openmc_cylindrical_mesh_set_grid(int32_t index, const double* grid_r,
+    int nr, const double* grid_phi, int nphi, const double* grid_z, int nz,
+    const double* origin);
   int openmc_energy_filter_get_bins(int32_t index, double** energies, int32_t* n);
   int openmc_energy_filter_set_bins(int32_t index, int32_t n, const double* energies);
   int openmc_extend_cells(int32_t n, int32_t* index_start, int32_t* index_end);
@@ -77,14 +83,20 @@ extern "C" {
   int openmc_mesh_get_id(int32_t index, int32_t* id);
   int openmc_mesh_get_dimension(int32_t index, int** id, int* n);
   int openmc_mesh_get_params(int32_t index, double** ll, double** ur, double** width, int* n);
+  int openmc_mesh_get_type(int32_t index, char* type);
   int openmc_mesh_set_id(int32_t index, int32_t id);
   int openmc_mesh_set_dimension(int32_t index, int n, const int* dims);
   int openmc_mesh_set_params(int32_t index, int n, const double* ll, const double* ur, const double* width);
+  int openmc_mesh_set_type(int32_t index, const char* type);
   int openmc_meshsurface_filter_get_mesh(int32_t index, int32_t* index_mesh);
   int openmc_meshsurface_filter_set_mesh(int32_t index, int32_t index_mesh);
   int openmc_next_batch(int* status);
   int openmc_nuclide_name(int index, const char** name);
   int openmc_plot_geometry();
+  int openmc_rectilinear_mesh_get_grid(int32_t index, double** grid_x, int* nx,
+    double** grid_y, int* ny, double** grid_z, int* nz);
+  int openmc_rectilinear_mesh_set_grid(int32_t index, const double* grid_x,
+    int nx, const double* grid_y, int ny, const double* grid_z, int nz);
   int openmc_reset();
   int openmc_run();
   void openmc_set_seed(int64_t new_seed);
@@ -1,8 +1,11 @@
 #ifndef OPENMC_CELL_H
 #define OPENMC_CELL_H
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <limits>
+#include <memory> // for unique_ptr
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -36,6 +39,10 @@ constexpr int32_t OP_COMPLEMENT   {std::numeric_limits<int32_t>::max() - 2};
 constexpr int32_t OP_INTERSECTION {std::numeric_limits<int32_t>::max() - 3};
 constexpr int32_t OP_UNION        {std::numeric_limits<int32_t>::max() - 4};
 
+// Terminal branch targets for compiled region expressions
+constexpr int32_t REGION_TRUE  {-1};
+constexpr int32_t REGION_FALSE {-2};
+
 //==============================================================================
 // Global variables
 //==============================================================================
@@ -55,6 +62,62 @@ extern std::unordered_map<int32_t, int32_t> universe_map;
 
 } // namespace model
 
+//==============================================================================
+//! A uniform Cartesian grid over the bounding boxes of the cells in a universe
+//!
+//! Each grid bin stores the cells whose bounding boxes overlap it so that a
+//! cell search only needs to test a few candidate cells rather than every cell
+//! in the universe. Points outside of the grid are assigned to the nearest
+//! bin, which also lists any cells whose bounding boxes extend beyond the grid.
+//==============================================================================
+
+class CellGrid
+{
+public:
+  //! Build a grid from the bounding boxes of a set of cells
+  //! \param cells Indices of the cells in the global cells array
+  explicit CellGrid(const std::vector<int32_t>& cells);
+
+  //! Whether the cells have finite extent along any axis so that a grid
+  //! could be formed
+  bool empty() const {return n_bins_ == 1;}
+
+  //! Determine the grid bin containing a point
+  //! \param r Position of the point
+  //! \return Index of the bin
+  int get_bin(Position r) const;
+
+  //! Candidate cells in a bin, given in the same order as the cells that were
+  //! used to build the grid
+  const int32_t* cbegin(int bin) const {return &cells_[offsets_[bin]];}
+  const int32_t* cend(int bin) const {return &cells_[offsets_[bin + 1]];}
+
+private:
+  int axis_bin(int axis, double x) const;
+
+  std::array<double, 3> lower_left_; //!< Lower-left corner of the grid
+  std::array<double, 3> width_;      //!< Width of a bin along each axis
+  std::array<int, 3> shape_ {1, 1, 1}; //!< Number of bins along each axis
+  int n_bins_ {1};                   //!< Total number of bins
+  std::vector<int32_t> offsets_;     //!< Start of each bin in cells_
+  std::vector<int32_t> cells_;       //!< Candidate cells for all bins
+};
+
+//==============================================================================
+//! A half-space test in a compiled region expression.
+//!
+//! Region expressions are compiled into a sequence of half-space tests where
+//! each test gives the index of the next test to perform depending on its
+//! outcome. Evaluation stops as soon as the value of the expression is known.
+//==============================================================================
+
+struct RegionBranch
+{
+  int32_t token;      //!< Signed surface index of the half-space
+  int32_t next_true;  //!< Next test if the point is in the half-space
+  int32_t next_false; //!< Next test if the point is not in the half-space
+};
+
 //==============================================================================
 //! A geometry primitive that fills all space and contains cells.
 //==============================================================================
@@ -65,9 +128,25 @@ public:
   int32_t id_;                  //!< Unique ID
   std::vector<int32_t> cells_;  //!< Cells within this universe
 
+  //! Grid used to accelerate the cell search for universes with many cells.
+  //! This is a null pointer if the cells are searched linearly.
+  std::unique_ptr<CellGrid> grid_;
+
+  //! Number of child nodes of each placement of this universe in the
+  //! flattened geometry hierarchy
+  int32_t n_node_slots_ {0};
+
+  //! Cell most recently entered when a particle crossed into a lattice tile
+  //! filled with this universe from a tile filled with a different universe
+  std::atomic<int32_t> entry_cell_ {C_NONE};
+
   //! \brief Write universe information to an HDF5 group.
   //! \param group_id An HDF5 group id.
   void to_hdf5(hid_t group_id) const;
+
+  //! Build the cell search grid if this universe has enough cells with
+  //! bounded extent to benefit from one
+  void build_grid();
 };
 
 //==============================================================================
@@ -102,23 +181,37 @@ public:
   std::vector<std::int32_t> region_;
   //! Reverse Polish notation for region expression
   std::vector<std::int32_t> rpn_;
+  //! Short-circuiting form of the region expression for complex cells
+  std::vector<RegionBranch> branches_;
+  //! Unique half-spaces in the region expression, in order of appearance
+  std::vector<std::int32_t> halfspaces_;
   bool simple_;  //!< Does the region contain only intersections?
 
   //! \brief Neighboring cells in the same universe.
-  NeighborList neighbors_;
-
-  Position translation_ {0, 0, 0}; //!< Translation vector for filled universe
-
-  //! \brief Rotational tranfsormation of the filled universe.
+  //!
+  //! There is one list for each side of each surface bounding the cell, holding
+  //! the cells that particles were found in after leaving this cell across that
+  //! side of the surface, followed by one list for crossings of any other
+  //! surface.
+  std::unique_ptr<NeighborList[]> neighbors_;
+  std::vector<int32_t> neighbor_surfaces_; //!< Surfaces indexing neighbors_
+
+  //! \brief Transformation from coordinates in this cell's universe to
+  //! coordinates in the filled universe.
   //
-  //! The vector is empty if there is no rotation.  Otherwise, the first three
-  //! values are the rotation angles respectively about the x-, y-, and z-, axes
-  //! in degrees.  The next 9 values give the rotation matrix in row-major
-  //! order.
-  std::vector<double> rotation_;
+  //! The translation vector is subtracted first and the rotation matrix is
+  //! then applied.
+  Transform transform_;
+
+  //! Rotation angles about the x-, y-, and z-axes in degrees
+  std::array<double, 3> rotation_angles_ {0., 0., 0.};
 
   std::vector<int32_t> offset_;  //!< Distribcell offset table
 
+  //! Position of the first child node filling this cell among the children of
+  //! a node for the cell's universe in the flattened geometry hierarchy
+  int32_t node_slot_ {C_NONE};
+
   explicit Cell(pugi::xml_node cell_node);
   Cell() {};
 
@@ -132,9 +225,10 @@ public:
   //! involving only the intersection of half-spaces) and one for complex cells.
   //! Simple cells can be evaluated with short circuit evaluation, i.e., as soon
   //! as we know that one half-space is not satisfied, we can exit. This
-  //! provides a performance benefit for the common case. In
-  //! contains_complex, we evaluate the RPN expression using a stack, similar to
-  //! how a RPN calculator would work.
+  //! provides a performance benefit for the common case. For complex cells,
+  //! the RPN expression is compiled at initialization into a sequence of
+  //! half-space tests with jumps that skip any operands that can no longer
+  //! change the result.
   //! \param r The 3D Cartesian coordinate to check.
   //! \param u A direction used to "break ties" the coordinates are very
   //!   close to a surface.
@@ -148,6 +242,17 @@ public:
   virtual std::pair<double, int32_t>
   distance(Position r, Direction u, int32_t on_surface) const = 0;
 
+  //! Get a conservative axis-aligned bounding box for the cell region
+  virtual BoundingBox bounding_box() const {return INFINITE_BOX;}
+
+  //! \brief Get the neighbor list for leaving the cell across a surface.
+  //! \param on_surface The signed index of the surface crossed, where the
+  //!   sign indicates the side of the surface crossed into.
+  //! \return The neighbor list for the side of the surface, the list shared
+  //!   by surfaces that do not appear in the cell's region, or a null pointer
+  //!   if the cell has no neighbor lists.
+  NeighborList* neighbor_list(int32_t on_surface) const;
+
   //! Write all information needed to reconstruct the cell to an HDF5 group.
   //! @param group_id An HDF5 group id.
   virtual void to_hdf5(hid_t group_id) const = 0;
@@ -170,11 +275,17 @@ public:
   std::pair<double, int32_t>
   distance(Position r, Direction u, int32_t on_surface) const;
 
+  BoundingBox bounding_box() const;
+
   void to_hdf5(hid_t group_id) const;
 
 protected:
   bool contains_simple(Position r, Direction u, int32_t on_surface) const;
   bool contains_complex(Position r, Direction u, int32_t on_surface) const;
+
+  //! Bounding half-spaces grouped by surface kind for distance calculations
+  //! (empty for cells with few bounding surfaces)
+  SurfaceBatch batch_;
 };
 
 //==============================================================================
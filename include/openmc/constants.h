@@ -6,6 +6,7 @@
 
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <limits>
 #include <vector>
 
@@ -32,8 +33,9 @@ constexpr std::array<int, 2> VERSION_STATEPOINT {17, 0};
 constexpr std::array<int, 2> VERSION_PARTICLE_RESTART {2, 0};
 constexpr std::array<int, 2> VERSION_TRACK {2, 0};
 constexpr std::array<int, 2> VERSION_SUMMARY {6, 0};
-constexpr std::array<int, 2> VERSION_VOLUME {1, 0};
+constexpr std::array<int, 2> VERSION_VOLUME {1, 1};
 constexpr std::array<int, 2> VERSION_VOXEL {1, 0};
+constexpr std::array<int, 2> VERSION_OVERLAPS {1, 0};
 constexpr std::array<int, 2> VERSION_MGXS_LIBRARY {1, 0};
 constexpr char VERSION_MULTIPOLE[] {"v0.2"};
 
@@ -57,6 +59,20 @@ constexpr double FP_PRECISION {1e-14};
 constexpr double FP_REL_PRECISION {1e-5};
 constexpr double FP_COINCIDENT {1e-12};
 
+// Minimum number of cells in a universe for which a cell search grid is built
+constexpr int CELL_GRID_MIN_CELLS {16};
+
+// Maximum number of surface/lattice crossings for a neighbor list sweep ray
+constexpr int NEIGHBOR_SWEEP_MAX_CROSSINGS {10000};
+
+// Minimum number of bounding surfaces for which a cell computes distances to
+// its surfaces grouped by surface kind
+constexpr int SURFACE_BATCH_MIN_HALFSPACES {8};
+
+// Maximum number of universe placements for which the geometry hierarchy is
+// flattened
+constexpr int64_t GEOMETRY_MAX_NODES {10000000};
+
 // Maximum number of collisions/crossings
 constexpr int MAX_EVENTS {1000000};
 constexpr int MAX_SAMPLE {100000};
@@ -71,6 +87,10 @@ constexpr int MAX_WORD_LEN {150};
 constexpr int EXTSRC_REJECT_THRESHOLD {10000};
 constexpr double EXTSRC_REJECT_FRACTION {0.05};
 
+// Resolution of tabulated incoherent scattering angular distributions
+constexpr int INCOHERENT_ALPHA_PER_DECADE {20};
+constexpr int INCOHERENT_N_MU {201};
+
 // ============================================================================
 // MATH AND PHYSICAL CONSTANTS
 
@@ -410,6 +430,7 @@ constexpr int RUN_MODE_EIGENVALUE  {2};
 constexpr int RUN_MODE_PLOTTING    {3};
 constexpr int RUN_MODE_PARTICLE    {4};
 constexpr int RUN_MODE_VOLUME      {5};
+constexpr int RUN_MODE_OVERLAP     {6};
 
 // ============================================================================
 // CMFD CONSTANTS
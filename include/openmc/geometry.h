@@ -1,14 +1,30 @@
 #ifndef OPENMC_GEOMETRY_H
 #define OPENMC_GEOMETRY_H
 
+#include <array>
 #include <cstdint>
 #include <vector>
 
+#include "openmc/constants.h"
 #include "openmc/particle.h"
 
 
 namespace openmc {
 
+//==============================================================================
+//! A single placement of a universe in the flattened geometry hierarchy.
+//!
+//! The children of a node, one for each universe-filled cell and for each tile
+//! (plus the outer universe) of each lattice-filled cell in the universe, are
+//! stored contiguously starting at the index given by children.
+//==============================================================================
+
+struct GeometryNode {
+  int32_t universe; //!< Index of the universe at this placement
+  int32_t instance; //!< Distribcell instance of the cells in the universe
+  int32_t children; //!< Index of the first child node
+};
+
 //==============================================================================
 // Global variables
 //==============================================================================
@@ -19,8 +35,35 @@ extern "C" int root_universe;
 
 extern std::vector<int64_t> overlap_check_count;
 
+//! Every placement of every universe, starting with the root universe. This is
+//! empty if the geometry hierarchy has not been flattened.
+extern std::vector<GeometryNode> geometry_nodes;
+
 } // namespace model
 
+namespace simulation {
+
+// Threadprivate variables
+extern int64_t lattice_hits;   //!< Lattice crossings located in the predicted cell
+extern int64_t lattice_misses; //!< Lattice crossings that needed a full search
+
+#pragma omp threadprivate(lattice_hits, lattice_misses)
+
+} // namespace simulation
+
+//==============================================================================
+//! Get the node of a universe placed within another node.
+//! \param node Index of the parent node or C_NONE.
+//! \param slot Position of the child among the children of the parent.
+//! \return Index of the child node, or C_NONE if the parent is C_NONE.
+//==============================================================================
+
+inline int32_t
+child_node(int32_t node, int32_t slot)
+{
+  return (node == C_NONE) ? C_NONE : model::geometry_nodes[node].children + slot;
+}
+
 //==============================================================================
 //! Check for overlapping cells at a particle's position.
 //==============================================================================
@@ -35,7 +78,9 @@ check_cell_overlap(Particle* p);
 //!   geometry-dependent data fields of the particle.
 //! \param use_neighbor_lists If true, neighbor lists will be used to accelerate
 //!   the geometry search, but this only works if the cell attribute of the
-//!   particle's lowest coordinate level is valid and meaningful.
+//!   particle's lowest coordinate level is valid and meaningful and the
+//!   surface attribute is the surface it just crossed, signed by the side it
+//!   crossed into.
 //! \return True if the particle's location could be found and ascribed to a
 //!   valid geometry coordinate stack.
 //==============================================================================
@@ -50,6 +95,24 @@ find_cell(Particle* p, bool use_neighbor_lists);
 extern "C" void
 cross_lattice(Particle* p, int lattice_translation[3]);
 
+//==============================================================================
+//! Distances to the boundaries on a single coordinate level.
+//!
+//! While a particle travels in a straight line and stays in the same cell on a
+//! given level, these distances only need to be reduced by the distance
+//! travelled rather than recomputed.
+//==============================================================================
+
+struct BoundaryDistance {
+  bool valid {false};     //!< Are the distances up to date?
+  int cell;               //!< Cell the distances were computed in
+  std::array<int, 3> lattice_index; //!< Lattice tile the distances were computed in
+  double d_surf;          //!< Distance to the nearest surface of the cell
+  int32_t surface;        //!< Signed index of the nearest surface
+  double d_lat;           //!< Distance to the next lattice tile
+  std::array<int, 3> lattice_translation; //!< Lattice tile crossed at d_lat
+};
+
 //==============================================================================
 //! Find the next boundary a particle will intersect.
 //==============================================================================
@@ -58,6 +121,26 @@ extern "C" void
 distance_to_boundary(Particle* p, double* dist, int* surface_crossed,
                      int lattice_translation[3], int* next_level);
 
+//! \param saved Distances for each coordinate level that are reused where
+//!   still valid and updated where recomputed, or nullptr.
+void
+distance_to_boundary(Particle* p, double* dist, int* surface_crossed,
+                     int lattice_translation[3], int* next_level,
+                     BoundaryDistance* saved);
+
+//==============================================================================
+//! Populate cell neighbor lists by tracing rays through the geometry.
+//!
+//! Rays start at the sites in the source bank and travel in directions spread
+//! uniformly over the unit sphere, crossing surfaces the same way particles do
+//! during transport but without any physics or tallies. Rays are reflected by
+//! reflective surfaces in the root universe; a ray ends when it leaks, reaches
+//! a periodic surface, or reaches a reflective surface in a lower universe.
+//! \param n_rays The number of rays to trace.
+//==============================================================================
+
+void prepopulate_neighbor_lists(int n_rays);
+
 } // namespace openmc
 
 #endif // OPENMC_GEOMETRY_H
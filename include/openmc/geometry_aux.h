@@ -65,6 +65,17 @@ extern "C" int32_t find_root_universe();
 
 void prepare_distribcell();
 
+//==============================================================================
+//! Flatten the geometry hierarchy into an array of universe placements.
+//!
+//! Each placement stores the distribcell instance of the cells in its universe
+//! so that the instance of a cell can be looked up directly during tracking
+//! rather than by summing offsets over every coordinate level. This must be
+//! called after prepare_distribcell.
+//==============================================================================
+
+void build_geometry_nodes();
+
 //==============================================================================
 //! Recursively search through the geometry and count cell instances.
 //!
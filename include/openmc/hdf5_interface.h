@@ -5,6 +5,7 @@
 #include <array>
 #include <complex>
 #include <cstddef>
+#include <cstdint>
 #include <cstring> // for strlen
 #include <string>
 #include <sstream>
@@ -21,6 +22,8 @@
 
 namespace openmc {
 
+class SparseResults;
+
 //==============================================================================
 // Low-level internal functions
 //==============================================================================
@@ -57,6 +60,20 @@ std::vector<std::string> group_names(hid_t group_id);
 std::vector<hsize_t> object_shape(hid_t obj_id);
 std::string object_name(hid_t obj_id);
 
+//! Write the sum and sum of squares of a sparsely stored tally. The results
+//! dataset is chunked and only chunks with a nonzero result are written, so
+//! the rest take no space in the file and are read as zeros.
+//! \param bins Sorted indices of filter and score bin combinations
+//! \param values Sum and sum of squares for each of those bins
+void write_tally_results_sparse(hid_t group_id, hsize_t n_filter,
+  hsize_t n_score, const std::vector<int64_t>& bins,
+  const std::vector<double>& values);
+
+//! Read the sum and sum of squares of a sparsely stored tally. Only nonzero
+//! values are copied into the results, which must be zero beforehand.
+void read_tally_results_sparse(hid_t group_id, hsize_t n_filter,
+  hsize_t n_score, SparseResults& results);
+
 //==============================================================================
 // Fortran compatibility functions
 //==============================================================================
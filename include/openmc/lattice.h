@@ -121,6 +121,11 @@ public:
   virtual bool is_valid_index(int indx) const
   {return (indx >= 0) && (indx < universes_.size());}
 
+  //! \brief Get the flattened index of a lattice tile.
+  //! \param i_xyz[3] The indices for a lattice tile.
+  //! \return The index of the tile in the universes and offsets arrays.
+  virtual int get_flat_index(const int i_xyz[3]) const = 0;
+
   //! \brief Get the distribcell offset for a lattice tile.
   //! \param The map index for the target cell.
   //! \param i_xyz[3] The indices for a lattice tile.
@@ -218,6 +223,8 @@ public:
   Position
   get_local_position(Position r, const std::array<int, 3> i_xyz) const;
 
+  int get_flat_index(const int i_xyz[3]) const;
+
   int32_t& offset(int map, const int i_xyz[3]);
 
   std::string index_to_string(int indx) const;
@@ -260,6 +267,8 @@ public:
 
   bool is_valid_index(int indx) const;
 
+  int get_flat_index(const int i_xyz[3]) const;
+
   int32_t& offset(int map, const int i_xyz[3]);
 
   std::string index_to_string(int indx) const;
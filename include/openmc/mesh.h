@@ -4,6 +4,7 @@
 #ifndef OPENMC_MESH_H
 #define OPENMC_MESH_H
 
+#include <array>
 #include <memory> // for unique_ptr
 #include <vector>
 #include <unordered_map>
@@ -21,24 +22,25 @@ namespace openmc {
 // Global variables
 //==============================================================================
 
-class RegularMesh;
+class Mesh;
 
 namespace model {
 
-extern std::vector<std::unique_ptr<RegularMesh>> meshes;
+extern std::vector<std::unique_ptr<Mesh>> meshes;
 extern std::unordered_map<int32_t, int32_t> mesh_map;
 
 } // namespace model
 
 //==============================================================================
-//! Tessellation of n-dimensional Euclidean space by congruent squares or cubes
+//! Structured mesh whose elements are identified by one, two, or three indices
 //==============================================================================
 
-class RegularMesh {
+class Mesh {
 public:
-  // Constructors
-  RegularMesh() = default;
-  RegularMesh(pugi::xml_node node);
+  // Constructors, destructors
+  Mesh() = default;
+  Mesh(pugi::xml_node node);
+  virtual ~Mesh() = default;
 
   // Methods
 
@@ -47,20 +49,21 @@ public:
   //! \param[in] p Particle to check
   //! \param[out] bins Bins that were crossed
   //! \param[out] lengths Fraction of tracklength in each bin
-  void bins_crossed(const Particle* p, std::vector<int>& bins,
-                    std::vector<double>& lengths) const;
+  virtual void bins_crossed(const Particle* p, std::vector<int>& bins,
+                            std::vector<double>& lengths) const = 0;
 
   //! Determine which surface bins were crossed by a particle
   //!
   //! \param[in] p Particle to check
   //! \param[out] bins Surface bins that were crossed
-  void surface_bins_crossed(const Particle* p, std::vector<int>& bins) const;
+  virtual void surface_bins_crossed(const Particle* p, std::vector<int>& bins)
+    const = 0;
 
   //! Get bin at a given position in space
   //!
   //! \param[in] r Position to get bin for
   //! \return Mesh bin
-  int get_bin(Position r) const;
+  virtual int get_bin(Position r) const;
 
   //! Get bin given mesh indices
   //!
@@ -73,7 +76,7 @@ public:
   //! \param[in] r Position to get indices for
   //! \param[out] ijk Array of mesh indices
   //! \param[out] in_mesh Whether position is in mesh
-  void get_indices(Position r, int* ijk, bool* in_mesh) const;
+  virtual void get_indices(Position r, int* ijk, bool* in_mesh) const = 0;
 
   //! Get mesh indices corresponding to a mesh bin
   //!
@@ -81,17 +84,27 @@ public:
   //! \param[out] ijk Mesh indices
   void get_indices_from_bin(int bin, int* ijk) const;
 
-  //! Check if a line connected by two points intersects the mesh
+  //! Get the number of mesh bins
   //!
-  //! \param[in] r0 Starting position
-  //! \param[in] r1 Ending position
-  //! \return Whether line connecting r0 and r1 intersects mesh
-  bool intersects(Position r0, Position r1) const;
+  //! \return Number of mesh bins
+  int n_bins() const;
+
+  //! Get the fraction of the volume of the mesh in a mesh bin
+  //!
+  //! \param[in] bin Mesh bin
+  //! \return Volume fraction
+  virtual double volume_frac(int bin) const = 0;
+
+  //! Get the positions of the mesh surfaces along one dimension
+  //!
+  //! \param[in] i Dimension
+  //! \return Positions of the surfaces in increasing order
+  virtual std::vector<double> grid(int i) const = 0;
 
   //! Write mesh data to an HDF5 group
   //!
   //! \param[in] group HDF5 group
-  void to_hdf5(hid_t group) const;
+  virtual void to_hdf5(hid_t group) const = 0;
 
   //! Count number of bank sites in each mesh bin / energy bin
   //!
@@ -106,18 +119,165 @@ public:
 
   int id_ {-1};  //!< User-specified ID
   int n_dimension_; //!< Number of dimensions
-  double volume_frac_; //!< Volume fraction of each mesh element
   xt::xarray<int> shape_; //!< Number of mesh elements in each dimension
+};
+
+//==============================================================================
+//! Tessellation of n-dimensional Euclidean space by congruent squares or cubes
+//==============================================================================
+
+class RegularMesh : public Mesh {
+public:
+  // Constructors
+  RegularMesh() = default;
+  RegularMesh(pugi::xml_node node);
+
+  // Overridden methods
+
+  void bins_crossed(const Particle* p, std::vector<int>& bins,
+                    std::vector<double>& lengths) const override;
+
+  void surface_bins_crossed(const Particle* p, std::vector<int>& bins)
+    const override;
+
+  int get_bin(Position r) const override;
+
+  void get_indices(Position r, int* ijk, bool* in_mesh) const override;
+
+  double volume_frac(int bin) const override { return volume_frac_; }
+
+  std::vector<double> grid(int i) const override;
+
+  void to_hdf5(hid_t group) const override;
+
+  // Methods
+
+  //! Check if a line connected by two points intersects the mesh
+  //!
+  //! \param[in] r0 Starting position
+  //! \param[in] r1 Ending position
+  //! \return Whether line connecting r0 and r1 intersects mesh
+  bool intersects(Position r0, Position r1) const;
+
+  double volume_frac_; //!< Volume fraction of each mesh element
   xt::xarray<double> lower_left_; //!< Lower-left coordinates of mesh
   xt::xarray<double> upper_right_; //!< Upper-right coordinates of mesh
   xt::xarray<double> width_; //!< Width of each mesh element
 
 private:
+  //! Determine which bins were crossed by a particle by stepping from one mesh
+  //! surface to the next along the track
+  //!
+  //! \param[in] p Particle to check
+  //! \param[out] bins Bins that were crossed
+  //! \param[out] lengths Fraction of tracklength in each bin
+  template<int N>
+  void bins_crossed_dda(const Particle* p, std::vector<int>& bins,
+                        std::vector<double>& lengths) const;
+
   bool intersects_1d(Position r0, Position r1) const;
   bool intersects_2d(Position r0, Position r1) const;
   bool intersects_3d(Position r0, Position r1) const;
 };
 
+//==============================================================================
+//! Three-dimensional Cartesian mesh with arbitrary mesh surfaces along each axis
+//==============================================================================
+
+class RectilinearMesh : public Mesh {
+public:
+  // Constructors
+  RectilinearMesh() = default;
+  RectilinearMesh(pugi::xml_node node);
+
+  // Overridden methods
+
+  void bins_crossed(const Particle* p, std::vector<int>& bins,
+                    std::vector<double>& lengths) const override;
+
+  void surface_bins_crossed(const Particle* p, std::vector<int>& bins)
+    const override;
+
+  void get_indices(Position r, int* ijk, bool* in_mesh) const override;
+
+  double volume_frac(int bin) const override;
+
+  std::vector<double> grid(int i) const override { return grid_[i]; }
+
+  void to_hdf5(hid_t group) const override;
+
+  // Methods
+
+  //! Set the mesh surfaces and check that they are valid
+  //!
+  //! \param[in] grid Positions of the mesh surfaces along x, y, and z
+  //! \return Error code
+  int set_grid(std::array<std::vector<double>, 3> grid);
+
+  std::array<std::vector<double>, 3> grid_; //!< Mesh surfaces along each axis
+};
+
+//==============================================================================
+//! Three-dimensional mesh in cylindrical (r, phi, z) coordinates
+//==============================================================================
+
+class CylindricalMesh : public Mesh {
+public:
+  // Constructors
+  CylindricalMesh() = default;
+  CylindricalMesh(pugi::xml_node node);
+
+  // Overridden methods
+
+  void bins_crossed(const Particle* p, std::vector<int>& bins,
+                    std::vector<double>& lengths) const override;
+
+  void surface_bins_crossed(const Particle* p, std::vector<int>& bins)
+    const override;
+
+  void get_indices(Position r, int* ijk, bool* in_mesh) const override;
+
+  double volume_frac(int bin) const override;
+
+  std::vector<double> grid(int i) const override { return grid_[i]; }
+
+  void to_hdf5(hid_t group) const override;
+
+  // Methods
+
+  //! Set the mesh surfaces and check that they are valid
+  //!
+  //! \param[in] grid Radii, azimuthal angles in radians, and axial positions
+  //!   of the mesh surfaces
+  //! \return Error code
+  int set_grid(std::array<std::vector<double>, 3> grid);
+
+  std::array<std::vector<double>, 3> grid_; //!< Mesh surfaces in r, phi, z
+  Position origin_ {0.0, 0.0, 0.0}; //!< Position of the mesh axis at z = 0
+
+private:
+  //! Get mesh indices at a position, where an index of zero or one past the
+  //! last element is used for positions outside the mesh
+  //!
+  //! \param[in] r Position relative to the origin of the mesh
+  //! \param[out] ijk Mesh indices
+  //! \return Whether position is in mesh
+  bool local_indices(Position r, int* ijk) const;
+
+  //! Find the distance along a ray to the nearest surface of a mesh element
+  //!
+  //! \param[in] r Position relative to the origin of the mesh
+  //! \param[in] u Direction of the ray
+  //! \param[in] ijk Indices of the mesh element containing r
+  //! \param[out] i_dim Dimension of the surface that is crossed
+  //! \param[out] lower Whether the lower surface in that dimension is crossed
+  //! \return Distance to the surface
+  double distance_to_surface(Position r, Direction u, const int* ijk,
+    int* i_dim, bool* lower) const;
+
+  bool full_phi_; //!< Whether the mesh covers every azimuthal angle
+};
+
 //==============================================================================
 // Non-member functions
 //==============================================================================
@@ -2,9 +2,12 @@
 #define OPENMC_NEIGHBOR_LIST_H
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
-#include <forward_list>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include "openmc/openmp_interface.h"
 
@@ -13,16 +16,37 @@ namespace openmc {
 //==============================================================================
 //! A threadsafe, dynamic container for listing neighboring cells.
 //
-//! This container is a reduced interface for a linked list with an added OpenMP
-//! lock for write operations.  It allows for threadsafe dynamic growth; any
-//! number of threads can safely read data without locks or reference counting.
+//! Elements are stored contiguously in a fixed-capacity block.  Writers
+//! serialize on an OpenMP lock and publish new elements by atomically
+//! incrementing the size.  When a block fills up, its contents are copied into
+//! a larger block which is then published in place of the old one.  Old blocks
+//! are kept alive until the list is destroyed so that any number of threads can
+//! safely read data without locks or reference counting.
 //==============================================================================
 
 class NeighborList
 {
 public:
   using value_type = int32_t;
-  using const_iterator = std::forward_list<value_type>::const_iterator;
+  using const_iterator = const value_type*;
+
+  //! A consistent snapshot of the elements in the list
+  class View {
+  public:
+    View(const_iterator first, const_iterator last)
+      : first_{first}, last_{last} { }
+
+    const_iterator begin() const {return first_;}
+    const_iterator end() const {return last_;}
+
+  private:
+    const_iterator first_;
+    const_iterator last_;
+  };
+
+  NeighborList() = default;
+  NeighborList(const NeighborList&) = delete;
+  NeighborList& operator=(const NeighborList&) = delete;
 
   // Attempt to add an element.
   //
@@ -34,33 +58,49 @@ public:
   {
     // Try to acquire the lock.
     std::unique_lock<OpenMPMutex> lock(mutex_, std::try_to_lock);
-    if (lock) {
-      // It is possible another thread already added this element to the list
-      // while this thread was searching for a cell so make sure the given
-      // element isn't a duplicate before adding it.
-      if (std::find(list_.cbegin(), list_.cend(), new_elem) == list_.cend()) {
-        // Find the end of the list and add the the new element there.
-        if (!list_.empty()) {
-          auto it1 = list_.cbegin();
-          auto it2 = ++list_.cbegin();
-          while (it2 != list_.cend()) it1 = it2++;
-          list_.insert_after(it1, new_elem);
-        } else {
-          list_.push_front(new_elem);
-        }
-      }
-    }
-  }
+    if (!lock) return;
 
-  const_iterator cbegin() const
-  {return list_.cbegin();}
+    // It is possible another thread already added this element to the list
+    // while this thread was searching for a cell so make sure the given
+    // element isn't a duplicate before adding it.
+    std::size_t n = size_.load(std::memory_order_relaxed);
+    value_type* data = data_.load(std::memory_order_relaxed);
+    if (std::find(data, data + n, new_elem) != data + n) return;
 
-  const_iterator cend() const
-  {return list_.cend();}
+    // Move the elements into a larger block if the current one is full. The
+    // new block must be published before the size is incremented past the
+    // capacity of the old block.
+    if (n == capacity_) {
+      capacity_ = (capacity_ > 0) ? 2*capacity_ : INITIAL_CAPACITY;
+      blocks_.emplace_back(new value_type[capacity_]);
+      value_type* new_data = blocks_.back().get();
+      std::copy(data, data + n, new_data);
+      data = new_data;
+      data_.store(data, std::memory_order_release);
+    }
+
+    // Write the element and then make it visible to readers
+    data[n] = new_elem;
+    size_.store(n + 1, std::memory_order_release);
+  }
 
+  //! Get the elements currently in the list
+  View view() const
+  {
+    // The size must be read before the data pointer; any block published
+    // after a given size was stored holds at least that many elements.
+    std::size_t n = size_.load(std::memory_order_acquire);
+    const value_type* data = data_.load(std::memory_order_acquire);
+    return {data, data + n};
+  }
 
 private:
-  std::forward_list<value_type> list_;
+  static constexpr std::size_t INITIAL_CAPACITY {8};
+
+  std::atomic<value_type*> data_ {nullptr}; //!< Current block
+  std::atomic<std::size_t> size_ {0}; //!< Number of published elements
+  std::size_t capacity_ {0}; //!< Capacity of the current block
+  std::vector<std::unique_ptr<value_type[]>> blocks_; //!< Current and retired blocks
   OpenMPMutex mutex_;
 };
 
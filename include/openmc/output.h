@@ -53,6 +53,10 @@ void print_batch_keff();
 //! Display time elapsed for various stages of a run
 void print_runtime();
 
+//! Display how often the cell entered across a lattice tile boundary was
+//! predicted, and reset the counts
+void print_lattice_crossings();
+
 //! Display results for global tallies including k-effective estimators
 void print_results();
 
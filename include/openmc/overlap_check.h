@@ -0,0 +1,104 @@
+#ifndef OPENMC_OVERLAP_CHECK_H
+#define OPENMC_OVERLAP_CHECK_H
+
+#include "openmc/particle.h"
+#include "openmc/position.h"
+
+#include "pugixml.hpp"
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory> // for unique_ptr
+#include <string>
+#include <vector>
+
+namespace openmc {
+
+//==============================================================================
+//! Search for overlapping cells by sampling points throughout the geometry.
+//!
+//! Points are sampled uniformly at random within a box and on a structured
+//! grid. Grid voxels whose neighbors lie in a different cell straddle a
+//! surface, so they are refined with a finer grid of points since overlaps
+//! are most likely found near surfaces. At each point, every cell on every
+//! coordinate level that could contain the point is tested.
+//==============================================================================
+
+class OverlapCheck {
+public:
+  // Aliases, types
+  struct Overlap {
+    int32_t universe; //!< Index of the universe containing both cells
+    std::array<int32_t, 2> cells; //!< Indices of the overlapping cells
+    int64_t count {0}; //!< Number of points found in both cells
+    int64_t sample; //!< Sample number of the example point
+    Position r; //!< Global coordinates of the example point
+  };
+
+  struct Result {
+    std::vector<Overlap> overlaps; //!< Overlapping pairs of cells
+    int64_t n_points {0}; //!< Number of points tested
+    int64_t n_undefined {0}; //!< Number of points not in any cell
+  };
+
+  // Constructors
+  OverlapCheck() = default;
+  explicit OverlapCheck(pugi::xml_node node);
+
+  // Methods
+
+  //! \brief Use the bounding box of the root universe if no box was given
+  void set_bounding_box();
+
+  //! \brief Sample points and test each of them for overlapping cells
+  //
+  //! \return Overlaps found on all processes (only on the master process)
+  Result execute() const;
+
+  //! \brief Write the overlaps found to an HDF5 file
+  //
+  //! \param[in] filename  Path to HDF5 file to write
+  //! \param[in] result    Overlaps found by execute()
+  void to_hdf5(const std::string& filename, const Result& result) const;
+
+  // Data members
+  int64_t n_samples_ {1000000}; //!< Number of random points
+  std::array<int, 3> dimension_ {50, 50, 50}; //!< Voxels of the structured grid
+  int refinement_ {4}; //!< Points per axis in refined voxels
+  Position lower_left_; //!< Lower-left position of bounding box
+  Position upper_right_; //!< Upper-right position of bounding box
+  bool box_given_ {false}; //!< Was the bounding box specified?
+
+private:
+  using OverlapMap = std::map<std::array<int32_t, 3>, Overlap>;
+
+  //! \brief Locate a point and test it for overlaps on every level
+  //
+  //! \param[in] r Global coordinates of the point
+  //! \param[in] sample Unique number of the point, used to choose examples
+  //! \param[in,out] p Particle used for the geometry search
+  //! \param[in,out] overlaps Overlaps found, or nullptr if not recording
+  //! \return Non-negative key identifying the cells containing the point on
+  //!   every level, or C_NONE if the point is not in the geometry
+  int64_t check_point(Position r, int64_t sample, Particle& p,
+    OverlapMap* overlaps) const;
+
+  //! \brief Add overlaps into an accumulated set
+  //
+  //! \param[in] from Overlaps to add
+  //! \param[in,out] to Accumulated overlaps
+  static void merge(const OverlapMap& from, OverlapMap& to);
+};
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace model {
+extern std::unique_ptr<OverlapCheck> overlap_check;
+}
+
+} // namespace openmc
+
+#endif // OPENMC_OVERLAP_CHECK_H
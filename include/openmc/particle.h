@@ -47,6 +47,7 @@ extern "C" {
     int lattice_x {-1};
     int lattice_y {-1};
     int lattice_z {-1};
+    int node {-1}; //!< index in the flattened geometry hierarchy
     double xyz[3]; //!< particle position
     double uvw[3]; //!< particle direction
     bool rotated {false};  //!< Is the level rotated?
@@ -54,6 +54,13 @@ public:
 
   void atomic_relaxation(const ElectronSubshell& shell, Particle& p) const;
 
+  //! Determine the index on the momentum grid of a Compton profile CDF value
+  //! \param[in] shell Index of the electron shell
+  //! \param[in] c CDF value
+  //! \return Index i such that profile_cdf_(shell,i) < c <= profile_cdf_(shell,i+1),
+  //!   which is at most n - 2 for a momentum grid of n points
+  int profile_cdf_index(int shell, double c) const;
+
   // Data members
   std::string name_; //!< Name of element, e.g. "Zr"
   int Z_; //!< Atomic number
@@ -82,6 +89,7 @@ public:
   // Compton profile data
   xt::xtensor<double, 2> profile_pdf_;
   xt::xtensor<double, 2> profile_cdf_;
+  xt::xtensor<int, 2> profile_guide_; //!< Guide table into profile_cdf_
   xt::xtensor<double, 1> binding_energy_;
   xt::xtensor<double, 1> electron_pdf_;
 
@@ -93,8 +101,28 @@ public:
   // Bremsstrahlung scaled DCS
   xt::xtensor<double, 2> dcs_;
 
+  // Tabulated incoherent scattering angular distribution, i.e. the
+  // Klein-Nishina cross section multiplied by the incoherent scattering
+  // function, on a uniform grid in log(alpha)
+  double incoherent_log_alpha_min_; //!< log(alpha) of first grid point
+  double incoherent_log_alpha_spacing_; //!< spacing of log(alpha) grid
+  xt::xtensor<double, 1> incoherent_mu_; //!< scattering cosine grid
+  xt::xtensor<double, 2> incoherent_pdf_; //!< PDF for each alpha grid point
+  xt::xtensor<double, 2> incoherent_cdf_; //!< CDF for each alpha grid point
+
 private:
   void compton_doppler(double alpha, double mu, double* E_out, int* i_shell) const;
+
+  //! Build per-shell guide tables for inverting the Compton profile CDFs
+  void build_profile_guide();
+
+  //! Tabulate the incoherent scattering angular distribution
+  void build_incoherent_tables();
+
+  //! Sample the cosine of the incoherent scattering angle from tabulated data
+  //! \param[in] alpha Photon energy divided by electron rest mass
+  //! \return Cosine of the scattering angle
+  double sample_incoherent_mu(double alpha) const;
 };
 
 //==============================================================================
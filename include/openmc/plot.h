@@ -116,6 +116,12 @@ public:
 // Non-member functions
 //===============================================================================
 
+//! Check whether two plots cover the same region with the same pixels
+//! \param[in] first plot object
+//! \param[in] second plot object
+//! \return whether the plots have the same type and view
+bool same_view(const Plot& a, const Plot& b);
+
 //! Add mesh lines to image data of a plot object
 //! \param[in] plot object
 //! \param[out] image data associated with the plot object
@@ -131,30 +137,38 @@ void output_ppm(Plot pl, const ImageData& data);
 //! \param[in] plot object
 //! \param[out] rgb color
 //! \param[out] cell or material id for particle position
-void position_rgb(Particle p, Plot pl, RGBColor& rgb, int& id);
+void position_rgb(Particle p, const Plot& pl, RGBColor& rgb, int& id);
+
+//! Get the rgb color for a particle that has already been located
+//! \param[in] particle located in the geometry
+//! \param[in] whether a cell containing the particle was found
+//! \param[in] plot object
+//! \param[out] rgb color
+//! \param[out] cell or material id for particle position
+void located_rgb(const Particle& p, bool found_cell, const Plot& pl,
+                 RGBColor& rgb, int& id);
 
 //! Initialize a voxel file
 //! \param[in] id of an open hdf5 file
 //! \param[in] dimensions of the voxel file (dx, dy, dz)
 //! \param[out] dataspace pointer to voxel data
-//! \param[out] dataset pointer to voxesl data
-//! \param[out] pointer to memory space of voxel data
+//! \param[out] dataset pointer to voxel data, chunked and compressed
 void voxel_init(hid_t file_id, const hsize_t* dims, hid_t* dspace,
-                hid_t* dset, hid_t* memspace);
+                hid_t* dset);
 
-//! Write a section of the voxel data to hdf5
-//! \param[in] voxel slice
-//! \param[out] dataspace pointer to voxel data
-//! \param[out] dataset pointer to voxesl data
-//! \param[out] pointer to data to write
-void voxel_write_slice(int x, hid_t dspace, hid_t dset,
-                       hid_t memspace, void* buf);
+//! Write a slab of consecutive x-slices of the voxel data to hdf5
+//! \param[in] first voxel slice
+//! \param[in] number of voxel slices
+//! \param[in] dataspace pointer to voxel data
+//! \param[in] dataset pointer to voxel data
+//! \param[in] pointer to data to write
+void voxel_write_slab(hsize_t x, hsize_t n, hid_t dspace, hid_t dset,
+                      const void* buf);
 
 //! Close voxel file entities
 //! \param[in] data space to close
 //! \param[in] dataset to close
-//! \param[in] memory space to close
-void voxel_finalize(hid_t dspace, hid_t dset, hid_t memspace);
+void voxel_finalize(hid_t dspace, hid_t dset);
 
 //===============================================================================
 // External functions
@@ -164,9 +178,9 @@ void voxel_finalize(hid_t dspace, hid_t dset, hid_t memspace);
 //! \param[in] plot node of plots.xml
 extern "C" void read_plots(pugi::xml_node* plot_node);
 
-//! Create a ppm image for a plot object
-//! \param[in] plot object
-void create_ppm(Plot pl);
+//! Create ppm images for slice plots with the same view in one pass
+//! \param[in] plot objects, all with the same basis, origin, width, and pixels
+void create_ppm(const std::vector<const Plot*>& plots);
 
 //! Create an hdf5 voxel file for a plot object
 //! \param[in] plot object
@@ -1,6 +1,7 @@
 #ifndef OPENMC_POSITION_H
 #define OPENMC_POSITION_H
 
+#include <array>
 #include <cmath> // for sqrt
 #include <stdexcept> // for out_of_range
 #include <vector>
@@ -94,6 +95,42 @@ inline bool operator!=(Position a, Position b)
 
 using Direction = Position;
 
+//==============================================================================
+//! An affine transformation consisting of a translation followed by a rotation
+//!
+//! The rotation matrix is stored inline in row-major order. Flags indicate
+//! whether each part differs from the identity so that it can be skipped.
+//==============================================================================
+
+struct Transform {
+  Position translation {0., 0., 0.}; //!< Vector subtracted from positions
+  std::array<double, 9> rotation {1., 0., 0., 0., 1., 0., 0., 0., 1.};
+  bool translated {false}; //!< Is the translation nonzero?
+  bool rotated {false};    //!< Is the rotation not the identity?
+
+  //! Rotate a position or direction
+  Position rotate(Position r) const
+  {
+    const double* m = rotation.data();
+    return {r.x*m[0] + r.y*m[1] + r.z*m[2],
+            r.x*m[3] + r.y*m[4] + r.z*m[5],
+            r.x*m[6] + r.y*m[7] + r.z*m[8]};
+  }
+
+  //! Transform a position
+  Position apply(Position r) const
+  {
+    if (translated) r -= translation;
+    return rotated ? rotate(r) : r;
+  }
+
+  //! Transform a direction, which is unaffected by the translation
+  Direction apply_direction(Direction u) const
+  {
+    return rotated ? rotate(u) : u;
+  }
+};
+
 } // namespace openmc
 
 #endif // OPENMC_POSITION_H
@@ -25,10 +25,13 @@ namespace settings {
 // Boolean flags
 extern "C" bool assume_separate;         //!< assume tallies are spatially separate?
 extern "C" bool check_overlaps;          //!< check overlaps in geometry?
+extern bool compton_tables;              //!< use tabulated incoherent scattering?
 extern "C" bool confidence_intervals;    //!< use confidence intervals for results?
 extern "C" bool create_fission_neutrons; //!< create fission neutrons (fixed source)?
 extern "C" bool dagmc;                   //!< indicator of DAGMC geometry
+extern bool distance_cache;              //!< reuse boundary distances along straight tracks?
 extern "C" bool entropy_on;              //!< calculate Shannon entropy?
+extern bool flatten_geometry;            //!< flatten the geometry hierarchy?
 extern "C" bool legendre_to_tabular;     //!< convert Legendre distributions to tabular?
 extern bool output_summary;              //!< write summary.h5?
 extern "C" bool output_tallies;          //!< write tallies.out?
@@ -42,6 +45,8 @@ extern "C" bool source_latest;           //!< write latest source at each batch?
 extern "C" bool source_separate;         //!< write source to separate file?
 extern "C" bool source_write;            //!< write source in HDF5 files?
 extern "C" bool survival_biasing;        //!< use survival biasing?
+extern bool tally_buffers;               //!< buffer tally scores on each thread?
+extern bool tally_dispatch;              //!< index tallies by cell and material?
 extern "C" bool temperature_multipole;   //!< use multipole data?
 extern "C" bool trigger_on;              //!< tally triggers enabled?
 extern "C" bool trigger_predict;         //!< predict batches for triggers?
@@ -72,6 +77,7 @@ extern "C" std::array<double, 4> energy_cutoff;      //!< Energy cutoff in [eV]
 extern "C" int legendre_to_tabular_points; //!< number of points to convert Legendres
 extern "C" int max_order;                //!< Maximum Legendre order for multigroup data
 extern "C" int n_log_bins;               //!< number of bins for logarithmic energy grid
+extern int n_neighbor_sweep;             //!< number of rays to prepopulate neighbor lists
 extern "C" int n_max_batches;            //!< Maximum number of batches
 extern ResScatMethod res_scat_method;          //!< resonance upscattering method
 extern double res_scat_energy_min;   //!< Min energy in [eV] for res. upscattering
@@ -80,6 +86,7 @@ extern std::vector<std::string> res_scat_nuclides;  //!< Nuclides using res. ups
 extern "C" int run_mode;                 //!< Run mode (eigenvalue, fixed src, etc.)
 extern std::unordered_set<int> sourcepoint_batch; //!< Batches when source should be written
 extern std::unordered_set<int> statepoint_batch; //!< Batches when state should be written
+extern double tally_buffer_memory;   //!< Memory in [MB] for tally buffers on each thread
 extern "C" int temperature_method;       //!< method for choosing temperatures
 extern "C" double temperature_tolerance; //!< Tolerance in [K] on choosing temperatures
 extern "C" double temperature_default;   //!< Default T in [K]
@@ -1,6 +1,8 @@
 #ifndef OPENMC_SURFACE_H
 #define OPENMC_SURFACE_H
 
+#include <algorithm> // for min, max
+#include <cstdint>
 #include <map>
 #include <limits>  // For numeric_limits
 #include <string>
@@ -33,12 +35,16 @@ extern "C" const int BC_PERIODIC;
 //==============================================================================
 
 class Surface;
+class SurfacePack;
 
 namespace model {
 
 extern std::vector<Surface*> surfaces;
 extern std::map<int, int> surface_map;
 
+//! Packed copy of the surfaces used for geometry tracking
+extern SurfacePack surface_pack;
+
 } // namespace model
 
 //==============================================================================
@@ -53,6 +59,36 @@ struct BoundingBox
   double ymax;
   double zmin;
   double zmax;
+
+  //! Intersection of two bounding boxes
+  BoundingBox operator&(const BoundingBox& other) const
+  {
+    return {std::max(xmin, other.xmin), std::min(xmax, other.xmax),
+            std::max(ymin, other.ymin), std::min(ymax, other.ymax),
+            std::max(zmin, other.zmin), std::min(zmax, other.zmax)};
+  }
+
+  //! Smallest bounding box containing both bounding boxes
+  BoundingBox operator|(const BoundingBox& other) const
+  {
+    return {std::min(xmin, other.xmin), std::max(xmax, other.xmax),
+            std::min(ymin, other.ymin), std::max(ymax, other.ymax),
+            std::min(zmin, other.zmin), std::max(zmax, other.zmax)};
+  }
+};
+
+//! A bounding box covering all of space
+constexpr BoundingBox INFINITE_BOX {-INFTY, INFTY, -INFTY, INFTY, -INFTY, INFTY};
+
+//==============================================================================
+//! Kinds of surfaces that can be evaluated from packed coefficients
+//==============================================================================
+
+enum class SurfaceKind {
+  x_plane, y_plane, z_plane, plane,
+  x_cylinder, y_cylinder, z_cylinder, sphere,
+  x_cone, y_cone, z_cone, quadric,
+  other  //!< Surfaces that must be evaluated through virtual calls
 };
 
 //==============================================================================
@@ -104,6 +140,21 @@ public:
   //! \return Normal direction
   virtual Direction normal(Position r) const = 0;
 
+  //! Get a bounding box for one of the half-spaces of the surface.
+  //!
+  //! The bounding box is conservative; surfaces whose half-spaces are not
+  //! easily bounded return a box covering all of space.
+  //! \param pos_side Whether to bound the positive or negative half-space
+  //! \return Axis-aligned box containing the half-space
+  virtual BoundingBox bounding_box(bool pos_side) const {return INFINITE_BOX;}
+
+  //! Get the kind of surface for packed evaluation
+  virtual SurfaceKind kind() const {return SurfaceKind::other;}
+
+  //! Get the coefficients of the surface equation in the order they are given
+  //! in the geometry input
+  virtual std::vector<double> coefficients() const {return {};}
+
   //! Write all information needed to reconstruct the surface to an HDF5 group.
   //! \param group_id An HDF5 group id.
   //TODO: this probably needs to include i_periodic for PeriodicSurface
@@ -185,10 +236,13 @@ public:
   double evaluate(Position r) const;
   double distance(Position r, Direction u, bool coincident) const;
   Direction normal(Position r) const;
+  SurfaceKind kind() const {return SurfaceKind::x_plane;}
+  std::vector<double> coefficients() const;
   void to_hdf5_inner(hid_t group_id) const;
   bool periodic_translate(const PeriodicSurface* other, Position& r,
                           Direction& u) const;
   BoundingBox bounding_box() const;
+  BoundingBox bounding_box(bool pos_side) const;
 };
 
 //==============================================================================
@@ -205,10 +259,13 @@ public:
   double evaluate(Position r) const;
   double distance(Position r, Direction u, bool coincident) const;
   Direction normal(Position r) const;
+  SurfaceKind kind() const {return SurfaceKind::y_plane;}
+  std::vector<double> coefficients() const;
   void to_hdf5_inner(hid_t group_id) const;
   bool periodic_translate(const PeriodicSurface* other, Position& r,
                           Direction& u) const;
   BoundingBox bounding_box() const;
+  BoundingBox bounding_box(bool pos_side) const;
 };
 
 //==============================================================================
@@ -225,10 +282,13 @@ public:
   double evaluate(Position r) const;
   double distance(Position r, Direction u, bool coincident) const;
   Direction normal(Position r) const;
+  SurfaceKind kind() const {return SurfaceKind::z_plane;}
+  std::vector<double> coefficients() const;
   void to_hdf5_inner(hid_t group_id) const;
   bool periodic_translate(const PeriodicSurface* other, Position& r,
                           Direction& u) const;
   BoundingBox bounding_box() const;
+  BoundingBox bounding_box(bool pos_side) const;
 };
 
 //==============================================================================
@@ -245,6 +305,8 @@ public:
   double evaluate(Position r) const;
   double distance(Position r, Direction u, bool coincident) const;
   Direction normal(Position r) const;
+  SurfaceKind kind() const {return SurfaceKind::plane;}
+  std::vector<double> coefficients() const;
   void to_hdf5_inner(hid_t group_id) const;
   bool periodic_translate(const PeriodicSurface* other, Position& r,
                           Direction& u) const;
@@ -266,6 +328,9 @@ public:
   double evaluate(Position r) const;
   double distance(Position r, Direction u, bool coincident) const;
   Direction normal(Position r) const;
+  SurfaceKind kind() const {return SurfaceKind::x_cylinder;}
+  std::vector<double> coefficients() const;
+  BoundingBox bounding_box(bool pos_side) const;
   void to_hdf5_inner(hid_t group_id) const;
 };
 
@@ -284,6 +349,9 @@ public:
   double evaluate(Position r) const;
   double distance(Position r, Direction u, bool coincident) const;
   Direction normal(Position r) const;
+  SurfaceKind kind() const {return SurfaceKind::y_cylinder;}
+  std::vector<double> coefficients() const;
+  BoundingBox bounding_box(bool pos_side) const;
   void to_hdf5_inner(hid_t group_id) const;
 };
 
@@ -302,6 +370,9 @@ public:
   double evaluate(Position r) const;
   double distance(Position r, Direction u, bool coincident) const;
   Direction normal(Position r) const;
+  SurfaceKind kind() const {return SurfaceKind::z_cylinder;}
+  std::vector<double> coefficients() const;
+  BoundingBox bounding_box(bool pos_side) const;
   void to_hdf5_inner(hid_t group_id) const;
 };
 
@@ -320,6 +391,9 @@ public:
   double evaluate(Position r) const;
   double distance(Position r, Direction u, bool coincident) const;
   Direction normal(Position r) const;
+  SurfaceKind kind() const {return SurfaceKind::sphere;}
+  std::vector<double> coefficients() const;
+  BoundingBox bounding_box(bool pos_side) const;
   void to_hdf5_inner(hid_t group_id) const;
 };
 
@@ -338,6 +412,8 @@ public:
   double evaluate(Position r) const;
   double distance(Position r, Direction u, bool coincident) const;
   Direction normal(Position r) const;
+  SurfaceKind kind() const {return SurfaceKind::x_cone;}
+  std::vector<double> coefficients() const;
   void to_hdf5_inner(hid_t group_id) const;
 };
 
@@ -356,6 +432,8 @@ public:
   double evaluate(Position r) const;
   double distance(Position r, Direction u, bool coincident) const;
   Direction normal(Position r) const;
+  SurfaceKind kind() const {return SurfaceKind::y_cone;}
+  std::vector<double> coefficients() const;
   void to_hdf5_inner(hid_t group_id) const;
 };
 
@@ -374,6 +452,8 @@ public:
   double evaluate(Position r) const;
   double distance(Position r, Direction u, bool coincident) const;
   Direction normal(Position r) const;
+  SurfaceKind kind() const {return SurfaceKind::z_cone;}
+  std::vector<double> coefficients() const;
   void to_hdf5_inner(hid_t group_id) const;
 };
 
@@ -392,9 +472,151 @@ public:
   double evaluate(Position r) const;
   double distance(Position r, Direction u, bool coincident) const;
   Direction normal(Position r) const;
+  SurfaceKind kind() const {return SurfaceKind::quadric;}
+  std::vector<double> coefficients() const;
   void to_hdf5_inner(hid_t group_id) const;
 };
 
+//==============================================================================
+//! Surface equations packed contiguously for evaluation without virtual calls
+//!
+//! Each surface is stored as a kind tag and an offset into a single array of
+//! coefficients. Evaluation dispatches on the kind with a switch; surfaces of
+//! kind SurfaceKind::other are forwarded to the polymorphic Surface objects.
+//==============================================================================
+
+class SurfacePack
+{
+public:
+  //! Pack a surface; surfaces must be added in the order of model::surfaces
+  void push_back(const Surface& surf);
+
+  void clear();
+
+  SurfaceKind kind(int i) const {return entries_[i].kind;}
+
+  const double* coeffs(int i) const {return &coeffs_[entries_[i].offset];}
+
+  //! Evaluate the equation of surface i (see Surface::evaluate)
+  double evaluate(int i, Position r) const
+  {
+    const Entry& e {entries_[i]};
+    const double* c = &coeffs_[e.offset];
+    switch (e.kind) {
+      case SurfaceKind::x_plane:
+        return r.x - c[0];
+      case SurfaceKind::y_plane:
+        return r.y - c[0];
+      case SurfaceKind::z_plane:
+        return r.z - c[0];
+      case SurfaceKind::plane:
+        return c[0]*r.x + c[1]*r.y + c[2]*r.z - c[3];
+      case SurfaceKind::x_cylinder:
+        return quadratic_2d(r.y - c[0], r.z - c[1], c[2]);
+      case SurfaceKind::y_cylinder:
+        return quadratic_2d(r.x - c[0], r.z - c[1], c[2]);
+      case SurfaceKind::z_cylinder:
+        return quadratic_2d(r.x - c[0], r.y - c[1], c[2]);
+      case SurfaceKind::sphere: {
+        const double x = r.x - c[0];
+        const double y = r.y - c[1];
+        const double z = r.z - c[2];
+        return x*x + y*y + z*z - c[3]*c[3];
+      }
+      case SurfaceKind::x_cone:
+        return cone(r.x - c[0], r.y - c[1], r.z - c[2], c[3]);
+      case SurfaceKind::y_cone:
+        return cone(r.y - c[1], r.x - c[0], r.z - c[2], c[3]);
+      case SurfaceKind::z_cone:
+        return cone(r.z - c[2], r.x - c[0], r.y - c[1], c[3]);
+      case SurfaceKind::quadric:
+        return r.x*(c[0]*r.x + c[3]*r.y + c[6]) +
+               r.y*(c[1]*r.y + c[4]*r.z + c[7]) +
+               r.z*(c[2]*r.z + c[5]*r.x + c[8]) + c[9];
+      default:
+        return evaluate_other(i, r);
+    }
+  }
+
+  //! Compute the distance to surface i along a ray (see Surface::distance)
+  double distance(int i, Position r, Direction u, bool coincident) const;
+
+  //! Compute the normal of surface i (see Surface::normal)
+  Direction normal(int i, Position r) const;
+
+  //! Determine which side of surface i a point lies on (see Surface::sense)
+  bool sense(int i, Position r, Direction u) const
+  {
+    // Evaluate the surface equation at the particle's coordinates to determine
+    // which side the particle is on.
+    const double f = evaluate(i, r);
+
+    // If the particle may be coincident with this surface, look at the
+    // direction of the particle relative to the surface normal.
+    if (std::abs(f) < FP_COINCIDENT) return u.dot(normal(i, r)) > 0.0;
+    return f > 0.0;
+  }
+
+private:
+  struct Entry {
+    SurfaceKind kind; //!< Kind of surface
+    int offset;       //!< Offset of the coefficients in coeffs_
+  };
+
+  static double quadratic_2d(double r1, double r2, double radius)
+  {return r1*r1 + r2*r2 - radius*radius;}
+
+  static double cone(double r1, double r2, double r3, double radius_sq)
+  {return r2*r2 + r3*r3 - radius_sq*r1*r1;}
+
+  double evaluate_other(int i, Position r) const;
+
+  std::vector<Entry> entries_;  //!< Kind and coefficient offset of each surface
+  std::vector<double> coeffs_;  //!< Coefficients of all surfaces
+};
+
+//==============================================================================
+//! A set of half-spaces grouped by surface kind for distance calculations.
+//!
+//! The kind of surface is dispatched on once for each group rather than once
+//! for each surface, and the coefficients of each group are stored
+//! coefficient-major. The distance kernels still branch on the discriminant
+//! and on coincidence for each surface, so the loop over a group is not
+//! vectorized.
+//==============================================================================
+
+class SurfaceBatch
+{
+public:
+  SurfaceBatch() = default;
+
+  //! \param halfspaces Signed (1-based) surface indices of the half-spaces
+  explicit SurfaceBatch(const std::vector<int32_t>& halfspaces);
+
+  //! Compute the distance to each surface along a ray
+  //! \param r The starting point of the ray.
+  //! \param u The direction of the ray.
+  //! \param on_surface The signed index of a surface that r is known to be on.
+  //! \param[out] d Distance to each surface in the order the half-spaces were
+  //!   given to the constructor.
+  void distances(Position r, Direction u, int32_t on_surface, double* d) const;
+
+  bool empty() const {return groups_.empty();}
+
+private:
+  struct Group {
+    SurfaceKind kind;
+    int start;        //!< Index of first member in token_ and index_
+    int n;            //!< Number of members
+    int coeff_start;  //!< Index of first coefficient in coeffs_
+  };
+
+  std::vector<Group> groups_;
+  std::vector<int32_t> token_;  //!< Signed surface index of each member
+  std::vector<int> index_;      //!< Position of each member in the input order
+  std::vector<double> coeffs_;  //!< Coefficients of each group
+};
+
 //==============================================================================
 // Non-member functions
 //==============================================================================
@@ -57,6 +57,9 @@ public:
   get_all_bins(const Particle* p, int estimator, FilterMatch& match) const = 0;
 
   //! Writes data describing this filter to an HDF5 statepoint group.
+  //
+  //! Everything that affects get_all_bins() must be written, since filters
+  //! that write the same data share their matches for each tally event.
   virtual void
   to_statepoint(hid_t filter_group) const
   {
@@ -72,6 +75,17 @@ public:
 
   virtual void initialize() {}
 
+  //! Whether another filter with the same serialized bins always matches the
+  //! same bins with the same weights as this one. Equivalent filters share
+  //! their matches for each tally event so that the bins are only found once.
+  //! By default, filters with the same serialized bins are equivalent if they
+  //! have the same type, and overrides can only be stricter than that.
+  virtual bool equivalent(const Filter& other) const;
+
+  //! Serialize the data that to_statepoint() writes for this filter, which
+  //! includes its type and defines its bins
+  std::string serialized_bins() const;
+
   int32_t id_;
 
   int n_bins_;
@@ -83,8 +97,15 @@ public:
 
 namespace simulation {
 
+//! Matches for the current tally event, shared by equivalent filters
 extern std::vector<FilterMatch> filter_matches;
-#pragma omp threadprivate(filter_matches)
+
+//! Indices of the matches whose bins were found for the current tally event
+extern std::vector<int> filter_matches_found;
+#pragma omp threadprivate(filter_matches, filter_matches_found)
+
+//! Index in filter_matches for each filter
+extern std::vector<int> filter_match_index;
 
 } // namespace simulation
 
@@ -95,6 +116,26 @@ extern std::vector<std::unique_ptr<Filter>> tally_filters;
 
 } // namespace model
 
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Get the match of a filter for the current tally event
+//
+//! \param[in] i_filt Index in tally_filters array
+//! \return Match shared by the filter and all filters equivalent to it
+inline FilterMatch& filter_match(int32_t i_filt)
+{
+  return simulation::filter_matches[simulation::filter_match_index[i_filt]];
+}
+
+//! Group equivalent filters so that they share matches and allocate the
+//! matches for each thread
+void setup_filter_matches();
+
+//! Mark the matches found for the last tally event as not present
+void reset_filter_matches();
+
 //==============================================================================
 
 // Filter-related Fortran functions that will be called from C++
@@ -2,7 +2,6 @@
 #define OPENMC_TALLIES_FILTER_CELL_H
 
 #include <cstdint>
-#include <unordered_map>
 #include <vector>
 
 #include "openmc/tallies/filter.h"
@@ -34,8 +33,9 @@ public:
   //! The indices of the cells binned by this filter.
   std::vector<int32_t> cells_;
 
-  //! A map from cell indices to filter bin indices.
-  std::unordered_map<int32_t, int> map_;
+  //! Filter bin index for each index of the global cell array, or C_NONE if
+  //! the cell is not binned by this filter.
+  std::vector<int> map_;
 };
 
 } // namespace openmc
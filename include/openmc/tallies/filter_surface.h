@@ -2,7 +2,6 @@
 #define OPENMC_TALLIES_FILTER_SURFACE_H
 
 #include <cstdint>
-#include <unordered_map>
 #include <vector>
 
 #include "openmc/tallies/filter.h"
@@ -34,8 +33,9 @@ public:
   //! The indices of the surfaces binned by this filter.
   std::vector<int32_t> surfaces_;
 
-  //! A map from surface indices to filter bin indices.
-  std::unordered_map<int32_t, int> map_;
+  //! Filter bin index for each index of the global surface array, or C_NONE if
+  //! the surface is not binned by this filter.
+  std::vector<int> map_;
 };
 
 } // namespace openmc
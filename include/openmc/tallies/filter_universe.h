@@ -2,7 +2,6 @@
 #define OPENMC_TALLIES_FILTER_UNIVERSE_H
 
 #include <cstdint>
-#include <unordered_map>
 #include <vector>
 
 #include "openmc/tallies/filter.h"
@@ -34,8 +33,9 @@ public:
   //! The indices of the universes binned by this filter.
   std::vector<int32_t> universes_;
 
-  //! A map from universe indices to filter bin indices.
-  std::unordered_map<int32_t, int> map_;
+  //! Filter bin index for each index of the global universe array, or C_NONE if
+  //! the universe is not binned by this filter.
+  std::vector<int> map_;
 };
 
 } // namespace openmc
@@ -0,0 +1,94 @@
+#ifndef OPENMC_TALLIES_SPARSE_RESULTS_H
+#define OPENMC_TALLIES_SPARSE_RESULTS_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory> // for unique_ptr
+#include <vector>
+
+namespace openmc {
+
+//==============================================================================
+//! Results of a sparse tally, stored in blocks of filter bins.
+//
+//! A block holds the value, sum, and sum of squares of every score bin for
+//! BLOCK_SIZE consecutive filter bins and is allocated, zeroed, the first time
+//! one of its bins is scored to. Blocks that were never scored to take no
+//! memory apart from one pointer each in the block table, and passes over the
+//! results only visit the blocks that have been allocated.
+//
+//! Any number of threads can look up and allocate blocks concurrently. Blocks
+//! are published with an atomic pointer after they are zeroed and are not
+//! freed until the results are cleared.
+//==============================================================================
+
+class SparseResults {
+public:
+  //! Number of filter bins in each block
+  static constexpr int64_t BLOCK_SIZE {64};
+
+  //! Set the shape of the results and free all blocks
+  //
+  //! \param[in] n_filter Number of filter bin combinations
+  //! \param[in] n_score Number of score bins
+  void resize(int64_t n_filter, int64_t n_score);
+
+  //! Free all blocks so that every result is zero
+  void clear();
+
+  //! Get the results of a filter bin, allocating its block if needed
+  //
+  //! \param[in] i_bin Index of the filter bin combination
+  //! \return Pointer to the value, sum, and sum of squares of each score bin
+  double* get(int64_t i_bin)
+  {
+    double* block = table_[i_bin / BLOCK_SIZE].load(std::memory_order_acquire);
+    if (!block) block = allocate(i_bin / BLOCK_SIZE);
+    return block + (i_bin % BLOCK_SIZE) * n_score_ * 3;
+  }
+
+  //! Find the results of a filter bin without allocating its block
+  //
+  //! \param[in] i_bin Index of the filter bin combination
+  //! \return Pointer to the value, sum, and sum of squares of each score bin,
+  //!   or nullptr if the results are all zero
+  const double* find(int64_t i_bin) const
+  {
+    const double* block = table_[i_bin / BLOCK_SIZE].load(
+      std::memory_order_acquire);
+    if (!block) return nullptr;
+    return block + (i_bin % BLOCK_SIZE) * n_score_ * 3;
+  }
+
+  //! Get the indices of the allocated blocks in ascending order
+  std::vector<int64_t> blocks() const;
+
+  //! Get the first filter bin of a block and the number of filter bins in it
+  int64_t block_start(int64_t i_block) const {return i_block * BLOCK_SIZE;}
+  int64_t block_length(int64_t i_block) const;
+
+  //! Get the results of an allocated block, which are ordered by filter bin,
+  //! score bin, and result type
+  double* block_data(int64_t i_block) const
+  {return table_[i_block].load(std::memory_order_relaxed);}
+
+private:
+  //! Allocate a zeroed block, unless another thread already has
+  double* allocate(int64_t i_block);
+
+  int64_t n_filter_ {0}; //!< Number of filter bin combinations
+  int64_t n_score_ {0}; //!< Number of score bins
+
+  //! Pointer to each block, or nullptr if it has not been allocated
+  std::unique_ptr<std::atomic<double*>[]> table_;
+
+  //! Storage for the allocated blocks, in the order they were allocated
+  std::vector<std::unique_ptr<double[]>> storage_;
+
+  //! Index of each allocated block, in the order they were allocated
+  std::vector<int64_t> allocated_;
+};
+
+} // namespace openmc
+
+#endif // OPENMC_TALLIES_SPARSE_RESULTS_H
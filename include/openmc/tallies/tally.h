@@ -2,17 +2,28 @@
 #define OPENMC_TALLIES_TALLY_H
 
 #include "openmc/constants.h"
+#include "openmc/tallies/sparse_results.h"
 #include "openmc/tallies/trigger.h"
 
 #include "pugixml.hpp"
 #include "xtensor/xtensor.hpp"
 
+#include <array>
+#include <cstddef> // for size_t
+#include <cstdint>
 #include <memory> // for unique_ptr
 #include <string>
 #include <vector>
 
 namespace openmc {
 
+struct Particle;
+
+// Alias for the type returned by xt::adapt(...). N is the dimension of the
+// multidimensional array
+template <std::size_t N>
+using adaptor_type = xt::xtensor_adaptor<xt::xbuffer_adaptor<double*&, xt::no_ownership>, N>;
+
 //==============================================================================
 //! A user-specified flux-weighted (or current) measurement.
 //==============================================================================
@@ -42,6 +53,27 @@ public:
 
   int32_t n_filter_bins() const {return n_filter_bins_;}
 
+  //----------------------------------------------------------------------------
+  // Methods for accessing results.
+
+  //! Get the shape of the results: filter bins, score bins, and result types
+  const std::array<std::size_t, 3>& results_shape() const
+  {return results_shape_;}
+
+  //! Get the results of a filter bin combination and score bin. The results
+  //! of sparse tallies are allocated if they have not been scored to yet.
+  //! \param i_bin Index of the filter bin combination
+  //! \param i_score Index of the score bin
+  //! \return Pointer to the value, sum, and sum of squares of the results
+  double* results(int i_bin, int i_score) const
+  {
+    if (sparse_) return sparse_results_.get(i_bin) + i_score*3;
+    return results_ + (i_bin*results_shape_[1] + i_score)*3;
+  }
+
+  //! Get the results of a sparse tally
+  SparseResults& sparse_results() const {return sparse_results_;}
+
   //----------------------------------------------------------------------------
   // Other methods.
 
@@ -70,6 +102,10 @@ public:
   //! True if this tally has a bin for every nuclide in the problem
   bool all_nuclides_ {false};
 
+  //! True if memory is only used for the parts of the results that are scored
+  //! to, which is meant for very large tallies that are mostly empty
+  bool sparse_ {false};
+
   //----------------------------------------------------------------------------
   // Miscellaneous public members.
 
@@ -95,6 +131,61 @@ private:
   std::vector<int32_t> strides_;
 
   int32_t n_filter_bins_ {0};
+
+  //! Results of this tally, which are stored in the results arena, or nullptr
+  //! for sparse tallies
+  double* results_ {nullptr};
+
+  //! Shape of the results: filter bins, score bins, and result types
+  std::array<std::size_t, 3> results_shape_ {0, 0, 3};
+
+  //! Results of a sparse tally. Blocks of results are allocated as they are
+  //! first scored to, including through const references to the tally.
+  mutable SparseResults sparse_results_;
+
+  friend void allocate_tally_results();
+  friend adaptor_type<3> tally_results(int idx);
+};
+
+//==============================================================================
+//! Index of the tallies in a list that can score in each cell and material.
+//
+//! A tally with a cell filter can only score when the particle is in one of
+//! the filter's cells on some coordinate level, and a tally with a material
+//! filter can only score in one of the filter's materials. The index lets each
+//! tally event skip such tallies without searching for their filter bins.
+//==============================================================================
+
+class TallyDispatch {
+public:
+  //! Build the index for a list of tallies, unless it is turned off by the
+  //! tally_dispatch setting
+  //
+  //! \param[in] tallies Indices in the tallies array
+  void build(const std::vector<int>& tallies);
+
+  //! Find the tallies that can score for the particle's current position
+  //
+  //! \param[in] p Particle
+  //! \return Indices in the tallies array, in the same order as the list the
+  //!   index was built for
+  const std::vector<int>& tallies(const Particle* p) const;
+
+private:
+  //! Indices in the tallies array
+  std::vector<int> tallies_;
+
+  //! Positions in tallies_ of the tallies that can score anywhere
+  std::vector<int> anywhere_;
+
+  //! Positions in tallies_ of the tallies that can score in each cell
+  std::vector<std::vector<int>> by_cell_;
+
+  //! Positions in tallies_ of the tallies that can score in each material
+  std::vector<std::vector<int>> by_material_;
+
+  //! Whether any tally is restricted to certain cells or materials
+  bool indexed_ {false};
 };
 
 //==============================================================================
@@ -112,8 +203,20 @@ extern std::vector<int> active_collision_tallies;
 extern std::vector<int> active_meshsurf_tallies;
 extern std::vector<int> active_surface_tallies;
 
+//! Active volume tallies with each estimator indexed by cell and material
+extern TallyDispatch analog_tally_dispatch;
+extern TallyDispatch tracklength_tally_dispatch;
+extern TallyDispatch collision_tally_dispatch;
+
 } // namespace model
 
+namespace simulation {
+
+//! Contiguous storage for the results of all tallies
+extern std::vector<double> tally_results_arena;
+
+} // namespace simulation
+
 // Threadprivate variables
 extern "C" double global_tally_absorption;
 extern "C" double global_tally_collision;
@@ -126,20 +229,52 @@ extern "C" double global_tally_leakage;
 // Non-member functions
 //==============================================================================
 
-// Alias for the type returned by xt::adapt(...). N is the dimension of the
-// multidimensional array
-template <std::size_t N>
-using adaptor_type = xt::xtensor_adaptor<xt::xbuffer_adaptor<double*&, xt::no_ownership>, N>;
-
 //! Get the global tallies as a multidimensional array
 //! \return Global tallies array
 adaptor_type<2> global_tallies();
 
-//! Get tally results as a multidimensional array
+//! Get tally results as a multidimensional array. Results of sparse tallies
+//! are not contiguous and have to be accessed through Tally::sparse_results.
 //! \param idx Index in tallies array
 //! \return Tally results array
 adaptor_type<3> tally_results(int idx);
 
+//! Allocate the results of every tally in the results arena. Results of
+//! tallies whose shape has not changed since the last allocation are kept.
+void allocate_tally_results();
+
+//! Get the nonzero entries of some of the result types of a tally. Only the
+//! allocated blocks of sparse tallies are searched.
+//! \param tally Tally to get the results of
+//! \param first First result type, e.g. RESULT_SUM
+//! \param n Number of result types
+//! \param[out] bins Sorted indices of the filter and score bin combinations
+//!   that have a nonzero result, i.e. i_filter*n_score_bins + i_score
+//! \param[out] values The n result types of each of those bins
+void nonzero_tally_results(const Tally& tally, int first, int n,
+  std::vector<int64_t>& bins, std::vector<double>& values);
+
+#ifdef OPENMC_MPI
+//! Gather the nonzero entries of some of the result types of a tally from
+//! every process other than the master process onto the master process
+//! \param tally Tally to get the results of
+//! \param first First result type, e.g. RESULT_SUM
+//! \param n Number of result types
+//! \param[out] bins Bin combinations with a nonzero result on each process.
+//!   Only significant on the master process.
+//! \param[out] values The n result types of each of those bins
+void gather_tally_results(const Tally& tally, int first, int n,
+  std::vector<int64_t>& bins, std::vector<double>& values);
+#endif
+
+//! Add the results of a sparse tally at the end of a batch to the sum and sum
+//! of squares of its allocated blocks, and zero the values
+//! \param tally Tally to accumulate
+//! \param total_weight Total starting particle weight in the batch
+//! \param total_source Total source strength used for normalization
+void accumulate_sparse_results(Tally& tally, double total_weight,
+  double total_source);
+
 #ifdef OPENMC_MPI
 //! Collect all tally results onto master process
 extern "C" void reduce_tally_results();
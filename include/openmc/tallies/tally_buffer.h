@@ -0,0 +1,122 @@
+#ifndef OPENMC_TALLIES_TALLY_BUFFER_H
+#define OPENMC_TALLIES_TALLY_BUFFER_H
+
+#include "openmc/constants.h"
+#include "openmc/tallies/tally.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace openmc {
+
+//==============================================================================
+//! Private accumulation buffer for the results of one tally on one thread.
+//
+//! Scores are added to the buffer without any synchronization and are reduced
+//! into the shared tally results at the end of each generation. Small tallies
+//! have an entry for every result bin. Larger tallies, such as mesh tallies
+//! where a thread only scores to a small fraction of the bins in a
+//! generation, only have entries for the bins that were scored. Scores that do
+//! not fit in the buffer are added to the shared results atomically.
+//==============================================================================
+
+class TallyBuffer {
+public:
+  enum class Mode {
+    atomic, //!< Scores are added directly to the shared results
+    dense,  //!< Entries for every result bin
+    sparse  //!< Entries for the result bins that were scored
+  };
+
+  //! \brief Add a score to a result bin
+  //
+  //! \param[in] i_bin Index of the filter bin combination
+  //! \param[in] i_score Index of the score bin
+  //! \param[in] score Value to add
+  //! \return Whether the score was added to the buffer
+  bool add(int i_bin, int i_score, double score)
+  {
+    int64_t k = static_cast<int64_t>(i_bin)*n_scores_ + i_score;
+    switch (mode_) {
+    case Mode::dense:
+      dense_[k] += score;
+      return true;
+    case Mode::sparse: {
+      auto it = sparse_.find(k);
+      if (it != sparse_.end()) {
+        it->second += score;
+        return true;
+      }
+      if (sparse_.size() >= max_entries_) return false;
+      sparse_.emplace(k, score);
+      return true;
+    }
+    default:
+      return false;
+    }
+  }
+
+  Mode mode_ {Mode::atomic}; //!< How scores are buffered
+  int n_scores_ {0}; //!< Number of score bins for each filter bin
+  std::vector<double> dense_; //!< Entries for every result bin
+  std::unordered_map<int64_t, double> sparse_; //!< Entries for scored bins
+  std::size_t max_entries_ {0}; //!< Maximum number of sparse entries
+};
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace simulation {
+
+//! Buffers for each tally on each thread, or empty if scores are added to the
+//! shared tally results directly
+extern std::vector<std::vector<TallyBuffer>> tally_buffers;
+
+} // namespace simulation
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Add a score to a tally result, either in the thread's buffer or directly in
+//! the shared results
+//
+//! \param[in] i_tally Index in tallies array
+//! \param[in] tally The tally at that index
+//! \param[in] i_bin Index of the filter bin combination
+//! \param[in] i_score Index of the score bin
+//! \param[in] score Value to add
+inline void add_tally_result(int i_tally, const Tally& tally, int i_bin,
+  int i_score, double score)
+{
+  if (!simulation::tally_buffers.empty()) {
+#ifdef _OPENMP
+    auto& buffer {simulation::tally_buffers[omp_get_thread_num()][i_tally]};
+#else
+    auto& buffer {simulation::tally_buffers[0][i_tally]};
+#endif
+    if (buffer.add(i_bin, i_score, score)) return;
+  }
+
+  double* result = tally.results(i_bin, i_score) + RESULT_VALUE;
+  #pragma omp atomic
+  *result += score;
+}
+
+//! Decide how each active tally is buffered and allocate the buffers for every
+//! thread
+void setup_tally_buffers();
+
+//! Add the buffered scores of every thread into the shared tally results and
+//! zero the buffers
+void reduce_tally_buffers();
+
+} // namespace openmc
+
+#endif // OPENMC_TALLIES_TALLY_BUFFER_H
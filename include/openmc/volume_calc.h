@@ -1,11 +1,14 @@
 #ifndef VOLUME_CALC_H
 #define VOLUME_CALC_H
 
+#include "openmc/constants.h"
+#include "openmc/particle.h"
 #include "openmc/position.h"
 
 #include "pugixml.hpp"
 #include "xtensor/xtensor.hpp"
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -18,11 +21,24 @@ namespace openmc {
 class VolumeCalculation {
 public:
   // Aliases, types
+  enum class Estimator {
+    hit, //!< Fraction of points sampled in the bounding box
+    ray  //!< Chord lengths of random lines through the bounding box
+  };
+
+  enum class TriggerMetric {
+    not_active,
+    variance,
+    standard_deviation,
+    relative_error
+  };
+
   struct Result {
     std::array<double, 2> volume; //!< Mean/standard deviation of volume
     std::vector<int> nuclides; //!< Index of nuclides
     std::vector<double> atoms; //!< Number of atoms for each nuclide
     std::vector<double> uncertainty; //!< Uncertainty on number of atoms
+    int iterations; //!< Number of iterations of n_samples_ needed
   }; // Results for a single domain
 
   // Constructors
@@ -34,7 +50,7 @@ public:
   //!   average number densities of nuclides within the domain
   //
   //! \return Vector of results for each user-specified domain
-  std::vector<Result> execute() const;
+  std::vector<Result> execute();
 
   //! \brief Write volume calculation results to HDF5 file
   //
@@ -44,21 +60,91 @@ public:
 
   // Data members
   int domain_type_; //!< Type of domain (cell, material, etc.)
-  int n_samples_; //!< Number of samples to use
+  int64_t n_samples_; //!< Number of samples to use in each iteration
   Position lower_left_; //!< Lower-left position of bounding box
   Position upper_right_; //!< Upper-right position of bounding box
   std::vector<int> domain_ids_; //!< IDs of domains to find volumes of
+  Estimator estimator_ {Estimator::hit}; //!< How volumes are estimated
+  TriggerMetric trigger_type_ {TriggerMetric::not_active}; //!< Trigger metric
+  std::vector<double> thresholds_; //!< Error threshold for all domain volumes
+                                  //!< or for each domain volume
+  int max_iterations_ {1000}; //!< Iterations after which the trigger is ended
 
 private:
-  //! \brief Check whether a material has already been hit for a given domain.
-  //! If not, add new entries to the vectors
+  //! Scores accumulated for each domain and material. Rows are the domains
+  //! followed by the whole bounding box, and columns are the materials (see
+  //! column()) followed by the total over all materials, so that a score is
+  //! added without any search. Each score x is paired with a score y for the
+  //! whole bounding box so that ratios of the two can be estimated.
+  struct Scores {
+    xt::xtensor<double, 2> sum; //!< Sum of x
+    xt::xtensor<double, 2> sum_sq; //!< Sum of x^2 (ray estimator only)
+    xt::xtensor<double, 2> sum_xy; //!< Sum of x*y (ray estimator only)
+  };
+
+  //! \brief Create zeroed scores for every domain and material
+  Scores create_scores() const;
+
+  //! \brief Get the column of the scores for a material
+  //
+  //! For material domains, each domain has a single material and only one
+  //! column is needed. Otherwise, column 0 is for void and column i + 1 is for
+  //! the material with index i.
+  //
+  //! \param[in] material Material of a located particle
+  //! \return Column of the scores
+  int column(int material) const
+  {
+    // TODO: off-by-one
+    if (domain_type_ == FILTER_MATERIAL || material == MATERIAL_VOID) return 0;
+    return material;
+  }
+
+  //! \brief Find the user-specified domains that a located particle is in
+  //
+  //! \param[in] p Particle located in the geometry
+  //! \param[out] domains Indices of domains containing the particle
+  void find_domains(const Particle& p, std::vector<int>& domains) const;
+
+  //! \brief Sample a point and score a hit for the domains it is in
+  //
+  //! \param[in,out] p Particle used for the geometry search
+  //! \param[in,out] scores Scores for each domain and material
+  //! \param[out] domains Work space for the domains containing the point
+  void sample_point(Particle& p, Scores& scores,
+    std::vector<int>& domains) const;
+
+  //! \brief Sample a line through the bounding box and score the volume
+  //!   estimated from the length of its chord in each domain
+  //
+  //! \param[in,out] p Particle used for the geometry search
+  //! \param[in,out] scores Scores for each domain and material and the
+  //!   bounding box
+  //! \param[in,out] lengths Work space for the chord lengths in each domain
+  //!   and material, which must be zero on entry and is zeroed on exit
+  //! \param[out] touched Work space for the entries of lengths that are set
+  //! \param[out] domains Work space for the domains containing a segment
+  void sample_ray(Particle& p, Scores& scores, xt::xtensor<double, 2>& lengths,
+    std::vector<int>& touched, std::vector<int>& domains) const;
+
+  //! \brief Combine the scores of all processes and compute results
+  //
+  //! \param[in] scores Scores for each domain and material and the bounding
+  //!   box on this process
+  //! \param[in] n_total Total number of samples on all processes
+  //! \return Results for each domain (only on the master process)
+  std::vector<Result> compute_results(const Scores& scores,
+    double n_total) const;
+
+  //! \brief Check whether the trigger has been satisfied for every domain
   //
-  //! \param[in] i_material Index in global materials vector
-  //! \param[in,out] indices Vector of material indices
-  //! \param[in,out] hits Number of hits corresponding to each material
-  void check_hit(int i_material, std::vector<int>& indices,
-    std::vector<int>& hits) const;
+  //! \param[in] results Results for each domain
+  //! \return Whether more iterations are needed
+  bool trigger_unmet(const std::vector<Result>& results) const;
 
+  std::vector<int> domain_index_; //!< Domain of each cell, material, or
+                                  //!< universe, or C_NONE
+  int n_columns_; //!< Number of columns of the scores
 };
 
 //==============================================================================
@@ -29,6 +29,8 @@ _array_1d_dble = np.ctypeslib.ndpointer(dtype=np.double, ndim=1,
 
 _dll.openmc_calculate_volumes.restype = c_int
 _dll.openmc_calculate_volumes.errcheck = _error_handler
+_dll.openmc_check_overlaps.restype = c_int
+_dll.openmc_check_overlaps.errcheck = _error_handler
 _dll.openmc_finalize.restype = c_int
 _dll.openmc_finalize.errcheck = _error_handler
 _dll.openmc_find_cell.argtypes = [POINTER(c_double*3), POINTER(c_int32),
@@ -77,6 +79,11 @@ def calculate_volumes():
     _dll.openmc_calculate_volumes()
 
 
+def check_overlaps():
+    """Sample points throughout the geometry and check for overlapping cells"""
+    _dll.openmc_check_overlaps()
+
+
 def current_batch():
     """Return the current batch of the simulation.
 
@@ -1,5 +1,6 @@
 from collections.abc import Mapping, Iterable
-from ctypes import c_int, c_int32, c_double, POINTER
+from ctypes import c_int, c_int32, c_double, c_char_p, POINTER, \
+    create_string_buffer
 from weakref import WeakValueDictionary
 
 import numpy as np
@@ -11,10 +12,22 @@ from .core import _FortranObjectWithID
 from .error import _error_handler
 from .material import Material
 
-__all__ = ['Mesh', 'meshes']
+__all__ = ['Mesh', 'RectilinearMesh', 'CylindricalMesh', 'meshes']
 
 # Mesh functions
-_dll.openmc_extend_meshes.argtypes = [c_int32, POINTER(c_int32), POINTER(c_int32)]
+_dll.openmc_cylindrical_mesh_get_grid.argtypes = [
+    c_int32, POINTER(POINTER(c_double)), POINTER(c_int),
+    POINTER(POINTER(c_double)), POINTER(c_int), POINTER(POINTER(c_double)),
+    POINTER(c_int), POINTER(c_double)]
+_dll.openmc_cylindrical_mesh_get_grid.restype = c_int
+_dll.openmc_cylindrical_mesh_get_grid.errcheck = _error_handler
+_dll.openmc_cylindrical_mesh_set_grid.argtypes = [
+    c_int32, POINTER(c_double), c_int, POINTER(c_double), c_int,
+    POINTER(c_double), c_int, POINTER(c_double)]
+_dll.openmc_cylindrical_mesh_set_grid.restype = c_int
+_dll.openmc_cylindrical_mesh_set_grid.errcheck = _error_handler
+_dll.openmc_extend_meshes.argtypes = [
+    c_int32, POINTER(c_int32), POINTER(c_int32)]
 _dll.openmc_extend_meshes.restype = c_int
 _dll.openmc_extend_meshes.errcheck = _error_handler
 _dll.openmc_mesh_get_id.argtypes = [c_int32, POINTER(c_int32)]
@@ -28,6 +41,9 @@ _dll.openmc_mesh_get_params.argtypes = [
     POINTER(POINTER(c_double)), POINTER(c_int)]
 _dll.openmc_mesh_get_params.restype = c_int
 _dll.openmc_mesh_get_params.errcheck = _error_handler
+_dll.openmc_mesh_get_type.argtypes = [c_int32, c_char_p]
+_dll.openmc_mesh_get_type.restype = c_int
+_dll.openmc_mesh_get_type.errcheck = _error_handler
 _dll.openmc_mesh_set_id.argtypes = [c_int32, c_int32]
 _dll.openmc_mesh_set_id.restype = c_int
 _dll.openmc_mesh_set_id.errcheck = _error_handler
@@ -38,15 +54,29 @@ _dll.openmc_mesh_set_params.argtypes = [
     c_int32, c_int, POINTER(c_double), POINTER(c_double), POINTER(c_double)]
 _dll.openmc_mesh_set_params.restype = c_int
 _dll.openmc_mesh_set_params.errcheck = _error_handler
+_dll.openmc_mesh_set_type.argtypes = [c_int32, c_char_p]
+_dll.openmc_mesh_set_type.restype = c_int
+_dll.openmc_mesh_set_type.errcheck = _error_handler
 _dll.openmc_get_mesh_index.argtypes = [c_int32, POINTER(c_int32)]
 _dll.openmc_get_mesh_index.restype = c_int
 _dll.openmc_get_mesh_index.errcheck = _error_handler
+_dll.openmc_rectilinear_mesh_get_grid.argtypes = [
+    c_int32, POINTER(POINTER(c_double)), POINTER(c_int),
+    POINTER(POINTER(c_double)), POINTER(c_int), POINTER(POINTER(c_double)),
+    POINTER(c_int)]
+_dll.openmc_rectilinear_mesh_get_grid.restype = c_int
+_dll.openmc_rectilinear_mesh_get_grid.errcheck = _error_handler
+_dll.openmc_rectilinear_mesh_set_grid.argtypes = [
+    c_int32, POINTER(c_double), c_int, POINTER(c_double), c_int,
+    POINTER(c_double), c_int]
+_dll.openmc_rectilinear_mesh_set_grid.restype = c_int
+_dll.openmc_rectilinear_mesh_set_grid.errcheck = _error_handler
 _dll.n_meshes.argtypes = []
 _dll.n_meshes.restype = c_int
 
 
 class Mesh(_FortranObjectWithID):
-    """Mesh stored internally.
+    """Regular mesh stored internally.
 
     This class exposes a mesh that is stored internally in the OpenMC
     library. To obtain a view of a mesh with a given ID, use the
@@ -61,6 +91,8 @@ class Mesh(_FortranObjectWithID):
     ----------
     id : int
         ID of the mesh
+    type : str
+        Type of the mesh
     dimension : iterable of int
         The number of mesh cells in each direction.
     lower_left : numpy.ndarray
@@ -73,6 +105,7 @@ class Mesh(_FortranObjectWithID):
         The width of mesh cells in each direction.
 
     """
+    mesh_type = 'regular'
     __instances = WeakValueDictionary()
 
     def __new__(cls, uid=None, new=True, index=None):
@@ -90,6 +123,8 @@ class Mesh(_FortranObjectWithID):
                 index = c_int32()
                 _dll.openmc_extend_meshes(1, index, None)
                 index = index.value
+                if cls.mesh_type != 'regular':
+                    _dll.openmc_mesh_set_type(index, cls.mesh_type.encode())
             else:
                 index = mapping[uid]._index
 
@@ -112,6 +147,12 @@ class Mesh(_FortranObjectWithID):
     def id(self, mesh_id):
         _dll.openmc_mesh_set_id(self._index, mesh_id)
 
+    @property
+    def type(self):
+        mesh_type = create_string_buffer(20)
+        _dll.openmc_mesh_get_type(self._index, mesh_type)
+        return mesh_type.value.decode()
+
     @property
     def dimension(self):
         dims = POINTER(c_int)()
@@ -162,6 +203,136 @@ class Mesh(_FortranObjectWithID):
         _dll.openmc_mesh_set_params(self._index, n, lower_left, upper_right, width)
 
 
+class RectilinearMesh(Mesh):
+    """Rectilinear mesh stored internally.
+
+    Parameters
+    ----------
+    index : int
+         Index in the `meshes` array.
+
+    Attributes
+    ----------
+    id : int
+        ID of the mesh
+    type : str
+        Type of the mesh
+    dimension : iterable of int
+        The number of mesh cells in each direction.
+    x_grid : numpy.ndarray
+        Positions of the mesh surfaces along the x-axis
+    y_grid : numpy.ndarray
+        Positions of the mesh surfaces along the y-axis
+    z_grid : numpy.ndarray
+        Positions of the mesh surfaces along the z-axis
+
+    """
+    mesh_type = 'rectilinear'
+
+    @property
+    def x_grid(self):
+        return self._get_grid()[0]
+
+    @property
+    def y_grid(self):
+        return self._get_grid()[1]
+
+    @property
+    def z_grid(self):
+        return self._get_grid()[2]
+
+    def _get_grid(self):
+        grids = [POINTER(c_double)() for _ in range(3)]
+        sizes = [c_int() for _ in range(3)]
+        _dll.openmc_rectilinear_mesh_get_grid(
+            self._index, grids[0], sizes[0], grids[1], sizes[1], grids[2],
+            sizes[2])
+        return tuple(as_array(g, (n.value,)) for g, n in zip(grids, sizes))
+
+    def set_grid(self, x_grid, y_grid, z_grid):
+        grids = [(c_double*len(g))(*g) for g in (x_grid, y_grid, z_grid)]
+        _dll.openmc_rectilinear_mesh_set_grid(
+            self._index, grids[0], len(x_grid), grids[1], len(y_grid),
+            grids[2], len(z_grid))
+
+
+class CylindricalMesh(Mesh):
+    """Cylindrical mesh stored internally.
+
+    Parameters
+    ----------
+    index : int
+         Index in the `meshes` array.
+
+    Attributes
+    ----------
+    id : int
+        ID of the mesh
+    type : str
+        Type of the mesh
+    dimension : iterable of int
+        The number of mesh cells in each direction.
+    r_grid : numpy.ndarray
+        Radii of the mesh surfaces
+    phi_grid : numpy.ndarray
+        Azimuthal angles in radians of the mesh surfaces
+    z_grid : numpy.ndarray
+        Positions of the mesh surfaces along the z-axis
+    origin : numpy.ndarray
+        Position of the axis of the mesh at z = 0
+
+    """
+    mesh_type = 'cylindrical'
+
+    @property
+    def r_grid(self):
+        return self._get_grid()[0]
+
+    @property
+    def phi_grid(self):
+        return self._get_grid()[1]
+
+    @property
+    def z_grid(self):
+        return self._get_grid()[2]
+
+    @property
+    def origin(self):
+        return self._get_grid()[3]
+
+    def _get_grid(self):
+        grids = [POINTER(c_double)() for _ in range(3)]
+        sizes = [c_int() for _ in range(3)]
+        origin = (c_double*3)()
+        _dll.openmc_cylindrical_mesh_get_grid(
+            self._index, grids[0], sizes[0], grids[1], sizes[1], grids[2],
+            sizes[2], origin)
+        return tuple(as_array(g, (n.value,)) for g, n in zip(grids, sizes)) + \
+            (np.array(origin),)
+
+    def set_grid(self, r_grid, phi_grid, z_grid, origin=None):
+        grids = [(c_double*len(g))(*g) for g in (r_grid, phi_grid, z_grid)]
+        if origin is not None:
+            origin = (c_double*3)(*origin)
+        _dll.openmc_cylindrical_mesh_set_grid(
+            self._index, grids[0], len(r_grid), grids[1], len(phi_grid),
+            grids[2], len(z_grid), origin)
+
+
+_MESH_TYPE_MAP = {
+    'regular': Mesh,
+    'rectilinear': RectilinearMesh,
+    'cylindrical': CylindricalMesh
+}
+
+
+def _get_mesh(index):
+    mesh_type = create_string_buffer(20)
+    _dll.openmc_mesh_get_type(index, mesh_type)
+    mesh_type = mesh_type.value.decode()
+    return _MESH_TYPE_MAP[mesh_type](index=index)
+
+
 class _MeshMapping(Mapping):
     def __getitem__(self, key):
         index = c_int32()
@@ -170,11 +341,11 @@ class _MeshMapping(Mapping):
         except (AllocationError, InvalidIDError) as e:
             # __contains__ expects a KeyError to work correctly
             raise KeyError(str(e))
-        return Mesh(index=index.value)
+        return _get_mesh(index.value)
 
     def __iter__(self):
         for i in range(len(self)):
-            yield Mesh(index=i).id
+            yield _get_mesh(i).id
 
     def __len__(self):
         return _dll.n_meshes()
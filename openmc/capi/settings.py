@@ -9,7 +9,8 @@ _RUN_MODES = {1: 'fixed source',
               2: 'eigenvalue',
               3: 'plot',
               4: 'particle restart',
-              5: 'volume'}
+              5: 'volume',
+              6: 'overlap check'}
 
 _dll.openmc_set_seed.argtypes = [c_int64]
 _dll.openmc_get_seed.restype = c_int64
@@ -152,6 +152,50 @@ def calculate_volumes(threads=None, output=True, cwd='.',
     _run(args, output, cwd)
 
 
+def check_overlaps(threads=None, output=True, cwd='.', openmc_exec='openmc',
+                   mpi_args=None):
+    """Run OpenMC in overlap checking mode.
+
+    This function samples points throughout the geometry, both at random and
+    on a structured grid that is refined near surfaces, and tests every cell on
+    every level of the geometry at each point. Pairs of overlapping cells are
+    reported and written to an 'overlaps.h5' file. The sampling can be
+    controlled through :attr:`openmc.Settings.overlap_check`.
+
+    Parameters
+    ----------
+    threads : int, optional
+        Number of OpenMP threads. If OpenMC is compiled with OpenMP threading
+        enabled, the default is implementation-dependent but is usually equal to
+        the number of hardware threads available (or a value set by the
+        :envvar:`OMP_NUM_THREADS` environment variable).
+    output : bool, optional
+        Capture OpenMC output from standard out
+    cwd : str, optional
+        Path to working directory to run in. Defaults to the current working
+        directory.
+    openmc_exec : str, optional
+        Path to OpenMC executable. Defaults to 'openmc'.
+    mpi_args : list of str, optional
+        MPI execute command and any additional MPI arguments to pass,
+        e.g. ['mpiexec', '-n', '8'].
+
+    Raises
+    ------
+    subprocess.CalledProcessError
+        If the `openmc` executable returns a non-zero status
+
+    """
+    args = [openmc_exec, '--overlaps']
+
+    if isinstance(threads, Integral) and threads > 0:
+        args += ['-s', str(threads)]
+    if mpi_args is not None:
+        args = mpi_args + args
+
+    _run(args, output, cwd)
+
+
 def run(particles=None, threads=None, geometry_debug=False,
         restart_file=None, tracks=False, output=True, cwd='.',
         openmc_exec='openmc', mpi_args=None):
@@ -32,6 +32,12 @@ _CURRENT_NAMES = (
     'z-min out', 'z-min in', 'z-max out', 'z-max in'
 )
 
+_CYLINDRICAL_CURRENT_NAMES = (
+    'r-min out', 'r-min in', 'r-max out', 'r-max in',
+    'phi-min out', 'phi-min in', 'phi-max out', 'phi-max in',
+    'z-min out', 'z-min in', 'z-max out', 'z-max in'
+)
+
 _PARTICLE_IDS = {'neutron': 1, 'photon': 2, 'electron': 3, 'positron': 4}
 
 class FilterMeta(ABCMeta):
@@ -583,7 +589,7 @@ class ParticleFilter(Filter):
 
 
 class MeshFilter(Filter):
-    """Bins tally event locations onto a regular, rectangular mesh.
+    """Bins tally event locations onto a structured mesh.
 
     Parameters
     ----------
@@ -635,6 +641,17 @@ class MeshFilter(Filter):
 
         return out
 
+    def __eq__(self, other):
+        # Filters on different meshes with the same shape have the same bins
+        if type(self) is not type(other):
+            return False
+        return self.mesh.id == other.mesh.id
+
+    def __hash__(self):
+        string = type(self).__name__ + '\n'
+        string += '{: <16}=\t{}\n'.format('\tMesh ID', self.mesh.id)
+        return hash(string)
+
     @property
     def mesh(self):
         return self._mesh
@@ -741,7 +758,7 @@ class MeshFilter(Filter):
 
 
 class MeshSurfaceFilter(MeshFilter):
-    """Filter events by surface crossings on a regular, rectangular mesh.
+    """Filter events by surface crossings on a structured mesh.
 
     Parameters
     ----------
@@ -775,8 +792,12 @@ class MeshSurfaceFilter(MeshFilter):
 
         # Take the product of mesh indices and current names
         n_dim = len(mesh.dimension)
+        if mesh.type == 'cylindrical':
+            names = _CYLINDRICAL_CURRENT_NAMES
+        else:
+            names = _CURRENT_NAMES
         self.bins = [mesh_tuple + (surf,) for mesh_tuple, surf in
-                     product(mesh.indices, _CURRENT_NAMES[:4*n_dim])]
+                     product(mesh.indices, names[:4*n_dim])]
 
     def get_pandas_dataframe(self, data_size, stride, **kwargs):
         """Builds a Pandas DataFrame for the Filter's bins.
@@ -854,7 +875,11 @@ class MeshSurfaceFilter(MeshFilter):
 
         # Generate multi-index sub-column for surface
         repeat_factor = stride
-        filter_bins = np.repeat(_CURRENT_NAMES[:n_surfs], repeat_factor)
+        if self.mesh.type == 'cylindrical':
+            names = _CYLINDRICAL_CURRENT_NAMES
+        else:
+            names = _CURRENT_NAMES
+        filter_bins = np.repeat(names[:n_surfs], repeat_factor)
         tile_factor = data_size // len(filter_bins)
         filter_bins = np.tile(filter_bins, tile_factor)
         filter_dict[(mesh_key, 'surf')] = filter_bins
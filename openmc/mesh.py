@@ -7,11 +7,19 @@ import numpy as np
 
 import openmc.checkvalue as cv
 import openmc
+from openmc._xml import get_text
 from openmc.mixin import EqualityMixin, IDManagerMixin
 
 
 class Mesh(IDManagerMixin):
-    """A structured Cartesian mesh in one, two, or three dimensions
+    """A structured mesh in one, two, or three dimensions
+
+    A regular mesh is a Cartesian mesh of identical elements defined by its
+    dimension and corners. A rectilinear mesh is a three-dimensional Cartesian
+    mesh with arbitrary mesh surfaces given by :attr:`x_grid`, :attr:`y_grid`,
+    and :attr:`z_grid`. A cylindrical mesh is a three-dimensional mesh in
+    (r, phi, z) coordinates given by :attr:`r_grid`, :attr:`phi_grid`, and
+    :attr:`z_grid`.
 
     Parameters
     ----------
@@ -26,10 +34,11 @@ class Mesh(IDManagerMixin):
         Unique identifier for the mesh
     name : str
         Name of the mesh
-    type : str
+    type : {'regular', 'rectilinear', 'cylindrical'}
         Type of the mesh
     dimension : Iterable of int
-        The number of mesh cells in each direction.
+        The number of mesh cells in each direction. For rectilinear and
+        cylindrical meshes, this is determined by the mesh surfaces.
     lower_left : Iterable of float
         The lower-left corner of the structured mesh. If only two coordinate are
         given, it is assumed that the mesh is an x-y mesh.
@@ -38,6 +47,20 @@ class Mesh(IDManagerMixin):
         are given, it is assumed that the mesh is an x-y mesh.
     width : Iterable of float
         The width of mesh cells in each direction.
+    x_grid : Iterable of float
+        Positions of the mesh surfaces along the x-axis of a rectilinear mesh
+    y_grid : Iterable of float
+        Positions of the mesh surfaces along the y-axis of a rectilinear mesh
+    z_grid : Iterable of float
+        Positions of the mesh surfaces along the z-axis of a rectilinear or
+        cylindrical mesh
+    r_grid : Iterable of float
+        Radii of the mesh surfaces of a cylindrical mesh
+    phi_grid : Iterable of float
+        Azimuthal angles in radians of the mesh surfaces of a cylindrical mesh.
+        If not given, the mesh covers every angle with a single element.
+    origin : Iterable of float
+        Position of the axis of a cylindrical mesh at z = 0
     indices : list of tuple
         A list of mesh indices for each mesh element, e.g. [(1, 1, 1), (2, 1,
         1), ...]
@@ -56,6 +79,12 @@ class Mesh(IDManagerMixin):
         self._lower_left = None
         self._upper_right = None
         self._width = None
+        self._x_grid = None
+        self._y_grid = None
+        self._z_grid = None
+        self._r_grid = None
+        self._phi_grid = None
+        self._origin = None
 
     @property
     def name(self):
@@ -67,6 +96,12 @@ class Mesh(IDManagerMixin):
 
     @property
     def dimension(self):
+        if self._type == 'rectilinear':
+            return tuple(len(g) - 1 for g in
+                         (self._x_grid, self._y_grid, self._z_grid))
+        elif self._type == 'cylindrical':
+            n_phi = 1 if self._phi_grid is None else len(self._phi_grid) - 1
+            return (len(self._r_grid) - 1, n_phi, len(self._z_grid) - 1)
         return self._dimension
 
     @property
@@ -81,13 +116,37 @@ class Mesh(IDManagerMixin):
     def width(self):
         return self._width
 
+    @property
+    def x_grid(self):
+        return self._x_grid
+
+    @property
+    def y_grid(self):
+        return self._y_grid
+
+    @property
+    def z_grid(self):
+        return self._z_grid
+
+    @property
+    def r_grid(self):
+        return self._r_grid
+
+    @property
+    def phi_grid(self):
+        return self._phi_grid
+
+    @property
+    def origin(self):
+        return self._origin
+
     @property
     def num_mesh_cells(self):
-        return np.prod(self._dimension)
+        return np.prod(self.dimension)
 
     @property
     def indices(self):
-        ndim = len(self._dimension)
+        ndim = len(self.dimension)
         if ndim == 3:
             nx, ny, nz = self.dimension
             return ((x, y, z)
@@ -117,7 +176,7 @@ class Mesh(IDManagerMixin):
         cv.check_type('type for mesh ID="{0}"'.format(self._id),
                       meshtype, str)
         cv.check_value('type for mesh ID="{0}"'.format(self._id),
-                       meshtype, ['regular'])
+                       meshtype, ['regular', 'rectilinear', 'cylindrical'])
         self._type = meshtype
 
     @dimension.setter
@@ -144,11 +203,58 @@ class Mesh(IDManagerMixin):
         cv.check_length('mesh width', width, 1, 3)
         self._width = width
 
+    @x_grid.setter
+    def x_grid(self, grid):
+        cv.check_type('mesh x_grid', grid, Iterable, Real)
+        cv.check_length('mesh x_grid', grid, 2, sys.maxsize)
+        self._x_grid = grid
+
+    @y_grid.setter
+    def y_grid(self, grid):
+        cv.check_type('mesh y_grid', grid, Iterable, Real)
+        cv.check_length('mesh y_grid', grid, 2, sys.maxsize)
+        self._y_grid = grid
+
+    @z_grid.setter
+    def z_grid(self, grid):
+        cv.check_type('mesh z_grid', grid, Iterable, Real)
+        cv.check_length('mesh z_grid', grid, 2, sys.maxsize)
+        self._z_grid = grid
+
+    @r_grid.setter
+    def r_grid(self, grid):
+        cv.check_type('mesh r_grid', grid, Iterable, Real)
+        cv.check_length('mesh r_grid', grid, 2, sys.maxsize)
+        self._r_grid = grid
+
+    @phi_grid.setter
+    def phi_grid(self, grid):
+        cv.check_type('mesh phi_grid', grid, Iterable, Real)
+        cv.check_length('mesh phi_grid', grid, 2, sys.maxsize)
+        self._phi_grid = grid
+
+    @origin.setter
+    def origin(self, origin):
+        cv.check_type('mesh origin', origin, Iterable, Real)
+        cv.check_length('mesh origin', origin, 3, 3)
+        self._origin = origin
+
     def __repr__(self):
         string = 'Mesh\n'
         string += '{0: <16}{1}{2}\n'.format('\tID', '=\t', self._id)
         string += '{0: <16}{1}{2}\n'.format('\tName', '=\t', self._name)
         string += '{0: <16}{1}{2}\n'.format('\tType', '=\t', self._type)
+        if self._type == 'rectilinear':
+            string += '{0: <16}{1}{2}\n'.format('\tX grid', '=\t', self._x_grid)
+            string += '{0: <16}{1}{2}\n'.format('\tY grid', '=\t', self._y_grid)
+            string += '{0: <16}{1}{2}\n'.format('\tZ grid', '=\t', self._z_grid)
+            return string
+        elif self._type == 'cylindrical':
+            string += '{0: <16}{1}{2}\n'.format('\tR grid', '=\t', self._r_grid)
+            string += '{0: <16}{1}{2}\n'.format('\tPhi grid', '=\t', self._phi_grid)
+            string += '{0: <16}{1}{2}\n'.format('\tZ grid', '=\t', self._z_grid)
+            string += '{0: <16}{1}{2}\n'.format('\tOrigin', '=\t', self._origin)
+            return string
         string += '{0: <16}{1}{2}\n'.format('\tBasis', '=\t', self._dimension)
         string += '{0: <16}{1}{2}\n'.format('\tWidth', '=\t', self._lower_left)
         string += '{0: <16}{1}{2}\n'.format('\tOrigin', '=\t', self._upper_right)
@@ -175,10 +281,20 @@ class Mesh(IDManagerMixin):
         # Read and assign mesh properties
         mesh = cls(mesh_id)
         mesh.type = group['type'].value.decode()
-        mesh.dimension = group['dimension'].value
-        mesh.lower_left = group['lower_left'].value
-        mesh.upper_right = group['upper_right'].value
-        mesh.width = group['width'].value
+        if mesh.type == 'rectilinear':
+            mesh.x_grid = group['x_grid'].value
+            mesh.y_grid = group['y_grid'].value
+            mesh.z_grid = group['z_grid'].value
+        elif mesh.type == 'cylindrical':
+            mesh.r_grid = group['r_grid'].value
+            mesh.phi_grid = group['phi_grid'].value
+            mesh.z_grid = group['z_grid'].value
+            mesh.origin = group['origin'].value
+        else:
+            mesh.dimension = group['dimension'].value
+            mesh.lower_left = group['lower_left'].value
+            mesh.upper_right = group['upper_right'].value
+            mesh.width = group['width'].value
 
         return mesh
 
@@ -216,6 +332,46 @@ class Mesh(IDManagerMixin):
 
         return mesh
 
+    @classmethod
+    def from_xml_element(cls, elem):
+        """Generate mesh from an XML element
+
+        Parameters
+        ----------
+        elem : xml.etree.ElementTree.Element
+            XML element
+
+        Returns
+        -------
+        openmc.Mesh
+            Mesh generated from XML element
+
+        """
+        mesh_id = int(get_text(elem, 'id'))
+        mesh = cls(mesh_id)
+        mesh.type = get_text(elem, 'type', 'regular')
+
+        def values(name, dtype=float):
+            text = get_text(elem, name)
+            if text is not None:
+                return [dtype(x) for x in text.split()]
+
+        if mesh.type == 'rectilinear':
+            names = ('x_grid', 'y_grid', 'z_grid')
+        elif mesh.type == 'cylindrical':
+            names = ('r_grid', 'phi_grid', 'z_grid', 'origin')
+        else:
+            mesh.dimension = values('dimension', int)
+            names = ('lower_left', 'upper_right', 'width')
+
+        # Optional parameters that are not given keep their default value
+        for name in names:
+            value = values(name)
+            if value is not None:
+                setattr(mesh, name, value)
+
+        return mesh
+
     def to_xml_element(self):
         """Return XML representation of the mesh
 
@@ -230,6 +386,18 @@ class Mesh(IDManagerMixin):
         element.set("id", str(self._id))
         element.set("type", self._type)
 
+        if self._type == 'rectilinear':
+            for name in ('x_grid', 'y_grid', 'z_grid'):
+                subelement = ET.SubElement(element, name)
+                subelement.text = ' '.join(map(str, getattr(self, name)))
+            return element
+        elif self._type == 'cylindrical':
+            for name in ('r_grid', 'phi_grid', 'z_grid', 'origin'):
+                if getattr(self, name) is not None:
+                    subelement = ET.SubElement(element, name)
+                    subelement.text = ' '.join(map(str, getattr(self, name)))
+            return element
+
         subelement = ET.SubElement(element, "dimension")
         subelement.text = ' '.join(map(str, self._dimension))
 
@@ -274,6 +442,7 @@ class Mesh(IDManagerMixin):
 
         """
 
+        cv.check_value('mesh type', self._type, ['regular'])
         cv.check_length('bc', bc, length_min=4, length_max=6)
         for entry in bc:
             cv.check_value('bc', entry, ['transmission', 'vacuum',
@@ -10,7 +10,8 @@ from openmc._xml import clean_indentation
 import openmc.checkvalue as cv
 from openmc import VolumeCalculation, Source, Mesh
 
-_RUN_MODES = ['eigenvalue', 'fixed source', 'plot', 'volume', 'particle restart']
+_RUN_MODES = ['eigenvalue', 'fixed source', 'plot', 'volume', 'overlap check',
+              'particle restart']
 _RES_SCAT_METHODS = ['dbrc', 'rvs']
 
 
@@ -21,6 +22,9 @@ class Settings(object):
     ----------
     batches : int
         Number of batches to simulate
+    compton_tables : bool
+        Whether to sample the angular distribution for incoherent scattering of
+        photons from tabulated data rather than by rejection sampling.
     confidence_intervals : bool
         If True, uncertainties on tally results will be reported as the
         half-width of the 95% two-sided confidence interval. If False,
@@ -39,6 +43,9 @@ class Settings(object):
         below which particle type will be killed.
     dagmc : bool
         Indicate that a CAD-based DAGMC geometry will be used.
+    distance_cache : bool
+        Whether to reuse distances to cell boundaries on higher coordinate
+        levels while a particle travels in a straight line
     electron_treatment : {'led', 'ttb'}
         Whether to deposit all energy from electrons locally ('led') or create
         secondary bremsstrahlung photons ('ttb').
@@ -48,6 +55,9 @@ class Settings(object):
         Mesh to be used to calculate Shannon entropy. If the mesh dimensions are
         not specified. OpenMC assigns a mesh such that 20 source sites per mesh
         cell are to be expected on average.
+    flatten_geometry : bool
+        Whether to enumerate all universe placements after loading the geometry
+        so that distributed cell instances can be looked up directly
     generations_per_batch : int
         Number of generations per batch
     inactive : int
@@ -62,6 +72,8 @@ class Settings(object):
         Number of bins for logarithmic energy grid search
     max_order : None or int
         Maximum scattering order to apply globally when in multi-group mode.
+    neighbor_sweep : int
+        Number of rays traced before transport to populate neighbor lists
     no_reduce : bool
         Indicate that all user-defined and global tallies should not be reduced
         across processes in a parallel calculation.
@@ -72,6 +84,18 @@ class Settings(object):
                written
         :summary: Whether the 'summary.h5' file should be written (bool)
         :tallies: Whether the 'tallies.out' file should be written (bool)
+    overlap_check : dict
+        Options for the overlap check run mode. Acceptable keys are:
+
+        :samples: Number of points sampled at random (int)
+        :dimension: Number of voxels along each axis of the structured grid
+                    whose voxels are refined near surfaces (iterable of int)
+        :refinement: Number of points along each axis tested within each
+                     refined voxel (int)
+        :lower_left: Lower-left coordinates of the bounding box (iterable of
+                     float)
+        :upper_right: Upper-right coordinates of the bounding box (iterable of
+                      float)
     particles : int
         Number of particles per generation
     photon_transport : bool
@@ -89,7 +113,7 @@ class Settings(object):
         applied. The 'nuclides' list indicates what nuclides the method should
         be applied to. In its absence, the method will be applied to all
         nuclides with 0 K elastic scattering data present.
-    run_mode : {'eigenvalue', 'fixed source', 'plot', 'volume', 'particle restart'}
+    run_mode : {'eigenvalue', 'fixed source', 'plot', 'volume', 'overlap check', 'particle restart'}
         The type of calculation to perform (default is 'eigenvalue')
     seed : int
         Seed for the linear congruential pseudorandom number generator
@@ -109,6 +133,16 @@ class Settings(object):
         :batches: list of batches at which to write source
     survival_biasing : bool
         Indicate whether survival biasing is to be used
+    tally_buffers : dict
+        Options for adding tally scores to private buffers on each thread
+        rather than atomically to the shared results. Accepted keys are
+        'enable' and 'max_memory'. The value for 'enable' is a bool stating
+        whether scores are buffered; the value for 'max_memory' is the memory
+        in MB that the buffers on each thread may use.
+    tally_dispatch : bool
+        Indicate whether tallies are indexed by the cells and materials of
+        their first cell or material filter, so that tallies that cannot score
+        are skipped at each tally event
     tabular_legendre : dict
         Determines if a multi-group scattering moment kernel expanded via
         Legendre polynomials is to be converted to a tabular distribution or
@@ -174,6 +208,7 @@ class Settings(object):
         # Source subelement
         self._source = cv.CheckedList(Source, 'source distributions')
 
+        self._compton_tables = None
         self._confidence_intervals = None
         self._cross_sections = None
         self._electron_treatment = None
@@ -191,6 +226,7 @@ class Settings(object):
         self._trigger_batch_interval = None
 
         self._output = None
+        self._overlap_check = {}
 
         # Output options
         self._statepoint = {}
@@ -205,6 +241,8 @@ class Settings(object):
         self._track = None
 
         self._tabular_legendre = {}
+        self._tally_buffers = {}
+        self._tally_dispatch = None
 
         self._temperature = {}
 
@@ -220,6 +258,9 @@ class Settings(object):
 
         self._create_fission_neutrons = None
         self._log_grid_bins = None
+        self._neighbor_sweep = None
+        self._distance_cache = None
+        self._flatten_geometry = None
 
         self._dagmc = False
 
@@ -259,6 +300,10 @@ class Settings(object):
     def source(self):
         return self._source
 
+    @property
+    def compton_tables(self):
+        return self._compton_tables
+
     @property
     def confidence_intervals(self):
         return self._confidence_intervals
@@ -283,6 +328,14 @@ class Settings(object):
     def survival_biasing(self):
         return self._survival_biasing
 
+    @property
+    def tally_buffers(self):
+        return self._tally_buffers
+
+    @property
+    def tally_dispatch(self):
+        return self._tally_dispatch
+
     @property
     def entropy_mesh(self):
         return self._entropy_mesh
@@ -303,6 +356,10 @@ class Settings(object):
     def output(self):
         return self._output
 
+    @property
+    def overlap_check(self):
+        return self._overlap_check
+
     @property
     def sourcepoint(self):
         return self._sourcepoint
@@ -363,6 +420,18 @@ class Settings(object):
     def log_grid_bins(self):
         return self._log_grid_bins
 
+    @property
+    def neighbor_sweep(self):
+        return self._neighbor_sweep
+
+    @property
+    def distance_cache(self):
+        return self._distance_cache
+
+    @property
+    def flatten_geometry(self):
+        return self._flatten_geometry
+
     @property
     def dagmc(self):
         return self._dagmc
@@ -456,6 +525,29 @@ class Settings(object):
                 cv.check_type("output['path']", value, str)
         self._output = output
 
+    @overlap_check.setter
+    def overlap_check(self, overlap_check):
+        cv.check_type('overlap check', overlap_check, Mapping)
+        for key, value in overlap_check.items():
+            cv.check_value('overlap check key', key, ('samples', 'dimension',
+                           'refinement', 'lower_left', 'upper_right'))
+            name = "overlap_check['{}']".format(key)
+            if key == 'samples':
+                cv.check_type(name, value, Integral)
+                cv.check_greater_than(name, value, 0, True)
+            elif key == 'refinement':
+                cv.check_type(name, value, Integral)
+                cv.check_greater_than(name, value, 0)
+            elif key == 'dimension':
+                cv.check_type(name, value, Iterable, Integral)
+                cv.check_length(name, value, 3)
+                for x in value:
+                    cv.check_greater_than(name, x, 0, True)
+            else:
+                cv.check_type(name, value, Iterable, Real)
+                cv.check_length(name, value, 3)
+        self._overlap_check = overlap_check
+
     @verbosity.setter
     def verbosity(self, verbosity):
         cv.check_type('verbosity', verbosity, Integral)
@@ -495,6 +587,11 @@ class Settings(object):
                                  "statepoint options.".format(key))
         self._statepoint = statepoint
 
+    @compton_tables.setter
+    def compton_tables(self, compton_tables):
+        cv.check_type('Compton tables', compton_tables, bool)
+        self._compton_tables = compton_tables
+
     @confidence_intervals.setter
     def confidence_intervals(self, confidence_intervals):
         cv.check_type('confidence interval', confidence_intervals, bool)
@@ -531,6 +628,24 @@ class Settings(object):
         cv.check_type('survival biasing', survival_biasing, bool)
         self._survival_biasing = survival_biasing
 
+    @tally_buffers.setter
+    def tally_buffers(self, tally_buffers):
+        cv.check_type('tally_buffers settings', tally_buffers, Mapping)
+        for key, value in tally_buffers.items():
+            cv.check_value('tally_buffers key', key, ['enable', 'max_memory'])
+            if key == 'enable':
+                cv.check_type('enable tally_buffers', value, bool)
+            elif key == 'max_memory':
+                cv.check_type('max_memory tally_buffers', value, Real)
+                cv.check_greater_than('max_memory tally_buffers', value, 0.0,
+                                      True)
+        self._tally_buffers = tally_buffers
+
+    @tally_dispatch.setter
+    def tally_dispatch(self, tally_dispatch):
+        cv.check_type('tally dispatch', tally_dispatch, bool)
+        self._tally_dispatch = tally_dispatch
+
     @cutoff.setter
     def cutoff(self, cutoff):
         if not isinstance(cutoff, Mapping):
@@ -559,8 +674,11 @@ class Settings(object):
     def entropy_mesh(self, entropy):
         cv.check_type('entropy mesh', entropy, Mesh)
         cv.check_length('entropy mesh dimension', entropy.dimension, 3)
-        cv.check_length('entropy mesh lower-left corner', entropy.lower_left, 3)
-        cv.check_length('entropy mesh upper-right corner', entropy.upper_right, 3)
+        if entropy.type == 'regular':
+            cv.check_length('entropy mesh lower-left corner',
+                            entropy.lower_left, 3)
+            cv.check_length('entropy mesh upper-right corner',
+                            entropy.upper_right, 3)
         self._entropy_mesh = entropy
 
     @trigger_active.setter
@@ -654,8 +772,11 @@ class Settings(object):
     def ufs_mesh(self, ufs_mesh):
         cv.check_type('UFS mesh', ufs_mesh, Mesh)
         cv.check_length('UFS mesh dimension', ufs_mesh.dimension, 3)
-        cv.check_length('UFS mesh lower-left corner', ufs_mesh.lower_left, 3)
-        cv.check_length('UFS mesh upper-right corner', ufs_mesh.upper_right, 3)
+        if ufs_mesh.type == 'regular':
+            cv.check_length('UFS mesh lower-left corner',
+                            ufs_mesh.lower_left, 3)
+            cv.check_length('UFS mesh upper-right corner',
+                            ufs_mesh.upper_right, 3)
         self._ufs_mesh = ufs_mesh
 
     @resonance_scattering.setter
@@ -701,6 +822,22 @@ class Settings(object):
         cv.check_greater_than('log grid bins', log_grid_bins, 0)
         self._log_grid_bins = log_grid_bins
 
+    @neighbor_sweep.setter
+    def neighbor_sweep(self, neighbor_sweep):
+        cv.check_type('neighbor sweep rays', neighbor_sweep, Integral)
+        cv.check_greater_than('neighbor sweep rays', neighbor_sweep, 0, True)
+        self._neighbor_sweep = neighbor_sweep
+
+    @distance_cache.setter
+    def distance_cache(self, distance_cache):
+        cv.check_type('distance cache', distance_cache, bool)
+        self._distance_cache = distance_cache
+
+    @flatten_geometry.setter
+    def flatten_geometry(self, flatten_geometry):
+        cv.check_type('flatten geometry', flatten_geometry, bool)
+        self._flatten_geometry = flatten_geometry
+
     def _create_run_mode_subelement(self, root):
         elem = ET.SubElement(root, "run_mode")
         elem.text = self._run_mode
@@ -762,6 +899,16 @@ class Settings(object):
                 else:
                     subelement.text = value
 
+    def _create_overlap_check_subelement(self, root):
+        if self._overlap_check:
+            element = ET.SubElement(root, "overlap_check")
+            for key, value in self._overlap_check.items():
+                subelement = ET.SubElement(element, key)
+                if key in ('samples', 'refinement'):
+                    subelement.text = str(value)
+                else:
+                    subelement.text = ' '.join(str(x) for x in value)
+
     def _create_verbosity_subelement(self, root):
         if self._verbosity is not None:
             element = ET.SubElement(root, "verbosity")
@@ -797,6 +944,11 @@ class Settings(object):
                 subelement = ET.SubElement(element, "overwrite_latest")
                 subelement.text = str(self._sourcepoint['overwrite']).lower()
 
+    def _create_compton_tables_subelement(self, root):
+        if self._compton_tables is not None:
+            element = ET.SubElement(root, "compton_tables")
+            element.text = str(self._compton_tables).lower()
+
     def _create_confidence_intervals(self, root):
         if self._confidence_intervals is not None:
             element = ET.SubElement(root, "confidence_intervals")
@@ -827,6 +979,19 @@ class Settings(object):
             element = ET.SubElement(root, "survival_biasing")
             element.text = str(self._survival_biasing).lower()
 
+    def _create_tally_buffers_subelement(self, root):
+        if self.tally_buffers:
+            element = ET.SubElement(root, "tally_buffers")
+            for key in ('enable', 'max_memory'):
+                if key in self._tally_buffers:
+                    subelement = ET.SubElement(element, key)
+                    subelement.text = str(self._tally_buffers[key]).lower()
+
+    def _create_tally_dispatch_subelement(self, root):
+        if self._tally_dispatch is not None:
+            element = ET.SubElement(root, "tally_dispatch")
+            element.text = str(self._tally_dispatch).lower()
+
     def _create_cutoff_subelement(self, root):
         if self._cutoff is not None:
             element = ET.SubElement(root, "cutoff")
@@ -939,6 +1104,21 @@ class Settings(object):
             elem = ET.SubElement(root, "log_grid_bins")
             elem.text = str(self._log_grid_bins)
 
+    def _create_neighbor_sweep_subelement(self, root):
+        if self._neighbor_sweep is not None:
+            elem = ET.SubElement(root, "neighbor_sweep")
+            elem.text = str(self._neighbor_sweep)
+
+    def _create_distance_cache_subelement(self, root):
+        if self._distance_cache is not None:
+            elem = ET.SubElement(root, "distance_cache")
+            elem.text = str(self._distance_cache).lower()
+
+    def _create_flatten_geometry_subelement(self, root):
+        if self._flatten_geometry is not None:
+            elem = ET.SubElement(root, "flatten_geometry")
+            elem.text = str(self._flatten_geometry).lower()
+
     def _create_dagmc_subelement(self, root):
         if self._dagmc:
             elem = ET.SubElement(root, "dagmc")
@@ -968,6 +1148,7 @@ class Settings(object):
         self._create_statepoint_subelement(root_element)
         self._create_sourcepoint_subelement(root_element)
         self._create_confidence_intervals(root_element)
+        self._create_compton_tables_subelement(root_element)
         self._create_electron_treatment_subelement(root_element)
         self._create_energy_mode_subelement(root_element)
         self._create_max_order_subelement(root_element)
@@ -975,6 +1156,8 @@ class Settings(object):
         self._create_ptables_subelement(root_element)
         self._create_seed_subelement(root_element)
         self._create_survival_biasing_subelement(root_element)
+        self._create_tally_buffers_subelement(root_element)
+        self._create_tally_dispatch_subelement(root_element)
         self._create_cutoff_subelement(root_element)
         self._create_entropy_mesh_subelement(root_element)
         self._create_trigger_subelement(root_element)
@@ -988,8 +1171,12 @@ class Settings(object):
         self._create_ufs_mesh_subelement(root_element)
         self._create_resonance_scattering_subelement(root_element)
         self._create_volume_calcs_subelement(root_element)
+        self._create_overlap_check_subelement(root_element)
         self._create_create_fission_neutrons_subelement(root_element)
         self._create_log_grid_bins_subelement(root_element)
+        self._create_neighbor_sweep_subelement(root_element)
+        self._create_distance_cache_subelement(root_element)
+        self._create_flatten_geometry_subelement(root_element)
         self._create_dagmc_subelement(root_element)
 
         # Clean the indentation in the file to be user-readable
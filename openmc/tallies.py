@@ -35,6 +35,9 @@ _FILTER_CLASSES = (openmc.Filter, openmc.CrossFilter, openmc.AggregateFilter)
 # Valid types of estimators
 ESTIMATOR_TYPES = ['tracklength', 'collision', 'analog']
 
+# Valid ways of storing tally results
+STORAGE_TYPES = ['dense', 'sparse']
+
 
 class Tally(IDManagerMixin):
     """A tally defined by a set of scores that are accumulated for a list of
@@ -62,6 +65,10 @@ class Tally(IDManagerMixin):
         List of defined scores, e.g. 'flux', 'fission', etc.
     estimator : {'analog', 'tracklength', 'collision'}
         Type of estimator for the tally
+    storage : {'dense', 'sparse'}
+        How OpenMC stores the results of the tally during a simulation. Sparse
+        storage only uses memory for the bins that are scored to and is meant
+        for very large tallies where most bins are never scored to.
     triggers : list of openmc.Trigger
         List of tally triggers
     num_scores : int
@@ -109,6 +116,7 @@ class Tally(IDManagerMixin):
         self._nuclides = cv.CheckedList(_NUCLIDE_CLASSES, 'tally nuclides')
         self._scores = cv.CheckedList(_SCORE_CLASSES, 'tally scores')
         self._estimator = None
+        self._storage = None
         self._triggers = cv.CheckedList(openmc.Trigger, 'tally triggers')
         self._derivative = None
 
@@ -194,6 +202,10 @@ class Tally(IDManagerMixin):
     def estimator(self):
         return self._estimator
 
+    @property
+    def storage(self):
+        return self._storage
+
     @property
     def triggers(self):
         return self._triggers
@@ -323,6 +335,11 @@ class Tally(IDManagerMixin):
         cv.check_value('estimator', estimator, ESTIMATOR_TYPES)
         self._estimator = estimator
 
+    @storage.setter
+    def storage(self, storage):
+        cv.check_value('storage', storage, STORAGE_TYPES)
+        self._storage = storage
+
     @triggers.setter
     def triggers(self, triggers):
         cv.check_type('tally triggers', triggers, MutableSequence)
@@ -882,6 +899,11 @@ class Tally(IDManagerMixin):
             subelement = ET.SubElement(element, "estimator")
             subelement.text = self.estimator
 
+        # Tally storage type
+        if self.storage is not None:
+            subelement = ET.SubElement(element, "storage")
+            subelement.text = self.storage
+
         # Optional Triggers
         for trigger in self.triggers:
             trigger.get_trigger_xml(element)
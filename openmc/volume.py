@@ -45,6 +45,19 @@ class VolumeCalculation(object):
         Lower-left coordinates of bounding box used to sample points
     upper_right : Iterable of float
         Upper-right coordinates of bounding box used to sample points
+    estimator : {'hit', 'ray'}
+        Whether volumes are estimated from the fraction of points sampled in
+        each domain or from the length of random lines within each domain
+    threshold : float or numpy.ndarray
+        Threshold on the uncertainty of every domain volume, or of each domain
+        volume in the order of :attr:`ids`, or None if no trigger is used
+    trigger_type : {'variance', 'std_dev', 'rel_err'}
+        Uncertainty checked against the threshold
+    max_iterations : int
+        Number of iterations after which the calculation stops even if the
+        trigger is not satisfied, or None for the default
+    iterations : int
+        Number of iterations of samples that were run
     atoms : dict
         Dictionary mapping unique IDs of domains to a mapping of nuclides to
         total number of atoms for each nuclide present in the domain. For
@@ -60,6 +73,11 @@ class VolumeCalculation(object):
                  upper_right=None):
         self._atoms = {}
         self._volumes = {}
+        self._estimator = 'hit'
+        self._threshold = None
+        self._trigger_type = None
+        self._max_iterations = None
+        self._iterations = None
 
         cv.check_type('domains', domains, Iterable,
                       (openmc.Cell, openmc.Material, openmc.Universe))
@@ -127,6 +145,26 @@ class VolumeCalculation(object):
     def domain_type(self):
         return self._domain_type
 
+    @property
+    def estimator(self):
+        return self._estimator
+
+    @property
+    def threshold(self):
+        return self._threshold
+
+    @property
+    def trigger_type(self):
+        return self._trigger_type
+
+    @property
+    def max_iterations(self):
+        return self._max_iterations
+
+    @property
+    def iterations(self):
+        return self._iterations
+
     @property
     def atoms(self):
         return self._atoms
@@ -170,6 +208,17 @@ class VolumeCalculation(object):
         cv.check_length(name, upper_right, 3)
         self._upper_right = upper_right
 
+    @estimator.setter
+    def estimator(self, estimator):
+        cv.check_value('estimator', estimator, ('hit', 'ray'))
+        self._estimator = estimator
+
+    @iterations.setter
+    def iterations(self, iterations):
+        cv.check_type('iterations', iterations, Integral)
+        cv.check_greater_than('iterations', iterations, 0)
+        self._iterations = iterations
+
     @volumes.setter
     def volumes(self, volumes):
         cv.check_type('volumes', volumes, Mapping)
@@ -180,6 +229,46 @@ class VolumeCalculation(object):
         cv.check_type('atoms', atoms, Mapping)
         self._atoms = atoms
 
+    def set_trigger(self, threshold, trigger_type, max_iterations=None):
+        """Set a trigger on the uncertainty of the domain volumes
+
+        Iterations of :attr:`samples` samples are run until the uncertainty of
+        every domain volume is below the threshold or the maximum number of
+        iterations is reached. With 'rel_err', domains that no sample has
+        reached are not checked.
+
+        Parameters
+        ----------
+        threshold : float or Iterable of float
+            Value that the uncertainty of every domain volume must be below, or
+            values for each domain in the order of :attr:`ids`
+        trigger_type : {'variance', 'std_dev', 'rel_err'}
+            Uncertainty checked against the threshold
+        max_iterations : int, optional
+            Number of iterations after which the calculation stops even if the
+            trigger is not satisfied. Defaults to 1000.
+
+        """
+        name = 'volume calculation trigger threshold'
+        if isinstance(threshold, Real):
+            cv.check_greater_than(name, threshold, 0.0)
+        else:
+            cv.check_type(name, threshold, Iterable, Real)
+            cv.check_length(name, threshold, len(self.ids), len(self.ids))
+            for t in threshold:
+                cv.check_greater_than(name, t, 0.0)
+            threshold = np.asarray(threshold, dtype=float)
+        cv.check_value('volume calculation trigger type', trigger_type,
+                       ('variance', 'std_dev', 'rel_err'))
+        if max_iterations is not None:
+            cv.check_type('volume calculation maximum iterations',
+                          max_iterations, Integral)
+            cv.check_greater_than('volume calculation maximum iterations',
+                                  max_iterations, 0)
+        self._threshold = threshold
+        self._trigger_type = trigger_type
+        self._max_iterations = max_iterations
+
     @classmethod
     def from_hdf5(cls, filename):
         """Load stochastic volume calculation results from HDF5 file.
@@ -202,6 +291,11 @@ class VolumeCalculation(object):
             samples = f.attrs['samples']
             lower_left = f.attrs['lower_left']
             upper_right = f.attrs['upper_right']
+            estimator = f.attrs.get('estimator', b'hit').decode()
+            iterations = f.attrs.get('iterations', 1)
+            threshold = f.attrs.get('threshold')
+            trigger_type = f.attrs.get('trigger_type')
+            max_iterations = f.attrs.get('max_iterations')
 
             volumes = {}
             atoms = {}
@@ -212,12 +306,14 @@ class VolumeCalculation(object):
                     ids.append(domain_id)
                     group = f[obj_name]
                     volume = ufloat(*group['volume'].value)
-                    nucnames = group['nuclides'].value
-                    atoms_ = group['atoms'].value
 
+                    # Nuclides are not written for a domain that was never hit
                     atom_dict = OrderedDict()
-                    for name_i, atoms_i in zip(nucnames, atoms_):
-                        atom_dict[name_i.decode()] = ufloat(*atoms_i)
+                    if 'nuclides' in group:
+                        nucnames = group['nuclides'].value
+                        atoms_ = group['atoms'].value
+                        for name_i, atoms_i in zip(nucnames, atoms_):
+                            atom_dict[name_i.decode()] = ufloat(*atoms_i)
                     volumes[domain_id] = volume
                     atoms[domain_id] = atom_dict
 
@@ -234,6 +330,14 @@ class VolumeCalculation(object):
 
         # Instantiate the class and assign results
         vol = cls(domains, samples, lower_left, upper_right)
+        vol.estimator = estimator
+        vol.iterations = int(iterations)
+        if threshold is not None:
+            if np.ndim(threshold) == 0:
+                threshold = float(threshold)
+            if max_iterations is not None:
+                max_iterations = int(max_iterations)
+            vol.set_trigger(threshold, trigger_type.decode(), max_iterations)
         vol.volumes = volumes
         vol.atoms = atoms
         return vol
@@ -255,6 +359,7 @@ class VolumeCalculation(object):
         assert np.all(self.upper_right == results.upper_right)
 
         # Copy results
+        self.iterations = results.iterations
         self.volumes = results.volumes
         self.atoms = results.atoms
 
@@ -278,4 +383,14 @@ class VolumeCalculation(object):
         ll_elem.text = ' '.join(str(x) for x in self.lower_left)
         ur_elem = ET.SubElement(element, "upper_right")
         ur_elem.text = ' '.join(str(x) for x in self.upper_right)
+        if self.estimator != 'hit':
+            est_elem = ET.SubElement(element, "estimator")
+            est_elem.text = self.estimator
+        if self.threshold is not None:
+            trigger_elem = ET.SubElement(element, "threshold")
+            trigger_elem.set("type", self.trigger_type)
+            trigger_elem.set("threshold", ' '.join(
+                str(x) for x in np.atleast_1d(self.threshold)))
+            if self.max_iterations is not None:
+                trigger_elem.set("max_iterations", str(self.max_iterations))
         return element
@@ -1,5 +1,6 @@
 #include "openmc/cell.h"
 
+#include <algorithm> // for min, max
 #include <cmath>
 #include <sstream>
 #include <string>
@@ -31,6 +32,16 @@ std::unordered_map<int32_t, int32_t> universe_map;
 
 } // namespace model
 
+namespace simulation {
+
+// Scratch buffer for the distances computed by SurfaceBatch::distances
+extern std::vector<double> batch_distances;
+#pragma omp threadprivate(batch_distances)
+
+std::vector<double> batch_distances;
+
+} // namespace simulation
+
 //==============================================================================
 //! Convert region specification string to integer tokens.
 //!
@@ -184,6 +195,117 @@ generate_rpn(int32_t cell_id, std::vector<int32_t> infix)
   return rpn;
 }
 
+//==============================================================================
+// Helpers for compiling region expressions
+//==============================================================================
+
+namespace {
+
+struct RegionNode {
+  int32_t op;                  //!< OP_INTERSECTION, OP_UNION, or a half-space
+  std::vector<int> children;   //!< Indices of child nodes
+  int n_leaves;                //!< Number of half-spaces in the subtree
+};
+
+//! Complement the region represented by a node in place
+void
+complement_region(std::vector<RegionNode>& nodes, int i)
+{
+  RegionNode& node {nodes[i]};
+  if (node.op == OP_INTERSECTION) {
+    node.op = OP_UNION;
+  } else if (node.op == OP_UNION) {
+    node.op = OP_INTERSECTION;
+  } else {
+    node.op = -node.op;
+  }
+  for (int child : node.children) complement_region(nodes, child);
+}
+
+//! Emit the half-space tests for a node, starting at a given index
+void
+emit_region(const std::vector<RegionNode>& nodes, int i, int32_t start,
+  int32_t next_true, int32_t next_false, std::vector<RegionBranch>& branches)
+{
+  const RegionNode& node {nodes[i]};
+  if (node.children.empty()) {
+    branches[start] = {node.op, next_true, next_false};
+    return;
+  }
+
+  // For an intersection, a true operand moves on to the next operand and a
+  // false operand decides the result. The reverse holds for a union.
+  bool intersection = (node.op == OP_INTERSECTION);
+  for (int k = 0; k < node.children.size(); ++k) {
+    int child = node.children[k];
+    int32_t next_start = start + nodes[child].n_leaves;
+    bool last = (k == node.children.size() - 1);
+    if (intersection) {
+      emit_region(nodes, child, start, last ? next_true : next_start,
+        next_false, branches);
+    } else {
+      emit_region(nodes, child, start, next_true,
+        last ? next_false : next_start, branches);
+    }
+    start = next_start;
+  }
+}
+
+} // namespace
+
+//==============================================================================
+//! Convert an RPN region expression to a sequence of short-circuiting
+//! half-space tests
+//!
+//! The expression is first converted to a tree whose interior nodes are n-ary
+//! intersections and unions; complements are eliminated by applying De
+//! Morgan's laws down to the half-spaces. The leaves of the tree are then
+//! emitted from left to right with the index of the test that follows each
+//! possible outcome.
+//==============================================================================
+
+std::vector<RegionBranch>
+compile_region(const std::vector<int32_t>& rpn)
+{
+  std::vector<RegionNode> nodes;
+  std::vector<int> stack;
+  for (int32_t token : rpn) {
+    if (token == OP_UNION || token == OP_INTERSECTION) {
+      // Combine the top two operands, flattening nested operators of the same
+      // kind into a single n-ary node
+      int right = stack.back();
+      stack.pop_back();
+      int left = stack.back();
+      stack.pop_back();
+      RegionNode node {token, {}, 0};
+      for (int operand : {left, right}) {
+        if (nodes[operand].op == token) {
+          node.children.insert(node.children.end(),
+            nodes[operand].children.begin(), nodes[operand].children.end());
+        } else {
+          node.children.push_back(operand);
+        }
+        node.n_leaves += nodes[operand].n_leaves;
+      }
+      nodes.push_back(node);
+      stack.push_back(nodes.size() - 1);
+    } else if (token == OP_COMPLEMENT) {
+      complement_region(nodes, stack.back());
+    } else {
+      nodes.push_back({token, {}, 1});
+      stack.push_back(nodes.size() - 1);
+    }
+  }
+
+  // A cell with no region specification has no tests to perform
+  std::vector<RegionBranch> branches;
+  if (stack.empty()) return branches;
+
+  branches.resize(nodes[stack.back()].n_leaves);
+  emit_region(nodes, stack.back(), 0, REGION_TRUE, REGION_FALSE, branches);
+  return branches;
+}
+
 //==============================================================================
 // Universe implementation
 //==============================================================================
@@ -206,10 +328,145 @@ Universe::to_hdf5(hid_t universes_group) const
   close_group(group);
 }
 
+void
+Universe::build_grid()
+{
+  grid_.reset();
+  if (cells_.size() < CELL_GRID_MIN_CELLS) return;
+
+  std::unique_ptr<CellGrid> grid {new CellGrid(cells_)};
+  if (!grid->empty()) grid_ = std::move(grid);
+}
+
+//==============================================================================
+// CellGrid implementation
+//==============================================================================
+
+CellGrid::CellGrid(const std::vector<int32_t>& cells)
+{
+  // Get bounding boxes of each cell as arrays of lower/upper bounds
+  int n_cells = cells.size();
+  std::vector<std::array<double, 3>> lower(n_cells);
+  std::vector<std::array<double, 3>> upper(n_cells);
+  for (int i = 0; i < n_cells; ++i) {
+    BoundingBox bb = model::cells[cells[i]]->bounding_box();
+    lower[i] = {bb.xmin, bb.ymin, bb.zmin};
+    upper[i] = {bb.xmax, bb.ymax, bb.zmax};
+  }
+
+  // Determine the extent of the finite bounds along each axis
+  std::array<double, 3> lo {INFTY, INFTY, INFTY};
+  std::array<double, 3> hi {-INFTY, -INFTY, -INFTY};
+  for (int i = 0; i < n_cells; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      for (double x : {lower[i][j], upper[i][j]}) {
+        if (std::abs(x) < INFTY) {
+          lo[j] = std::min(lo[j], x);
+          hi[j] = std::max(hi[j], x);
+        }
+      }
+    }
+  }
+
+  // Divide the axes with finite extent into bins such that the number of bins
+  // is proportional to the number of cells
+  int n_axes = 0;
+  for (int j = 0; j < 3; ++j) {
+    if (hi[j] > lo[j]) ++n_axes;
+  }
+  if (n_axes == 0) return;
+  int n_per_axis = std::ceil(std::pow(4.0*n_cells, 1.0/n_axes));
+  for (int j = 0; j < 3; ++j) {
+    lower_left_[j] = lo[j];
+    if (hi[j] > lo[j]) {
+      shape_[j] = n_per_axis;
+      width_[j] = (hi[j] - lo[j]) / n_per_axis;
+    } else {
+      shape_[j] = 1;
+      width_[j] = 1.0;
+    }
+  }
+  n_bins_ = shape_[0]*shape_[1]*shape_[2];
+
+  // Determine the range of bins overlapped by each cell. The bounding boxes
+  // are padded slightly so that points lying on a cell boundary are always
+  // assigned to a bin that lists the cell.
+  std::vector<std::array<int, 6>> ranges(n_cells);
+  for (int i = 0; i < n_cells; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      ranges[i][2*j] = axis_bin(j, lower[i][j] - TINY_BIT);
+      ranges[i][2*j + 1] = axis_bin(j, upper[i][j] + TINY_BIT);
+    }
+  }
+
+  // Count cells in each bin and then fill the bins in compressed row form,
+  // preserving the order of the cells
+  std::vector<int32_t> counts(n_bins_, 0);
+  auto for_each_bin = [this](const std::array<int, 6>& range, auto f) {
+    for (int iz = range[4]; iz <= range[5]; ++iz) {
+      for (int iy = range[2]; iy <= range[3]; ++iy) {
+        for (int ix = range[0]; ix <= range[1]; ++ix) {
+          f((iz*shape_[1] + iy)*shape_[0] + ix);
+        }
+      }
+    }
+  };
+  for (int i = 0; i < n_cells; ++i) {
+    for_each_bin(ranges[i], [&counts](int bin) {++counts[bin];});
+  }
+  offsets_.resize(n_bins_ + 1);
+  offsets_[0] = 0;
+  for (int bin = 0; bin < n_bins_; ++bin) {
+    offsets_[bin + 1] = offsets_[bin] + counts[bin];
+  }
+  cells_.resize(offsets_[n_bins_]);
+  std::fill(counts.begin(), counts.end(), 0);
+  for (int i = 0; i < n_cells; ++i) {
+    for_each_bin(ranges[i], [&, this](int bin) {
+      cells_[offsets_[bin] + counts[bin]++] = cells[i];
+    });
+  }
+}
+
+int
+CellGrid::axis_bin(int axis, double x) const
+{
+  double t = (x - lower_left_[axis]) / width_[axis];
+  if (!(t > 0.0)) return 0;
+  if (t >= shape_[axis]) return shape_[axis] - 1;
+  return static_cast<int>(t);
+}
+
+int
+CellGrid::get_bin(Position r) const
+{
+  int ix = axis_bin(0, r.x);
+  int iy = axis_bin(1, r.y);
+  int iz = axis_bin(2, r.z);
+  return (iz*shape_[1] + iy)*shape_[0] + ix;
+}
+
 //==============================================================================
 // Cell implementation
 //==============================================================================
 
+NeighborList*
+Cell::neighbor_list(int32_t on_surface) const
+{
+  if (!neighbors_) return nullptr;
+
+  int32_t i_surf = std::abs(on_surface);
+  for (int i = 0; i < neighbor_surfaces_.size(); ++i) {
+    if (neighbor_surfaces_[i] == i_surf) {
+      return &neighbors_[2*i + (on_surface > 0)];
+    }
+  }
+
+  // Crossings of any other surface, such as a periodic boundary or a surface
+  // of a DAGMC cell, share the list that follows those of the surfaces
+  return &neighbors_[2*neighbor_surfaces_.size()];
+}
+
 CSGCell::CSGCell() {} // empty constructor
 
 CSGCell::CSGCell(pugi::xml_node cell_node)
@@ -329,6 +586,31 @@ CSGCell::CSGCell(pugi::xml_node cell_node)
   rpn_ = generate_rpn(id_, region_);
   rpn_.shrink_to_fit();
 
+  // Get the unique half-spaces that could bound the cell.
+  for (int32_t token : rpn_) {
+    if (token < OP_UNION && std::find(halfspaces_.begin(), halfspaces_.end(),
+        token) == halfspaces_.end()) {
+      halfspaces_.push_back(token);
+    }
+  }
+  halfspaces_.shrink_to_fit();
+  if (halfspaces_.size() >= SURFACE_BATCH_MIN_HALFSPACES) {
+    batch_ = SurfaceBatch(halfspaces_);
+  }
+
+  // Allocate neighbor lists for both sides of each bounding surface.
+  for (int32_t token : region_) {
+    if (token < OP_UNION) {
+      int32_t i_surf = std::abs(token);
+      if (std::find(neighbor_surfaces_.begin(), neighbor_surfaces_.end(),
+          i_surf) == neighbor_surfaces_.end()) {
+        neighbor_surfaces_.push_back(i_surf);
+      }
+    }
+  }
+  neighbor_surfaces_.shrink_to_fit();
+  neighbors_.reset(new NeighborList[2*neighbor_surfaces_.size() + 1]);
+
   // Check if this is a simple cell.
   simple_ = true;
   for (int32_t token : rpn_) {
@@ -338,6 +620,9 @@ CSGCell::CSGCell(pugi::xml_node cell_node)
     }
   }
 
+  // Compile the region expression for complex cells.
+  if (!simple_) branches_ = compile_region(rpn_);
+
   // Read the translation vector.
   if (check_for_node(cell_node, "translation")) {
     if (fill_ == C_NONE) {
@@ -353,7 +638,8 @@ CSGCell::CSGCell(pugi::xml_node cell_node)
       err_msg << "Non-3D translation vector applied to cell " << id_;
       fatal_error(err_msg);
     }
-    translation_ = xyz;
+    transform_.translation = xyz;
+    transform_.translated = (transform_.translation != Position(0, 0, 0));
   }
 
   // Read the rotation transform.
@@ -373,28 +659,28 @@ CSGCell::CSGCell(pugi::xml_node cell_node)
     }
 
     // Store the rotation angles.
-    rotation_.reserve(12);
-    rotation_.push_back(rot[0]);
-    rotation_.push_back(rot[1]);
-    rotation_.push_back(rot[2]);
+    rotation_angles_ = {rot[0], rot[1], rot[2]};
 
     // Compute and store the rotation matrix.
     auto phi = -rot[0] * PI / 180.0;
     auto theta = -rot[1] * PI / 180.0;
     auto psi = -rot[2] * PI / 180.0;
-    rotation_.push_back(std::cos(theta) * std::cos(psi));
-    rotation_.push_back(-std::cos(phi) * std::sin(psi)
-                        + std::sin(phi) * std::sin(theta) * std::cos(psi));
-    rotation_.push_back(std::sin(phi) * std::sin(psi)
-                        + std::cos(phi) * std::sin(theta) * std::cos(psi));
-    rotation_.push_back(std::cos(theta) * std::sin(psi));
-    rotation_.push_back(std::cos(phi) * std::cos(psi)
-                        + std::sin(phi) * std::sin(theta) * std::sin(psi));
-    rotation_.push_back(-std::sin(phi) * std::cos(psi)
-                        + std::cos(phi) * std::sin(theta) * std::sin(psi));
-    rotation_.push_back(-std::sin(theta));
-    rotation_.push_back(std::sin(phi) * std::cos(theta));
-    rotation_.push_back(std::cos(phi) * std::cos(theta));
+    transform_.rotation = {
+      std::cos(theta) * std::cos(psi),
+      -std::cos(phi) * std::sin(psi)
+        + std::sin(phi) * std::sin(theta) * std::cos(psi),
+      std::sin(phi) * std::sin(psi)
+        + std::cos(phi) * std::sin(theta) * std::cos(psi),
+      std::cos(theta) * std::sin(psi),
+      std::cos(phi) * std::cos(psi)
+        + std::sin(phi) * std::sin(theta) * std::sin(psi),
+      -std::sin(phi) * std::cos(psi)
+        + std::cos(phi) * std::sin(theta) * std::sin(psi),
+      -std::sin(theta),
+      std::sin(phi) * std::cos(theta),
+      std::cos(phi) * std::cos(theta)
+    };
+    transform_.rotated = true;
   }
 }
 
@@ -418,14 +704,21 @@ CSGCell::distance(Position r, Direction u, int32_t on_surface) const
   double min_dist {INFTY};
   int32_t i_surf {std::numeric_limits<int32_t>::max()};
 
-  for (int32_t token : rpn_) {
-    // Ignore this token if it corresponds to an operator rather than a region.
-    if (token >= OP_UNION) continue;
+  // Cells with many bounding surfaces compute all distances in one pass into
+  // a scratch buffer that each thread reuses between calls
+  std::vector<double>& dists {simulation::batch_distances};
+  const bool batched {!batch_.empty()};
+  if (batched) {
+    if (dists.size() < halfspaces_.size()) dists.resize(halfspaces_.size());
+    batch_.distances(r, u, on_surface, dists.data());
+  }
 
+  for (int i = 0; i < halfspaces_.size(); ++i) {
     // Calculate the distance to this surface.
     // Note the off-by-one indexing
-    bool coincident {token == on_surface};
-    double d {model::surfaces[abs(token)-1]->distance(r, u, coincident)};
+    int32_t token = halfspaces_[i];
+    double d {batched ? dists[i] :
+      model::surface_pack.distance(abs(token)-1, r, u, token == on_surface)};
 
     // Check if this distance is the new minimum.
     if (d < min_dist) {
@@ -441,6 +734,37 @@ CSGCell::distance(Position r, Direction u, int32_t on_surface) const
 
 //==============================================================================
 
+BoundingBox
+CSGCell::bounding_box() const
+{
+  // Evaluate the RPN expression with bounding boxes in place of booleans.
+  // Intersections and unions of the half-space boxes give a conservative box
+  // for the region. The complement of a region is treated as unbounded.
+  std::vector<BoundingBox> stack;
+  stack.reserve(rpn_.size());
+  for (int32_t token : rpn_) {
+    if (token == OP_UNION) {
+      BoundingBox right = stack.back();
+      stack.pop_back();
+      stack.back() = stack.back() | right;
+    } else if (token == OP_INTERSECTION) {
+      BoundingBox right = stack.back();
+      stack.pop_back();
+      stack.back() = stack.back() & right;
+    } else if (token == OP_COMPLEMENT) {
+      stack.back() = INFINITE_BOX;
+    } else {
+      // Note the off-by-one indexing
+      stack.push_back(model::surfaces[abs(token)-1]->bounding_box(token > 0));
+    }
+  }
+
+  // A cell with no region specification fills all space
+  return stack.empty() ? INFINITE_BOX : stack.back();
+}
+
+//==============================================================================
+
 void
 CSGCell::to_hdf5(hid_t cell_group) const
 {
@@ -502,12 +826,11 @@ CSGCell::to_hdf5(hid_t cell_group) const
   } else if (type_ == FILL_UNIVERSE) {
     write_dataset(group, "fill_type", "universe");
     write_dataset(group, "fill", model::universes[fill_]->id_);
-    if (translation_ != Position(0, 0, 0)) {
-      write_dataset(group, "translation", translation_);
+    if (transform_.translated) {
+      write_dataset(group, "translation", transform_.translation);
     }
-    if (!rotation_.empty()) {
-      std::array<double, 3> rot {rotation_[0], rotation_[1], rotation_[2]};
-      write_dataset(group, "rotation", rot);
+    if (transform_.rotated) {
+      write_dataset(group, "rotation", rotation_angles_);
     }
 
   } else if (type_ == FILL_LATTICE) {
@@ -534,7 +857,7 @@ CSGCell::contains_simple(Position r, Direction u, int32_t on_surface) const
         return false;
       } else {
         // Note the off-by-one indexing
-        bool sense = model::surfaces[abs(token)-1]->sense(r, u);
+        bool sense = model::surface_pack.sense(abs(token)-1, r, u);
         if (sense != (token > 0)) {return false;}
       }
     }
@@ -547,49 +870,32 @@ CSGCell::contains_simple(Position r, Direction u, int32_t on_surface) const
 bool
 CSGCell::contains_complex(Position r, Direction u, int32_t on_surface) const
 {
-  // Make a stack of booleans.  We don't know how big it needs to be, but we do
-  // know that rpn.size() is an upper-bound.
-  bool stack[rpn_.size()];
-  int i_stack = -1;
-
-  for (int32_t token : rpn_) {
-    // If the token is a binary operator (intersection/union), apply it to
-    // the last two items on the stack. If the token is a unary operator
-    // (complement), apply it to the last item on the stack.
-    if (token == OP_UNION) {
-      stack[i_stack-1] = stack[i_stack-1] || stack[i_stack];
-      i_stack --;
-    } else if (token == OP_INTERSECTION) {
-      stack[i_stack-1] = stack[i_stack-1] && stack[i_stack];
-      i_stack --;
-    } else if (token == OP_COMPLEMENT) {
-      stack[i_stack] = !stack[i_stack];
+  // A cell with no region specification fills all space.
+  if (branches_.empty()) return true;
+
+  // Perform half-space tests until the value of the region expression is
+  // known, jumping over any tests that cannot change it.
+  int32_t i = 0;
+  while (true) {
+    const RegionBranch& b {branches_[i]};
+
+    // Evaluate the sense of particle with respect to the surface and see if
+    // the token matches the sense. If the particle's surface attribute is set
+    // and matches the token, that overrides the determination based on sense().
+    bool in_halfspace;
+    if (b.token == on_surface) {
+      in_halfspace = true;
+    } else if (-b.token == on_surface) {
+      in_halfspace = false;
     } else {
-      // If the token is not an operator, evaluate the sense of particle with
-      // respect to the surface and see if the token matches the sense. If the
-      // particle's surface attribute is set and matches the token, that
-      // overrides the determination based on sense().
-      i_stack ++;
-      if (token == on_surface) {
-        stack[i_stack] = true;
-      } else if (-token == on_surface) {
-        stack[i_stack] = false;
-      } else {
-        // Note the off-by-one indexing
-        bool sense = model::surfaces[abs(token)-1]->sense(r, u);
-        stack[i_stack] = (sense == (token > 0));
-      }
+      // Note the off-by-one indexing
+      bool sense = model::surface_pack.sense(abs(b.token)-1, r, u);
+      in_halfspace = (sense == (b.token > 0));
     }
-  }
 
-  if (i_stack == 0) {
-    // The one remaining bool on the stack indicates whether the particle is
-    // in the cell.
-    return stack[i_stack];
-  } else {
-    // This case occurs if there is no region specification since i_stack will
-    // still be -1.
-    return true;
+    i = in_halfspace ? b.next_true : b.next_false;
+    if (i == REGION_TRUE) return true;
+    if (i == REGION_FALSE) return false;
   }
 }
 
@@ -597,7 +903,12 @@ CSGCell::contains_complex(Position r, Direction u, int32_t on_surface) const
 // DAGMC Cell implementation
 //==============================================================================
 #ifdef DAGMC
-DAGCell::DAGCell() : Cell{} {};
+DAGCell::DAGCell() : Cell{}
+{
+  // The surfaces of DAGMC cells are not known, so a single neighbor list is
+  // shared by every surface crossing
+  neighbors_.reset(new NeighborList[1]);
+}
 
 std::pair<double, int32_t>
 DAGCell::distance(Position r, Direction u, int32_t on_surface) const
@@ -571,8 +571,11 @@ void ufs_count_sites()
     // distributed so that effectively the production of fission sites is not
     // biased
 
-    auto s = xt::view(simulation::source_frac, xt::all());
-    s = m->volume_frac_;
+    int n_bins = m->n_bins();
+    simulation::source_frac = xt::empty<double>({n_bins});
+    for (int i = 0; i < n_bins; ++i) {
+      simulation::source_frac(i) = m->volume_frac(i + 1);
+    }
 
   } else {
     // count number of source sites in each ufs mesh cell
@@ -587,7 +590,7 @@ void ufs_count_sites()
 
 #ifdef OPENMC_MPI
     // Send source fraction to all processors
-    int n_bins = xt::prod(m->shape_)();
+    int n_bins = m->n_bins();
     MPI_Bcast(simulation::source_frac.data(), n_bins, MPI_DOUBLE, 0, mpi::intracomm);
 #endif
 
@@ -616,7 +619,7 @@ double ufs_get_weight(const Particle* p)
   }
 
   if (simulation::source_frac(mesh_bin) != 0.0) {
-    return m->volume_frac_ / simulation::source_frac(mesh_bin);
+    return m->volume_frac(mesh_bin + 1) / simulation::source_frac(mesh_bin);
   } else {
     return 1.0;
   }
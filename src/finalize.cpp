@@ -28,16 +28,20 @@ int openmc_finalize()
   // Reset global variables
   settings::assume_separate = false;
   settings::check_overlaps = false;
+  settings::compton_tables = false;
   settings::confidence_intervals = false;
   settings::create_fission_neutrons = true;
   settings::electron_treatment = ELECTRON_LED;
   settings::energy_cutoff = {0.0, 1000.0, 0.0, 0.0};
+  settings::distance_cache = false;
   settings::entropy_on = false;
+  settings::flatten_geometry = false;
   settings::gen_per_batch = 1;
   settings::index_entropy_mesh = -1;
   settings::index_ufs_mesh = -1;
   settings::legendre_to_tabular = true;
   settings::legendre_to_tabular_points = -1;
+  settings::n_neighbor_sweep = 0;
   settings::n_particles = -1;
   settings::output_summary = true;
   settings::output_tallies = true;
@@ -56,6 +60,9 @@ int openmc_finalize()
   settings::source_separate = false;
   settings::source_write = true;
   settings::survival_biasing = false;
+  settings::tally_buffers = false;
+  settings::tally_dispatch = true;
+  settings::tally_buffer_memory = 16.0;
   settings::temperature_default = 293.6;
   settings::temperature_method = TEMPERATURE_NEAREST;
   settings::temperature_multipole = false;
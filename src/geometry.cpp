@@ -1,8 +1,11 @@
 #include "openmc/geometry.h"
 
 #include <array>
+#include <atomic>
+#include <cmath>
 #include <sstream>
 
+#include "openmc/bank.h"
 #include "openmc/cell.h"
 #include "openmc/constants.h"
 #include "openmc/error.h"
@@ -25,8 +28,17 @@ int root_universe {-1};
 
 std::vector<int64_t> overlap_check_count;
 
+std::vector<GeometryNode> geometry_nodes;
+
 } // namespace model
 
+namespace simulation {
+
+int64_t lattice_hits {0};
+int64_t lattice_misses {0};
+
+} // namespace simulation
+
 //==============================================================================
 // Non-member functions
 //==============================================================================
@@ -63,50 +75,35 @@ check_cell_overlap(Particle* p)
 //==============================================================================
 
 bool
-find_cell_inner(Particle* p, const NeighborList* neighbor_list)
+find_cell_inner(Particle* p, const NeighborList* neighbor_list);
+
+//! Search a range of candidate cells for the one containing a particle and
+//! descend into it.
+//! \param p The particle, located on every level above the current one
+//! \param first First candidate cell
+//! \param last End of the candidate cells
+//! \return Whether the particle was located down to a material cell
+
+bool
+find_cell_inner(Particle* p, const int32_t* first, const int32_t* last)
 {
-  // Find which cell of this universe the particle is in.  Use the neighbor list
-  // to shorten the search if one was provided.
   bool found = false;
   int32_t i_cell;
-  if (neighbor_list) {
-    for (auto it = neighbor_list->cbegin(); it != neighbor_list->cend(); ++it) {
-      i_cell = *it;
+  for (auto it = first; it != last; it++) {
+    i_cell = *it;
 
-      // Make sure the search cell is in the same universe.
-      int i_universe = p->coord[p->n_coord-1].universe;
-      if (model::cells[i_cell]->universe_ != i_universe) continue;
-
-      // Check if this cell contains the particle.
-      Position r {p->coord[p->n_coord-1].xyz};
-      Direction u {p->coord[p->n_coord-1].uvw};
-      auto surf = p->surface;
-      if (model::cells[i_cell]->contains(r, u, surf)) {
-        p->coord[p->n_coord-1].cell = i_cell;
-        found = true;
-        break;
-      }
-    }
-
-  } else {
+    // Make sure the search cell is in the same universe.
     int i_universe = p->coord[p->n_coord-1].universe;
-    const auto& cells {model::universes[i_universe]->cells_};
-    for (auto it = cells.cbegin(); it != cells.cend(); it++) {
-      i_cell = *it;
-
-      // Make sure the search cell is in the same universe.
-      int i_universe = p->coord[p->n_coord-1].universe;
-      if (model::cells[i_cell]->universe_ != i_universe) continue;
-
-      // Check if this cell contains the particle.
-      Position r {p->coord[p->n_coord-1].xyz};
-      Direction u {p->coord[p->n_coord-1].uvw};
-      auto surf = p->surface;
-      if (model::cells[i_cell]->contains(r, u, surf)) {
-        p->coord[p->n_coord-1].cell = i_cell;
-        found = true;
-        break;
-      }
+    if (model::cells[i_cell]->universe_ != i_universe) continue;
+
+    // Check if this cell contains the particle.
+    Position r {p->coord[p->n_coord-1].xyz};
+    Direction u {p->coord[p->n_coord-1].uvw};
+    auto surf = p->surface;
+    if (model::cells[i_cell]->contains(r, u, surf)) {
+      p->coord[p->n_coord-1].cell = i_cell;
+      found = true;
+      break;
     }
   }
 
@@ -125,22 +122,28 @@ find_cell_inner(Particle* p, const NeighborList* neighbor_list)
 
       // Find the distribcell instance number.
       if (c.material_.size() > 1 || c.sqrtkT_.size() > 1) {
-        int offset = 0;
-        for (int i = 0; i < p->n_coord; i++) {
-          Cell& c_i {*model::cells[p->coord[i].cell]};
-          if (c_i.type_ == FILL_UNIVERSE) {
-            offset += c_i.offset_[c.distribcell_index_];
-          } else if (c_i.type_ == FILL_LATTICE) {
-            Lattice& lat {*model::lattices[p->coord[i+1].lattice-1]};
-            int i_xyz[3] {p->coord[i+1].lattice_x,
-                          p->coord[i+1].lattice_y,
-                          p->coord[i+1].lattice_z};
-            if (lat.are_valid_indices(i_xyz)) {
-              offset += lat.offset(c.distribcell_index_, i_xyz);
+        int32_t node = p->coord[p->n_coord-1].node;
+        if (node != C_NONE) {
+          // The instance is stored with the placement of the universe.
+          p->cell_instance = model::geometry_nodes[node].instance;
+        } else {
+          int offset = 0;
+          for (int i = 0; i < p->n_coord; i++) {
+            Cell& c_i {*model::cells[p->coord[i].cell]};
+            if (c_i.type_ == FILL_UNIVERSE) {
+              offset += c_i.offset_[c.distribcell_index_];
+            } else if (c_i.type_ == FILL_LATTICE) {
+              Lattice& lat {*model::lattices[p->coord[i+1].lattice-1]};
+              int i_xyz[3] {p->coord[i+1].lattice_x,
+                            p->coord[i+1].lattice_y,
+                            p->coord[i+1].lattice_z};
+              if (lat.are_valid_indices(i_xyz)) {
+                offset += lat.offset(c.distribcell_index_, i_xyz);
+              }
             }
           }
+          p->cell_instance = offset;
         }
-        p->cell_instance = offset;
       } else {
         p->cell_instance = 0;
       }
@@ -173,40 +176,21 @@ find_cell_inner(Particle* p, const NeighborList* neighbor_list)
 
       // Set the lower coordinate level universe.
       p->coord[p->n_coord].universe = c.fill_;
-
-      // Set the position and direction.
-      for (int i = 0; i < 3; i++) {
-        p->coord[p->n_coord].xyz[i] = p->coord[p->n_coord-1].xyz[i];
-        p->coord[p->n_coord].uvw[i] = p->coord[p->n_coord-1].uvw[i];
-      }
-
-      // Apply translation.
-      p->coord[p->n_coord].xyz[0] -= c.translation_.x;
-      p->coord[p->n_coord].xyz[1] -= c.translation_.y;
-      p->coord[p->n_coord].xyz[2] -= c.translation_.z;
-
-      // Apply rotation.
-      if (!c.rotation_.empty()) {
-        auto x = p->coord[p->n_coord].xyz[0];
-        auto y = p->coord[p->n_coord].xyz[1];
-        auto z = p->coord[p->n_coord].xyz[2];
-        p->coord[p->n_coord].xyz[0] = x*c.rotation_[3] + y*c.rotation_[4]
-                                      + z*c.rotation_[5];
-        p->coord[p->n_coord].xyz[1] = x*c.rotation_[6] + y*c.rotation_[7]
-                                      + z*c.rotation_[8];
-        p->coord[p->n_coord].xyz[2] = x*c.rotation_[9] + y*c.rotation_[10]
-                                      + z*c.rotation_[11];
-        auto u = p->coord[p->n_coord].uvw[0];
-        auto v = p->coord[p->n_coord].uvw[1];
-        auto w = p->coord[p->n_coord].uvw[2];
-        p->coord[p->n_coord].uvw[0] = u*c.rotation_[3] + v*c.rotation_[4]
-                                      + w*c.rotation_[5];
-        p->coord[p->n_coord].uvw[1] = u*c.rotation_[6] + v*c.rotation_[7]
-                                      + w*c.rotation_[8];
-        p->coord[p->n_coord].uvw[2] = u*c.rotation_[9] + v*c.rotation_[10]
-                                      + w*c.rotation_[11];
-        p->coord[p->n_coord].rotated = true;
-      }
+      p->coord[p->n_coord].node = child_node(p->coord[p->n_coord-1].node,
+                                             c.node_slot_);
+
+      // Apply the translation and rotation of the fill to the position and
+      // direction.
+      const Transform& t {c.transform_};
+      Position r = t.apply(p->coord[p->n_coord-1].xyz);
+      Direction u = t.apply_direction(p->coord[p->n_coord-1].uvw);
+      p->coord[p->n_coord].xyz[0] = r.x;
+      p->coord[p->n_coord].xyz[1] = r.y;
+      p->coord[p->n_coord].xyz[2] = r.z;
+      p->coord[p->n_coord].uvw[0] = u.x;
+      p->coord[p->n_coord].uvw[1] = u.y;
+      p->coord[p->n_coord].uvw[2] = u.z;
+      p->coord[p->n_coord].rotated = t.rotated;
 
       // Update the coordinate level and recurse.
       ++p->n_coord;
@@ -240,11 +224,16 @@ find_cell_inner(Particle* p, const NeighborList* neighbor_list)
       p->coord[p->n_coord].lattice_z = i_xyz[2];
 
       // Set the lower coordinate level universe.
+      int32_t node = p->coord[p->n_coord-1].node;
       if (lat.are_valid_indices(i_xyz)) {
         p->coord[p->n_coord].universe = lat[i_xyz];
+        p->coord[p->n_coord].node = child_node(node,
+          c.node_slot_ + lat.get_flat_index(i_xyz.data()));
       } else {
         if (lat.outer_ != NO_OUTER_UNIVERSE) {
           p->coord[p->n_coord].universe = lat.outer_;
+          p->coord[p->n_coord].node = child_node(node,
+            c.node_slot_ + lat.universes_.size());
         } else {
           std::stringstream err_msg;
           err_msg << "Particle " << p->id << " is outside lattice "
@@ -266,6 +255,31 @@ find_cell_inner(Particle* p, const NeighborList* neighbor_list)
 
 //==============================================================================
 
+bool
+find_cell_inner(Particle* p, const NeighborList* neighbor_list)
+{
+  // Find which cell of this universe the particle is in.  Use the neighbor list
+  // to shorten the search if one was provided.
+  if (neighbor_list) {
+    auto neighbors = neighbor_list->view();
+    return find_cell_inner(p, neighbors.begin(), neighbors.end());
+  }
+
+  // If the universe has a cell search grid, only the cells whose bounding
+  // boxes overlap the grid bin containing the particle need to be checked.
+  int i_universe = p->coord[p->n_coord-1].universe;
+  const Universe& univ {*model::universes[i_universe]};
+  if (univ.grid_) {
+    int bin = univ.grid_->get_bin(p->coord[p->n_coord-1].xyz);
+    return find_cell_inner(p, univ.grid_->cbegin(bin), univ.grid_->cend(bin));
+  } else {
+    return find_cell_inner(p, univ.cells_.data(),
+                           univ.cells_.data() + univ.cells_.size());
+  }
+}
+
+//==============================================================================
+
 extern "C" bool
 find_cell(Particle* p, bool use_neighbor_lists)
 {
@@ -277,27 +291,37 @@ find_cell(Particle* p, bool use_neighbor_lists)
     i_universe = model::root_universe;
   }
 
+  // The top coordinate level is always the root node of the flattened
+  // geometry hierarchy.
+  if (p->n_coord == 1) {
+    p->coord[0].node = model::geometry_nodes.empty() ? C_NONE : 0;
+  }
+
   // Reset all the deeper coordinate levels.
   for (int i = p->n_coord; i < MAX_COORD; i++) {
     p->coord[i].reset();
   }
 
-  if (use_neighbor_lists) {
-    // Get the cell this particle was in previously.
-    auto coord_lvl = p->n_coord - 1;
-    auto i_cell = p->coord[coord_lvl].cell;
-    Cell& c {*model::cells[i_cell]};
+  // Get the neighbor list of the cell this particle was in previously for the
+  // side of the surface it just crossed into.
+  auto coord_lvl = p->n_coord - 1;
+  NeighborList* neighbors = nullptr;
+  if (use_neighbor_lists && p->surface != ERROR_INT) {
+    neighbors = model::cells[p->coord[coord_lvl].cell]->neighbor_list(
+      p->surface);
+  }
 
-    // Search for the particle in that cell's neighbor list.  Return if we
-    // found the particle.
-    bool found = find_cell_inner(p, &c.neighbors_);
+  if (neighbors) {
+    // Search for the particle in that neighbor list.  Return if we found the
+    // particle.
+    bool found = find_cell_inner(p, neighbors);
     if (found) return found;
 
     // The particle could not be found in the neighbor list.  Try searching all
     // cells in this universe, and update the neighbor list if we find a new
     // neighboring cell.
     found = find_cell_inner(p, nullptr);
-    if (found) c.neighbors_.push_back(p->coord[coord_lvl].cell);
+    if (found) neighbors->push_back(p->coord[coord_lvl].cell);
     return found;
 
   } else {
@@ -349,8 +373,43 @@ cross_lattice(Particle* p, int lattice_translation[3])
 
   } else {
     // Find cell in next lattice element.
-    p->coord[p->n_coord-1].universe = lat[i_xyz];
-    bool found = find_cell(p, 0);
+    int32_t i_univ = lat[i_xyz];
+    int32_t exit_cell = p->coord[p->n_coord-1].cell;
+    p->coord[p->n_coord-1].universe = i_univ;
+    const Cell& c {*model::cells[p->coord[p->n_coord-2].cell]};
+    p->coord[p->n_coord-1].node = child_node(p->coord[p->n_coord-2].node,
+      c.node_slot_ + lat.get_flat_index(i_xyz.data()));
+
+    // Neighboring tiles are usually filled with the same universe, in which
+    // case the particle enters the cell corresponding to the one it just left,
+    // e.g. the moderator surrounding a pin. Otherwise, guess the cell last
+    // entered across a tile boundary of the new universe. Only if this single
+    // candidate does not contain the particle is the full search needed.
+    Universe& univ {*model::universes[i_univ]};
+    bool same_universe = exit_cell != C_NONE
+      && model::cells[exit_cell]->universe_ == i_univ;
+    int32_t predicted = same_universe ? exit_cell
+      : univ.entry_cell_.load(std::memory_order_relaxed);
+    int n_coord = p->n_coord;
+    bool found = false;
+    if (predicted != C_NONE) {
+      for (int i = n_coord; i < MAX_COORD; i++) {
+        p->coord[i].reset();
+      }
+      found = find_cell_inner(p, &predicted, &predicted + 1);
+    }
+
+    if (found) {
+      ++simulation::lattice_hits;
+    } else {
+      ++simulation::lattice_misses;
+      p->n_coord = n_coord;
+      found = find_cell(p, 0);
+      if (found && !same_universe) {
+        univ.entry_cell_.store(p->coord[n_coord-1].cell,
+                               std::memory_order_relaxed);
+      }
+    }
 
     if (!found) {
       // A particle crossing the corner of a lattice tile may not be found.  In
@@ -372,6 +431,15 @@ cross_lattice(Particle* p, int lattice_translation[3])
 extern "C" void
 distance_to_boundary(Particle* p, double* dist, int* surface_crossed,
                      int lattice_translation[3], int* next_level)
+{
+  distance_to_boundary(p, dist, surface_crossed, lattice_translation,
+                       next_level, nullptr);
+}
+
+void
+distance_to_boundary(Particle* p, double* dist, int* surface_crossed,
+                     int lattice_translation[3], int* next_level,
+                     BoundaryDistance* saved)
 {
   *dist = INFINITY;
   double d_lat = INFINITY;
@@ -380,45 +448,61 @@ distance_to_boundary(Particle* p, double* dist, int* surface_crossed,
   lattice_translation[1] = 0;
   lattice_translation[2] = 0;
   int32_t level_surf_cross;
-  std::array<int, 3> level_lat_trans;
+  std::array<int, 3> level_lat_trans {};
 
   // Loop over each coordinate level.
   for (int i = 0; i < p->n_coord; i++) {
     Position r {p->coord[i].xyz};
     Direction u {p->coord[i].uvw};
     Cell& c {*model::cells[p->coord[i].cell]};
+    std::array<int, 3> i_xyz {p->coord[i].lattice_x, p->coord[i].lattice_y,
+                              p->coord[i].lattice_z};
+
+    if (saved && saved[i].valid && saved[i].cell == p->coord[i].cell
+        && saved[i].lattice_index == i_xyz) {
+      // The particle has moved in a straight line within the same cell since
+      // the distances on this level were computed.
+      d_surf = saved[i].d_surf;
+      level_surf_cross = saved[i].surface;
+      d_lat = saved[i].d_lat;
+      level_lat_trans = saved[i].lattice_translation;
 
-    // Find the oncoming surface in this cell and the distance to it.
-    auto surface_distance = c.distance(r, u, p->surface);
-    d_surf = surface_distance.first;
-    level_surf_cross = surface_distance.second;
-
-    // Find the distance to the next lattice tile crossing.
-    if (p->coord[i].lattice != F90_NONE) {
-      Lattice& lat {*model::lattices[p->coord[i].lattice-1]};
-      std::array<int, 3> i_xyz {p->coord[i].lattice_x, p->coord[i].lattice_y,
-                                p->coord[i].lattice_z};
-      //TODO: refactor so both lattice use the same position argument (which
-      //also means the lat.type attribute can be removed)
-      std::pair<double, std::array<int, 3>> lattice_distance;
-      switch (lat.type_) {
-        case LatticeType::rect:
-          lattice_distance = lat.distance(r, u, i_xyz);
-          break;
-        case LatticeType::hex:
-          Position r_hex {p->coord[i-1].xyz[0], p->coord[i-1].xyz[1],
-                          p->coord[i].xyz[2]};
-          lattice_distance = lat.distance(r_hex, u, i_xyz);
-          break;
+    } else {
+      // Find the oncoming surface in this cell and the distance to it.
+      auto surface_distance = c.distance(r, u, p->surface);
+      d_surf = surface_distance.first;
+      level_surf_cross = surface_distance.second;
+
+      // Find the distance to the next lattice tile crossing.
+      if (p->coord[i].lattice != F90_NONE) {
+        Lattice& lat {*model::lattices[p->coord[i].lattice-1]};
+        //TODO: refactor so both lattice use the same position argument (which
+        //also means the lat.type attribute can be removed)
+        std::pair<double, std::array<int, 3>> lattice_distance;
+        switch (lat.type_) {
+          case LatticeType::rect:
+            lattice_distance = lat.distance(r, u, i_xyz);
+            break;
+          case LatticeType::hex:
+            Position r_hex {p->coord[i-1].xyz[0], p->coord[i-1].xyz[1],
+                            p->coord[i].xyz[2]};
+            lattice_distance = lat.distance(r_hex, u, i_xyz);
+            break;
+        }
+        d_lat = lattice_distance.first;
+        level_lat_trans = lattice_distance.second;
+
+        if (d_lat < 0) {
+          std::stringstream err_msg;
+          err_msg << "Particle " << p->id
+                  << " had a negative distance to a lattice boundary";
+          p->mark_as_lost(err_msg);
+        }
       }
-      d_lat = lattice_distance.first;
-      level_lat_trans = lattice_distance.second;
 
-      if (d_lat < 0) {
-        std::stringstream err_msg;
-        err_msg << "Particle " << p->id
-                << " had a negative distance to a lattice boundary";
-        p->mark_as_lost(err_msg);
+      if (saved) {
+        saved[i] = {true, p->coord[i].cell, i_xyz, d_surf, level_surf_cross,
+                    d_lat, level_lat_trans};
       }
     }
 
@@ -464,4 +548,103 @@ distance_to_boundary(Particle* p, double* dist, int* surface_crossed,
   }
 }
 
+//==============================================================================
+
+void
+prepopulate_neighbor_lists(int n_rays)
+{
+  int64_t n_sites = simulation::source_bank.size();
+  if (n_rays <= 0 || n_sites == 0) return;
+
+  // Golden angle used to spread ray directions over the unit sphere
+  const double golden_angle = PI*(3.0 - std::sqrt(5.0));
+
+  #pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < n_rays; ++i) {
+    Particle p;
+    p.initialize();
+
+    // Start the ray at a source site
+    const Bank& site {simulation::source_bank[i % n_sites]};
+    std::copy(site.xyz, site.xyz + 3, p.coord[0].xyz);
+    double mu = 1.0 - (2.0*i + 1.0)/n_rays;
+    double phi = i*golden_angle;
+    double rho = std::sqrt(1.0 - mu*mu);
+    p.coord[0].uvw[0] = rho*std::cos(phi);
+    p.coord[0].uvw[1] = rho*std::sin(phi);
+    p.coord[0].uvw[2] = mu;
+    if (!find_cell(&p, false)) continue;
+
+    for (int j = 0; j < NEIGHBOR_SWEEP_MAX_CROSSINGS; ++j) {
+      double d;
+      int surface_crossed = F90_NONE;
+      int lattice_translation[3];
+      int next_level = 0;
+      distance_to_boundary(&p, &d, &surface_crossed, lattice_translation,
+        &next_level);
+
+      // Stop if the ray is in a cell without any bounding surfaces. Cells
+      // report INFTY rather than INFINITY in that case.
+      if (d >= INFTY) break;
+
+      // Advance the ray to the boundary
+      for (int k = 0; k < p.n_coord; ++k) {
+        p.coord[k].xyz[0] += d * p.coord[k].uvw[0];
+        p.coord[k].xyz[1] += d * p.coord[k].uvw[1];
+        p.coord[k].xyz[2] += d * p.coord[k].uvw[2];
+      }
+      if (next_level > 0) p.n_coord = next_level;
+
+      bool found;
+      if (lattice_translation[0] != 0 || lattice_translation[1] != 0 ||
+          lattice_translation[2] != 0) {
+        // Lattice crossings don't use neighbor lists, so just relocate the ray
+        // from the root universe just past the lattice boundary.
+        p.surface = ERROR_INT;
+        p.n_coord = 1;
+        p.coord[0].xyz[0] += TINY_BIT * p.coord[0].uvw[0];
+        p.coord[0].xyz[1] += TINY_BIT * p.coord[0].uvw[1];
+        p.coord[0].xyz[2] += TINY_BIT * p.coord[0].uvw[2];
+        found = find_cell(&p, false);
+
+      } else {
+        if (surface_crossed == F90_NONE
+            || std::abs(surface_crossed) > model::surfaces.size()) break;
+        p.surface = surface_crossed;
+        const auto& surf {model::surfaces[std::abs(surface_crossed) - 1]};
+
+        // As in transport, boundary conditions are only applied in the root
+        // universe. A ray that reaches a reflective or periodic surface in a
+        // lower universe, or any periodic surface, ends there.
+        if (surf->bc_ == BC_REFLECT && p.n_coord == 1) {
+          // Reflect the ray and stay in the same cell
+          Direction u = surf->reflect(p.coord[0].xyz, p.coord[0].uvw);
+          u /= u.norm();
+          p.coord[0].uvw[0] = u.x;
+          p.coord[0].uvw[1] = u.y;
+          p.coord[0].uvw[2] = u.z;
+          p.surface = -p.surface;
+        } else if (surf->bc_ != BC_TRANSMIT) {
+          // The ray leaks out of the problem or would need to be moved to a
+          // periodic partner surface
+          break;
+        }
+
+        // Search the neighbor list of the side of the surface crossed into,
+        // adding the next cell to it if necessary
+        found = find_cell(&p, true);
+        if (!found) {
+          p.surface = ERROR_INT;
+          p.n_coord = 1;
+          p.coord[0].xyz[0] += TINY_BIT * p.coord[0].uvw[0];
+          p.coord[0].xyz[1] += TINY_BIT * p.coord[0].uvw[1];
+          p.coord[0].xyz[2] += TINY_BIT * p.coord[0].uvw[2];
+          found = find_cell(&p, false);
+        }
+      }
+      if (!found) break;
+    }
+  }
+}
+
 } // namespace openmc
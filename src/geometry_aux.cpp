@@ -202,6 +202,17 @@ void finalize_geometry(std::vector<std::vector<double>>& nuc_temps,
   adjust_indices();
   count_cell_instances(model::root_universe);
 
+  // Pack surface equations for evaluation during tracking
+  model::surface_pack.clear();
+  for (const Surface* surf : model::surfaces) {
+    model::surface_pack.push_back(*surf);
+  }
+
+  // Build grids to accelerate cell searches in universes with many cells
+  for (Universe* u : model::universes) {
+    u->build_grid();
+  }
+
   // Assign temperatures to cells that don't have temperatures already assigned
   assign_temperatures();
 
@@ -354,6 +365,145 @@ prepare_distribcell()
 
 //==============================================================================
 
+int64_t
+count_geometry_nodes(int32_t univ, std::vector<int64_t>& n_below)
+{
+  // Universes are usually placed many times, so remember the number of nodes
+  // below each universe.
+  if (n_below[univ] >= 0) return n_below[univ];
+
+  const Universe& u {*model::universes[univ]};
+  int64_t n = u.n_node_slots_;
+  for (int32_t cell_indx : u.cells_) {
+    Cell& c = *model::cells[cell_indx];
+
+    if (c.type_ == FILL_UNIVERSE) {
+      n += count_geometry_nodes(c.fill_, n_below);
+
+    } else if (c.type_ == FILL_LATTICE) {
+      Lattice& lat = *model::lattices[c.fill_];
+      for (auto it = lat.begin(); it != lat.end(); ++it) {
+        n += count_geometry_nodes(*it, n_below);
+      }
+      if (lat.outer_ != NO_OUTER_UNIVERSE) {
+        n += count_geometry_nodes(lat.outer_, n_below);
+      }
+    }
+  }
+
+  n_below[univ] = n;
+  return n;
+}
+
+//==============================================================================
+
+void
+place_geometry_node(int32_t node, const std::vector<int32_t>& offsets,
+                    const std::vector<int>& universe_maps)
+{
+  // The instance of a cell is the sum of the offsets for its distribcell map
+  // over all levels above it. Cells in the same universe share their offsets,
+  // so any map of the universe gives the instance.
+  int32_t univ = model::geometry_nodes[node].universe;
+  int map = universe_maps[univ];
+  model::geometry_nodes[node].instance = (map == C_NONE) ? 0 : offsets[map];
+
+  const Universe& u {*model::universes[univ]};
+  if (u.n_node_slots_ == 0) return;
+  int32_t first = model::geometry_nodes.size();
+  model::geometry_nodes[node].children = first;
+  model::geometry_nodes.resize(first + u.n_node_slots_,
+                               {C_NONE, 0, C_NONE});
+
+  int n_maps = offsets.size();
+  std::vector<int32_t> child_offsets(n_maps);
+  for (int32_t cell_indx : u.cells_) {
+    Cell& c = *model::cells[cell_indx];
+
+    if (c.type_ == FILL_UNIVERSE) {
+      for (int m = 0; m < n_maps; ++m) {
+        child_offsets[m] = offsets[m] + c.offset_[m];
+      }
+      int32_t child = first + c.node_slot_;
+      model::geometry_nodes[child].universe = c.fill_;
+      place_geometry_node(child, child_offsets, universe_maps);
+
+    } else if (c.type_ == FILL_LATTICE) {
+      Lattice& lat = *model::lattices[c.fill_];
+      int n_tiles = lat.universes_.size();
+      for (auto it = lat.begin(); it != lat.end(); ++it) {
+        for (int m = 0; m < n_maps; ++m) {
+          child_offsets[m] = offsets[m] + lat.offsets_[m*n_tiles + it.indx_];
+        }
+        int32_t child = first + c.node_slot_ + it.indx_;
+        model::geometry_nodes[child].universe = *it;
+        place_geometry_node(child, child_offsets, universe_maps);
+      }
+
+      // Tiles outside of the lattice don't add to the distribcell offsets
+      if (lat.outer_ != NO_OUTER_UNIVERSE) {
+        int32_t child = first + c.node_slot_ + n_tiles;
+        model::geometry_nodes[child].universe = lat.outer_;
+        place_geometry_node(child, offsets, universe_maps);
+      }
+    }
+  }
+}
+
+//==============================================================================
+
+void
+build_geometry_nodes()
+{
+  model::geometry_nodes.clear();
+
+  // Assign each filled cell the positions of its children among the children
+  // of a node for its universe: one for a universe and one for each lattice
+  // tile plus the outer universe for a lattice.
+  for (Universe* u : model::universes) {
+    u->n_node_slots_ = 0;
+    for (int32_t cell_indx : u->cells_) {
+      Cell& c = *model::cells[cell_indx];
+      if (c.type_ == FILL_UNIVERSE) {
+        c.node_slot_ = u->n_node_slots_;
+        u->n_node_slots_ += 1;
+      } else if (c.type_ == FILL_LATTICE) {
+        c.node_slot_ = u->n_node_slots_;
+        u->n_node_slots_ += model::lattices[c.fill_]->universes_.size() + 1;
+      }
+    }
+  }
+
+  // Make sure the hierarchy isn't too large to flatten
+  std::vector<int64_t> n_below(model::universes.size(), -1);
+  int64_t n_nodes = 1 + count_geometry_nodes(model::root_universe, n_below);
+  if (n_nodes > GEOMETRY_MAX_NODES) {
+    warning("The geometry has too many universe placements to be flattened.");
+    return;
+  }
+
+  // Find a distribcell map for each universe
+  std::vector<int> universe_maps(model::universes.size(), C_NONE);
+  int n_maps = 0;
+  for (int i = 0; i < model::universes.size(); ++i) {
+    for (int32_t cell_indx : model::universes[i]->cells_) {
+      int map = model::cells[cell_indx]->distribcell_index_;
+      if (map != C_NONE) {
+        universe_maps[i] = map;
+        n_maps = std::max(n_maps, map + 1);
+      }
+    }
+  }
+
+  // Place the root universe and recursively everything below it
+  model::geometry_nodes.reserve(n_nodes);
+  model::geometry_nodes.push_back({model::root_universe, 0, C_NONE});
+  std::vector<int32_t> offsets(n_maps, 0);
+  place_geometry_node(0, offsets, universe_maps);
+}
+
+//==============================================================================
+
 void
 count_cell_instances(int32_t univ_indx)
 {
@@ -529,6 +679,7 @@ free_memory_geometry()
   model::lattice_map.clear();
 
   model::overlap_check_count.clear();
+  model::geometry_nodes.clear();
 }
 
 } // namespace openmc
@@ -15,6 +15,8 @@
 #include "openmc/message_passing.h"
 #endif
 
+#include "openmc/tallies/sparse_results.h"
+
 
 namespace openmc {
 
@@ -755,6 +757,90 @@ write_tally_results(hid_t group_id, hsize_t n_filter, hsize_t n_score, const dou
 }
 
 
+//! Number of filter bins in each chunk of the results of a sparse tally, which
+//! is chosen so that a chunk holds about 8192 values
+hsize_t
+tally_results_chunk(hsize_t n_filter, hsize_t n_score)
+{
+  return std::max(hsize_t{1}, std::min(n_filter, 8192 / (2*n_score)));
+}
+
+
+void
+write_tally_results_sparse(hid_t group_id, hsize_t n_filter, hsize_t n_score,
+  const std::vector<int64_t>& bins, const std::vector<double>& values)
+{
+  // Create a chunked dataset for sum/sum_sq. Chunks are only allocated in the
+  // file when they are written.
+  hsize_t n_chunk = tally_results_chunk(n_filter, n_score);
+  hsize_t dims[] {n_filter, n_score, 2};
+  hsize_t chunk[] {n_chunk, n_score, 2};
+  hid_t dspace = H5Screate_simple(3, dims, nullptr);
+  hid_t plist = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(plist, 3, chunk);
+  hid_t dset = H5Dcreate(group_id, "results", H5T_NATIVE_DOUBLE, dspace,
+                         H5P_DEFAULT, plist, H5P_DEFAULT);
+
+  // Write each chunk that contains a nonzero result
+  std::vector<double> buffer;
+  for (std::size_t i = 0; i < bins.size(); ) {
+    hsize_t start[] {bins[i] / n_score / n_chunk * n_chunk, 0, 0};
+    hsize_t count[] {std::min(n_chunk, n_filter - start[0]), n_score, 2};
+    buffer.assign(count[0] * n_score * 2, 0.0);
+    for (; i < bins.size() && bins[i] / n_score < start[0] + count[0]; ++i) {
+      auto k = bins[i] - start[0]*n_score;
+      buffer[2*k] = values[2*i];
+      buffer[2*k + 1] = values[2*i + 1];
+    }
+
+    hid_t memspace = H5Screate_simple(3, count, nullptr);
+    H5Sselect_hyperslab(dspace, H5S_SELECT_SET, start, nullptr, count, nullptr);
+    H5Dwrite(dset, H5T_NATIVE_DOUBLE, memspace, dspace, H5P_DEFAULT,
+             buffer.data());
+    H5Sclose(memspace);
+  }
+
+  // Free resources
+  H5Dclose(dset);
+  H5Pclose(plist);
+  H5Sclose(dspace);
+}
+
+
+void
+read_tally_results_sparse(hid_t group_id, hsize_t n_filter, hsize_t n_score,
+  SparseResults& results)
+{
+  hid_t dset = H5Dopen(group_id, "results", H5P_DEFAULT);
+  hid_t dspace = H5Dget_space(dset);
+
+  // Read a block of filter bins at a time and copy the nonzero values so that
+  // memory is only allocated for results that were scored to
+  hsize_t n_block = tally_results_chunk(n_filter, n_score);
+  std::vector<double> buffer;
+  for (hsize_t i = 0; i < n_filter; i += n_block) {
+    hsize_t start[] {i, 0, 0};
+    hsize_t count[] {std::min(n_block, n_filter - i), n_score, 2};
+    buffer.resize(count[0] * n_score * 2);
+
+    hid_t memspace = H5Screate_simple(3, count, nullptr);
+    H5Sselect_hyperslab(dspace, H5S_SELECT_SET, start, nullptr, count, nullptr);
+    H5Dread(dset, H5T_NATIVE_DOUBLE, memspace, dspace, H5P_DEFAULT,
+            buffer.data());
+    H5Sclose(memspace);
+
+    for (hsize_t k = 0; k < buffer.size(); ++k) {
+      if (buffer[k] == 0.0) continue;
+      hsize_t j = k / 2;
+      results.get(i + j/n_score)[j%n_score*3 + 1 + k%2] = buffer[k];
+    }
+  }
+
+  // Free resources
+  H5Sclose(dspace);
+  H5Dclose(dset);
+}
+
 bool
 using_mpio_device(hid_t obj_id)
 {
@@ -204,6 +204,8 @@ parse_command_line(int argc, char* argv[])
       settings::check_overlaps = true;
       } else if (arg == "-c" || arg == "--volume") {
         settings::run_mode = RUN_MODE_VOLUME;
+      } else if (arg == "-o" || arg == "--overlaps") {
+        settings::run_mode = RUN_MODE_OVERLAP;
       } else if (arg == "-s" || arg == "--threads") {
         // Read number of threads
         i += 1;
@@ -268,7 +270,8 @@ void read_input_xml()
   double_2dvec thermal_temps(data::thermal_scatt_map.size());
   finalize_geometry(nuc_temps, thermal_temps);
 
-  if (settings::run_mode != RUN_MODE_PLOTTING) {
+  if (settings::run_mode != RUN_MODE_PLOTTING &&
+      settings::run_mode != RUN_MODE_OVERLAP) {
     simulation::time_read_xs.start();
     if (settings::run_CE) {
       // Read continuous-energy cross sections
@@ -286,12 +289,15 @@ void read_input_xml()
   // Initialize distribcell_filters
   prepare_distribcell();
 
+  // Flatten the geometry hierarchy for faster distribcell lookups
+  if (settings::flatten_geometry) build_geometry_nodes();
+
   if (settings::run_mode == RUN_MODE_PLOTTING) {
     // Read plots.xml if it exists
     read_plots_xml();
     if (mpi::master && settings::verbosity >= 5) print_plot();
 
-  } else {
+  } else if (settings::run_mode != RUN_MODE_OVERLAP) {
     // Write summary information
     if (mpi::master && settings::output_summary) write_summary();
 
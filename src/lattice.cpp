@@ -316,6 +316,14 @@ const
 
 //==============================================================================
 
+int
+RectLattice::get_flat_index(const int i_xyz[3]) const
+{
+  return nx*ny*i_xyz[2] + nx*i_xyz[1] + i_xyz[0];
+}
+
+//==============================================================================
+
 int32_t&
 RectLattice::offset(int map, const int i_xyz[3])
 {
@@ -785,6 +793,16 @@ HexLattice::is_valid_index(int indx) const
 
 //==============================================================================
 
+int
+HexLattice::get_flat_index(const int i_xyz[3]) const
+{
+  int nx {2*n_rings_ - 1};
+  int ny {2*n_rings_ - 1};
+  return nx*ny*i_xyz[2] + nx*i_xyz[1] + i_xyz[0];
+}
+
+//==============================================================================
+
 int32_t&
 HexLattice::offset(int map, const int i_xyz[3])
 {
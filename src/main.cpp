@@ -43,6 +43,9 @@ int main(int argc, char* argv[]) {
     case RUN_MODE_VOLUME:
       err = openmc_calculate_volumes();
       break;
+    case RUN_MODE_OVERLAP:
+      err = openmc_check_overlaps();
+      break;
   }
   if (err) fatal_error(openmc_err_msg);
 
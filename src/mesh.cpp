@@ -3,6 +3,7 @@
 #include <algorithm> // for copy, min
 #include <cstddef> // for size_t
 #include <cmath>  // for ceil
+#include <cstring> // for strcpy
 #include <string>
 
 #ifdef OPENMC_MPI
@@ -31,16 +32,53 @@ namespace openmc {
 
 namespace model {
 
-std::vector<std::unique_ptr<RegularMesh>> meshes;
+std::vector<std::unique_ptr<Mesh>> meshes;
 std::unordered_map<int32_t, int32_t> mesh_map;
 
 } // namespace model
 
 //==============================================================================
-// RegularMesh implementation
+// Helper functions
 //==============================================================================
 
-RegularMesh::RegularMesh(pugi::xml_node node)
+//! Find the index of the mesh element containing a position along one axis,
+//! where zero and one past the last element are used for positions below and
+//! above the mesh surfaces
+//!
+//! \param[in] grid Positions of the mesh surfaces in increasing order
+//! \param[in] x Position along the axis
+//! \return Index of the mesh element
+int grid_index(const std::vector<double>& grid, double x)
+{
+  return std::lower_bound(grid.begin(), grid.end(), x) - grid.begin();
+}
+
+//! Check that the mesh surfaces along one axis are valid
+//!
+//! \param[in] grid Positions of the mesh surfaces
+//! \param[in] name Name of the axis for error messages
+//! \return Error code
+int check_grid(const std::vector<double>& grid, const std::string& name)
+{
+  if (grid.size() < 2) {
+    set_errmsg("At least two mesh surfaces must be given on <" + name + ">.");
+    return OPENMC_E_INVALID_ARGUMENT;
+  }
+  for (int i = 1; i < grid.size(); ++i) {
+    if (grid[i] <= grid[i - 1]) {
+      set_errmsg("Mesh surfaces on <" + name + "> must be in strictly "
+        "increasing order.");
+      return OPENMC_E_INVALID_ARGUMENT;
+    }
+  }
+  return 0;
+}
+
+//==============================================================================
+// Mesh implementation
+//==============================================================================
+
+Mesh::Mesh(pugi::xml_node node)
 {
   // Copy mesh id
   if (check_for_node(node, "id")) {
@@ -52,17 +90,129 @@ RegularMesh::RegularMesh(pugi::xml_node node)
         std::to_string(id_));
     }
   }
+}
+
+int Mesh::get_bin(Position r) const
+{
+  // Determine indices
+  int ijk[3];
+  bool in_mesh;
+  get_indices(r, ijk, &in_mesh);
+  if (!in_mesh) return -1;
+
+  // Convert indices to bin
+  return get_bin_from_indices(ijk);
+}
+
+int Mesh::get_bin_from_indices(const int* ijk) const
+{
+  switch (n_dimension_) {
+    case 1:
+      return ijk[0];
+    case 2:
+      return (ijk[1] - 1)*shape_[0] + ijk[0];
+    case 3:
+      return ((ijk[2] - 1)*shape_[1] + (ijk[1] - 1))*shape_[0] + ijk[0];
+    default:
+      throw std::runtime_error{"Invalid number of mesh dimensions"};
+  }
+}
+
+void Mesh::get_indices_from_bin(int bin, int* ijk) const
+{
+  if (n_dimension_ == 1) {
+    ijk[0] = bin;
+  } else if (n_dimension_ == 2) {
+    ijk[0] = (bin - 1) % shape_[0] + 1;
+    ijk[1] = (bin - 1) / shape_[0] + 1;
+  } else if (n_dimension_ == 3) {
+    ijk[0] = (bin - 1) % shape_[0] + 1;
+    ijk[1] = ((bin - 1) % (shape_[0] * shape_[1])) / shape_[0] + 1;
+    ijk[2] = (bin - 1) / (shape_[0] * shape_[1]) + 1;
+  }
+}
+
+int Mesh::n_bins() const
+{
+  int n = 1;
+  for (auto dim : shape_) n *= dim;
+  return n;
+}
+
+xt::xarray<double> Mesh::count_sites(int64_t n, const Bank* bank,
+  int n_energy, const double* energies, bool* outside) const
+{
+  // Determine shape of array for counts
+  std::size_t m = n_bins();
+  std::vector<std::size_t> shape;
+  if (n_energy > 0) {
+    shape = {m, static_cast<std::size_t>(n_energy - 1)};
+  } else {
+    shape = {m};
+  }
+
+  // Create array of zeros
+  xt::xarray<double> cnt {shape, 0.0};
+  bool outside_ = false;
+
+  for (int64_t i = 0; i < n; ++i) {
+    // determine scoring bin for entropy mesh
+    // TODO: off-by-one
+    int mesh_bin = get_bin({bank[i].xyz}) - 1;
+
+    // if outside mesh, skip particle
+    if (mesh_bin < 0) {
+      outside_ = true;
+      continue;
+    }
+
+    if (n_energy > 0) {
+      double E = bank[i].E;
+      if (E >= energies[0] && E <= energies[n_energy - 1]) {
+        // determine energy bin
+        int e_bin = lower_bound_index(energies, energies + n_energy, E);
 
-  // Read mesh type
-  if (check_for_node(node, "type")) {
-    auto temp = get_node_value(node, "type", true, true);
-    if (temp == "regular") {
-      // TODO: move elsewhere
+        // Add to appropriate bin
+        cnt(mesh_bin, e_bin) += bank[i].wgt;
+      }
     } else {
-      fatal_error("Invalid mesh type: " + temp);
+      // Add to appropriate bin
+      cnt(mesh_bin) += bank[i].wgt;
     }
   }
 
+  // Create copy of count data
+  int total = cnt.size();
+  double* cnt_reduced = new double[total];
+
+#ifdef OPENMC_MPI
+  // collect values from all processors
+  MPI_Reduce(cnt.data(), cnt_reduced, total, MPI_DOUBLE, MPI_SUM, 0,
+    mpi::intracomm);
+
+  // Check if there were sites outside the mesh for any processor
+  if (outside) {
+    MPI_Reduce(&outside_, outside, 1, MPI_C_BOOL, MPI_LOR, 0, mpi::intracomm);
+  }
+#else
+  std::copy(cnt.data(), cnt.data() + total, cnt_reduced);
+  if (outside) *outside = outside_;
+#endif
+
+  // Adapt reduced values in array back into an xarray
+  auto arr = xt::adapt(cnt_reduced, total, xt::acquire_ownership(), shape);
+  xt::xarray<double> counts = arr;
+
+  return counts;
+}
+
+//==============================================================================
+// RegularMesh implementation
+//==============================================================================
+
+RegularMesh::RegularMesh(pugi::xml_node node)
+  : Mesh {node}
+{
   // Determine number of dimensions for mesh
   if (check_for_node(node, "dimension")) {
     shape_ = get_node_xarray<int>(node, "dimension");
@@ -164,20 +314,6 @@ int RegularMesh::get_bin(Position r) const
   return get_bin_from_indices(ijk);
 }
 
-int RegularMesh::get_bin_from_indices(const int* ijk) const
-{
-  switch (n_dimension_) {
-    case 1:
-      return ijk[0];
-    case 2:
-      return (ijk[1] - 1)*shape_[0] + ijk[0];
-    case 3:
-      return ((ijk[2] - 1)*shape_[1] + (ijk[1] - 1))*shape_[0] + ijk[0];
-    default:
-      throw std::runtime_error{"Invalid number of mesh dimensions"};
-  }
-}
-
 void RegularMesh::get_indices(Position r, int* ijk, bool* in_mesh) const
 {
   // Find particle in mesh
@@ -190,20 +326,6 @@ void RegularMesh::get_indices(Position r, int* ijk, bool* in_mesh) const
   }
 }
 
-void RegularMesh::get_indices_from_bin(int bin, int* ijk) const
-{
-  if (n_dimension_ == 1) {
-    ijk[0] = bin;
-  } else if (n_dimension_ == 2) {
-    ijk[0] = (bin - 1) % shape_[0] + 1;
-    ijk[1] = (bin - 1) / shape_[0] + 1;
-  } else if (n_dimension_ == 3) {
-    ijk[0] = (bin - 1) % shape_[0] + 1;
-    ijk[1] = ((bin - 1) % (shape_[0] * shape_[1])) / shape_[0] + 1;
-    ijk[2] = (bin - 1) / (shape_[0] * shape_[1]) + 1;
-  }
-}
-
 bool RegularMesh::intersects(Position r0, Position r1) const
 {
   switch(n_dimension_) {
@@ -376,143 +498,157 @@ bool RegularMesh::intersects_3d(Position r0, Position r1) const
 void RegularMesh::bins_crossed(const Particle* p, std::vector<int>& bins,
                                std::vector<double>& lengths) const
 {
-  constexpr int MAX_SEARCH_ITER = 100;
+  switch (n_dimension_) {
+    case 1:
+      bins_crossed_dda<1>(p, bins, lengths);
+      break;
+    case 2:
+      bins_crossed_dda<2>(p, bins, lengths);
+      break;
+    case 3:
+      bins_crossed_dda<3>(p, bins, lengths);
+      break;
+  }
+}
+
+template<int N> void
+RegularMesh::bins_crossed_dda(const Particle* p, std::vector<int>& bins,
+                              std::vector<double>& lengths) const
+{
+  // Copy the mesh parameters onto the stack since they are used at every mesh
+  // surface crossing
+  std::array<double, N> lower_left;
+  std::array<double, N> upper_right;
+  std::array<double, N> width;
+  std::array<int, N> shape;
+  for (int i = 0; i < N; ++i) {
+    lower_left[i] = lower_left_[i];
+    upper_right[i] = upper_right_[i];
+    width[i] = width_[i];
+    shape[i] = shape_[i];
+  }
 
   // ========================================================================
-  // Determine if the track intersects the tally mesh.
+  // Determine indices for the starting and ending location.
 
-  // Copy the starting and ending coordinates of the particle.  Offset these
-  // just a bit for the purposes of determining if there was an intersection
-  // in case the mesh surfaces coincide with lattice/geometric surfaces which
-  // might produce finite-precision errors.
-  Position last_r {p->last_xyz};
-  Position r {p->coord[0].xyz};
+  // The indices are found with the coordinates offset just a bit in case the
+  // mesh surfaces coincide with lattice/geometric surfaces which might produce
+  // finite-precision errors.
+  Position r0 {p->last_xyz};
+  Position r1 {p->coord[0].xyz};
   Direction u {p->coord[0].uvw};
 
-  Position r0 = last_r + TINY_BIT*u;
-  Position r1 = r - TINY_BIT*u;
-
-  // Determine indices for starting and ending location.
-  int n = n_dimension_;
-  xt::xtensor<int, 1> ijk0 = xt::empty<int>({n});
-  bool start_in_mesh;
-  get_indices(r0, ijk0.data(), &start_in_mesh);
-  xt::xtensor<int, 1> ijk1 = xt::empty<int>({n});
-  bool end_in_mesh;
-  get_indices(r1, ijk1.data(), &end_in_mesh);
-
-  // Check if the track intersects any part of the mesh.
-  if (!start_in_mesh && !end_in_mesh) {
-    if (!intersects(r0, r1)) return;
+  Position r0_nudged = r0 + TINY_BIT*u;
+  Position r1_nudged = r1 - TINY_BIT*u;
+
+  std::array<int, N> ijk0;
+  std::array<int, N> ijk1;
+  bool start_in_mesh = true;
+  bool end_in_mesh = true;
+  for (int i = 0; i < N; ++i) {
+    ijk0[i] = std::ceil((r0_nudged[i] - lower_left[i]) / width[i]);
+    ijk1[i] = std::ceil((r1_nudged[i] - lower_left[i]) / width[i]);
+    if (ijk0[i] < 1 || ijk0[i] > shape[i]) start_in_mesh = false;
+    if (ijk1[i] < 1 || ijk1[i] > shape[i]) end_in_mesh = false;
   }
 
-  // ========================================================================
-  // Figure out which mesh cell to tally.
-
-  // Copy the un-modified coordinates the particle direction.
-  r0 = last_r;
-  r1 = r;
-
   // Compute the length of the entire track.
   double total_distance = (r1 - r0).norm();
 
-  // We are looking for the first valid mesh bin.  Check to see if the
-  // particle starts inside the mesh.
-  if (!start_in_mesh) {
-    xt::xtensor<double, 1> d = xt::zeros<double>({n});
+  // ========================================================================
+  // Find the distance along the track at which it enters the mesh.
 
-    // The particle does not start in the mesh.  Note that we nudged the
-    // start and end coordinates by a TINY_BIT each so we will have
-    // difficulty resolving tracks that are less than 2*TINY_BIT in length.
-    // If the track is that short, it is also insignificant so we can
-    // safely ignore it in the tallies.
+  double t = 0.0;
+  if (!start_in_mesh) {
+    // Note that we nudged the start and end coordinates by a TINY_BIT each so
+    // we will have difficulty resolving tracks that are less than 2*TINY_BIT
+    // in length.  If the track is that short, it is also insignificant so we
+    // can safely ignore it in the tallies.
     if (total_distance < 2*TINY_BIT) return;
 
-    // The particle does not start in the mesh so keep iterating the ijk0
-    // indices to cross the nearest mesh surface until we've found a valid
-    // bin.  MAX_SEARCH_ITER prevents an infinite loop.
-    int search_iter = 0;
-    int j;
-    while (xt::any(ijk0 < 1) || xt::any(ijk0 > shape_)) {
-      if (search_iter == MAX_SEARCH_ITER) {
-        warning("Failed to find a mesh intersection on a tally mesh filter.");
-        return;
-      }
-
-      for (j = 0; j < n; ++j) {
-        if (std::fabs(u[j]) < FP_PRECISION) {
-          d(j) = INFTY;
-        } else if (u[j] > 0.0) {
-          double xyz_cross = lower_left_[j] + ijk0(j) * width_[j];
-          d(j) = (xyz_cross - r0[j]) / u[j];
-        } else {
-          double xyz_cross = lower_left_[j] + (ijk0(j) - 1) * width_[j];
-          d(j) = (xyz_cross - r0[j]) / u[j];
-        }
-      }
-
-      j = xt::argmin(d)(0);
-      if (u[j] > 0.0) {
-        ++ijk0(j);
-      } else {
-        --ijk0(j);
+    // Clip the track against the slab between the lower and upper mesh
+    // surfaces in each dimension.
+    double t_exit = total_distance;
+    for (int i = 0; i < N; ++i) {
+      if (std::fabs(u[i]) < FP_PRECISION) {
+        if (r0[i] < lower_left[i] || r0[i] > upper_right[i]) return;
+        continue;
       }
-
-      ++search_iter;
+      double t_lower = (lower_left[i] - r0[i]) / u[i];
+      double t_upper = (upper_right[i] - r0[i]) / u[i];
+      t = std::max(t, std::min(t_lower, t_upper));
+      t_exit = std::min(t_exit, std::max(t_lower, t_upper));
+    }
+    if (t >= t_exit) return;
+
+    // Find the mesh cell that the track enters.  The entry point lies on a
+    // mesh surface, so the cell ahead of the particle is chosen and the
+    // indices are clamped to the mesh in case of round-off.
+    for (int i = 0; i < N; ++i) {
+      double x = (r0[i] + t*u[i] - lower_left[i]) / width[i];
+      ijk0[i] = (u[i] > 0.0) ? std::floor(x) + 1 : std::ceil(x);
+      ijk0[i] = std::min(std::max(ijk0[i], 1), shape[i]);
     }
+  }
 
-    // Advance position
-    r0 += d(j) * u;
+  // ========================================================================
+  // Walk through the mesh cells crossed by the track.
+
+  // Distance along the track to the next mesh surface in each dimension and
+  // the distance between successive surfaces
+  std::array<double, N> t_max;
+  std::array<double, N> t_delta;
+  std::array<int, N> step;
+  for (int i = 0; i < N; ++i) {
+    if (std::fabs(u[i]) < FP_PRECISION) {
+      t_max[i] = INFTY;
+      t_delta[i] = INFTY;
+      step[i] = 0;
+    } else if (u[i] > 0.0) {
+      t_max[i] = (lower_left[i] + ijk0[i]*width[i] - r0[i]) / u[i];
+      t_delta[i] = width[i] / u[i];
+      step[i] = 1;
+    } else {
+      t_max[i] = (lower_left[i] + (ijk0[i] - 1)*width[i] - r0[i]) / u[i];
+      t_delta[i] = -width[i] / u[i];
+      step[i] = -1;
+    }
   }
 
+  // Bins are numbered starting at one with the first dimension varying
+  // fastest
+  std::array<int, N> stride;
+  stride[0] = 1;
+  for (int i = 1; i < N; ++i) stride[i] = stride[i - 1]*shape[i - 1];
+  int bin = 1;
+  for (int i = 0; i < N; ++i) bin += (ijk0[i] - 1)*stride[i];
+
   while (true) {
-    // ========================================================================
-    // Compute the length of the track segment in the each mesh cell and return
+    // Find the closest mesh surface
+    int j = 0;
+    for (int i = 1; i < N; ++i) {
+      if (t_max[i] < t_max[j]) j = i;
+    }
 
-    if (ijk0 == ijk1) {
+    if (ijk0 == ijk1 || t_max[j] >= total_distance) {
       // The track ends in this cell.  Use the particle end location rather
       // than the mesh surface.
-      double distance = (r1 - r0).norm();
-      bins.push_back(get_bin_from_indices(ijk0.data()));
-      lengths.push_back(distance / total_distance);
+      bins.push_back(bin);
+      lengths.push_back((total_distance - t) / total_distance);
       break;
     }
 
-    // The track exits this cell.  Determine the distance to the closest mesh
-    // surface.
-    xt::xtensor<double, 1> d = xt::zeros<double>({n});
-    for (int k = 0; k < n; ++k) {
-      if (std::fabs(u[k]) < FP_PRECISION) {
-        d(k) = INFTY;
-      } else if (u[k] > 0) {
-        double xyz_cross = lower_left_[k] + ijk0(k) * width_[k];
-        d(k) = (xyz_cross - r0[k]) / u[k];
-      } else {
-        double xyz_cross = lower_left_[k] + (ijk0(k) - 1) * width_[k];
-        d(k) = (xyz_cross - r0[k]) / u[k];
-      }
-    }
-
-    // Assign the next tally bin and the score.
-    auto j = xt::argmin(d)(0);
-    double distance = d(j);
-    bins.push_back(get_bin_from_indices(ijk0.data()));
-    lengths.push_back(distance / total_distance);
-
-    // Translate the starting coordintes by the distance to the oncoming mesh
-    // surface.
-    r0 += distance * u;
-
-    // Increment the indices into the next mesh cell.
-    if (u[j] > 0.0) {
-      ++ijk0(j);
-    } else {
-      --ijk0(j);
-    }
-
-    // If the next indices are invalid, then the track has left the mesh and
-    // we are done.
-    if (xt::any(ijk0 < 1) || xt::any(ijk0 > shape_)) break;
+    // The track exits this cell through the closest mesh surface.
+    bins.push_back(bin);
+    lengths.push_back((t_max[j] - t) / total_distance);
+    t = t_max[j];
+
+    // Move into the next mesh cell.  If the next indices are invalid, then
+    // the track has left the mesh and we are done.
+    ijk0[j] += step[j];
+    if (ijk0[j] < 1 || ijk0[j] > shape[j]) break;
+    bin += step[j]*stride[j];
+    t_max[j] += t_delta[j];
   }
 }
 
@@ -652,78 +788,501 @@ void RegularMesh::to_hdf5(hid_t group) const
   close_group(mesh_group);
 }
 
-xt::xarray<double> RegularMesh::count_sites(int64_t n, const Bank* bank,
-  int n_energy, const double* energies, bool* outside) const
+std::vector<double> RegularMesh::grid(int i) const
 {
-  // Determine shape of array for counts
-  std::size_t m = xt::prod(shape_)();
-  std::vector<std::size_t> shape;
-  if (n_energy > 0) {
-    shape = {m, static_cast<std::size_t>(n_energy - 1)};
-  } else {
-    shape = {m};
+  std::vector<double> g;
+  for (int j = 0; j <= shape_[i]; ++j) {
+    g.push_back(lower_left_[i] + j*width_[i]);
   }
+  return g;
+}
 
-  // Create array of zeros
-  xt::xarray<double> cnt {shape, 0.0};
-  bool outside_ = false;
+//==============================================================================
+// RectilinearMesh implementation
+//==============================================================================
 
-  for (int64_t i = 0; i < n; ++i) {
-    // determine scoring bin for entropy mesh
-    // TODO: off-by-one
-    int mesh_bin = get_bin({bank[i].xyz}) - 1;
+RectilinearMesh::RectilinearMesh(pugi::xml_node node)
+  : Mesh {node}
+{
+  std::array<std::vector<double>, 3> grid;
+  const char* names[] {"x_grid", "y_grid", "z_grid"};
+  for (int i = 0; i < 3; ++i) {
+    if (!check_for_node(node, names[i])) {
+      fatal_error(std::string{"Must specify <"} + names[i] + "> on a "
+        "rectilinear mesh.");
+    }
+    grid[i] = get_node_array<double>(node, names[i]);
+  }
 
-    // if outside mesh, skip particle
-    if (mesh_bin < 0) {
-      outside_ = true;
-      continue;
+  if (set_grid(grid) != 0) fatal_error(openmc_err_msg);
+}
+
+int RectilinearMesh::set_grid(std::array<std::vector<double>, 3> grid)
+{
+  const char* names[] {"x_grid", "y_grid", "z_grid"};
+  for (int i = 0; i < 3; ++i) {
+    int err = check_grid(grid[i], names[i]);
+    if (err) return err;
+  }
+
+  grid_ = std::move(grid);
+  n_dimension_ = 3;
+  shape_ = {static_cast<int>(grid_[0].size()) - 1,
+    static_cast<int>(grid_[1].size()) - 1,
+    static_cast<int>(grid_[2].size()) - 1};
+  return 0;
+}
+
+void RectilinearMesh::get_indices(Position r, int* ijk, bool* in_mesh) const
+{
+  *in_mesh = true;
+  for (int i = 0; i < 3; ++i) {
+    ijk[i] = grid_index(grid_[i], r[i]);
+    if (ijk[i] < 1 || ijk[i] > shape_[i]) *in_mesh = false;
+  }
+}
+
+double RectilinearMesh::volume_frac(int bin) const
+{
+  int ijk[3];
+  get_indices_from_bin(bin, ijk);
+
+  double frac = 1.0;
+  for (int i = 0; i < 3; ++i) {
+    const auto& g {grid_[i]};
+    frac *= (g[ijk[i]] - g[ijk[i] - 1]) / (g.back() - g.front());
+  }
+  return frac;
+}
+
+void RectilinearMesh::bins_crossed(const Particle* p, std::vector<int>& bins,
+                                   std::vector<double>& lengths) const
+{
+  // ========================================================================
+  // Determine indices for the starting and ending location.
+
+  // As for regular meshes, the indices are found with the coordinates offset
+  // just a bit in case mesh surfaces coincide with geometric surfaces.
+  Position r0 {p->last_xyz};
+  Position r1 {p->coord[0].xyz};
+  Direction u {p->coord[0].uvw};
+
+  std::array<int, 3> ijk0;
+  std::array<int, 3> ijk1;
+  bool start_in_mesh;
+  bool end_in_mesh;
+  get_indices(r0 + TINY_BIT*u, ijk0.data(), &start_in_mesh);
+  get_indices(r1 - TINY_BIT*u, ijk1.data(), &end_in_mesh);
+
+  // Compute the length of the entire track.
+  double total_distance = (r1 - r0).norm();
+
+  // ========================================================================
+  // Find the distance along the track at which it enters the mesh.
+
+  double t = 0.0;
+  if (!start_in_mesh) {
+    // Tracks less than 2*TINY_BIT in length are ignored.
+    if (total_distance < 2*TINY_BIT) return;
+
+    // Clip the track against the outer mesh surfaces in each dimension.
+    double t_exit = total_distance;
+    for (int i = 0; i < 3; ++i) {
+      const auto& g {grid_[i]};
+      if (std::fabs(u[i]) < FP_PRECISION) {
+        if (r0[i] < g.front() || r0[i] > g.back()) return;
+        continue;
+      }
+      double t_lower = (g.front() - r0[i]) / u[i];
+      double t_upper = (g.back() - r0[i]) / u[i];
+      t = std::max(t, std::min(t_lower, t_upper));
+      t_exit = std::min(t_exit, std::max(t_lower, t_upper));
+    }
+    if (t >= t_exit) return;
+
+    // Find the mesh element ahead of the entry point, clamping the indices to
+    // the mesh in case of round-off.
+    for (int i = 0; i < 3; ++i) {
+      const auto& g {grid_[i]};
+      double x = r0[i] + t*u[i];
+      ijk0[i] = (u[i] > 0.0) ?
+        std::upper_bound(g.begin(), g.end(), x) - g.begin() : grid_index(g, x);
+      ijk0[i] = std::min(std::max(ijk0[i], 1), shape_[i]);
+    }
+  }
+
+  // ========================================================================
+  // Walk through the mesh elements crossed by the track.
+
+  // Distance along the track to the next mesh surface in each dimension
+  auto next_surface = [&](int i) {
+    if (std::fabs(u[i]) < FP_PRECISION) return INFTY;
+    double x = (u[i] > 0.0) ? grid_[i][ijk0[i]] : grid_[i][ijk0[i] - 1];
+    return (x - r0[i]) / u[i];
+  };
+  std::array<double, 3> t_max;
+  for (int i = 0; i < 3; ++i) t_max[i] = next_surface(i);
+
+  while (true) {
+    // Find the closest mesh surface
+    int j = 0;
+    for (int i = 1; i < 3; ++i) {
+      if (t_max[i] < t_max[j]) j = i;
     }
 
-    if (n_energy > 0) {
-      double E = bank[i].E;
-      if (E >= energies[0] && E <= energies[n_energy - 1]) {
-        // determine energy bin
-        int e_bin = lower_bound_index(energies, energies + n_energy, E);
+    int bin = get_bin_from_indices(ijk0.data());
+    if (ijk0 == ijk1 || t_max[j] >= total_distance) {
+      // The track ends in this element.
+      bins.push_back(bin);
+      lengths.push_back((total_distance - t) / total_distance);
+      break;
+    }
 
-        // Add to appropriate bin
-        cnt(mesh_bin, e_bin) += bank[i].wgt;
+    // The track exits this element through the closest mesh surface.
+    bins.push_back(bin);
+    lengths.push_back((t_max[j] - t) / total_distance);
+    t = t_max[j];
+
+    // Move into the next mesh element unless the track leaves the mesh.
+    ijk0[j] += (u[j] > 0.0) ? 1 : -1;
+    if (ijk0[j] < 1 || ijk0[j] > shape_[j]) break;
+    t_max[j] = next_surface(j);
+  }
+}
+
+void RectilinearMesh::surface_bins_crossed(const Particle* p,
+                                           std::vector<int>& bins) const
+{
+  // Copy the starting and ending coordinates of the particle.
+  Position r0 {p->last_xyz_current};
+  Position r1 {p->coord[0].xyz};
+  Direction u {p->coord[0].uvw};
+
+  // Determine indices for starting and ending location. Positions below or
+  // above the mesh have an index of zero or one past the last element, so the
+  // mesh surfaces crossed in each dimension lie between the two indices.
+  std::array<int, 3> ijk0;
+  std::array<int, 3> ijk1;
+  bool in_mesh;
+  bool end_in_mesh;
+  get_indices(r0, ijk0.data(), &in_mesh);
+  get_indices(r1, ijk1.data(), &end_in_mesh);
+
+  while (ijk0 != ijk1) {
+    // Find the closest mesh surface among the dimensions that still have
+    // surfaces to cross
+    int j = -1;
+    double distance = INFTY;
+    for (int i = 0; i < 3; ++i) {
+      if (ijk0[i] == ijk1[i] || u[i] == 0.0) continue;
+      double x = (ijk1[i] > ijk0[i]) ? grid_[i][ijk0[i]] : grid_[i][ijk0[i] - 1];
+      double d = (x - r0[i]) / u[i];
+      if (d < distance) {
+        distance = d;
+        j = i;
       }
+    }
+    if (j < 0) break;
+
+    // Tally the outward current on the surface of the element being left and
+    // the inward current on the surface of the element being entered
+    bool positive = ijk1[j] > ijk0[j];
+    if (in_mesh) {
+      int i_surf = positive ? 4*j + 3 : 4*j + 1;
+      bins.push_back(4*3*(get_bin_from_indices(ijk0.data()) - 1) + i_surf);
+    }
+
+    ijk0[j] += positive ? 1 : -1;
+    in_mesh = true;
+    for (int i = 0; i < 3; ++i) {
+      if (ijk0[i] < 1 || ijk0[i] > shape_[i]) in_mesh = false;
+    }
+
+    if (in_mesh) {
+      int i_surf = positive ? 4*j + 2 : 4*j + 4;
+      bins.push_back(4*3*(get_bin_from_indices(ijk0.data()) - 1) + i_surf);
+    }
+  }
+}
+
+void RectilinearMesh::to_hdf5(hid_t group) const
+{
+  hid_t mesh_group = create_group(group, "mesh " + std::to_string(id_));
+
+  write_dataset(mesh_group, "type", "rectilinear");
+  write_dataset(mesh_group, "dimension", shape_);
+  write_dataset(mesh_group, "x_grid", grid_[0]);
+  write_dataset(mesh_group, "y_grid", grid_[1]);
+  write_dataset(mesh_group, "z_grid", grid_[2]);
+
+  close_group(mesh_group);
+}
+
+//==============================================================================
+// CylindricalMesh implementation
+//==============================================================================
+
+CylindricalMesh::CylindricalMesh(pugi::xml_node node)
+  : Mesh {node}
+{
+  std::array<std::vector<double>, 3> grid;
+  const char* names[] {"r_grid", "phi_grid", "z_grid"};
+  for (int i = 0; i < 3; ++i) {
+    if (check_for_node(node, names[i])) {
+      grid[i] = get_node_array<double>(node, names[i]);
+    } else if (i == 1) {
+      // By default, the mesh covers every azimuthal angle
+      grid[i] = {0.0, 2.0*PI};
     } else {
-      // Add to appropriate bin
-      cnt(mesh_bin) += bank[i].wgt;
+      fatal_error(std::string{"Must specify <"} + names[i] + "> on a "
+        "cylindrical mesh.");
     }
   }
 
-  // Create copy of count data
-  int total = cnt.size();
-  double* cnt_reduced = new double[total];
+  if (check_for_node(node, "origin")) {
+    auto origin = get_node_array<double>(node, "origin");
+    if (origin.size() != 3) {
+      fatal_error("Origin of a cylindrical mesh must have three coordinates.");
+    }
+    origin_ = Position{origin.data()};
+  }
 
-#ifdef OPENMC_MPI
-  // collect values from all processors
-  MPI_Reduce(cnt.data(), cnt_reduced, total, MPI_DOUBLE, MPI_SUM, 0,
-    mpi::intracomm);
+  if (set_grid(grid) != 0) fatal_error(openmc_err_msg);
+}
 
-  // Check if there were sites outside the mesh for any processor
-  if (outside) {
-    MPI_Reduce(&outside_, outside, 1, MPI_C_BOOL, MPI_LOR, 0, mpi::intracomm);
+int CylindricalMesh::set_grid(std::array<std::vector<double>, 3> grid)
+{
+  const char* names[] {"r_grid", "phi_grid", "z_grid"};
+  for (int i = 0; i < 3; ++i) {
+    int err = check_grid(grid[i], names[i]);
+    if (err) return err;
+  }
+  if (grid[0].front() < 0.0) {
+    set_errmsg("Radii on <r_grid> must not be negative.");
+    return OPENMC_E_INVALID_ARGUMENT;
+  }
+  if (grid[1].front() < 0.0 || grid[1].back() > 2.0*PI) {
+    set_errmsg("Angles on <phi_grid> must be between 0 and 2*pi.");
+    return OPENMC_E_INVALID_ARGUMENT;
   }
-#else
-  std::copy(cnt.data(), cnt.data() + total, cnt_reduced);
-  if (outside) *outside = outside_;
-#endif
 
-  // Adapt reduced values in array back into an xarray
-  auto arr = xt::adapt(cnt_reduced, total, xt::acquire_ownership(), shape);
-  xt::xarray<double> counts = arr;
+  grid_ = std::move(grid);
+  n_dimension_ = 3;
+  shape_ = {static_cast<int>(grid_[0].size()) - 1,
+    static_cast<int>(grid_[1].size()) - 1,
+    static_cast<int>(grid_[2].size()) - 1};
+  full_phi_ = grid_[1].front() == 0.0 &&
+    grid_[1].back() >= 2.0*PI - FP_COINCIDENT;
+  return 0;
+}
 
-  return counts;
+bool CylindricalMesh::local_indices(Position r, int* ijk) const
+{
+  // Radial index, where the axis itself is inside the mesh if the first
+  // radius is zero
+  double rho = std::sqrt(r.x*r.x + r.y*r.y);
+  ijk[0] = grid_index(grid_[0], rho);
+  if (ijk[0] == 0 && rho == grid_[0].front()) ijk[0] = 1;
+
+  // Azimuthal index, where each element includes its lower angle
+  double phi = std::atan2(r.y, r.x);
+  if (phi < 0.0) phi += 2.0*PI;
+  const auto& g {grid_[1]};
+  ijk[1] = std::upper_bound(g.begin(), g.end(), phi) - g.begin();
+  if (full_phi_) ijk[1] = std::min(std::max(ijk[1], 1), shape_[1]);
+
+  // Axial index
+  ijk[2] = grid_index(grid_[2], r.z);
+
+  for (int i = 0; i < 3; ++i) {
+    if (ijk[i] < 1 || ijk[i] > shape_[i]) return false;
+  }
+  return true;
+}
+
+void CylindricalMesh::get_indices(Position r, int* ijk, bool* in_mesh) const
+{
+  *in_mesh = local_indices(r - origin_, ijk);
+}
+
+double CylindricalMesh::volume_frac(int bin) const
+{
+  int ijk[3];
+  get_indices_from_bin(bin, ijk);
+
+  const auto& r {grid_[0]};
+  const auto& phi {grid_[1]};
+  const auto& z {grid_[2]};
+  int i = ijk[0];
+  int j = ijk[1];
+  int k = ijk[2];
+  return (r[i]*r[i] - r[i-1]*r[i-1]) / (r.back()*r.back() - r[0]*r[0])
+    * (phi[j] - phi[j-1]) / (phi.back() - phi.front())
+    * (z[k] - z[k-1]) / (z.back() - z.front());
+}
+
+double CylindricalMesh::distance_to_surface(Position r, Direction u,
+  const int* ijk, int* i_dim, bool* lower) const
+{
+  double distance = INFTY;
+  auto update = [&](double d, int i, bool is_lower) {
+    if (d > 0.0 && d < distance) {
+      distance = d;
+      *i_dim = i;
+      *lower = is_lower;
+    }
+  };
+
+  // Cylinders bounding the element, where the inner cylinder can only be
+  // crossed while moving toward the axis
+  double a = u.x*u.x + u.y*u.y;
+  if (a > 0.0) {
+    const auto& g {grid_[0]};
+    double k = r.x*u.x + r.y*u.y;
+    double rho2 = r.x*r.x + r.y*r.y;
+    if (ijk[0] >= 1 && g[ijk[0] - 1] > 0.0 && k < 0.0) {
+      double quad = k*k - a*(rho2 - g[ijk[0] - 1]*g[ijk[0] - 1]);
+      if (quad >= 0.0) update((-k - std::sqrt(quad)) / a, 0, true);
+    }
+    if (ijk[0] <= shape_[0]) {
+      double quad = k*k - a*(rho2 - g[ijk[0]]*g[ijk[0]]);
+      if (quad >= 0.0) update((-k + std::sqrt(quad)) / a, 0, false);
+    }
+  }
+
+  // Half-planes bounding the element in azimuth. Outside of the mesh, the
+  // element is the wedge between the last and first angles.
+  if (!(full_phi_ && shape_[1] == 1)) {
+    const auto& g {grid_[1]};
+    bool inside = ijk[1] >= 1 && ijk[1] <= shape_[1];
+    double phi[] {inside ? g[ijk[1] - 1] : g.back(),
+      inside ? g[ijk[1]] : g.front()};
+    for (int m = 0; m < 2; ++m) {
+      double c = std::cos(phi[m]);
+      double s = std::sin(phi[m]);
+      double denom = c*u.y - s*u.x;
+      if (denom == 0.0) continue;
+      double d = (s*r.x - c*r.y) / denom;
+
+      // Make sure the ray crosses the half-plane rather than its extension
+      // through the axis
+      if (c*(r.x + d*u.x) + s*(r.y + d*u.y) < 0.0) continue;
+      update(d, 1, m == 0);
+    }
+  }
+
+  // Planes bounding the element in z
+  if (u.z < 0.0 && ijk[2] >= 1) {
+    update((grid_[2][ijk[2] - 1] - r.z) / u.z, 2, true);
+  } else if (u.z > 0.0 && ijk[2] <= shape_[2]) {
+    update((grid_[2][ijk[2]] - r.z) / u.z, 2, false);
+  }
+
+  return distance;
+}
+
+void CylindricalMesh::bins_crossed(const Particle* p, std::vector<int>& bins,
+                                   std::vector<double>& lengths) const
+{
+  Position r0 = Position{p->last_xyz} - origin_;
+  Position r1 = Position{p->coord[0].xyz} - origin_;
+  Direction u {p->coord[0].uvw};
+
+  // Tracks less than 2*TINY_BIT in length are ignored as for regular meshes.
+  double total_distance = (r1 - r0).norm();
+  if (total_distance < 2*TINY_BIT) return;
+
+  // Walk along the track from one mesh surface to the next. A cylinder can be
+  // crossed twice and the azimuthal surfaces all meet on the axis, so rather
+  // than stepping the indices, the element beyond each surface is found a
+  // TINY_BIT past it. This also resolves mesh surfaces that coincide with
+  // geometric surfaces.
+  auto n_start = bins.size();
+  double t = 0.0;
+  while (t < total_distance) {
+    Position r = r0 + (t + TINY_BIT)*u;
+    int ijk[3];
+    bool in_mesh = local_indices(r, ijk);
+
+    int i_dim;
+    bool lower;
+    double d = distance_to_surface(r, u, ijk, &i_dim, &lower);
+    double t_next = std::min(t + TINY_BIT + d, total_distance);
+
+    if (in_mesh) {
+      // Elements split by a surface on the axis are only scored once
+      int bin = get_bin_from_indices(ijk);
+      double length = (t_next - t) / total_distance;
+      if (bins.size() > n_start && bins.back() == bin) {
+        lengths.back() += length;
+      } else {
+        bins.push_back(bin);
+        lengths.push_back(length);
+      }
+    }
+    t = t_next;
+  }
+}
+
+void CylindricalMesh::surface_bins_crossed(const Particle* p,
+                                           std::vector<int>& bins) const
+{
+  Position r0 = Position{p->last_xyz_current} - origin_;
+  Position r1 = Position{p->coord[0].xyz} - origin_;
+  Direction u {p->coord[0].uvw};
+
+  double total_distance = (r1 - r0).norm();
+  if (total_distance < 2*TINY_BIT) return;
+
+  // Walk along the track from one mesh surface to the next as in
+  // bins_crossed().
+  double t = TINY_BIT;
+  Position r = r0 + t*u;
+  int ijk[3];
+  bool in_mesh = local_indices(r, ijk);
+  while (true) {
+    int i_dim;
+    bool lower;
+    double d = distance_to_surface(r, u, ijk, &i_dim, &lower);
+    if (t + d > total_distance) break;
+
+    // Outward current on the surface of the element being left
+    if (in_mesh) {
+      int i_surf = lower ? 4*i_dim + 1 : 4*i_dim + 3;
+      bins.push_back(4*3*(get_bin_from_indices(ijk) - 1) + i_surf);
+    }
+
+    t += d + TINY_BIT;
+    r = r0 + t*u;
+    in_mesh = local_indices(r, ijk);
+
+    // Inward current on the surface of the element being entered
+    if (in_mesh) {
+      int i_surf = lower ? 4*i_dim + 4 : 4*i_dim + 2;
+      bins.push_back(4*3*(get_bin_from_indices(ijk) - 1) + i_surf);
+    }
+  }
+}
+
+void CylindricalMesh::to_hdf5(hid_t group) const
+{
+  hid_t mesh_group = create_group(group, "mesh " + std::to_string(id_));
+
+  write_dataset(mesh_group, "type", "cylindrical");
+  write_dataset(mesh_group, "dimension", shape_);
+  write_dataset(mesh_group, "r_grid", grid_[0]);
+  write_dataset(mesh_group, "phi_grid", grid_[1]);
+  write_dataset(mesh_group, "z_grid", grid_[2]);
+  write_dataset(mesh_group, "origin", origin_);
+
+  close_group(mesh_group);
 }
 
 //==============================================================================
 // C API functions
 //==============================================================================
 
-//! Extend the meshes array by n elements
+//! Extend the meshes array by n regular meshes
 extern "C" int
 openmc_extend_meshes(int32_t n, int32_t* index_start, int32_t* index_end)
 {
@@ -774,6 +1333,51 @@ openmc_mesh_set_id(int32_t index, int32_t id)
   return 0;
 }
 
+//! Get the type of a mesh
+extern "C" int
+openmc_mesh_get_type(int32_t index, char* type)
+{
+  if (index < 0 || index >= model::meshes.size()) {
+    set_errmsg("Index in meshes array is out of bounds.");
+    return OPENMC_E_OUT_OF_BOUNDS;
+  }
+
+  const auto* m = model::meshes[index].get();
+  if (dynamic_cast<const RectilinearMesh*>(m)) {
+    std::strcpy(type, "rectilinear");
+  } else if (dynamic_cast<const CylindricalMesh*>(m)) {
+    std::strcpy(type, "cylindrical");
+  } else {
+    std::strcpy(type, "regular");
+  }
+  return 0;
+}
+
+//! Replace a mesh with an empty mesh of a given type that has the same ID
+extern "C" int
+openmc_mesh_set_type(int32_t index, const char* type)
+{
+  if (index < 0 || index >= model::meshes.size()) {
+    set_errmsg("Index in meshes array is out of bounds.");
+    return OPENMC_E_OUT_OF_BOUNDS;
+  }
+
+  std::unique_ptr<Mesh> mesh;
+  if (std::strcmp(type, "regular") == 0) {
+    mesh.reset(new RegularMesh{});
+  } else if (std::strcmp(type, "rectilinear") == 0) {
+    mesh.reset(new RectilinearMesh{});
+  } else if (std::strcmp(type, "cylindrical") == 0) {
+    mesh.reset(new CylindricalMesh{});
+  } else {
+    set_errmsg("Unknown mesh type: " + std::string{type});
+    return OPENMC_E_INVALID_ARGUMENT;
+  }
+  mesh->id_ = model::meshes[index]->id_;
+  model::meshes[index] = std::move(mesh);
+  return 0;
+}
+
 //! Get the dimension of a mesh
 extern "C" int
 openmc_mesh_get_dimension(int32_t index, int** dims, int* n)
@@ -796,9 +1400,15 @@ openmc_mesh_set_dimension(int32_t index, int n, const int* dims)
     return OPENMC_E_OUT_OF_BOUNDS;
   }
 
+  auto m = dynamic_cast<RegularMesh*>(model::meshes[index].get());
+  if (!m) {
+    set_errmsg("Tried to set the dimension of a mesh that is not a regular "
+      "mesh.");
+    return OPENMC_E_INVALID_TYPE;
+  }
+
   // Copy dimension
   std::vector<std::size_t> shape = {static_cast<std::size_t>(n)};
-  auto& m = model::meshes[index];
   m->shape_ = xt::adapt(dims, n, xt::no_ownership(), shape);
   m->n_dimension_ = m->shape_.size();
 
@@ -814,7 +1424,12 @@ openmc_mesh_get_params(int32_t index, double** ll, double** ur, double** width,
     return OPENMC_E_OUT_OF_BOUNDS;
   }
 
-  auto& m = model::meshes[index];
+  auto m = dynamic_cast<RegularMesh*>(model::meshes[index].get());
+  if (!m) {
+    set_errmsg("Tried to get the parameters of a mesh that is not a regular "
+      "mesh.");
+    return OPENMC_E_INVALID_TYPE;
+  }
   if (m->lower_left_.dimension() == 0) {
     set_errmsg("Mesh parameters have not been set.");
     return OPENMC_E_ALLOCATE;
@@ -837,7 +1452,13 @@ openmc_mesh_set_params(int32_t index, int n, const double* ll, const double* ur,
     return OPENMC_E_OUT_OF_BOUNDS;
   }
 
-  auto& m = model::meshes[index];
+  auto m = dynamic_cast<RegularMesh*>(model::meshes[index].get());
+  if (!m) {
+    set_errmsg("Tried to set the parameters of a mesh that is not a regular "
+      "mesh.");
+    return OPENMC_E_INVALID_TYPE;
+  }
+
   std::vector<std::size_t> shape = {static_cast<std::size_t>(n)};
   if (ll && ur) {
     m->lower_left_ = xt::adapt(ll, n, xt::no_ownership(), shape);
@@ -859,6 +1480,117 @@ openmc_mesh_set_params(int32_t index, int n, const double* ll, const double* ur,
   return 0;
 }
 
+//! Get the mesh surfaces of a rectilinear mesh
+extern "C" int
+openmc_rectilinear_mesh_get_grid(int32_t index, double** grid_x, int* nx,
+  double** grid_y, int* ny, double** grid_z, int* nz)
+{
+  if (index < 0 || index >= model::meshes.size()) {
+    set_errmsg("Index in meshes array is out of bounds.");
+    return OPENMC_E_OUT_OF_BOUNDS;
+  }
+
+  auto m = dynamic_cast<RectilinearMesh*>(model::meshes[index].get());
+  if (!m) {
+    set_errmsg("Tried to get the grid of a mesh that is not a rectilinear "
+      "mesh.");
+    return OPENMC_E_INVALID_TYPE;
+  }
+  if (m->grid_[0].empty()) {
+    set_errmsg("Mesh grid has not been set.");
+    return OPENMC_E_ALLOCATE;
+  }
+
+  *grid_x = m->grid_[0].data();
+  *nx = m->grid_[0].size();
+  *grid_y = m->grid_[1].data();
+  *ny = m->grid_[1].size();
+  *grid_z = m->grid_[2].data();
+  *nz = m->grid_[2].size();
+  return 0;
+}
+
+//! Set the mesh surfaces of a rectilinear mesh
+extern "C" int
+openmc_rectilinear_mesh_set_grid(int32_t index, const double* grid_x, int nx,
+  const double* grid_y, int ny, const double* grid_z, int nz)
+{
+  if (index < 0 || index >= model::meshes.size()) {
+    set_errmsg("Index in meshes array is out of bounds.");
+    return OPENMC_E_OUT_OF_BOUNDS;
+  }
+
+  auto m = dynamic_cast<RectilinearMesh*>(model::meshes[index].get());
+  if (!m) {
+    set_errmsg("Tried to set the grid of a mesh that is not a rectilinear "
+      "mesh.");
+    return OPENMC_E_INVALID_TYPE;
+  }
+
+  return m->set_grid({std::vector<double>(grid_x, grid_x + nx),
+    std::vector<double>(grid_y, grid_y + ny),
+    std::vector<double>(grid_z, grid_z + nz)});
+}
+
+//! Get the mesh surfaces and origin of a cylindrical mesh
+extern "C" int
+openmc_cylindrical_mesh_get_grid(int32_t index, double** grid_r, int* nr,
+  double** grid_phi, int* nphi, double** grid_z, int* nz, double* origin)
+{
+  if (index < 0 || index >= model::meshes.size()) {
+    set_errmsg("Index in meshes array is out of bounds.");
+    return OPENMC_E_OUT_OF_BOUNDS;
+  }
+
+  auto m = dynamic_cast<CylindricalMesh*>(model::meshes[index].get());
+  if (!m) {
+    set_errmsg("Tried to get the grid of a mesh that is not a cylindrical "
+      "mesh.");
+    return OPENMC_E_INVALID_TYPE;
+  }
+  if (m->grid_[0].empty()) {
+    set_errmsg("Mesh grid has not been set.");
+    return OPENMC_E_ALLOCATE;
+  }
+
+  *grid_r = m->grid_[0].data();
+  *nr = m->grid_[0].size();
+  *grid_phi = m->grid_[1].data();
+  *nphi = m->grid_[1].size();
+  *grid_z = m->grid_[2].data();
+  *nz = m->grid_[2].size();
+  if (origin) {
+    for (int i = 0; i < 3; ++i) origin[i] = m->origin_[i];
+  }
+  return 0;
+}
+
+//! Set the mesh surfaces and origin of a cylindrical mesh
+extern "C" int
+openmc_cylindrical_mesh_set_grid(int32_t index, const double* grid_r, int nr,
+  const double* grid_phi, int nphi, const double* grid_z, int nz,
+  const double* origin)
+{
+  if (index < 0 || index >= model::meshes.size()) {
+    set_errmsg("Index in meshes array is out of bounds.");
+    return OPENMC_E_OUT_OF_BOUNDS;
+  }
+
+  auto m = dynamic_cast<CylindricalMesh*>(model::meshes[index].get());
+  if (!m) {
+    set_errmsg("Tried to set the grid of a mesh that is not a cylindrical "
+      "mesh.");
+    return OPENMC_E_INVALID_TYPE;
+  }
+
+  int err = m->set_grid({std::vector<double>(grid_r, grid_r + nr),
+    std::vector<double>(grid_phi, grid_phi + nphi),
+    std::vector<double>(grid_z, grid_z + nz)});
+  if (err) return err;
+  if (origin) m->origin_ = Position{origin};
+  return 0;
+}
+
 //==============================================================================
 // Non-member functions
 //==============================================================================
@@ -866,8 +1598,22 @@ openmc_mesh_set_params(int32_t index, int n, const double* ll, const double* ur,
 void read_meshes(pugi::xml_node* root)
 {
   for (auto node : root->children("mesh")) {
+    // Read mesh type
+    std::string mesh_type {"regular"};
+    if (check_for_node(node, "type")) {
+      mesh_type = get_node_value(node, "type", true, true);
+    }
+
     // Read mesh and add to vector
-    model::meshes.emplace_back(new RegularMesh{node});
+    if (mesh_type == "regular") {
+      model::meshes.emplace_back(new RegularMesh{node});
+    } else if (mesh_type == "rectilinear") {
+      model::meshes.emplace_back(new RectilinearMesh{node});
+    } else if (mesh_type == "cylindrical") {
+      model::meshes.emplace_back(new CylindricalMesh{node});
+    } else {
+      fatal_error("Invalid mesh type: " + mesh_type);
+    }
 
     // Map ID to position in vector
     model::mesh_map[model::meshes.back()->id_] = model::meshes.size() - 1;
@@ -901,42 +1647,6 @@ void meshes_to_hdf5(hid_t group)
 extern "C" {
   int n_meshes() { return model::meshes.size(); }
 
-  RegularMesh* mesh_ptr(int i) { return model::meshes.at(i).get(); }
-
-  int32_t mesh_id(RegularMesh* m) { return m->id_; }
-
-  double mesh_volume_frac(RegularMesh* m) { return m->volume_frac_; }
-
-  int mesh_n_dimension(RegularMesh* m) { return m->n_dimension_; }
-
-  int mesh_dimension(RegularMesh* m, int i) { return m->shape_(i - 1); }
-
-  double mesh_lower_left(RegularMesh* m, int i) { return m->lower_left_(i - 1); }
-
-  double mesh_upper_right(RegularMesh* m, int i) { return m->upper_right_(i - 1); }
-
-  double mesh_width(RegularMesh* m, int i) { return m->width_(i - 1); }
-
-  int mesh_get_bin(RegularMesh* m, const double* xyz)
-  {
-    return m->get_bin({xyz});
-  }
-
-  int mesh_get_bin_from_indices(RegularMesh* m, const int* ijk)
-  {
-    return m->get_bin_from_indices(ijk);
-  }
-
-  void mesh_get_indices(RegularMesh* m, const double* xyz, int* ijk, bool* in_mesh)
-  {
-    m->get_indices({xyz}, ijk, in_mesh);
-  }
-
-  void mesh_get_indices_from_bin(RegularMesh* m, int bin, int* ijk)
-  {
-    m->get_indices_from_bin(bin, ijk);
-  }
-
   void free_memory_mesh()
   {
     model::meshes.clear();
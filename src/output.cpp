@@ -319,6 +319,7 @@ void print_usage()
       "  -c, --volume           Run in stochastic volume calculation mode\n"
       "  -g, --geometry-debug   Run with geometry debugging on\n"
       "  -n, --particles        Number of particles per generation\n"
+      "  -o, --overlaps         Run in geometry overlap checking mode\n"
       "  -p, --plot             Run in plotting mode\n"
       "  -r, --restart          Restart a previous run from a state point\n"
       "                         or a particle restart file\n"
@@ -518,6 +519,51 @@ void print_runtime()
 
 //==============================================================================
 
+void print_lattice_crossings()
+{
+  // Sum the counts over threads and reset them for the next run
+  int64_t n_hits = 0;
+  int64_t n_misses = 0;
+#pragma omp parallel reduction(+:n_hits, n_misses)
+  {
+    n_hits += simulation::lattice_hits;
+    n_misses += simulation::lattice_misses;
+    simulation::lattice_hits = 0;
+    simulation::lattice_misses = 0;
+  }
+
+#ifdef OPENMC_MPI
+  int64_t counts[] {n_hits, n_misses};
+  if (mpi::master) {
+    MPI_Reduce(MPI_IN_PLACE, counts, 2, MPI_INT64_T, MPI_SUM, 0,
+      mpi::intracomm);
+  } else {
+    MPI_Reduce(counts, nullptr, 2, MPI_INT64_T, MPI_SUM, 0, mpi::intracomm);
+  }
+  n_hits = counts[0];
+  n_misses = counts[1];
+#endif
+
+  int64_t n_crossings = n_hits + n_misses;
+  if (!mpi::master || settings::verbosity < 6 || n_crossings == 0) return;
+
+  header("Lattice Crossing Statistics", 6);
+
+  // Save state of cout
+  auto f {std::cout.flags()};
+
+  std::cout << " " << std::setw(33) << std::left << "Lattice crossings"
+    << " = " << n_crossings << "\n";
+  std::cout << " " << std::setw(33) << std::left << "Located in predicted cell"
+    << " = " << n_hits << " (" << std::fixed << std::setprecision(2)
+    << 100.0*n_hits/n_crossings << "%)\n";
+
+  // Restore state of cout
+  std::cout.flags(f);
+}
+
+//==============================================================================
+
 std::pair<double, double>
 mean_stdev(const double* x, int n)
 {
@@ -633,7 +679,6 @@ write_tallies()
   // Loop over each tally.
   for (auto i_tally = 0; i_tally < model::tallies.size(); ++i_tally) {
     const auto& tally {*model::tallies[i_tally]};
-    auto results = tally_results(i_tally);
     // TODO: get this directly from the tally object when it's been translated
     int32_t n_realizations;
     auto err = openmc_tally_get_n_realizations(i_tally+1, &n_realizations);
@@ -687,7 +732,7 @@ write_tallies()
         if ((filter_index-1) % tally.strides(i) == 0) {
           auto i_filt = tally.filters(i);
           const auto& filt {*model::tally_filters[i_filt]};
-          auto& match {simulation::filter_matches[i_filt]};
+          auto& match {filter_match(i_filt)};
           tallies_out << std::string(indent+1, ' ')
             // TODO: off-by-one
             << filt.text_label(match.i_bin_+1) << "\n";
@@ -695,6 +740,13 @@ write_tallies()
         indent += 2;
       }
 
+      // Results of sparse tallies that were never scored to are not stored
+      //TODO: off-by-one
+      const double* results = tally.sparse_
+        ? tally.sparse_results().find(filter_index-1)
+        : tally.results(filter_index-1, 0);
+      const double zero[3] {};
+
       // Loop over all nuclide and score combinations.
       int score_index = 0;
       for (auto i_nuclide : tally.nuclides_) {
@@ -717,9 +769,8 @@ write_tallies()
           std::string score_name = score > 0 ? reaction_name(score)
             : score_names.at(score);
           double mean, stdev;
-          //TODO: off-by-one
           std::tie(mean, stdev) = mean_stdev(
-            &results(filter_index-1, score_index, 0), n_realizations);
+            results ? results + 3*score_index : zero, n_realizations);
           tallies_out << std::string(indent+1, ' ')  << std::left
             << std::setw(36) << score_name << " " << mean << " +/- "
             << t_value * stdev << "\n";
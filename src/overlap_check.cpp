@@ -0,0 +1,462 @@
+#include "openmc/overlap_check.h"
+
+#include "openmc/capi.h"
+#include "openmc/cell.h"
+#include "openmc/constants.h"
+#include "openmc/error.h"
+#include "openmc/geometry.h"
+#include "openmc/hdf5_interface.h"
+#include "openmc/message_passing.h"
+#include "openmc/output.h"
+#include "openmc/random_lcg.h"
+#include "openmc/settings.h"
+#include "openmc/surface.h"
+#include "openmc/timer.h"
+#include "openmc/xml_interface.h"
+
+#include "xtensor/xtensor.hpp"
+
+#include <algorithm> // for copy, max, min
+#include <sstream>
+
+namespace openmc {
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace model {
+std::unique_ptr<OverlapCheck> overlap_check;
+}
+
+//==============================================================================
+// OverlapCheck implementation
+//==============================================================================
+
+OverlapCheck::OverlapCheck(pugi::xml_node node)
+{
+  if (check_for_node(node, "samples")) {
+    n_samples_ = std::stoll(get_node_value(node, "samples"));
+    if (n_samples_ < 0) {
+      fatal_error("Number of samples for the overlap check must be "
+        "non-negative.");
+    }
+  }
+
+  if (check_for_node(node, "dimension")) {
+    auto dimension = get_node_array<int>(node, "dimension");
+    if (dimension.size() != 3 || *std::min_element(dimension.begin(),
+        dimension.end()) < 0) {
+      fatal_error("Overlap check grid dimension must be given as three "
+        "non-negative integers.");
+    }
+    std::copy(dimension.begin(), dimension.end(), dimension_.begin());
+  }
+
+  if (check_for_node(node, "refinement")) {
+    refinement_ = std::stoi(get_node_value(node, "refinement"));
+    if (refinement_ < 1) {
+      fatal_error("Overlap check grid refinement must be positive.");
+    }
+  }
+
+  if (check_for_node(node, "lower_left") || check_for_node(node,
+      "upper_right")) {
+    lower_left_ = get_node_array<double>(node, "lower_left");
+    upper_right_ = get_node_array<double>(node, "upper_right");
+    if (upper_right_.x <= lower_left_.x || upper_right_.y <= lower_left_.y ||
+        upper_right_.z <= lower_left_.z) {
+      fatal_error("Upper-right coordinates of the overlap check box must be "
+        "greater than the lower-left coordinates.");
+    }
+    box_given_ = true;
+  }
+}
+
+void OverlapCheck::set_bounding_box()
+{
+  if (box_given_) return;
+
+  BoundingBox bbox {INFTY, -INFTY, INFTY, -INFTY, INFTY, -INFTY};
+  for (int32_t i_cell : model::universes[model::root_universe]->cells_) {
+    bbox = bbox | model::cells[i_cell]->bounding_box();
+  }
+  if (bbox.xmin == -INFTY || bbox.xmax == INFTY || bbox.ymin == -INFTY ||
+      bbox.ymax == INFTY || bbox.zmin == -INFTY || bbox.zmax == INFTY) {
+    fatal_error("The geometry is not bounded along every axis. Specify "
+      "<lower_left> and <upper_right> for the overlap check.");
+  }
+  lower_left_ = {bbox.xmin, bbox.ymin, bbox.zmin};
+  upper_right_ = {bbox.xmax, bbox.ymax, bbox.zmax};
+  box_given_ = true;
+}
+
+int64_t OverlapCheck::check_point(Position r, int64_t sample, Particle& p,
+  OverlapMap* overlaps) const
+{
+  p.n_coord = 1;
+  p.coord[0].universe = C_NONE;
+  std::copy(&r.x, &r.x + 3, p.coord[0].xyz);
+  p.coord[0].uvw[0] = 1.0;
+  p.coord[0].uvw[1] = 0.0;
+  p.coord[0].uvw[2] = 0.0;
+  if (!find_cell(&p, false)) return C_NONE;
+
+  // Identify the cells on every level so that points on either side of a
+  // surface at any level can be told apart
+  int64_t key = 0;
+  for (int j = 0; j < p.n_coord; ++j) {
+    key = (key*1000003 + p.coord[j].cell + 1) & INT64_MAX;
+  }
+  if (!overlaps) return key;
+
+  for (int j = 0; j < p.n_coord; ++j) {
+    int32_t i_univ = p.coord[j].universe;
+    const Universe& univ {*model::universes[i_univ]};
+    Position r_j {p.coord[j].xyz};
+    Direction u_j {p.coord[j].uvw};
+
+    // Only cells whose bounding boxes overlap the grid bin containing the
+    // point can contain it
+    const int32_t* first;
+    const int32_t* last;
+    if (univ.grid_) {
+      int bin = univ.grid_->get_bin(r_j);
+      first = univ.grid_->cbegin(bin);
+      last = univ.grid_->cend(bin);
+    } else {
+      first = univ.cells_.data();
+      last = univ.cells_.data() + univ.cells_.size();
+    }
+
+    int32_t i_found = p.coord[j].cell;
+    for (auto it = first; it != last; ++it) {
+      int32_t i_cell = *it;
+      if (i_cell == i_found) continue;
+      if (!model::cells[i_cell]->contains(r_j, u_j, p.surface)) continue;
+
+      // Record the pair, keeping the example with the lowest sample number
+      // so that the report does not depend on the number of threads
+      std::array<int32_t, 2> cells {std::min(i_cell, i_found),
+                                    std::max(i_cell, i_found)};
+      Overlap& o {(*overlaps)[{i_univ, cells[0], cells[1]}]};
+      if (o.count == 0 || sample < o.sample) {
+        o.universe = i_univ;
+        o.cells = cells;
+        o.sample = sample;
+        o.r = r;
+      }
+      ++o.count;
+    }
+  }
+
+  return key;
+}
+
+void OverlapCheck::merge(const OverlapMap& from, OverlapMap& to)
+{
+  for (const auto& kv : from) {
+    const Overlap& src {kv.second};
+    Overlap& dst {to[kv.first]};
+    if (dst.count == 0 || src.sample < dst.sample) {
+      int64_t count = dst.count;
+      dst = src;
+      dst.count = count;
+    }
+    dst.count += src.count;
+  }
+}
+
+OverlapCheck::Result OverlapCheck::execute() const
+{
+  // Divide random samples over MPI processes
+  int64_t min_samples = n_samples_ / mpi::n_procs;
+  int64_t remainder = n_samples_ % mpi::n_procs;
+  int64_t i_start, i_end;
+  if (mpi::rank < remainder) {
+    i_start = (min_samples + 1)*mpi::rank;
+    i_end = i_start + min_samples + 1;
+  } else {
+    i_start = (min_samples + 1)*remainder + (mpi::rank - remainder)*min_samples;
+    i_end = i_start + min_samples;
+  }
+
+  // Divide layers of the structured grid over MPI processes. Each process
+  // also locates the voxel centers one layer beyond its own on either side so
+  // that it can tell which of its voxels straddle a surface.
+  int nx = dimension_[0];
+  int ny = dimension_[1];
+  int nz = dimension_[2];
+  int64_t n_voxels = static_cast<int64_t>(nx)*ny*nz;
+  int k_start = (static_cast<int64_t>(nz)*mpi::rank) / mpi::n_procs;
+  int k_end = (static_cast<int64_t>(nz)*(mpi::rank + 1)) / mpi::n_procs;
+  int k_lo = std::max(k_start - 1, 0);
+  int k_hi = std::min(k_end + 1, nz);
+  if (n_voxels == 0 || k_start == k_end) k_lo = k_hi = 0;
+  int64_t n_layer = static_cast<int64_t>(nx)*ny;
+  int64_t n_keys = n_layer*(k_hi - k_lo);
+  int64_t v_start = (n_keys > 0) ? (k_start - k_lo)*n_layer : 0;
+  int64_t v_end = (n_keys > 0) ? (k_end - k_lo)*n_layer : 0;
+  std::vector<int64_t> keys(n_keys);
+
+  Position width {upper_right_ - lower_left_};
+  if (n_voxels > 0) width /= Position{double(nx), double(ny), double(nz)};
+  int m = refinement_;
+
+  OverlapMap overlaps;
+  int64_t n_points = 0;
+  int64_t n_undefined = 0;
+
+#pragma omp parallel reduction(+:n_points, n_undefined)
+  {
+    // Variables that are private to each thread
+    OverlapMap found;
+    Particle p;
+    p.initialize();
+
+    prn_set_stream(STREAM_VOLUME);
+
+    // Test points sampled uniformly at random within the box
+#pragma omp for
+    for (int64_t i = i_start; i < i_end; ++i) {
+      set_particle_seed(i);
+
+      Position xi {prn(), prn(), prn()};
+      Position r {lower_left_ + xi*(upper_right_ - lower_left_)};
+      if (check_point(r, i, p, &found) == C_NONE) ++n_undefined;
+      ++n_points;
+    }
+
+    prn_set_stream(STREAM_TRACKING);
+
+    // Test the centers of the voxels of the structured grid
+#pragma omp for
+    for (int64_t v = 0; v < n_keys; ++v) {
+      int k = k_lo + v / n_layer;
+      int j = (v % n_layer) / nx;
+      int i = v % nx;
+      Position r {lower_left_ + Position{i + 0.5, j + 0.5, k + 0.5}*width};
+      bool owned = k >= k_start && k < k_end;
+      int64_t sample = n_samples_ + k*n_layer + j*nx + i;
+      keys[v] = check_point(r, sample, p, owned ? &found : nullptr);
+      if (owned) {
+        if (keys[v] == C_NONE) ++n_undefined;
+        ++n_points;
+      }
+    }
+
+    // Refine the voxels that straddle a surface, i.e. whose centers are in
+    // different cells than the center of a neighboring voxel
+#pragma omp for schedule(dynamic, 64)
+    for (int64_t v = v_start; v < v_end; ++v) {
+      int k = k_lo + v / n_layer;
+      int j = (v % n_layer) / nx;
+      int i = v % nx;
+      int64_t key = keys[v];
+      bool refine = (i > 0 && keys[v - 1] != key) ||
+        (i < nx - 1 && keys[v + 1] != key) ||
+        (j > 0 && keys[v - nx] != key) ||
+        (j < ny - 1 && keys[v + nx] != key) ||
+        (k > k_lo && keys[v - n_layer] != key) ||
+        (k < k_hi - 1 && keys[v + n_layer] != key);
+      if (!refine) continue;
+
+      int64_t sample = n_samples_ + n_voxels + (k*n_layer + j*nx + i)*m*m*m;
+      for (int c = 0; c < m; ++c) {
+        for (int b = 0; b < m; ++b) {
+          for (int a = 0; a < m; ++a) {
+            Position xi {(a + 0.5)/m, (b + 0.5)/m, (c + 0.5)/m};
+            Position r {lower_left_ + (Position{double(i), double(j),
+              double(k)} + xi)*width};
+            if (check_point(r, sample++, p, &found) == C_NONE) ++n_undefined;
+            ++n_points;
+          }
+        }
+      }
+    }
+
+#pragma omp critical (merge_overlaps)
+    merge(found, overlaps);
+  } // omp parallel
+
+#ifdef OPENMC_MPI
+  // Collect the overlaps found by each process on the master process
+  if (mpi::master) {
+    for (int j = 1; j < mpi::n_procs; ++j) {
+      int q;
+      MPI_Recv(&q, 1, MPI_INT, j, 0, mpi::intracomm, MPI_STATUS_IGNORE);
+      std::vector<int64_t> ints(5*q);
+      std::vector<double> coords(3*q);
+      MPI_Recv(ints.data(), 5*q, MPI_INT64_T, j, 1, mpi::intracomm,
+        MPI_STATUS_IGNORE);
+      MPI_Recv(coords.data(), 3*q, MPI_DOUBLE, j, 2, mpi::intracomm,
+        MPI_STATUS_IGNORE);
+
+      OverlapMap received;
+      for (int k = 0; k < q; ++k) {
+        Overlap o;
+        o.universe = ints[5*k];
+        o.cells = {static_cast<int32_t>(ints[5*k + 1]),
+                   static_cast<int32_t>(ints[5*k + 2])};
+        o.count = ints[5*k + 3];
+        o.sample = ints[5*k + 4];
+        o.r = {coords[3*k], coords[3*k + 1], coords[3*k + 2]};
+        received[{o.universe, o.cells[0], o.cells[1]}] = o;
+      }
+      merge(received, overlaps);
+    }
+  } else {
+    int q = overlaps.size();
+    std::vector<int64_t> ints;
+    std::vector<double> coords;
+    for (const auto& kv : overlaps) {
+      const Overlap& o {kv.second};
+      ints.insert(ints.end(), {o.universe, o.cells[0], o.cells[1], o.count,
+        o.sample});
+      coords.insert(coords.end(), {o.r.x, o.r.y, o.r.z});
+    }
+    MPI_Send(&q, 1, MPI_INT, 0, 0, mpi::intracomm);
+    MPI_Send(ints.data(), 5*q, MPI_INT64_T, 0, 1, mpi::intracomm);
+    MPI_Send(coords.data(), 3*q, MPI_DOUBLE, 0, 2, mpi::intracomm);
+  }
+
+  int64_t counts[] {n_points, n_undefined};
+  if (mpi::master) {
+    MPI_Reduce(MPI_IN_PLACE, counts, 2, MPI_INT64_T, MPI_SUM, 0,
+      mpi::intracomm);
+  } else {
+    MPI_Reduce(counts, nullptr, 2, MPI_INT64_T, MPI_SUM, 0, mpi::intracomm);
+  }
+  n_points = counts[0];
+  n_undefined = counts[1];
+#endif
+
+  Result result;
+  for (const auto& kv : overlaps) {
+    result.overlaps.push_back(kv.second);
+  }
+  result.n_points = n_points;
+  result.n_undefined = n_undefined;
+  return result;
+}
+
+void OverlapCheck::to_hdf5(const std::string& filename,
+  const Result& result) const
+{
+  // Create HDF5 file
+  hid_t file_id = file_open(filename, 'w');
+
+  // Write header info
+  write_attribute(file_id, "filetype", "overlaps");
+  write_attribute(file_id, "version", VERSION_OVERLAPS);
+  write_attribute(file_id, "openmc_version", VERSION);
+#ifdef GIT_SHA1
+  write_attribute(file_id, "git_sha1", GIT_SHA1);
+#endif
+
+  // Write current date and time
+  write_attribute(file_id, "date_and_time", time_stamp());
+
+  // Write basic metadata
+  write_attribute(file_id, "samples", n_samples_);
+  write_attribute(file_id, "dimension", dimension_);
+  write_attribute(file_id, "refinement", refinement_);
+  write_attribute(file_id, "lower_left", lower_left_);
+  write_attribute(file_id, "upper_right", upper_right_);
+  write_attribute(file_id, "points", result.n_points);
+  write_attribute(file_id, "undefined_points", result.n_undefined);
+
+  // Write the IDs of each pair of overlapping cells along with the number of
+  // points found in both and an example point
+  std::size_t n = result.overlaps.size();
+  std::vector<int> universes(n);
+  xt::xtensor<int, 2> cells({n, 2});
+  std::vector<int64_t> counts(n);
+  xt::xtensor<double, 2> coordinates({n, 3});
+  for (int i = 0; i < n; ++i) {
+    const Overlap& o {result.overlaps[i]};
+    universes[i] = model::universes[o.universe]->id_;
+    cells(i, 0) = model::cells[o.cells[0]]->id_;
+    cells(i, 1) = model::cells[o.cells[1]]->id_;
+    counts[i] = o.count;
+    coordinates(i, 0) = o.r.x;
+    coordinates(i, 1) = o.r.y;
+    coordinates(i, 2) = o.r.z;
+  }
+  write_dataset(file_id, "universes", universes);
+  write_dataset(file_id, "cells", cells);
+  write_dataset(file_id, "counts", counts);
+  write_dataset(file_id, "coordinates", coordinates);
+
+  file_close(file_id);
+}
+
+} // namespace openmc
+
+//==============================================================================
+// OPENMC_CHECK_OVERLAPS samples points throughout the geometry, reports any
+// overlapping cells that were found, and writes them to an HDF5 file
+//==============================================================================
+
+int openmc_check_overlaps() {
+  using namespace openmc;
+
+  if (mpi::master) {
+    header("GEOMETRY OVERLAP CHECK", 3);
+  }
+  Timer time_overlap;
+  time_overlap.start();
+
+  if (!model::overlap_check) {
+    model::overlap_check = std::make_unique<OverlapCheck>();
+  }
+  auto& check {*model::overlap_check};
+  check.set_bounding_box();
+
+  auto result = check.execute();
+
+  if (mpi::master) {
+    // Display each pair of overlapping cells
+    for (const auto& o : result.overlaps) {
+      std::stringstream msg;
+      msg << "  Cells " << model::cells[o.cells[0]]->id_ << " and "
+          << model::cells[o.cells[1]]->id_ << " in universe "
+          << model::universes[o.universe]->id_ << " overlap at ("
+          << o.r.x << ", " << o.r.y << ", " << o.r.z << ") [" << o.count
+          << " points]";
+      write_message(msg, 4);
+    }
+
+    std::stringstream msg;
+    msg << "Tested " << result.n_points << " points, of which "
+        << result.n_undefined << " were not in any cell";
+    write_message(msg, 5);
+    if (!result.overlaps.empty()) {
+      warning("Found " + std::to_string(result.overlaps.size())
+        + " pairs of overlapping cells.");
+    } else {
+      write_message("No overlapping cells were found.", 4);
+    }
+
+    // Write overlaps to HDF5 file
+    check.to_hdf5(settings::path_output + "overlaps.h5", result);
+  }
+
+  // Show elapsed time
+  time_overlap.stop();
+  if (mpi::master) {
+    write_message("Elapsed time: " + std::to_string(time_overlap.elapsed())
+      + " s", 6);
+  }
+
+  return 0;
+}
+
+//==============================================================================
+// Fortran compatibility
+//==============================================================================
+
+extern "C" void free_memory_overlap_check()
+{
+  openmc::model::overlap_check.reset();
+}
@@ -39,6 +39,7 @@ LocalCoord::reset()
   lattice = 0;
   lattice_x = 0;
   lattice_y = 0;
+  node = C_NONE;
   rotated = false;
 }
 
@@ -165,6 +166,12 @@ Particle::transport()
   // Every particle starts with no accumulated flux derivative.
   if (!model::active_tallies.empty()) zero_flux_derivs();
 
+  // Boundary distances on each coordinate level, saved for reuse while the
+  // particle travels in a straight line
+  std::array<BoundaryDistance, MAX_COORD> saved_distances;
+  BoundaryDistance* saved {settings::distance_cache ?
+    saved_distances.data() : nullptr};
+
   while (true) {
     // Set the random number stream
     if (type == static_cast<int>(ParticleType::neutron)) {
@@ -230,7 +237,7 @@ Particle::transport()
     int lattice_translation[3];
     int next_level;
     distance_to_boundary(this, &d_boundary, &surface_crossed,
-      lattice_translation, &next_level);
+      lattice_translation, &next_level, saved);
 
     // Sample a distance to collision
     double d_collision;
@@ -253,6 +260,12 @@ Particle::transport()
       coord[j].xyz[1] += distance * coord[j].uvw[1];
       coord[j].xyz[2] += distance * coord[j].uvw[2];
     }
+    if (saved) {
+      for (int j = 0; j < n_coord; ++j) {
+        saved[j].d_surf -= distance;
+        saved[j].d_lat -= distance;
+      }
+    }
 
     // Score track-length tallies
     if (!model::active_tracklength_tallies.empty()) {
@@ -276,6 +289,11 @@ Particle::transport()
 
       if (next_level > 0) n_coord = next_level;
 
+      // Only the distances on levels above the boundary remain valid
+      for (int j = n_coord - 1; j < MAX_COORD; ++j) {
+        saved_distances[j].valid = false;
+      }
+
       // Saving previous cell data
       for (int j = 0; j < n_coord; ++j) {
         last_cell[j] = coord[j].cell;
@@ -293,6 +311,11 @@ Particle::transport()
         surface = surface_crossed;
         this->cross_surface();
         event = EVENT_SURFACE;
+
+        // Boundary conditions move the particle or change its direction
+        if (model::surfaces[std::abs(surface_crossed) - 1]->bc_ != BC_TRANSMIT) {
+          for (auto& s : saved_distances) s.valid = false;
+        }
       }
       // Score cell to cell partial currents
       if (!model::active_surface_tallies.empty()) {
@@ -319,6 +342,9 @@ Particle::transport()
       // Clear surface component
       surface = ERROR_INT;
 
+      // The direction changes in a collision
+      for (auto& s : saved_distances) s.valid = false;
+
       if (settings::run_CE) {
         collision(this);
       } else {
@@ -357,11 +383,11 @@ Particle::transport()
       for (int j = 0; j < n_coord - 1; ++j) {
         if (coord[j + 1].rotated) {
           // If next level is rotated, apply rotation matrix
-          const auto& m {model::cells[coord[j].cell]->rotation_};
-          Direction u {coord[j].uvw};
-          coord[j + 1].uvw[0] = m[3]*u.x + m[4]*u.y + m[5]*u.z;
-          coord[j + 1].uvw[1] = m[6]*u.x + m[7]*u.y + m[8]*u.z;
-          coord[j + 1].uvw[2] = m[9]*u.x + m[10]*u.y + m[11]*u.z;
+          const Transform& t {model::cells[coord[j].cell]->transform_};
+          Direction u = t.rotate(coord[j].uvw);
+          coord[j + 1].uvw[0] = u.x;
+          coord[j + 1].uvw[1] = u.y;
+          coord[j + 1].uvw[2] = u.z;
         } else {
           // Otherwise, copy this level's direction
           std::copy(coord[j].uvw, coord[j].uvw + 3, coord[j + 1].uvw);
@@ -388,6 +414,7 @@ Particle::transport()
       this->from_source(&secondary_bank[n_secondary - 1]);
       --n_secondary;
       n_event = 0;
+      for (auto& s : saved_distances) s.valid = false;
 
       // Enter new particle in particle track file
       if (write_track) add_particle_track();
@@ -13,6 +13,7 @@
 #include "xtensor/xoperation.hpp"
 #include "xtensor/xview.hpp"
 
+#include <algorithm> // for max, min
 #include <array>
 #include <cmath>
 #include <tuple> // for tie
@@ -194,6 +195,7 @@ PhotonInteraction::PhotonInteraction(hid_t group, int i_element)
       profile_cdf_(i,j+1) = c;
     }
   }
+  this->build_profile_guide();
 
   // Calculate total pair production
   pair_production_total_ = pair_production_nuclear_ + pair_production_electron_;
@@ -284,39 +286,165 @@ PhotonInteraction::PhotonInteraction(hid_t group, int i_element)
     xt::log(photoelectric_total_), -500.0);
   pair_production_total_ = xt::where(pair_production_total_ > 0.0,
     xt::log(pair_production_total_), -500.0);
+
+  if (settings::compton_tables) this->build_incoherent_tables();
 }
 
-void PhotonInteraction::compton_scatter(double alpha, bool doppler,
-  double* alpha_out, double* mu, int* i_shell) const
+void PhotonInteraction::build_profile_guide()
 {
-  double form_factor_xmax = 0.0;
-  while (true) {
-    // Sample Klein-Nishina distribution for trial energy and angle
-    std::tie(*alpha_out, *mu) = klein_nishina(alpha);
-
-    // Note that the parameter used here does not correspond exactly to the
-    // momentum transfer q in ENDF-102 Eq. (27.2). Rather, this is the
-    // parameter as defined by Hubbell, where the actual data comes from
-    double x = MASS_ELECTRON_EV/PLANCK_C*alpha*std::sqrt(0.5*(1.0 - *mu));
-
-    // Calculate S(x, Z) and S(x_max, Z)
-    double form_factor_x = incoherent_form_factor_(x);
-    if (form_factor_xmax == 0.0) {
-      form_factor_xmax = incoherent_form_factor_(MASS_ELECTRON_EV/PLANCK_C*alpha);
+  // The guide table stores, for equal subdivisions of the CDF of each shell,
+  // the index of the last momentum grid point below the subdivision so that
+  // inverting the CDF only requires a short linear walk
+  auto n_shell = profile_cdf_.shape()[0];
+  auto n_profile = profile_cdf_.shape()[1];
+  profile_guide_ = xt::empty<int>({n_shell, n_profile});
+  for (int i = 0; i < n_shell; ++i) {
+    double c_total = profile_cdf_(i, n_profile - 1);
+    int j = 0;
+    for (int k = 0; k < n_profile; ++k) {
+      double c = k*c_total/n_profile;
+      while (j < n_profile - 2 && profile_cdf_(i, j+1) < c) ++j;
+      profile_guide_(i, k) = j;
     }
+  }
+}
 
-    // Perform rejection on form factor
-    if (prn() < form_factor_x / form_factor_xmax) {
-      if (doppler) {
-        double E_out;
-        this->compton_doppler(alpha, *mu, &E_out, i_shell);
-        *alpha_out = E_out/MASS_ELECTRON_EV;
-      } else {
-        *i_shell = -1;
+int PhotonInteraction::profile_cdf_index(int shell, double c) const
+{
+  // Start from the guide table entry and walk to the interval containing c.
+  // The backward walk guards against roundoff in computing the guide index so
+  // that the result is identical to a binary search over the CDF.
+  int n = profile_cdf_.shape()[1];
+  double c_total = profile_cdf_(shell, n - 1);
+  int k = std::min(static_cast<int>(c/c_total*n), n - 1);
+  int i = profile_guide_(shell, k);
+  while (i > 0 && profile_cdf_(shell, i) >= c) --i;
+  while (i < n - 2 && profile_cdf_(shell, i + 1) < c) ++i;
+  return i;
+}
+
+void PhotonInteraction::build_incoherent_tables()
+{
+  // Determine uniform grid in log(alpha) spanning the energy grid
+  int n_energy = energy_.size();
+  double log_alpha_min = energy_(0) - std::log(MASS_ELECTRON_EV);
+  double log_alpha_max = energy_(n_energy - 1) - std::log(MASS_ELECTRON_EV);
+  int n_alpha = std::max(2, static_cast<int>(std::ceil((log_alpha_max -
+    log_alpha_min)/std::log(10.0)*INCOHERENT_ALPHA_PER_DECADE)) + 1);
+  incoherent_log_alpha_min_ = log_alpha_min;
+  incoherent_log_alpha_spacing_ = (log_alpha_max - log_alpha_min)/(n_alpha - 1);
+
+  // Cosine grid that is quadratically refined near mu = 1. Since the momentum
+  // transfer goes as sqrt(1 - mu), this gives a uniform grid in x at fixed
+  // alpha, which resolves the rapid variation of the scattering function
+  // for small momentum transfer.
+  int n_mu = INCOHERENT_N_MU;
+  incoherent_mu_ = xt::empty<double>({n_mu});
+  for (int j = 0; j < n_mu; ++j) {
+    double t = static_cast<double>(n_mu - 1 - j)/(n_mu - 1);
+    incoherent_mu_(j) = 1.0 - 2.0*t*t;
+  }
+
+  incoherent_pdf_ = xt::empty<double>({n_alpha, n_mu});
+  incoherent_cdf_ = xt::empty<double>({n_alpha, n_mu});
+  for (int i = 0; i < n_alpha; ++i) {
+    double alpha = std::exp(log_alpha_min + i*incoherent_log_alpha_spacing_);
+    for (int j = 0; j < n_mu; ++j) {
+      // Klein-Nishina cross section, dsigma/dmu, up to a constant
+      double mu = incoherent_mu_(j);
+      double k = 1.0/(1.0 + alpha*(1.0 - mu));
+      double kn = k*k*(k + 1.0/k - 1.0 + mu*mu);
+
+      // Incoherent scattering function (see compton_scatter)
+      double x = MASS_ELECTRON_EV/PLANCK_C*alpha*std::sqrt(0.5*(1.0 - mu));
+      incoherent_pdf_(i, j) = kn*incoherent_form_factor_(x);
+    }
+
+    double c = 0.0;
+    incoherent_cdf_(i, 0) = 0.0;
+    for (int j = 0; j < n_mu - 1; ++j) {
+      c += 0.5*(incoherent_mu_(j+1) - incoherent_mu_(j)) *
+        (incoherent_pdf_(i, j) + incoherent_pdf_(i, j+1));
+      incoherent_cdf_(i, j+1) = c;
+    }
+  }
+}
+
+double PhotonInteraction::sample_incoherent_mu(double alpha) const
+{
+  // Determine alpha grid point using statistical interpolation on log(alpha)
+  int n_alpha = incoherent_pdf_.shape()[0];
+  int n_mu = incoherent_mu_.size();
+  double u = (std::log(alpha) - incoherent_log_alpha_min_) /
+    incoherent_log_alpha_spacing_;
+  int i;
+  if (u <= 0.0) {
+    i = 0;
+  } else if (u >= n_alpha - 1) {
+    i = n_alpha - 1;
+  } else {
+    i = static_cast<int>(u);
+    if (prn() < u - i) ++i;
+  }
+
+  // Sample value on CDF
+  auto cdf = xt::view(incoherent_cdf_, i, xt::all());
+  double c = prn()*cdf(n_mu - 1);
+  int j = lower_bound_index(cdf.cbegin(), cdf.cend(), c);
+
+  // Invert the CDF assuming the PDF is linear between grid points
+  double mu_l = incoherent_mu_(j);
+  double mu_r = incoherent_mu_(j + 1);
+  double p_l = incoherent_pdf_(i, j);
+  double p_r = incoherent_pdf_(i, j + 1);
+  double c_l = cdf(j);
+  double mu;
+  if (p_l == p_r) {
+    mu = mu_l + (c - c_l)/p_l;
+  } else {
+    double m = (p_r - p_l)/(mu_r - mu_l);
+    mu = mu_l + (std::sqrt(std::max(0.0, p_l*p_l + 2.0*m*(c - c_l))) - p_l)/m;
+  }
+  return std::max(-1.0, std::min(1.0, mu));
+}
+
+void PhotonInteraction::compton_scatter(double alpha, bool doppler,
+  double* alpha_out, double* mu, int* i_shell) const
+{
+  if (settings::compton_tables) {
+    // Sample directly from the tabulated product of the Klein-Nishina cross
+    // section and the incoherent scattering function
+    *mu = this->sample_incoherent_mu(alpha);
+    *alpha_out = alpha/(1.0 + alpha*(1.0 - *mu));
+  } else {
+    double form_factor_xmax = 0.0;
+    while (true) {
+      // Sample Klein-Nishina distribution for trial energy and angle
+      std::tie(*alpha_out, *mu) = klein_nishina(alpha);
+
+      // Note that the parameter used here does not correspond exactly to the
+      // momentum transfer q in ENDF-102 Eq. (27.2). Rather, this is the
+      // parameter as defined by Hubbell, where the actual data comes from
+      double x = MASS_ELECTRON_EV/PLANCK_C*alpha*std::sqrt(0.5*(1.0 - *mu));
+
+      // Calculate S(x, Z) and S(x_max, Z)
+      double form_factor_x = incoherent_form_factor_(x);
+      if (form_factor_xmax == 0.0) {
+        form_factor_xmax = incoherent_form_factor_(MASS_ELECTRON_EV/PLANCK_C*alpha);
       }
-      break;
+
+      // Perform rejection on form factor
+      if (prn() < form_factor_x / form_factor_xmax) break;
     }
   }
+
+  if (doppler) {
+    double E_out;
+    this->compton_doppler(alpha, *mu, &E_out, i_shell);
+    *alpha_out = E_out/MASS_ELECTRON_EV;
+  } else {
+    *i_shell = -1;
+  }
 }
 
 void PhotonInteraction::compton_doppler(double alpha, double mu,
@@ -377,8 +505,7 @@ void PhotonInteraction::compton_doppler(double alpha, double mu,
     c = prn()*c_max;
 
     // Determine pz corresponding to sampled cdf value
-    auto cdf_shell = xt::view(profile_cdf_, shell, xt::all());
-    int i = lower_bound_index(cdf_shell.cbegin(), cdf_shell.cend(), c);
+    int i = this->profile_cdf_index(shell, c);
     double pz_l = data::compton_profile_pz(i);
     double pz_r = data::compton_profile_pz(i + 1);
     double p_l = profile_pdf_(shell, i);
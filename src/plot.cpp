@@ -1,3 +1,4 @@
+#include <algorithm> // for min, max
 #include <fstream>
 #include <sstream>
 
@@ -26,6 +27,9 @@ namespace openmc {
 
 const RGBColor WHITE {255, 255, 255};
 constexpr int PLOT_LEVEL_LOWEST {-1}; //!< lower bound on plot universe level
+constexpr hsize_t VOXEL_TILE_SIZE {1 << 22}; //!< voxels computed per tile
+constexpr hsize_t VOXEL_CHUNK_SIZE {1 << 20}; //!< voxels per dataset chunk
+constexpr int VOXEL_COMPRESSION {4}; //!< deflate level for voxel data
 
 //==============================================================================
 // Global variables
@@ -47,23 +51,133 @@ int openmc_plot_geometry()
 {
   int err;
 
-  for (auto pl : model::plots) {
-    std::stringstream ss;
-    ss << "Processing plot " << pl.id_ << ": "
-       << pl.path_plot_ << "...";
-    write_message(ss.str(), 5);
+  std::vector<bool> done(model::plots.size(), false);
+  for (int i = 0; i < model::plots.size(); ++i) {
+    if (done[i]) continue;
+    auto& pl = model::plots[i];
 
     if (PlotType::slice == pl.type_) {
-      // create 2D image
-      create_ppm(pl);
+      // Slice plots of the same view are all created with one pass through
+      // the geometry
+      std::vector<const Plot*> group;
+      for (int j = i; j < model::plots.size(); ++j) {
+        if (!done[j] && same_view(pl, model::plots[j])) {
+          group.push_back(&model::plots[j]);
+          done[j] = true;
+        }
+      }
+      for (auto plot : group) {
+        std::stringstream ss;
+        ss << "Processing plot " << plot->id_ << ": "
+           << plot->path_plot_ << "...";
+        write_message(ss.str(), 5);
+      }
+
+      // create 2D images
+      create_ppm(group);
+
     } else if (PlotType::voxel == pl.type_) {
+      std::stringstream ss;
+      ss << "Processing plot " << pl.id_ << ": "
+         << pl.path_plot_ << "...";
+      write_message(ss.str(), 5);
+
       // create voxel file for 3D viewing
       create_voxel(pl);
     }
+    done[i] = true;
   }
   return 0;
 }
 
+bool same_view(const Plot& a, const Plot& b)
+{
+  return a.type_ == b.type_ && a.basis_ == b.basis_ && a.origin_ == b.origin_
+    && a.width_ == b.width_ && a.pixels_ == b.pixels_;
+}
+
+//==============================================================================
+// TRACE_PLOT_RAY moves a particle along one axis through a row of pixels or
+// voxels. The particle is only located from the root universe at the first
+// point and at the first point past each boundary; every point before the
+// next boundary is in the same cells on every level. For each run of points in
+// the same cells, fill(first, last, found_cell) is called with the particle
+// located in those cells.
+//==============================================================================
+
+template<typename F>
+void trace_plot_ray(Particle& p, Position r, int axis, double step, int n,
+                    F fill)
+{
+  int i = 0;
+  while (i < n) {
+    // Locate the particle at this point, moving along the ray so that a point
+    // lying on a surface is placed in the cell the ray is entering
+    Position r_i = r;
+    r_i[axis] += i*step;
+    p.n_coord = 1;
+    p.coord[0].xyz[0] = r_i.x;
+    p.coord[0].xyz[1] = r_i.y;
+    p.coord[0].xyz[2] = r_i.z;
+    p.coord[0].uvw[0] = 0.0;
+    p.coord[0].uvw[1] = 0.0;
+    p.coord[0].uvw[2] = 0.0;
+    p.coord[0].uvw[axis] = 1.0;
+    p.coord[0].universe = model::root_universe;
+    bool found_cell = find_cell(&p, false);
+
+    if (settings::check_overlaps) {check_cell_overlap(&p);}
+
+    if (!found_cell) {
+      fill(i, i + 1, false);
+      ++i;
+      continue;
+    }
+
+    // Find the distance to the next boundary along the ray on every level
+    double d;
+    int surface_crossed;
+    int lattice_translation[3];
+    int next_level;
+    distance_to_boundary(&p, &d, &surface_crossed, lattice_translation,
+                         &next_level);
+
+    int i_start = i;
+    int i_end = i + 1;
+    while (i_end < n && (i_end - i_start)*step < d - FP_COINCIDENT) ++i_end;
+
+    // A ray that starts on a surface and is tangent to it may not stay in the
+    // cell it was located in, in which case the distance found above means
+    // nothing. Only this point is filled if the last point of the run has
+    // left the cell on any level.
+    if (i_end - i_start > 1) {
+      double s = (i_end - 1 - i_start)*step;
+      for (int j = 0; j < p.n_coord; ++j) {
+        Position r_j {p.coord[j].xyz};
+        Direction u_j {p.coord[j].uvw};
+        if (!model::cells[p.coord[j].cell]->contains(r_j + s*u_j, u_j, 0)) {
+          i_end = i_start + 1;
+          break;
+        }
+      }
+    }
+
+    ++i;
+    while (i < i_end) {
+      // Move to the next point on every level for the overlap check
+      if (settings::check_overlaps) {
+        for (int j = 0; j < p.n_coord; ++j) {
+          p.coord[j].xyz[0] += step*p.coord[j].uvw[0];
+          p.coord[j].xyz[1] += step*p.coord[j].uvw[1];
+          p.coord[j].xyz[2] += step*p.coord[j].uvw[2];
+        }
+        check_cell_overlap(&p);
+      }
+      ++i;
+    }
+    fill(i_start, i, true);
+  }
+}
 
 void
 read_plots(pugi::xml_node* plots_node)
@@ -80,8 +194,9 @@ read_plots(pugi::xml_node* plots_node)
 // specification in the portable pixmap format (PPM)
 //==============================================================================
 
-void create_ppm(Plot pl)
+void create_ppm(const std::vector<const Plot*>& plots)
 {
+  const Plot& pl {*plots[0]};
 
   size_t width = pl.pixels_[0];
   size_t height = pl.pixels_[1];
@@ -89,11 +204,13 @@ void create_ppm(Plot pl)
   double in_pixel = (pl.width_[0])/static_cast<double>(width);
   double out_pixel = (pl.width_[1])/static_cast<double>(height);
 
-  ImageData data;
-  data.resize({width, height});
+  std::vector<ImageData> data(plots.size());
+  for (auto& d : data) {
+    d.resize({width, height});
+  }
 
   int in_i, out_i;
-  double xyz[3];
+  Position xyz;
   switch(pl.basis_) {
   case PlotBasis::xy :
     in_i = 0;
@@ -118,34 +235,40 @@ void create_ppm(Plot pl)
     break;
   }
 
-  double dir[3] = {0.5, 0.5, 0.5};
-
 #pragma omp parallel
 {
   Particle p;
   p.initialize();
-  std::copy(xyz, xyz+3, p.coord[0].xyz);
-  std::copy(dir, dir+3, p.coord[0].uvw);
-  p.coord[0].universe = model::root_universe;
 
-#pragma omp for
+#pragma omp for schedule(dynamic)
   for (int y = 0; y < height; y++) {
-    p.coord[0].xyz[out_i] = xyz[out_i] - out_pixel * y;
-    for (int x = 0; x < width; x++) {
-      // local variables
-      RGBColor rgb;
-      int id;
-      p.coord[0].xyz[in_i] = xyz[in_i] + in_pixel * x;
-      position_rgb(p, pl, rgb, id);
-      data(x,y) = rgb;
-    }
+    // Trace a ray across the row, coloring each run of pixels in the same
+    // cell for every plot
+    Position r = xyz;
+    r[out_i] = xyz[out_i] - out_pixel * y;
+    trace_plot_ray(p, r, in_i, in_pixel, width,
+      [&](int first, int last, bool found_cell) {
+        for (int k = 0; k < plots.size(); ++k) {
+          RGBColor rgb;
+          int id;
+          located_rgb(p, found_cell, *plots[k], rgb, id);
+          for (int x = first; x < last; ++x) {
+            data[k](x,y) = rgb;
+          }
+        }
+      });
   }
 }
-  // draw mesh lines if present
-  if (pl.index_meshlines_mesh_ >= 0) {draw_mesh_lines(pl, data);}
 
-  // write ppm data to file
-  output_ppm(pl, data);
+  for (int k = 0; k < plots.size(); ++k) {
+    // draw mesh lines if present
+    if (plots[k]->index_meshlines_mesh_ >= 0) {
+      draw_mesh_lines(*plots[k], data[k]);
+    }
+
+    // write ppm data to file
+    output_ppm(*plots[k], data[k]);
+  }
 }
 
 void
@@ -529,6 +652,15 @@ Plot::set_meshlines(pugi::xml_node plot_node)
         err_msg << "Invalid type for meshlines on plot " << id_ ;
         fatal_error(err_msg);
       }
+
+      // Mesh lines are drawn along the axes of the plot
+      if (dynamic_cast<const CylindricalMesh*>(
+          model::meshes[index_meshlines_mesh_].get())) {
+        std::stringstream err_msg;
+        err_msg << "Meshlines on plot " << id_ << " must be drawn for a "
+                << "Cartesian mesh.";
+        fatal_error(err_msg);
+      }
     } else {
       std::stringstream err_msg;
       err_msg << "Mutliple meshlines specified in plot " << id_;
@@ -633,16 +765,27 @@ index_meshlines_mesh_(-1)
 //==============================================================================
 
 
-void position_rgb(Particle p, Plot pl, RGBColor& rgb, int& id)
+void position_rgb(Particle p, const Plot& pl, RGBColor& rgb, int& id)
 {
   p.n_coord = 1;
 
   bool found_cell = find_cell(&p, 0);
 
-  int j = p.n_coord - 1;
-
   if (settings::check_overlaps) {check_cell_overlap(&p);}
 
+  located_rgb(p, found_cell, pl, rgb, id);
+}
+
+//==============================================================================
+// LOCATED_RGB computes the red/green/blue values for a given plot from the
+// cells a particle has already been located in
+//==============================================================================
+
+void located_rgb(const Particle& p, bool found_cell, const Plot& pl,
+                 RGBColor& rgb, int& id)
+{
+  int j = p.n_coord - 1;
+
   // Set coordinate level if specified
   if (pl.level_ >= 0) {j = pl.level_ + 1;}
 
@@ -753,6 +896,8 @@ void draw_mesh_lines(Plot pl, ImageData& data)
   width[2] = xyz_ur_plot[2] - xyz_ll_plot[2];
 
   auto& m = model::meshes[pl.index_meshlines_mesh_];
+  auto grid_outer = m->grid(outer);
+  auto grid_inner = m->grid(inner);
 
   int ijk_ll[3], ijk_ur[3];
   bool in_mesh;
@@ -770,10 +915,10 @@ void draw_mesh_lines(Plot pl, ImageData& data)
       if (i > 0 && i <= m->shape_[outer] && j >0 && j <= m->shape_[inner] ) {
         int outrange[3], inrange[3];
         // get xyz's of lower left and upper right of this mesh cell
-        xyz_ll[outer] = m->lower_left_[outer] + m->width_[outer] * (i - 1);
-        xyz_ll[inner] = m->lower_left_[inner] + m->width_[inner] * (j - 1);
-        xyz_ur[outer] = m->lower_left_[outer] + m->width_[outer] * i;
-        xyz_ur[inner] = m->lower_left_[inner] + m->width_[inner] * j;
+        xyz_ll[outer] = grid_outer[i - 1];
+        xyz_ll[inner] = grid_inner[j - 1];
+        xyz_ur[outer] = grid_outer[i];
+        xyz_ur[inner] = grid_inner[j];
 
         // map the xyz ranges to pixel ranges
         double frac = (xyz_ll[outer] - xyz_ll_plot[outer]) / width[outer];
@@ -811,17 +956,14 @@ void draw_mesh_lines(Plot pl, ImageData& data)
 } // end draw_mesh_lines
 
 //==============================================================================
-// CREATE_VOXEL outputs a binary file that can be input into silomesh for 3D
-// geometry visualization.  It works the same way as create_ppm by dragging a
-// particle across the geometry for the specified number of voxels. The first 3
-// int(4)'s in the binary are the number of x, y, and z voxels.  The next 3
-// real(8)'s are the widths of the voxels in the x, y, and z directions. The
-// next 3 real(8)'s are the x, y, and z coordinates of the lower left
-// point. Finally the binary is filled with entries of four int(4)'s each. Each
-// 'row' in the binary contains four int(4)'s: 3 for x,y,z position and 1 for
-// cell or material id.  For 1 million voxels this produces a file of
-// approximately 15MB.
-// =============================================================================
+// CREATE_VOXEL outputs an HDF5 file that can be converted for 3D geometry
+// visualization. The voxels are computed in tiles of whole x-slices which are
+// dealt out to MPI processes in turn and whose columns of voxels along z are
+// divided among OpenMP threads. While one round of tiles is computed, the
+// master thread of the master process writes its own tile from the previous
+// round to a chunked, compressed dataset. Tiles from other processes are
+// collected between rounds, outside of the parallel region.
+//==============================================================================
 
 void create_voxel(Plot pl)
 {
@@ -838,119 +980,180 @@ void create_voxel(Plot pl)
   ll[1] = pl.origin_[1] - pl.width_[1] / 2.;
   ll[2] = pl.origin_[2] - pl.width_[2] / 2.;
 
-  // allocate and initialize particle
-  double dir[3] = {0.5, 0.5, 0.5};
-  Particle p;
-  p.initialize();
-  std::copy(ll.begin(), ll.begin()+ll.size(), p.coord[0].xyz);
-  std::copy(dir, dir+3, p.coord[0].uvw);
-  p.coord[0].universe = model::root_universe;
+  // Create dataset for voxel data -- note that the dimensions are reversed
+  // since we want the order in the file to be z, y, x
+  hsize_t dims[3];
+  dims[0] = pl.pixels_[0];
+  dims[1] = pl.pixels_[1];
+  dims[2] = pl.pixels_[2];
 
-  // Open binary plot file for writing
-  std::ofstream of;
-  std::string fname = std::string(pl.path_plot_);
-  fname = strtrim(fname);
-  hid_t file_id = file_open(fname, 'w');
+  hid_t file_id, dspace, dset;
+  if (mpi::master) {
+    // Open binary plot file for writing
+    std::string fname = std::string(pl.path_plot_);
+    fname = strtrim(fname);
+    file_id = file_open(fname, 'w');
 
-  // write header info
-  write_attribute(file_id, "filetype", "voxel");
-  write_attribute(file_id, "version", VERSION_VOXEL);
-  write_attribute(file_id, "openmc_version", VERSION);
+    // write header info
+    write_attribute(file_id, "filetype", "voxel");
+    write_attribute(file_id, "version", VERSION_VOXEL);
+    write_attribute(file_id, "openmc_version", VERSION);
 
 #ifdef GIT_SHA1
-  write_attribute(file_id, "git_sha1", GIT_SHA1);
+    write_attribute(file_id, "git_sha1", GIT_SHA1);
 #endif
 
-  // Write current date and time
-  write_attribute(file_id, "date_and_time", time_stamp().c_str());
-  hsize_t three = 3;
-  write_attribute(file_id, "num_voxels", pl.pixels_);
-  write_attribute(file_id, "voxel_width", vox);
-  write_attribute(file_id, "lower_left", ll);
+    // Write current date and time
+    write_attribute(file_id, "date_and_time", time_stamp().c_str());
+    write_attribute(file_id, "num_voxels", pl.pixels_);
+    write_attribute(file_id, "voxel_width", vox);
+    write_attribute(file_id, "lower_left", ll);
 
-  // Create dataset for voxel data -- note that the dimensions are reversed
-  // since we want the order in the file to be z, y, x
-  hsize_t dims[3];
-  dims[0] = pl.pixels_[0];
-  dims[1] = pl.pixels_[1];
-  dims[2] = pl.pixels_[2];
-  hid_t dspace, dset, memspace;
-  voxel_init(file_id, &(dims[0]), &dspace, &dset, &memspace);
+    voxel_init(file_id, &(dims[0]), &dspace, &dset);
+  }
 
-  // move to center of voxels
-  ll[0] = ll[0] + vox[0] / 2.;
-  ll[1] = ll[1] + vox[1] / 2.;
-  ll[2] = ll[2] + vox[2] / 2.;
+  // Divide the x-slices into tiles of roughly VOXEL_TILE_SIZE voxels
+  hsize_t n_slice = dims[1]*dims[2];
+  hsize_t tile_slices = std::max(hsize_t{1}, std::min(dims[0],
+    VOXEL_TILE_SIZE / std::max(n_slice, hsize_t{1})));
+  int n_tiles = (dims[0] + tile_slices - 1) / tile_slices;
+  int n_rounds = (n_tiles + mpi::n_procs - 1) / mpi::n_procs;
 
-  int data[pl.pixels_[1]][pl.pixels_[2]];
+  // Two buffers so that one round of tiles can be written while the next is
+  // computed
+  std::vector<int> tiles[2];
+  tiles[0].resize(tile_slices*n_slice);
+  tiles[1].resize(tile_slices*n_slice);
+
+  // Number of x-slices in a given tile
+  auto slices_in = [&](int tile) {
+    return std::min(tile_slices, dims[0] - tile*tile_slices);
+  };
 
   ProgressBar pb;
 
-  RGBColor rgb;
-  int id;
-  for (int x = 0; x < pl.pixels_[0]; x++) {
-    pb.set_value(100.*(double)x/(double)(pl.pixels_[0]-1));
-    for (int y = 0; y < pl.pixels_[1]; y++) {
-      for (int z = 0; z < pl.pixels_[2]; z++) {
-        // get voxel color
-        position_rgb(p, pl, rgb, id);
-        // write to plot data
-        data[y][z] = id;
-        // advance particle in z direction
-        p.coord[0].xyz[2] = p.coord[0].xyz[2] + vox[2];
+  // Write the tile computed by the master process in a round
+  auto write_own_tile = [&](int round) {
+    int tile = round*mpi::n_procs;
+    voxel_write_slab(tile*tile_slices, slices_in(tile), dspace, dset,
+      tiles[round % 2].data());
+  };
+
+  // Collect on the master process, and write, the tiles computed by the other
+  // processes in a round. This is called outside of any parallel region so
+  // that MPI only needs to support a single thread.
+  auto collect_round = [&](int round) {
+    int first = round*mpi::n_procs;
+    int last = std::min(first + mpi::n_procs, n_tiles);
+#ifdef OPENMC_MPI
+    if (mpi::master) {
+      std::vector<int> received(tile_slices*n_slice);
+      for (int tile = first + 1; tile < last; ++tile) {
+        MPI_Recv(received.data(), int(slices_in(tile)*n_slice), MPI_INT,
+          tile - first, tile, mpi::intracomm, MPI_STATUS_IGNORE);
+        voxel_write_slab(tile*tile_slices, slices_in(tile), dspace, dset,
+          received.data());
       }
-      // advance particle in y direction
-      p.coord[0].xyz[1] = p.coord[0].xyz[1] + vox[1];
-      p.coord[0].xyz[2] = ll[2];
+    } else if (first + mpi::rank < last) {
+      int tile = first + mpi::rank;
+      MPI_Send(tiles[round % 2].data(), int(slices_in(tile)*n_slice), MPI_INT,
+        0, tile, mpi::intracomm);
+    }
+#endif
+    if (mpi::master) pb.set_value(100.*(double)last/(double)n_tiles);
+  };
+
+  for (int round = 0; round < n_rounds; ++round) {
+#pragma omp parallel
+{
+    Particle p;
+    p.initialize();
+
+    // Write the master's tile from the previous round while the other threads
+    // start on this one
+#pragma omp master
+    {
+      if (mpi::master && round > 0) write_own_tile(round - 1);
     }
-    // advance particle in x direction
-    p.coord[0].xyz[0] = p.coord[0].xyz[0] + vox[0];
-    p.coord[0].xyz[1] = ll[1];
-    p.coord[0].xyz[2] = ll[2];
-    // Write to HDF5 dataset
-    voxel_write_slice(x, dspace, dset, memspace, &(data[0]));
+
+    int tile = round*mpi::n_procs + mpi::rank;
+    int64_t n_columns = (tile < n_tiles) ? slices_in(tile)*dims[1] : 0;
+    int* buf = tiles[round % 2].data();
+
+#pragma omp for schedule(dynamic)
+    for (int64_t i = 0; i < n_columns; ++i) {
+      // Position of the center of the first voxel in the column
+      int x = tile*tile_slices + i / dims[1];
+      int y = i % dims[1];
+      Position r {ll[0] + (x + 0.5)*vox[0], ll[1] + (y + 0.5)*vox[1],
+                  ll[2] + 0.5*vox[2]};
+      int* column = buf + i*dims[2];
+      trace_plot_ray(p, r, 2, vox[2], dims[2],
+        [&](int first, int last, bool found_cell) {
+          RGBColor rgb;
+          int id;
+          located_rgb(p, found_cell, pl, rgb, id);
+          std::fill(column + first, column + last, id);
+        });
+    }
+}
+
+    collect_round(round);
   }
 
-  voxel_finalize(dspace, dset, memspace);
-  file_close(file_id);
+  if (mpi::master && n_rounds > 0) write_own_tile(n_rounds - 1);
 
+  if (mpi::master) {
+    voxel_finalize(dspace, dset);
+    file_close(file_id);
+  }
 }
 
 void
-voxel_init(hid_t file_id, const hsize_t* dims,
-           hid_t* dspace, hid_t* dset, hid_t* memspace)
+voxel_init(hid_t file_id, const hsize_t* dims, hid_t* dspace, hid_t* dset)
 {
+  // Store the voxel data in chunks of whole z-columns, compressed if the
+  // deflate filter is available
+  hsize_t chunk[3] {1, std::min(dims[1], std::max(hsize_t{1},
+    VOXEL_CHUNK_SIZE / std::max(dims[2], hsize_t{1}))), dims[2]};
+  hid_t plist = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(plist, 3, chunk);
+  if (H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0) {
+    H5Pset_shuffle(plist);
+    H5Pset_deflate(plist, VOXEL_COMPRESSION);
+  }
+
   // Create dataspace/dataset for voxel data
   *dspace = H5Screate_simple(3, dims, nullptr);
   *dset = H5Dcreate(file_id, "data", H5T_NATIVE_INT, *dspace, H5P_DEFAULT,
-                    H5P_DEFAULT, H5P_DEFAULT);
-
-  // Create dataspace for a slice of the voxel
-  hsize_t dims_slice[2] {dims[1], dims[2]};
-  *memspace = H5Screate_simple(2, dims_slice, nullptr);
-
-  // Select hyperslab in dataspace
-  hsize_t start[3] {0, 0, 0};
-  hsize_t count[3] {1, dims[1], dims[2]};
-  H5Sselect_hyperslab(*dspace, H5S_SELECT_SET, start, nullptr, count, nullptr);
+                    plist, H5P_DEFAULT);
+  H5Pclose(plist);
 }
 
 
 void
-voxel_write_slice(int x, hid_t dspace, hid_t dset, hid_t memspace, void* buf)
+voxel_write_slab(hsize_t x, hsize_t n, hid_t dspace, hid_t dset,
+                 const void* buf)
 {
-  hssize_t offset[3] {x, 0, 0};
-  H5Soffset_simple(dspace, offset);
+  // Create dataspace for the slices being written
+  hsize_t dims[3];
+  H5Sget_simple_extent_dims(dspace, dims, nullptr);
+  hsize_t count[3] {n, dims[1], dims[2]};
+  hid_t memspace = H5Screate_simple(3, count, nullptr);
+
+  // Select hyperslab in dataspace
+  hsize_t start[3] {x, 0, 0};
+  H5Sselect_hyperslab(dspace, H5S_SELECT_SET, start, nullptr, count, nullptr);
   H5Dwrite(dset, H5T_NATIVE_INT, memspace, dspace, H5P_DEFAULT, buf);
+  H5Sclose(memspace);
 }
 
 
 void
-voxel_finalize(hid_t dspace, hid_t dset, hid_t memspace)
+voxel_finalize(hid_t dspace, hid_t dset)
 {
   H5Dclose(dset);
   H5Sclose(dspace);
-  H5Sclose(memspace);
 }
 
 RGBColor random_color() {
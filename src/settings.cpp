@@ -21,6 +21,7 @@
 #include "openmc/mesh.h"
 #include "openmc/message_passing.h"
 #include "openmc/output.h"
+#include "openmc/overlap_check.h"
 #include "openmc/random_lcg.h"
 #include "openmc/simulation.h"
 #include "openmc/source.h"
@@ -40,10 +41,13 @@ namespace settings {
 // Default values for boolean flags
 bool assume_separate         {false};
 bool check_overlaps          {false};
+bool compton_tables          {false};
 bool confidence_intervals    {false};
 bool create_fission_neutrons {true};
 bool dagmc                   {false};
+bool distance_cache          {false};
 bool entropy_on              {false};
+bool flatten_geometry        {false};
 bool legendre_to_tabular     {true};
 bool output_summary          {true};
 bool output_tallies          {true};
@@ -57,6 +61,8 @@ bool source_latest           {false};
 bool source_separate         {false};
 bool source_write            {true};
 bool survival_biasing        {false};
+bool tally_buffers           {false};
+bool tally_dispatch          {true};
 bool temperature_multipole   {false};
 bool trigger_on              {false};
 bool trigger_predict         {false};
@@ -86,6 +92,7 @@ std::array<double, 4> energy_cutoff {0.0, 1000.0, 0.0, 0.0};
 int legendre_to_tabular_points {C_NONE};
 int max_order {0};
 int n_log_bins {8000};
+int n_neighbor_sweep {0};
 int n_max_batches;
 ResScatMethod res_scat_method {ResScatMethod::rvs};
 double res_scat_energy_min {0.01};
@@ -94,6 +101,7 @@ std::vector<std::string> res_scat_nuclides;
 int run_mode {-1};
 std::unordered_set<int> sourcepoint_batch;
 std::unordered_set<int> statepoint_batch;
+double tally_buffer_memory {16.0};
 int temperature_method {TEMPERATURE_NEAREST};
 double temperature_tolerance {10.0};
 double temperature_default {293.6};
@@ -306,6 +314,8 @@ void read_settings_xml()
         run_mode = RUN_MODE_PARTICLE;
       } else if (temp_str == "volume") {
         run_mode = RUN_MODE_VOLUME;
+      } else if (temp_str == "overlap check") {
+        run_mode = RUN_MODE_OVERLAP;
       } else {
         fatal_error("Unrecognized run mode: " + temp_str);
       }
@@ -372,6 +382,11 @@ void read_settings_xml()
     }
   }
 
+  // Check whether to sample incoherent scattering from tabulated data
+  if (check_for_node(root, "compton_tables")) {
+    compton_tables = get_node_value_bool(root, "compton_tables");
+  }
+
   // Number of bins for logarithmic grid
   if (check_for_node(root, "log_grid_bins")) {
     n_log_bins = std::stoi(get_node_value(root, "log_grid_bins"));
@@ -381,6 +396,24 @@ void read_settings_xml()
     }
   }
 
+  // Reuse of boundary distances along straight tracks
+  if (check_for_node(root, "distance_cache")) {
+    distance_cache = get_node_value_bool(root, "distance_cache");
+  }
+
+  // Flattening of the geometry hierarchy
+  if (check_for_node(root, "flatten_geometry")) {
+    flatten_geometry = get_node_value_bool(root, "flatten_geometry");
+  }
+
+  // Number of rays used to prepopulate neighbor lists
+  if (check_for_node(root, "neighbor_sweep")) {
+    n_neighbor_sweep = std::stoi(get_node_value(root, "neighbor_sweep"));
+    if (n_neighbor_sweep < 0) {
+      fatal_error("Number of neighbor list sweep rays must be non-negative.");
+    }
+  }
+
   // Number of OpenMP threads
   if (check_for_node(root, "threads")) {
 #ifdef _OPENMP
@@ -427,6 +460,11 @@ void read_settings_xml()
     survival_biasing = get_node_value_bool(root, "survival_biasing");
   }
 
+  // Indexing tallies by cell and material
+  if (check_for_node(root, "tally_dispatch")) {
+    tally_dispatch = get_node_value_bool(root, "tally_dispatch");
+  }
+
   // Probability tables
   if (check_for_node(root, "ptables")) {
     urr_ptables_on = get_node_value_bool(root, "ptables");
@@ -520,17 +558,17 @@ void read_settings_xml()
   }
 
   if (index_entropy_mesh >= 0) {
-    auto& m = *model::meshes[index_entropy_mesh];
-    if (m.shape_.dimension() == 0) {
+    auto m = dynamic_cast<RegularMesh*>(model::meshes[index_entropy_mesh].get());
+    if (m && m->shape_.dimension() == 0) {
       // If the user did not specify how many mesh cells are to be used in
       // each direction, we automatically determine an appropriate number of
       // cells
       int n = std::ceil(std::pow(n_particles / 20.0, 1.0/3.0));
-      m.shape_ = {n, n, n};
-      m.n_dimension_ = 3;
+      m->shape_ = {n, n, n};
+      m->n_dimension_ = 3;
 
       // Calculate width
-      m.width_ = (m.upper_right_ - m.lower_left_) / m.shape_;
+      m->width_ = (m->upper_right_ - m->lower_left_) / m->shape_;
     }
 
     // Turn on Shannon entropy calculation
@@ -727,6 +765,12 @@ void read_settings_xml()
     model::volume_calcs.emplace_back(node_vol);
   }
 
+  // Get parameters of the overlap check
+  if (check_for_node(root, "overlap_check")) {
+    model::overlap_check = std::make_unique<OverlapCheck>(
+      root.child("overlap_check"));
+  }
+
   // Get temperature settings
   if (check_for_node(root, "temperature_default")) {
     temperature_default = std::stod(get_node_value(root, "temperature_default"));
@@ -774,6 +818,23 @@ void read_settings_xml()
     }
   }
 
+  // Check for thread-private tally buffer options
+  if (check_for_node(root, "tally_buffers")) {
+    xml_node node_buffers = root.child("tally_buffers");
+
+    if (check_for_node(node_buffers, "enable")) {
+      tally_buffers = get_node_value_bool(node_buffers, "enable");
+    }
+    if (check_for_node(node_buffers, "max_memory")) {
+      tally_buffer_memory = std::stod(get_node_value(node_buffers,
+        "max_memory"));
+      if (tally_buffer_memory < 0.0) {
+        fatal_error("The 'max_memory' subelement/attribute of the "
+          "<tally_buffers> element must not be negative.");
+      }
+    }
+  }
+
   // Check whether create fission sites
   if (run_mode == RUN_MODE_FIXEDSOURCE) {
     if (check_for_node(root, "create_fission_neutrons")) {
@@ -5,6 +5,7 @@
 #include "openmc/container_util.h"
 #include "openmc/eigenvalue.h"
 #include "openmc/error.h"
+#include "openmc/geometry.h"
 #include "openmc/material.h"
 #include "openmc/message_passing.h"
 #include "openmc/nuclide.h"
@@ -17,6 +18,7 @@
 #include "openmc/timer.h"
 #include "openmc/tallies/filter.h"
 #include "openmc/tallies/tally.h"
+#include "openmc/tallies/tally_buffer.h"
 #include "openmc/tallies/trigger.h"
 
 #include <omp.h>
@@ -28,7 +30,6 @@ namespace openmc {
 
 // data/functions from Fortran side
 extern "C" void accumulate_tallies();
-extern "C" void allocate_tally_results();
 extern "C" void setup_active_tallies();
 extern "C" void write_tallies();
 
@@ -67,10 +68,7 @@ int openmc_simulation_init()
   calculate_work();
 
   // Allocate array for matching filter bins
-#pragma omp parallel
-  {
-    simulation::filter_matches.resize(model::tally_filters.size());
-  }
+  setup_filter_matches();
 
   // Allocate source bank, and for eigenvalue simulations also allocate the
   // fission bank
@@ -105,6 +103,13 @@ int openmc_simulation_init()
     initialize_source();
   }
 
+  // Trace rays through the geometry to populate neighbor lists before
+  // transport begins
+  if (settings::n_neighbor_sweep > 0) {
+    write_message("Populating neighbor lists...", 6);
+    prepopulate_neighbor_lists(settings::n_neighbor_sweep);
+  }
+
   // Display header
   if (mpi::master) {
     if (settings::run_mode == RUN_MODE_FIXEDSOURCE) {
@@ -150,7 +155,9 @@ int openmc_simulation_finalize()
 #pragma omp parallel
   {
     simulation::filter_matches.clear();
+    simulation::filter_matches_found.clear();
   }
+  simulation::tally_buffers.clear();
 
   // Deactivate all tallies
   for (int i = 1; i <= n_tallies; ++i) {
@@ -164,6 +171,7 @@ int openmc_simulation_finalize()
     if (settings::verbosity >= 6) print_runtime();
     if (settings::verbosity >= 4) print_results();
   }
+  print_lattice_crossings();
   if (settings::check_overlaps) print_overlap_check();
 
   // Reset flags
@@ -339,6 +347,9 @@ void initialize_batch()
 
   // Add user tallies to active tallies list
   setup_active_tallies();
+
+  // Allocate private tally buffers for each thread
+  setup_tally_buffers();
 }
 
 void finalize_batch()
@@ -411,6 +422,11 @@ void initialize_generation()
 
 void finalize_generation()
 {
+  // Add scores buffered on each thread into the tally results
+  simulation::time_tallies.start();
+  reduce_tally_buffers();
+  simulation::time_tallies.stop();
+
   auto gt = global_tallies();
 
   // Update global tallies with the omp private accumulation variables
@@ -534,6 +550,30 @@ void calculate_work()
 void broadcast_results() {
   // Broadcast tally results so that each process has access to results
   for (int i = 0; i < n_tallies; ++i) {
+    // Only the nonzero results of sparse tallies are broadcast
+    const auto& tally {*model::tallies[i]};
+    if (tally.sparse_) {
+      std::vector<int64_t> bins;
+      std::vector<double> values;
+      if (mpi::master) nonzero_tally_results(tally, 0, 3, bins, values);
+      int64_t n = bins.size();
+      MPI_Bcast(&n, 1, MPI_INT64_T, 0, mpi::intracomm);
+      bins.resize(n);
+      values.resize(3*n);
+      MPI_Bcast(bins.data(), n, MPI_INT64_T, 0, mpi::intracomm);
+      MPI_Bcast(values.data(), 3*n, MPI_DOUBLE, 0, mpi::intracomm);
+
+      if (!mpi::master) {
+        tally.sparse_results().clear();
+        int64_t n_score = tally.results_shape()[1];
+        for (int64_t j = 0; j < n; ++j) {
+          std::copy(&values[3*j], &values[3*j] + 3,
+            tally.results(bins[j] / n_score, bins[j] % n_score));
+        }
+      }
+      continue;
+    }
+
     // Create a new datatype that consists of all values for a given filter
     // bin and then use that to broadcast. This is done to minimize the
     // chance of the 'count' argument of MPI_BCAST exceeding 2**31
@@ -577,7 +617,7 @@ extern "C" int64_t work_index(int rank) { return simulation::work_index[rank]; }
 // This function was moved here to get around a bug on macOS whereby an invalid
 // pointer is returned for the threadprivate filter_matches
 extern "C" FilterMatch* filter_match_pointer(int indx) {
-  return &simulation::filter_matches[indx];
+  return &filter_match(indx);
 }
 
 } // namespace openmc
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cstdint> // for int64_t
 #include <iomanip> // for setfill, setw
+#include <numeric> // for iota
 #include <string>
 #include <vector>
 
@@ -615,6 +616,68 @@ void read_source_bank(hid_t group_id)
   H5Tclose(banktype);
 }
 
+//! Reduce the sum and sum of squares of a sparse tally onto the master process
+//! and write them when tally results are not reduced every batch. Only the
+//! nonzero results of each process are sent.
+
+void write_sparse_tally_results_nr(hid_t tallies_group, const Tally& tally)
+{
+  std::vector<int64_t> bins;
+  std::vector<double> values;
+#ifdef OPENMC_MPI
+  gather_tally_results(tally, RESULT_SUM, 2, bins, values);
+#endif
+  if (!mpi::master) return;
+
+  if (simulation::current_batch == settings::n_max_batches ||
+      simulation::satisfy_triggers) {
+    // At the end of the simulation, store the reduced results back in the
+    // tally and write those
+    int64_t n_score = tally.results_shape()[1];
+    for (int64_t j = 0; j < bins.size(); ++j) {
+      double* results = tally.results(bins[j] / n_score, bins[j] % n_score);
+      results[RESULT_SUM] += values[2*j];
+      results[RESULT_SUM_SQ] += values[2*j + 1];
+    }
+    nonzero_tally_results(tally, RESULT_SUM, 2, bins, values);
+
+  } else {
+    // Add the results of the master process and combine the results of the
+    // same bin from different processes
+    std::vector<int64_t> master_bins;
+    std::vector<double> master_values;
+    nonzero_tally_results(tally, RESULT_SUM, 2, master_bins, master_values);
+    bins.insert(bins.end(), master_bins.begin(), master_bins.end());
+    values.insert(values.end(), master_values.begin(), master_values.end());
+
+    std::vector<std::size_t> order(bins.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+      [&bins](std::size_t a, std::size_t b) {return bins[a] < bins[b];});
+
+    master_bins.clear();
+    master_values.clear();
+    for (auto j : order) {
+      if (!master_bins.empty() && master_bins.back() == bins[j]) {
+        master_values.end()[-2] += values[2*j];
+        master_values.end()[-1] += values[2*j + 1];
+      } else {
+        master_bins.push_back(bins[j]);
+        master_values.push_back(values[2*j]);
+        master_values.push_back(values[2*j + 1]);
+      }
+    }
+    bins = std::move(master_bins);
+    values = std::move(master_values);
+  }
+
+  std::string groupname {"tally " + std::to_string(tally.id_)};
+  hid_t tally_group = open_group(tallies_group, groupname.c_str());
+  const auto& shape {tally.results_shape()};
+  write_tally_results_sparse(tally_group, shape[0], shape[1], bins, values);
+  close_group(tally_group);
+}
+
 void write_tally_results_nr(hid_t file_id)
 {
   // ==========================================================================
@@ -665,6 +728,11 @@ void write_tally_results_nr(hid_t file_id)
       write_attribute(file_id, "tallies_present", 1);
     }
 
+    if (model::tallies[i]->sparse_) {
+      write_sparse_tally_results_nr(tallies_group, *model::tallies[i]);
+      continue;
+    }
+
     // Get view of accumulated tally values
     auto results = tally_results(i);
     auto values_view = xt::view(results, xt::all(), xt::all(),
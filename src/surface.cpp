@@ -30,6 +30,7 @@ namespace model {
 
 std::vector<Surface*> surfaces;
 std::map<int, int> surface_map;
+SurfacePack surface_pack;
 
 } // namespace model
 
@@ -337,6 +338,11 @@ void SurfaceXPlane::to_hdf5_inner(hid_t group_id) const
   write_dataset(group_id, "coefficients", coeffs);
 }
 
+std::vector<double> SurfaceXPlane::coefficients() const
+{
+  return {x0_};
+}
+
 bool SurfaceXPlane::periodic_translate(const PeriodicSurface* other,
                                        Position& r,  Direction& u) const
 {
@@ -366,6 +372,16 @@ SurfaceXPlane::bounding_box() const
   return {x0_, x0_, -INFTY, INFTY, -INFTY, INFTY};
 }
 
+BoundingBox
+SurfaceXPlane::bounding_box(bool pos_side) const
+{
+  if (pos_side) {
+    return {x0_, INFTY, -INFTY, INFTY, -INFTY, INFTY};
+  } else {
+    return {-INFTY, x0_, -INFTY, INFTY, -INFTY, INFTY};
+  }
+}
+
 //==============================================================================
 // SurfaceYPlane implementation
 //==============================================================================
@@ -398,6 +414,11 @@ void SurfaceYPlane::to_hdf5_inner(hid_t group_id) const
   write_dataset(group_id, "coefficients", coeffs);
 }
 
+std::vector<double> SurfaceYPlane::coefficients() const
+{
+  return {y0_};
+}
+
 bool SurfaceYPlane::periodic_translate(const PeriodicSurface* other,
                                        Position& r, Direction& u) const
 {
@@ -428,6 +449,16 @@ SurfaceYPlane::bounding_box() const
   return {-INFTY, INFTY, y0_, y0_, -INFTY, INFTY};
 }
 
+BoundingBox
+SurfaceYPlane::bounding_box(bool pos_side) const
+{
+  if (pos_side) {
+    return {-INFTY, INFTY, y0_, INFTY, -INFTY, INFTY};
+  } else {
+    return {-INFTY, INFTY, -INFTY, y0_, -INFTY, INFTY};
+  }
+}
+
 //==============================================================================
 // SurfaceZPlane implementation
 //==============================================================================
@@ -460,6 +491,11 @@ void SurfaceZPlane::to_hdf5_inner(hid_t group_id) const
   write_dataset(group_id, "coefficients", coeffs);
 }
 
+std::vector<double> SurfaceZPlane::coefficients() const
+{
+  return {z0_};
+}
+
 bool SurfaceZPlane::periodic_translate(const PeriodicSurface* other,
                                        Position& r, Direction& u) const
 {
@@ -474,6 +510,35 @@ SurfaceZPlane::bounding_box() const
   return {-INFTY, INFTY, -INFTY, INFTY, z0_, z0_};
 }
 
+BoundingBox
+SurfaceZPlane::bounding_box(bool pos_side) const
+{
+  if (pos_side) {
+    return {-INFTY, INFTY, -INFTY, INFTY, z0_, INFTY};
+  } else {
+    return {-INFTY, INFTY, -INFTY, INFTY, -INFTY, z0_};
+  }
+}
+
+//==============================================================================
+// Generic functions for general planes
+//==============================================================================
+
+double
+plane_distance(Position r, Direction u, bool coincident, double A, double B,
+               double C, double D)
+{
+  const double f = A*r.x + B*r.y + C*r.z - D;
+  const double projection = A*u.x + B*u.y + C*u.z;
+  if (coincident or std::abs(f) < FP_COINCIDENT or projection == 0.0) {
+    return INFTY;
+  } else {
+    const double d = -f / projection;
+    if (d < 0.0) return INFTY;
+    return d;
+  }
+}
+
 //==============================================================================
 // SurfacePlane implementation
 //==============================================================================
@@ -493,15 +558,7 @@ SurfacePlane::evaluate(Position r) const
 double
 SurfacePlane::distance(Position r, Direction u, bool coincident) const
 {
-  const double f = A_*r.x + B_*r.y + C_*r.z - D_;
-  const double projection = A_*u.x + B_*u.y + C_*u.z;
-  if (coincident or std::abs(f) < FP_COINCIDENT or projection == 0.0) {
-    return INFTY;
-  } else {
-    const double d = -f / projection;
-    if (d < 0.0) return INFTY;
-    return d;
-  }
+  return plane_distance(r, u, coincident, A_, B_, C_, D_);
 }
 
 Direction
@@ -517,6 +574,11 @@ void SurfacePlane::to_hdf5_inner(hid_t group_id) const
   write_dataset(group_id, "coefficients", coeffs);
 }
 
+std::vector<double> SurfacePlane::coefficients() const
+{
+  return {A_, B_, C_, D_};
+}
+
 bool SurfacePlane::periodic_translate(const PeriodicSurface* other, Position& r,
                                       Direction& u) const
 {
@@ -640,6 +702,12 @@ Direction SurfaceXCylinder::normal(Position r) const
   return axis_aligned_cylinder_normal<0, 1, 2>(r, y0_, z0_);
 }
 
+BoundingBox SurfaceXCylinder::bounding_box(bool pos_side) const
+{
+  if (pos_side) return INFINITE_BOX;
+  return {-INFTY, INFTY, y0_ - radius_, y0_ + radius_, z0_ - radius_,
+          z0_ + radius_};
+}
 
 void SurfaceXCylinder::to_hdf5_inner(hid_t group_id) const
 {
@@ -648,6 +716,11 @@ void SurfaceXCylinder::to_hdf5_inner(hid_t group_id) const
   write_dataset(group_id, "coefficients", coeffs);
 }
 
+std::vector<double> SurfaceXCylinder::coefficients() const
+{
+  return {y0_, z0_, radius_};
+}
+
 //==============================================================================
 // SurfaceYCylinder implementation
 //==============================================================================
@@ -674,6 +747,13 @@ Direction SurfaceYCylinder::normal(Position r) const
   return axis_aligned_cylinder_normal<1, 0, 2>(r, x0_, z0_);
 }
 
+BoundingBox SurfaceYCylinder::bounding_box(bool pos_side) const
+{
+  if (pos_side) return INFINITE_BOX;
+  return {x0_ - radius_, x0_ + radius_, -INFTY, INFTY, z0_ - radius_,
+          z0_ + radius_};
+}
+
 void SurfaceYCylinder::to_hdf5_inner(hid_t group_id) const
 {
   write_string(group_id, "type", "y-cylinder", false);
@@ -681,6 +761,11 @@ void SurfaceYCylinder::to_hdf5_inner(hid_t group_id) const
   write_dataset(group_id, "coefficients", coeffs);
 }
 
+std::vector<double> SurfaceYCylinder::coefficients() const
+{
+  return {x0_, z0_, radius_};
+}
+
 //==============================================================================
 // SurfaceZCylinder implementation
 //==============================================================================
@@ -707,6 +792,13 @@ Direction SurfaceZCylinder::normal(Position r) const
   return axis_aligned_cylinder_normal<2, 0, 1>(r, x0_, y0_);
 }
 
+BoundingBox SurfaceZCylinder::bounding_box(bool pos_side) const
+{
+  if (pos_side) return INFINITE_BOX;
+  return {x0_ - radius_, x0_ + radius_, y0_ - radius_, y0_ + radius_, -INFTY,
+          INFTY};
+}
+
 void SurfaceZCylinder::to_hdf5_inner(hid_t group_id) const
 {
   write_string(group_id, "type", "z-cylinder", false);
@@ -714,31 +806,24 @@ void SurfaceZCylinder::to_hdf5_inner(hid_t group_id) const
   write_dataset(group_id, "coefficients", coeffs);
 }
 
-//==============================================================================
-// SurfaceSphere implementation
-//==============================================================================
-
-SurfaceSphere::SurfaceSphere(pugi::xml_node surf_node)
-  : CSGSurface(surf_node)
+std::vector<double> SurfaceZCylinder::coefficients() const
 {
-  read_coeffs(surf_node, id_, x0_, y0_, z0_, radius_);
+  return {x0_, y0_, radius_};
 }
 
-double SurfaceSphere::evaluate(Position r) const
-{
-  const double x = r.x - x0_;
-  const double y = r.y - y0_;
-  const double z = r.z - z0_;
-  return x*x + y*y + z*z - radius_*radius_;
-}
+//==============================================================================
+// Generic functions for spheres
+//==============================================================================
 
-double SurfaceSphere::distance(Position r, Direction u, bool coincident) const
+double
+sphere_distance(Position r, Direction u, bool coincident, double x0,
+                double y0, double z0, double radius)
 {
-  const double x = r.x - x0_;
-  const double y = r.y - y0_;
-  const double z = r.z - z0_;
+  const double x = r.x - x0;
+  const double y = r.y - y0;
+  const double z = r.z - z0;
   const double k = x*u.x + y*u.y + z*u.z;
-  const double c = x*x + y*y + z*z - radius_*radius_;
+  const double c = x*x + y*y + z*z - radius*radius;
   const double quad = k*k - c;
 
   if (quad < 0.0) {
@@ -770,11 +855,41 @@ double SurfaceSphere::distance(Position r, Direction u, bool coincident) const
   }
 }
 
+//==============================================================================
+// SurfaceSphere implementation
+//==============================================================================
+
+SurfaceSphere::SurfaceSphere(pugi::xml_node surf_node)
+  : CSGSurface(surf_node)
+{
+  read_coeffs(surf_node, id_, x0_, y0_, z0_, radius_);
+}
+
+double SurfaceSphere::evaluate(Position r) const
+{
+  const double x = r.x - x0_;
+  const double y = r.y - y0_;
+  const double z = r.z - z0_;
+  return x*x + y*y + z*z - radius_*radius_;
+}
+
+double SurfaceSphere::distance(Position r, Direction u, bool coincident) const
+{
+  return sphere_distance(r, u, coincident, x0_, y0_, z0_, radius_);
+}
+
 Direction SurfaceSphere::normal(Position r) const
 {
   return {2.0*(r.x - x0_), 2.0*(r.y - y0_), 2.0*(r.z - z0_)};
 }
 
+BoundingBox SurfaceSphere::bounding_box(bool pos_side) const
+{
+  if (pos_side) return INFINITE_BOX;
+  return {x0_ - radius_, x0_ + radius_, y0_ - radius_, y0_ + radius_,
+          z0_ - radius_, z0_ + radius_};
+}
+
 void SurfaceSphere::to_hdf5_inner(hid_t group_id) const
 {
   write_string(group_id, "type", "sphere", false);
@@ -782,6 +897,11 @@ void SurfaceSphere::to_hdf5_inner(hid_t group_id) const
   write_dataset(group_id, "coefficients", coeffs);
 }
 
+std::vector<double> SurfaceSphere::coefficients() const
+{
+  return {x0_, y0_, z0_, radius_};
+}
+
 //==============================================================================
 // Generic functions for x-, y-, and z-, cones
 //==============================================================================
@@ -900,6 +1020,11 @@ void SurfaceXCone::to_hdf5_inner(hid_t group_id) const
   write_dataset(group_id, "coefficients", coeffs);
 }
 
+std::vector<double> SurfaceXCone::coefficients() const
+{
+  return {x0_, y0_, z0_, radius_sq_};
+}
+
 //==============================================================================
 // SurfaceYCone implementation
 //==============================================================================
@@ -933,6 +1058,11 @@ void SurfaceYCone::to_hdf5_inner(hid_t group_id) const
   write_dataset(group_id, "coefficients", coeffs);
 }
 
+std::vector<double> SurfaceYCone::coefficients() const
+{
+  return {x0_, y0_, z0_, radius_sq_};
+}
+
 //==============================================================================
 // SurfaceZCone implementation
 //==============================================================================
@@ -966,29 +1096,19 @@ void SurfaceZCone::to_hdf5_inner(hid_t group_id) const
   write_dataset(group_id, "coefficients", coeffs);
 }
 
-//==============================================================================
-// SurfaceQuadric implementation
-//==============================================================================
-
-SurfaceQuadric::SurfaceQuadric(pugi::xml_node surf_node)
-  : CSGSurface(surf_node)
+std::vector<double> SurfaceZCone::coefficients() const
 {
-  read_coeffs(surf_node, id_, A_, B_, C_, D_, E_, F_, G_, H_, J_, K_);
+  return {x0_, y0_, z0_, radius_sq_};
 }
 
-double
-SurfaceQuadric::evaluate(Position r) const
-{
-  const double x = r.x;
-  const double y = r.y;
-  const double z = r.z;
-  return x*(A_*x + D_*y + G_) +
-         y*(B_*y + E_*z + H_) +
-         z*(C_*z + F_*x + J_) + K_;
-}
+//==============================================================================
+// Generic functions for general quadric surfaces
+//==============================================================================
 
 double
-SurfaceQuadric::distance(Position r, Direction ang, bool coincident) const
+quadric_distance(Position r, Direction ang, bool coincident, double A,
+                 double B, double C, double D, double E, double F, double G,
+                 double H, double J, double K)
 {
   const double &x = r.x;
   const double &y = r.y;
@@ -997,11 +1117,11 @@ SurfaceQuadric::distance(Position r, Direction ang, bool coincident) const
   const double &v = ang.y;
   const double &w = ang.z;
 
-  const double a = A_*u*u + B_*v*v + C_*w*w + D_*u*v + E_*v*w + F_*u*w;
-  const double k = A_*u*x + B_*v*y + C_*w*z + 0.5*(D_*(u*y + v*x)
-                   + E_*(v*z + w*y) + F_*(w*x + u*z) + G_*u + H_*v + J_*w);
-  const double c = A_*x*x + B_*y*y + C_*z*z + D_*x*y + E_*y*z +  F_*x*z + G_*x
-                   + H_*y + J_*z + K_;
+  const double a = A*u*u + B*v*v + C*w*w + D*u*v + E*v*w + F*u*w;
+  const double k = A*u*x + B*v*y + C*w*z + 0.5*(D*(u*y + v*x)
+                   + E*(v*z + w*y) + F*(w*x + u*z) + G*u + H*v + J*w);
+  const double c = A*x*x + B*y*y + C*z*z + D*x*y + E*y*z +  F*x*z + G*x
+                   + H*y + J*z + K;
   double quad = k*k - a*c;
 
   double d;
@@ -1041,6 +1161,34 @@ SurfaceQuadric::distance(Position r, Direction ang, bool coincident) const
   return d;
 }
 
+//==============================================================================
+// SurfaceQuadric implementation
+//==============================================================================
+
+SurfaceQuadric::SurfaceQuadric(pugi::xml_node surf_node)
+  : CSGSurface(surf_node)
+{
+  read_coeffs(surf_node, id_, A_, B_, C_, D_, E_, F_, G_, H_, J_, K_);
+}
+
+double
+SurfaceQuadric::evaluate(Position r) const
+{
+  const double x = r.x;
+  const double y = r.y;
+  const double z = r.z;
+  return x*(A_*x + D_*y + G_) +
+         y*(B_*y + E_*z + H_) +
+         z*(C_*z + F_*x + J_) + K_;
+}
+
+double
+SurfaceQuadric::distance(Position r, Direction ang, bool coincident) const
+{
+  return quadric_distance(r, ang, coincident, A_, B_, C_, D_, E_, F_, G_, H_,
+                          J_, K_);
+}
+
 Direction
 SurfaceQuadric::normal(Position r) const
 {
@@ -1059,6 +1207,351 @@ void SurfaceQuadric::to_hdf5_inner(hid_t group_id) const
   write_dataset(group_id, "coefficients", coeffs);
 }
 
+std::vector<double> SurfaceQuadric::coefficients() const
+{
+  return {A_, B_, C_, D_, E_, F_, G_, H_, J_, K_};
+}
+
+//==============================================================================
+// Distance kernels for packed coefficients
+//==============================================================================
+
+// Number of coefficients stored for each kind of surface
+int
+n_coefficients(SurfaceKind kind)
+{
+  switch (kind) {
+    case SurfaceKind::x_plane:
+    case SurfaceKind::y_plane:
+    case SurfaceKind::z_plane:
+      return 1;
+    case SurfaceKind::x_cylinder:
+    case SurfaceKind::y_cylinder:
+    case SurfaceKind::z_cylinder:
+      return 3;
+    case SurfaceKind::plane:
+    case SurfaceKind::sphere:
+    case SurfaceKind::x_cone:
+    case SurfaceKind::y_cone:
+    case SurfaceKind::z_cone:
+      return 4;
+    case SurfaceKind::quadric:
+      return 10;
+    default:
+      return 0;
+  }
+}
+
+// The template parameter indicates the kind of surface. Coefficient k of the
+// surface is given by c[k*stride].
+template<SurfaceKind K> double
+packed_distance(Position r, Direction u, bool coincident, const double* c,
+                int stride);
+
+template<> double
+packed_distance<SurfaceKind::x_plane>(Position r, Direction u,
+  bool coincident, const double* c, int stride)
+{
+  return axis_aligned_plane_distance<0>(r, u, coincident, c[0]);
+}
+
+template<> double
+packed_distance<SurfaceKind::y_plane>(Position r, Direction u,
+  bool coincident, const double* c, int stride)
+{
+  return axis_aligned_plane_distance<1>(r, u, coincident, c[0]);
+}
+
+template<> double
+packed_distance<SurfaceKind::z_plane>(Position r, Direction u,
+  bool coincident, const double* c, int stride)
+{
+  return axis_aligned_plane_distance<2>(r, u, coincident, c[0]);
+}
+
+template<> double
+packed_distance<SurfaceKind::plane>(Position r, Direction u,
+  bool coincident, const double* c, int stride)
+{
+  return plane_distance(r, u, coincident, c[0], c[stride], c[2*stride],
+                        c[3*stride]);
+}
+
+template<> double
+packed_distance<SurfaceKind::x_cylinder>(Position r, Direction u,
+  bool coincident, const double* c, int stride)
+{
+  return axis_aligned_cylinder_distance<0, 1, 2>(r, u, coincident, c[0],
+    c[stride], c[2*stride]);
+}
+
+template<> double
+packed_distance<SurfaceKind::y_cylinder>(Position r, Direction u,
+  bool coincident, const double* c, int stride)
+{
+  return axis_aligned_cylinder_distance<1, 0, 2>(r, u, coincident, c[0],
+    c[stride], c[2*stride]);
+}
+
+template<> double
+packed_distance<SurfaceKind::z_cylinder>(Position r, Direction u,
+  bool coincident, const double* c, int stride)
+{
+  return axis_aligned_cylinder_distance<2, 0, 1>(r, u, coincident, c[0],
+    c[stride], c[2*stride]);
+}
+
+template<> double
+packed_distance<SurfaceKind::sphere>(Position r, Direction u,
+  bool coincident, const double* c, int stride)
+{
+  return sphere_distance(r, u, coincident, c[0], c[stride], c[2*stride],
+                         c[3*stride]);
+}
+
+template<> double
+packed_distance<SurfaceKind::x_cone>(Position r, Direction u,
+  bool coincident, const double* c, int stride)
+{
+  return axis_aligned_cone_distance<0, 1, 2>(r, u, coincident, c[0],
+    c[stride], c[2*stride], c[3*stride]);
+}
+
+template<> double
+packed_distance<SurfaceKind::y_cone>(Position r, Direction u,
+  bool coincident, const double* c, int stride)
+{
+  return axis_aligned_cone_distance<1, 0, 2>(r, u, coincident, c[stride],
+    c[0], c[2*stride], c[3*stride]);
+}
+
+template<> double
+packed_distance<SurfaceKind::z_cone>(Position r, Direction u,
+  bool coincident, const double* c, int stride)
+{
+  return axis_aligned_cone_distance<2, 0, 1>(r, u, coincident, c[2*stride],
+    c[0], c[stride], c[3*stride]);
+}
+
+template<> double
+packed_distance<SurfaceKind::quadric>(Position r, Direction u,
+  bool coincident, const double* c, int stride)
+{
+  return quadric_distance(r, u, coincident, c[0], c[stride], c[2*stride],
+    c[3*stride], c[4*stride], c[5*stride], c[6*stride], c[7*stride],
+    c[8*stride], c[9*stride]);
+}
+
+// Compute distances to a group of surfaces of the same kind whose coefficients
+// are stored coefficient-major
+template<SurfaceKind K> void
+packed_distances(Position r, Direction u, int32_t on_surface, int n,
+                 const int32_t* token, const int* index, const double* c,
+                 double* d)
+{
+  for (int j = 0; j < n; ++j) {
+    d[index[j]] = packed_distance<K>(r, u, token[j] == on_surface, c + j, n);
+  }
+}
+
+//==============================================================================
+// SurfacePack implementation
+//==============================================================================
+
+void
+SurfacePack::push_back(const Surface& surf)
+{
+  entries_.push_back({surf.kind(), static_cast<int>(coeffs_.size())});
+  auto c = surf.coefficients();
+  coeffs_.insert(coeffs_.end(), c.begin(), c.end());
+}
+
+void
+SurfacePack::clear()
+{
+  entries_.clear();
+  coeffs_.clear();
+}
+
+double
+SurfacePack::evaluate_other(int i, Position r) const
+{
+  return model::surfaces[i]->evaluate(r);
+}
+
+double
+SurfacePack::distance(int i, Position r, Direction u, bool coincident) const
+{
+  const double* c = coeffs(i);
+  switch (kind(i)) {
+    case SurfaceKind::x_plane:
+      return packed_distance<SurfaceKind::x_plane>(r, u, coincident, c, 1);
+    case SurfaceKind::y_plane:
+      return packed_distance<SurfaceKind::y_plane>(r, u, coincident, c, 1);
+    case SurfaceKind::z_plane:
+      return packed_distance<SurfaceKind::z_plane>(r, u, coincident, c, 1);
+    case SurfaceKind::plane:
+      return packed_distance<SurfaceKind::plane>(r, u, coincident, c, 1);
+    case SurfaceKind::x_cylinder:
+      return packed_distance<SurfaceKind::x_cylinder>(r, u, coincident, c, 1);
+    case SurfaceKind::y_cylinder:
+      return packed_distance<SurfaceKind::y_cylinder>(r, u, coincident, c, 1);
+    case SurfaceKind::z_cylinder:
+      return packed_distance<SurfaceKind::z_cylinder>(r, u, coincident, c, 1);
+    case SurfaceKind::sphere:
+      return packed_distance<SurfaceKind::sphere>(r, u, coincident, c, 1);
+    case SurfaceKind::x_cone:
+      return packed_distance<SurfaceKind::x_cone>(r, u, coincident, c, 1);
+    case SurfaceKind::y_cone:
+      return packed_distance<SurfaceKind::y_cone>(r, u, coincident, c, 1);
+    case SurfaceKind::z_cone:
+      return packed_distance<SurfaceKind::z_cone>(r, u, coincident, c, 1);
+    case SurfaceKind::quadric:
+      return packed_distance<SurfaceKind::quadric>(r, u, coincident, c, 1);
+    default:
+      return model::surfaces[i]->distance(r, u, coincident);
+  }
+}
+
+Direction
+SurfacePack::normal(int i, Position r) const
+{
+  const double* c = coeffs(i);
+  switch (kind(i)) {
+    case SurfaceKind::x_plane:
+      return {1., 0., 0.};
+    case SurfaceKind::y_plane:
+      return {0., 1., 0.};
+    case SurfaceKind::z_plane:
+      return {0., 0., 1.};
+    case SurfaceKind::plane:
+      return {c[0], c[1], c[2]};
+    case SurfaceKind::x_cylinder:
+      return axis_aligned_cylinder_normal<0, 1, 2>(r, c[0], c[1]);
+    case SurfaceKind::y_cylinder:
+      return axis_aligned_cylinder_normal<1, 0, 2>(r, c[0], c[1]);
+    case SurfaceKind::z_cylinder:
+      return axis_aligned_cylinder_normal<2, 0, 1>(r, c[0], c[1]);
+    case SurfaceKind::sphere:
+      return {2.0*(r.x - c[0]), 2.0*(r.y - c[1]), 2.0*(r.z - c[2])};
+    case SurfaceKind::x_cone:
+      return axis_aligned_cone_normal<0, 1, 2>(r, c[0], c[1], c[2], c[3]);
+    case SurfaceKind::y_cone:
+      return axis_aligned_cone_normal<1, 0, 2>(r, c[1], c[0], c[2], c[3]);
+    case SurfaceKind::z_cone:
+      return axis_aligned_cone_normal<2, 0, 1>(r, c[2], c[0], c[1], c[3]);
+    case SurfaceKind::quadric:
+      return {2.0*c[0]*r.x + c[3]*r.y + c[5]*r.z + c[6],
+              2.0*c[1]*r.y + c[3]*r.x + c[4]*r.z + c[7],
+              2.0*c[2]*r.z + c[4]*r.y + c[5]*r.x + c[8]};
+    default:
+      return model::surfaces[i]->normal(r);
+  }
+}
+
+//==============================================================================
+// SurfaceBatch implementation
+//==============================================================================
+
+SurfaceBatch::SurfaceBatch(const std::vector<int32_t>& halfspaces)
+{
+  // Gather the half-spaces of each kind, keeping their relative order
+  for (int k = 0; k <= static_cast<int>(SurfaceKind::other); ++k) {
+    SurfaceKind kind = static_cast<SurfaceKind>(k);
+    Group group {kind, static_cast<int>(token_.size()), 0,
+                 static_cast<int>(coeffs_.size())};
+    for (int i = 0; i < halfspaces.size(); ++i) {
+      // Note the off-by-one indexing
+      const Surface& surf {*model::surfaces[std::abs(halfspaces[i]) - 1]};
+      if (surf.kind() != kind) continue;
+      token_.push_back(halfspaces[i]);
+      index_.push_back(i);
+      ++group.n;
+    }
+    if (group.n == 0) continue;
+
+    // Store the coefficients of the group coefficient-major
+    int n_coeffs = n_coefficients(kind);
+    coeffs_.resize(coeffs_.size() + n_coeffs*group.n);
+    for (int j = 0; j < group.n; ++j) {
+      const Surface& surf {*model::surfaces[
+        std::abs(token_[group.start + j]) - 1]};
+      auto c = surf.coefficients();
+      for (int m = 0; m < n_coeffs; ++m) {
+        coeffs_[group.coeff_start + m*group.n + j] = c[m];
+      }
+    }
+    groups_.push_back(group);
+  }
+}
+
+void
+SurfaceBatch::distances(Position r, Direction u, int32_t on_surface,
+                        double* d) const
+{
+  for (const Group& g : groups_) {
+    const int32_t* token = &token_[g.start];
+    const int* index = &index_[g.start];
+    const double* c = coeffs_.data() + g.coeff_start;
+    switch (g.kind) {
+      case SurfaceKind::x_plane:
+        packed_distances<SurfaceKind::x_plane>(r, u, on_surface, g.n, token,
+          index, c, d);
+        break;
+      case SurfaceKind::y_plane:
+        packed_distances<SurfaceKind::y_plane>(r, u, on_surface, g.n, token,
+          index, c, d);
+        break;
+      case SurfaceKind::z_plane:
+        packed_distances<SurfaceKind::z_plane>(r, u, on_surface, g.n, token,
+          index, c, d);
+        break;
+      case SurfaceKind::plane:
+        packed_distances<SurfaceKind::plane>(r, u, on_surface, g.n, token,
+          index, c, d);
+        break;
+      case SurfaceKind::x_cylinder:
+        packed_distances<SurfaceKind::x_cylinder>(r, u, on_surface, g.n, token,
+          index, c, d);
+        break;
+      case SurfaceKind::y_cylinder:
+        packed_distances<SurfaceKind::y_cylinder>(r, u, on_surface, g.n, token,
+          index, c, d);
+        break;
+      case SurfaceKind::z_cylinder:
+        packed_distances<SurfaceKind::z_cylinder>(r, u, on_surface, g.n, token,
+          index, c, d);
+        break;
+      case SurfaceKind::sphere:
+        packed_distances<SurfaceKind::sphere>(r, u, on_surface, g.n, token,
+          index, c, d);
+        break;
+      case SurfaceKind::x_cone:
+        packed_distances<SurfaceKind::x_cone>(r, u, on_surface, g.n, token,
+          index, c, d);
+        break;
+      case SurfaceKind::y_cone:
+        packed_distances<SurfaceKind::y_cone>(r, u, on_surface, g.n, token,
+          index, c, d);
+        break;
+      case SurfaceKind::z_cone:
+        packed_distances<SurfaceKind::z_cone>(r, u, on_surface, g.n, token,
+          index, c, d);
+        break;
+      case SurfaceKind::quadric:
+        packed_distances<SurfaceKind::quadric>(r, u, on_surface, g.n, token,
+          index, c, d);
+        break;
+      default:
+        for (int j = 0; j < g.n; ++j) {
+          // Note the off-by-one indexing
+          const Surface& surf {*model::surfaces[std::abs(token[j]) - 1]};
+          d[index[j]] = surf.distance(r, u, token[j] == on_surface);
+        }
+    }
+  }
+}
+
 //==============================================================================
 
 void read_surfaces(pugi::xml_node node)
@@ -1267,6 +1760,7 @@ extern "C" void free_memory_surfaces()
   for (Surface* surf : model::surfaces) {delete surf;}
   model::surfaces.clear();
   model::surface_map.clear();
+  model::surface_pack.clear();
 }
 
 } // namespace openmc
@@ -1,6 +1,7 @@
 #include "openmc/tallies/filter.h"
 
 #include <string>
+#include <unordered_map>
 
 #include "openmc/capi.h"
 #include "openmc/constants.h"  // for MAX_LINE_LEN;
@@ -25,6 +26,7 @@
 #include "openmc/tallies/filter_surface.h"
 #include "openmc/tallies/filter_universe.h"
 #include "openmc/tallies/filter_zernike.h"
+#include "openmc/tallies/tally.h"
 
 // explicit template instantiation definition
 template class std::vector<openmc::FilterMatch>;
@@ -37,12 +39,121 @@ namespace openmc {
 
 namespace simulation {
 std::vector<FilterMatch> filter_matches;
+std::vector<int> filter_matches_found;
+std::vector<int> filter_match_index;
 } // namespace simulation
 
 namespace model {
 std::vector<std::unique_ptr<Filter>> tally_filters;
 } // namespace model
 
+//==============================================================================
+// Filter implementation
+//==============================================================================
+
+bool
+Filter::equivalent(const Filter& other) const
+{
+  return other.type() == type();
+}
+
+std::string
+Filter::serialized_bins() const
+{
+  // Write the filter to an HDF5 file that is only kept in memory
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  H5Pset_fapl_core(fapl, 4096, false);
+  hid_t file = H5Fcreate("filter.h5", H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+  H5Pclose(fapl);
+  to_statepoint(file);
+
+  // Concatenate the name, element size, and raw data of each dataset
+  std::string out;
+  for (const auto& name : dataset_names(file)) {
+    hid_t dset = open_dataset(file, name.c_str());
+    hid_t dtype = H5Dget_type(dset);
+    hid_t dspace = H5Dget_space(dset);
+    size_t size = H5Tget_size(dtype);
+    std::string data(size*H5Sget_simple_extent_npoints(dspace), '\0');
+    if (!data.empty()) {
+      H5Dread(dset, dtype, H5S_ALL, H5S_ALL, H5P_DEFAULT, &data[0]);
+    }
+    H5Sclose(dspace);
+    H5Tclose(dtype);
+    close_dataset(dset);
+
+    out += name + '\0' + std::to_string(size) + '\0' + data;
+  }
+
+  file_close(file);
+  return out;
+}
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+void
+setup_filter_matches()
+{
+  int n = model::tally_filters.size();
+
+  // Find the tallies that use each filter
+  std::vector<std::vector<int>> users(n);
+  for (int i = 0; i < model::tallies.size(); ++i) {
+    for (auto i_filt : model::tallies[i]->filters()) users[i_filt].push_back(i);
+  }
+
+  // Each filter shares the match of the first filter equivalent to it, unless
+  // a tally uses both filters since they then need separate current bins.
+  // Filters are grouped by their serialized bins, which are found once for
+  // each filter, and only filters in the same group are compared.
+  auto& index {simulation::filter_match_index};
+  index.assign(n, C_NONE);
+  std::vector<int> first;
+  std::unordered_map<std::string, std::vector<int>> candidates;
+  for (int i = 0; i < n; ++i) {
+    const auto& filt {*model::tally_filters[i]};
+    auto& same_bins {candidates[filt.serialized_bins()]};
+    for (int k = 0; k < same_bins.size() && index[i] == C_NONE; ++k) {
+      int j = same_bins[k];
+      const auto& other {*model::tally_filters[first[j]]};
+      if (!filt.equivalent(other)) continue;
+
+      bool same_tally = false;
+      for (auto i_tally : users[i]) {
+        for (auto i_filt : model::tallies[i_tally]->filters()) {
+          if (i_filt != i && index[i_filt] == j) same_tally = true;
+        }
+      }
+      if (!same_tally) index[i] = j;
+    }
+
+    if (index[i] == C_NONE) {
+      index[i] = first.size();
+      same_bins.push_back(first.size());
+      first.push_back(i);
+    }
+  }
+
+#pragma omp parallel
+  {
+    simulation::filter_matches.clear();
+    simulation::filter_matches.resize(first.size());
+    simulation::filter_matches_found.clear();
+    simulation::filter_matches_found.reserve(first.size());
+  }
+}
+
+void
+reset_filter_matches()
+{
+  for (auto i : simulation::filter_matches_found) {
+    simulation::filter_matches[i].bins_present_ = false;
+  }
+  simulation::filter_matches_found.clear();
+}
+
 //==============================================================================
 // Fortran compatibility functions
 //==============================================================================
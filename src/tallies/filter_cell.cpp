@@ -3,6 +3,7 @@
 #include <sstream>
 
 #include "openmc/capi.h"
+#include "openmc/constants.h"
 #include "openmc/cell.h"
 #include "openmc/error.h"
 #include "openmc/xml_interface.h"
@@ -32,6 +33,7 @@ CellFilter::initialize()
   }
 
   // Populate the index->bin map.
+  map_.assign(model::cells.size(), C_NONE);
   for (int i = 0; i < cells_.size(); i++) {
     map_[cells_[i]] = i;
   }
@@ -42,10 +44,10 @@ CellFilter::get_all_bins(const Particle* p, int estimator,
                          FilterMatch& match) const
 {
   for (int i = 0; i < p->n_coord; i++) {
-    auto search = map_.find(p->coord[i].cell);
-    if (search != map_.end()) {
+    int32_t i_cell = p->coord[i].cell;
+    if (i_cell < map_.size() && map_[i_cell] != C_NONE) {
       //TODO: off-by-one
-      match.bins_.push_back(search->second + 1);
+      match.bins_.push_back(map_[i_cell] + 1);
       match.weights_.push_back(1.0);
     }
   }
@@ -1,6 +1,7 @@
 #include "openmc/tallies/filter_cellfrom.h"
 
 #include "openmc/cell.h"
+#include "openmc/constants.h"
 
 namespace openmc {
 
@@ -9,10 +10,10 @@ CellFromFilter::get_all_bins(const Particle* p, int estimator,
                              FilterMatch& match) const
 {
   for (int i = 0; i < p->last_n_coord; i++) {
-    auto search = map_.find(p->last_cell[i]);
-    if (search != map_.end()) {
+    int32_t i_cell = p->last_cell[i];
+    if (i_cell >= 0 && i_cell < map_.size() && map_[i_cell] != C_NONE) {
       //TODO: off-by-one
-      match.bins_.push_back(search->second + 1);
+      match.bins_.push_back(map_[i_cell] + 1);
       match.weights_.push_back(1.0);
     }
   }
@@ -2,6 +2,7 @@
 
 #include "openmc/cell.h"
 #include "openmc/error.h"
+#include "openmc/geometry.h"
 #include "openmc/geometry_aux.h" // For distribcell_path
 #include "openmc/lattice.h"
 #include "openmc/xml_interface.h"
@@ -41,6 +42,15 @@ DistribcellFilter::get_all_bins(const Particle* p, int estimator,
   int offset = 0;
   auto distribcell_index = model::cells[cell_]->distribcell_index_;
   for (int i = 0; i < p->n_coord; i++) {
+    // If the geometry hierarchy was flattened, the instance is stored with the
+    // placement of the universe containing the cell.
+    if (cell_ == p->coord[i].cell && p->coord[i].node != C_NONE) {
+      //TODO: off-by-one
+      match.bins_.push_back(model::geometry_nodes[p->coord[i].node].instance + 1);
+      match.weights_.push_back(1.0);
+      return;
+    }
+
     auto& c {*model::cells[p->coord[i].cell]};
     if (c.type_ == FILL_UNIVERSE) {
       offset += c.offset_[distribcell_index];
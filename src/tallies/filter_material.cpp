@@ -3,6 +3,7 @@
 #include <sstream>
 
 #include "openmc/capi.h"
+#include "openmc/constants.h"
 #include "openmc/error.h"
 #include "openmc/material.h"
 #include "openmc/xml_interface.h"
@@ -33,6 +34,7 @@ MaterialFilter::initialize()
   }
 
   // Populate the index->bin map.
+  map_.assign(model::materials.size(), C_NONE);
   for (int i = 0; i < materials_.size(); i++) {
     map_[materials_[i]] = i;
   }
@@ -42,10 +44,10 @@ void
 MaterialFilter::get_all_bins(const Particle* p, int estimator,
                              FilterMatch& match) const
 {
-  auto search = map_.find(p->material - 1);
-  if (search != map_.end()) {
+  int32_t i_mat = p->material - 1;
+  if (i_mat >= 0 && i_mat < map_.size() && map_[i_mat] != C_NONE) {
     //TODO: off-by-one
-    match.bins_.push_back(search->second + 1);
+    match.bins_.push_back(map_[i_mat] + 1);
     match.weights_.push_back(1.0);
   }
 }
@@ -115,7 +117,7 @@ openmc_material_filter_set_bins(int32_t index, int32_t n, const int32_t* bins)
   filt->materials_.resize(n);
   for (int i = 0; i < n; i++) filt->materials_[i] = bins[i];
   filt->n_bins_ = filt->materials_.size();
-  filt->map_.clear();
+  filt->map_.assign(model::materials.size(), C_NONE);
   for (int i = 0; i < n; i++) filt->map_[filt->materials_[i]] = i;
   filter_update_n_bins(index);
   return 0;
@@ -1,5 +1,8 @@
 #include "openmc/tallies/filter_meshsurface.h"
 
+#include <array>
+#include <string>
+
 #include "openmc/capi.h"
 #include "openmc/constants.h"
 #include "openmc/error.h"
@@ -30,42 +33,24 @@ MeshSurfaceFilter::text_label(int bin) const
   std::string out = MeshFilter::text_label(i_mesh);
 
   // Get surface part of label.
-  switch (i_surf) {
+  std::string axis;
+  if (dynamic_cast<const CylindricalMesh*>(&mesh)) {
+    axis = std::array<std::string, 3>{"r", "phi", "z"}[(i_surf - 1) / 4];
+  } else {
+    axis = std::array<std::string, 3>{"x", "y", "z"}[(i_surf - 1) / 4];
+  }
+  switch ((i_surf - 1) % 4 + 1) {
     case OUT_LEFT:
-      out += " Outgoing, x-min";
+      out += " Outgoing, " + axis + "-min";
       break;
     case IN_LEFT:
-      out += " Incoming, x-min";
+      out += " Incoming, " + axis + "-min";
       break;
     case OUT_RIGHT:
-      out += " Outgoing, x-max";
+      out += " Outgoing, " + axis + "-max";
       break;
     case IN_RIGHT:
-      out += " Incoming, x-max";
-      break;
-    case OUT_BACK:
-      out += " Outgoing, y-min";
-      break;
-    case IN_BACK:
-      out += " Incoming, y-min";
-      break;
-    case OUT_FRONT:
-      out += " Outgoing, y-max";
-      break;
-    case IN_FRONT:
-      out += " Incoming, y-max";
-      break;
-    case OUT_BOTTOM:
-      out += " Outgoing, z-min";
-      break;
-    case IN_BOTTOM:
-      out += " Incoming, z-min";
-      break;
-    case OUT_TOP:
-      out += " Outgoing, z-max";
-      break;
-    case IN_TOP:
-      out += " Incoming, z-max";
+      out += " Incoming, " + axis + "-max";
       break;
   }
 
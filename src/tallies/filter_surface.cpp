@@ -2,6 +2,7 @@
 
 #include <sstream>
 
+#include "openmc/constants.h"
 #include "openmc/error.h"
 #include "openmc/surface.h"
 #include "openmc/xml_interface.h"
@@ -32,6 +33,7 @@ SurfaceFilter::initialize()
   }
 
   // Populate the index->bin map.
+  map_.assign(model::surfaces.size(), C_NONE);
   for (int i = 0; i < surfaces_.size(); i++) {
     map_[surfaces_[i]] = i;
   }
@@ -41,10 +43,10 @@ void
 SurfaceFilter::get_all_bins(const Particle* p, int estimator,
                             FilterMatch& match) const
 {
-  auto search = map_.find(std::abs(p->surface)-1);
-  if (search != map_.end()) {
+  int32_t i_surf = std::abs(p->surface) - 1;
+  if (i_surf >= 0 && i_surf < map_.size() && map_[i_surf] != C_NONE) {
     //TODO: off-by-one
-    match.bins_.push_back(search->second + 1);
+    match.bins_.push_back(map_[i_surf] + 1);
     if (p->surface < 0) {
       match.weights_.push_back(-1.0);
     } else {
@@ -3,6 +3,7 @@
 #include <sstream>
 
 #include "openmc/cell.h"
+#include "openmc/constants.h"
 #include "openmc/error.h"
 #include "openmc/xml_interface.h"
 
@@ -32,6 +33,7 @@ UniverseFilter::initialize()
   }
 
   // Populate the index->bin map.
+  map_.assign(model::universes.size(), C_NONE);
   for (int i = 0; i < universes_.size(); i++) {
     map_[universes_[i]] = i;
   }
@@ -42,10 +44,10 @@ UniverseFilter::get_all_bins(const Particle* p, int estimator,
                              FilterMatch& match) const
 {
   for (int i = 0; i < p->n_coord; i++) {
-    auto search = map_.find(p->coord[i].universe);
-    if (search != map_.end()) {
+    int32_t i_univ = p->coord[i].universe;
+    if (i_univ < map_.size() && map_[i_univ] != C_NONE) {
       //TODO: off-by-one
-      match.bins_.push_back(search->second + 1);
+      match.bins_.push_back(map_[i_univ] + 1);
       match.weights_.push_back(1.0);
     }
   }
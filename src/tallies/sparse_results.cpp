@@ -0,0 +1,62 @@
+#include "openmc/tallies/sparse_results.h"
+
+#include <algorithm> // for min, sort
+
+namespace openmc {
+
+//==============================================================================
+// SparseResults implementation
+//==============================================================================
+
+constexpr int64_t SparseResults::BLOCK_SIZE;
+
+void SparseResults::resize(int64_t n_filter, int64_t n_score)
+{
+  n_filter_ = n_filter;
+  n_score_ = n_score;
+  int64_t n_blocks = (n_filter + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  table_.reset(new std::atomic<double*>[n_blocks]());
+  storage_.clear();
+  allocated_.clear();
+}
+
+void SparseResults::clear()
+{
+  for (auto i_block : allocated_) {
+    table_[i_block].store(nullptr, std::memory_order_relaxed);
+  }
+  storage_.clear();
+  allocated_.clear();
+}
+
+double* SparseResults::allocate(int64_t i_block)
+{
+  double* block;
+  #pragma omp critical (SparseResultsAllocate)
+  {
+    // Another thread may have allocated the block while this one was waiting
+    block = table_[i_block].load(std::memory_order_relaxed);
+    if (!block) {
+      std::size_t n = block_length(i_block) * n_score_ * 3;
+      storage_.emplace_back(new double[n]());
+      allocated_.push_back(i_block);
+      block = storage_.back().get();
+      table_[i_block].store(block, std::memory_order_release);
+    }
+  }
+  return block;
+}
+
+std::vector<int64_t> SparseResults::blocks() const
+{
+  std::vector<int64_t> blocks {allocated_};
+  std::sort(blocks.begin(), blocks.end());
+  return blocks;
+}
+
+int64_t SparseResults::block_length(int64_t i_block) const
+{
+  return std::min(BLOCK_SIZE, n_filter_ - i_block*BLOCK_SIZE);
+}
+
+} // namespace openmc
@@ -1,11 +1,15 @@
 #include "openmc/tallies/tally.h"
 
 #include "openmc/capi.h"
+#include "openmc/cell.h"
 #include "openmc/constants.h"
 #include "openmc/error.h"
+#include "openmc/hdf5_interface.h"
+#include "openmc/material.h"
 #include "openmc/message_passing.h"
 #include "openmc/mgxs_interface.h"
 #include "openmc/nuclide.h"
+#include "openmc/particle.h"
 #include "openmc/reaction_product.h"
 #include "openmc/settings.h"
 #include "openmc/simulation.h"
@@ -16,6 +20,7 @@
 #include "openmc/tallies/filter_delayedgroup.h"
 #include "openmc/tallies/filter_energy.h"
 #include "openmc/tallies/filter_legendre.h"
+#include "openmc/tallies/filter_material.h"
 #include "openmc/tallies/filter_mesh.h"
 #include "openmc/tallies/filter_meshsurface.h"
 #include "openmc/tallies/filter_surface.h"
@@ -25,8 +30,10 @@
 #include "xtensor/xbuilder.hpp" // for empty_like
 #include "xtensor/xview.hpp"
 
+#include <algorithm> // for any_of, sort, unique
 #include <array>
 #include <cstddef>
+#include <cstdlib> // for calloc
 #include <sstream>
 #include <string>
 
@@ -45,6 +52,22 @@ namespace model {
   std::vector<int> active_collision_tallies;
   std::vector<int> active_meshsurf_tallies;
   std::vector<int> active_surface_tallies;
+
+  TallyDispatch analog_tally_dispatch;
+  TallyDispatch tracklength_tally_dispatch;
+  TallyDispatch collision_tally_dispatch;
+}
+
+namespace simulation {
+  std::vector<double> tally_results_arena;
+
+  // Buffers for the tallies found by TallyDispatch::tallies
+  extern std::vector<int> dispatch_positions;
+  extern std::vector<int> dispatch_tallies;
+  #pragma omp threadprivate(dispatch_positions, dispatch_tallies)
+
+  std::vector<int> dispatch_positions;
+  std::vector<int> dispatch_tallies;
 }
 
 double global_tally_absorption;
@@ -216,6 +239,16 @@ void
 Tally::init_from_xml(pugi::xml_node node)
 {
   if (check_for_node(node, "name")) name_ = get_node_value(node, "name");
+
+  if (check_for_node(node, "storage")) {
+    auto storage = get_node_value(node, "storage", true, true);
+    if (storage == "sparse") {
+      sparse_ = true;
+    } else if (storage != "dense") {
+      fatal_error("Invalid storage \"" + storage + "\" on tally. Valid "
+        "options are \"dense\" and \"sparse\".");
+    }
+  }
 }
 
 void
@@ -503,6 +536,91 @@ Tally::init_triggers(pugi::xml_node node, int i_tally)
   }
 }
 
+//==============================================================================
+// TallyDispatch implementation
+//==============================================================================
+
+void
+TallyDispatch::build(const std::vector<int>& tallies)
+{
+  tallies_ = tallies;
+  anywhere_.clear();
+  by_cell_.assign(model::cells.size(), {});
+  by_material_.assign(model::materials.size(), {});
+  indexed_ = false;
+
+  // Without the index, every tally in the list is tried at each event
+  if (!settings::tally_dispatch) return;
+
+  for (int pos = 0; pos < tallies_.size(); ++pos) {
+    const auto& tally {*model::tallies[tallies_[pos]]};
+
+    // Use the first cell or material filter of the tally, if any
+    const CellFilter* cell_filt = nullptr;
+    const MaterialFilter* mat_filt = nullptr;
+    for (auto i_filt : tally.filters()) {
+      const auto* filt = model::tally_filters[i_filt].get();
+      if (filt->type() == "cell") {
+        cell_filt = static_cast<const CellFilter*>(filt);
+        break;
+      } else if (filt->type() == "material") {
+        mat_filt = static_cast<const MaterialFilter*>(filt);
+        break;
+      }
+    }
+
+    if (cell_filt) {
+      for (auto i_cell : cell_filt->cells_) {
+        auto& list {by_cell_[i_cell]};
+        if (list.empty() || list.back() != pos) list.push_back(pos);
+      }
+      indexed_ = true;
+    } else if (mat_filt) {
+      for (auto i_mat : mat_filt->materials_) {
+        auto& list {by_material_[i_mat]};
+        if (list.empty() || list.back() != pos) list.push_back(pos);
+      }
+      indexed_ = true;
+    } else {
+      anywhere_.push_back(pos);
+    }
+  }
+}
+
+const std::vector<int>&
+TallyDispatch::tallies(const Particle* p) const
+{
+  if (!indexed_) return tallies_;
+
+  // Gather the positions of the tallies that can score anywhere, in any of the
+  // particle's cells, or in its material
+  auto& positions {simulation::dispatch_positions};
+  positions.assign(anywhere_.begin(), anywhere_.end());
+  for (int i = 0; i < p->n_coord; ++i) {
+    int32_t i_cell = p->coord[i].cell;
+    if (i_cell >= 0 && i_cell < by_cell_.size()) {
+      const auto& list {by_cell_[i_cell]};
+      positions.insert(positions.end(), list.begin(), list.end());
+    }
+  }
+  int32_t i_mat = p->material - 1;
+  if (i_mat >= 0 && i_mat < by_material_.size()) {
+    const auto& list {by_material_[i_mat]};
+    positions.insert(positions.end(), list.begin(), list.end());
+  }
+
+  // Keep the order of the list so that assume_separate behaves the same, and
+  // score a tally only once even if it matches on several levels
+  std::sort(positions.begin(), positions.end());
+  positions.erase(std::unique(positions.begin(), positions.end()),
+    positions.end());
+
+  auto& result {simulation::dispatch_tallies};
+  result.clear();
+  for (auto pos : positions) result.push_back(tallies_[pos]);
+  return result;
+}
+
 //==============================================================================
 // Non-member functions
 //==============================================================================
@@ -522,18 +640,157 @@ adaptor_type<2> global_tallies()
 
 adaptor_type<3> tally_results(int idx)
 {
-  // Get pointer to tally results
-  double* results;
-  std::array<std::size_t, 3> shape;
-  // TODO: off-by-one
-  openmc_tally_results(idx+1, &results, shape.data());
-
-  // Adapt array into xtensor with no ownership
+  // Adapt the results of the tally into xtensor with no ownership
+  auto& tally {*model::tallies[idx]};
+  const auto& shape {tally.results_shape_};
   std::size_t size {shape[0] * shape[1] * shape[2]};
-  return xt::adapt(results, size, xt::no_ownership(), shape);
+  return xt::adapt(tally.results_, size, xt::no_ownership(), shape);
+}
+
+extern "C" void allocate_tally_results_f();
+
+void allocate_tally_results()
+{
+  // Determine the shape of the results of each tally and where they start in
+  // the results arena
+  std::vector<std::array<std::size_t, 3>> shapes;
+  std::vector<std::size_t> offsets;
+  std::size_t size = 0;
+  for (const auto& t : model::tallies) {
+    shapes.push_back({static_cast<std::size_t>(t->n_filter_bins()),
+      t->scores_.size() * t->nuclides_.size(), 3});
+    offsets.push_back(size);
+    if (!t->sparse_) size += shapes.back()[0] * shapes.back()[1] * 3;
+  }
+
+  // Sparse results are stored in their own blocks, which are kept if the tally
+  // already had sparse results of the same shape
+  for (int i = 0; i < model::tallies.size(); ++i) {
+    auto& t {*model::tallies[i]};
+    if (!t.sparse_ || (!t.results_ && t.results_shape_ == shapes[i])) {
+      continue;
+    }
+    t.sparse_results_.resize(shapes[i][0], shapes[i][1]);
+  }
+
+  // Copy the results of tallies whose shape has not changed into the new arena
+  std::vector<double> arena(size, 0.0);
+  for (int i = 0; i < model::tallies.size(); ++i) {
+    auto& t {*model::tallies[i]};
+    if (t.sparse_) continue;
+    if (t.results_ && t.results_shape_ == shapes[i]) {
+      std::copy(t.results_, t.results_ + shapes[i][0]*shapes[i][1]*3,
+        arena.data() + offsets[i]);
+    }
+  }
+
+  simulation::tally_results_arena = std::move(arena);
+  for (int i = 0; i < model::tallies.size(); ++i) {
+    auto& t {*model::tallies[i]};
+    if (t.sparse_) {
+      t.results_ = nullptr;
+    } else {
+      t.sparse_results_.resize(0, 0);
+      t.results_ = simulation::tally_results_arena.data() + offsets[i];
+    }
+    t.results_shape_ = shapes[i];
+  }
+
+  // Point the Fortran tally objects at the new results
+  allocate_tally_results_f();
+}
+
+void
+nonzero_tally_results(const Tally& tally, int first, int n,
+  std::vector<int64_t>& bins, std::vector<double>& values)
+{
+  bins.clear();
+  values.clear();
+
+  const auto& shape {tally.results_shape()};
+  int64_t n_score = shape[1];
+  auto add_nonzero = [&](int64_t i_filter, const double* r) {
+    for (int64_t k = 0; k < n_score; ++k, r += 3) {
+      if (std::any_of(r + first, r + first + n,
+          [](double x) {return x != 0.0;})) {
+        bins.push_back(i_filter*n_score + k);
+        values.insert(values.end(), r + first, r + first + n);
+      }
+    }
+  };
+
+  if (tally.sparse_) {
+    const auto& sparse {tally.sparse_results()};
+    for (auto i_block : sparse.blocks()) {
+      const double* r = sparse.block_data(i_block);
+      int64_t start = sparse.block_start(i_block);
+      for (int64_t i = 0; i < sparse.block_length(i_block); ++i) {
+        add_nonzero(start + i, r + i*n_score*3);
+      }
+    }
+  } else {
+    for (int64_t i = 0; i < shape[0]; ++i) {
+      add_nonzero(i, tally.results(i, 0));
+    }
+  }
+}
+
+void
+accumulate_sparse_results(Tally& tally, double total_weight,
+  double total_source)
+{
+  auto& sparse {tally.sparse_results()};
+  int64_t n_score = tally.results_shape()[1];
+  for (auto i_block : sparse.blocks()) {
+    double* r = sparse.block_data(i_block);
+    int64_t n = sparse.block_length(i_block) * n_score;
+    for (int64_t k = 0; k < n; ++k, r += 3) {
+      if (r[RESULT_VALUE] == 0.0) continue;
+      double val = r[RESULT_VALUE]/total_weight * total_source;
+      r[RESULT_VALUE] = 0.0;
+      r[RESULT_SUM] += val;
+      r[RESULT_SUM_SQ] += val*val;
+    }
+  }
 }
 
 #ifdef OPENMC_MPI
+void
+gather_tally_results(const Tally& tally, int first, int n,
+  std::vector<int64_t>& bins, std::vector<double>& values)
+{
+  // Find the nonzero results on this process
+  std::vector<int64_t> local_bins;
+  std::vector<double> local_values;
+  if (!mpi::master) {
+    nonzero_tally_results(tally, first, n, local_bins, local_values);
+  }
+
+  // Determine where the results from each process go on the master process
+  int count = local_bins.size();
+  std::vector<int> counts(mpi::n_procs);
+  MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0,
+    mpi::intracomm);
+
+  std::vector<int> displs(mpi::n_procs);
+  std::vector<int> value_counts(mpi::n_procs);
+  std::vector<int> value_displs(mpi::n_procs);
+  int total = 0;
+  for (int i = 0; i < mpi::n_procs; ++i) {
+    displs[i] = total;
+    value_counts[i] = counts[i] * n;
+    value_displs[i] = total * n;
+    total += counts[i];
+  }
+  bins.resize(mpi::master ? total : 0);
+  values.resize(mpi::master ? total*n : 0);
+
+  MPI_Gatherv(local_bins.data(), count, MPI_INT64_T, bins.data(),
+    counts.data(), displs.data(), MPI_INT64_T, 0, mpi::intracomm);
+  MPI_Gatherv(local_values.data(), count*n, MPI_DOUBLE, values.data(),
+    value_counts.data(), value_displs.data(), MPI_DOUBLE, 0, mpi::intracomm);
+}
+
 void reduce_tally_results()
 {
   for (int i = 0; i < n_tallies; ++i) {
@@ -543,6 +800,31 @@ void reduce_tally_results()
     openmc_tally_get_active(i+1, &active);
     if (!active) continue;
 
+    // Only the nonzero values of sparse tallies are sent to the master process
+    const auto& tally {*model::tallies[i]};
+    if (tally.sparse_) {
+      std::vector<int64_t> bins;
+      std::vector<double> values;
+      gather_tally_results(tally, RESULT_VALUE, 1, bins, values);
+
+      if (mpi::master) {
+        int64_t n_score = tally.results_shape()[1];
+        for (int64_t j = 0; j < bins.size(); ++j) {
+          tally.results(bins[j] / n_score, bins[j] % n_score)[RESULT_VALUE]
+            += values[j];
+        }
+      } else {
+        const auto& sparse {tally.sparse_results()};
+        int64_t n_score = tally.results_shape()[1];
+        for (auto i_block : sparse.blocks()) {
+          double* r = sparse.block_data(i_block);
+          int64_t n = sparse.block_length(i_block) * n_score;
+          for (int64_t k = 0; k < n; ++k) r[3*k + RESULT_VALUE] = 0.0;
+        }
+      }
+      continue;
+    }
+
     // Get view of accumulated tally values
     auto results = tally_results(i);
     auto values_view = xt::view(results, xt::all(), xt::all(), RESULT_VALUE);
@@ -630,6 +912,10 @@ setup_active_tallies_c()
       }
     }
   }
+
+  model::analog_tally_dispatch.build(model::active_analog_tallies);
+  model::tracklength_tally_dispatch.build(model::active_tracklength_tallies);
+  model::collision_tally_dispatch.build(model::active_collision_tallies);
 }
 
 extern "C" void
@@ -643,6 +929,7 @@ free_memory_tally_c()
   model::tally_filters.clear();
 
   model::tallies.clear();
+  simulation::tally_results_arena.clear();
 
   model::active_tallies.clear();
   model::active_analog_tallies.clear();
@@ -650,12 +937,39 @@ free_memory_tally_c()
   model::active_collision_tallies.clear();
   model::active_meshsurf_tallies.clear();
   model::active_surface_tallies.clear();
+  model::analog_tally_dispatch = {};
+  model::tracklength_tally_dispatch = {};
+  model::collision_tally_dispatch = {};
 }
 
 //==============================================================================
 // C-API functions
 //==============================================================================
 
+extern "C" int
+openmc_tally_results(int32_t index, double** ptr, size_t shape_[3])
+{
+  if (index < 1 || index > model::tallies.size()) {
+    set_errmsg("Index in tallies array is out of bounds.");
+    return OPENMC_E_OUT_OF_BOUNDS;
+  }
+
+  const auto& t {*model::tallies[index - 1]};
+  if (t.sparse_) {
+    set_errmsg("Results of tallies with sparse storage are only available "
+      "from statepoint files.");
+    return OPENMC_E_INVALID_TYPE;
+  }
+  if (!t.results(0, 0)) {
+    set_errmsg("Tally results have not been allocated yet.");
+    return OPENMC_E_ALLOCATE;
+  }
+
+  *ptr = t.results(0, 0);
+  std::copy(t.results_shape().begin(), t.results_shape().end(), shape_);
+  return 0;
+}
+
 extern "C" int
 openmc_tally_get_type(int32_t index, int32_t* type)
 {
@@ -885,6 +1199,31 @@ extern "C" {
 
   bool tally_get_depletion_rx_c(Tally* tally) {return tally->depletion_rx_;}
 
+  bool tally_get_sparse_c(Tally* tally) {return tally->sparse_;}
+
+  void tally_write_results_sparse_c(Tally* tally, hid_t group_id)
+  {
+    std::vector<int64_t> bins;
+    std::vector<double> values;
+    nonzero_tally_results(*tally, RESULT_SUM, 2, bins, values);
+    const auto& shape {tally->results_shape()};
+    write_tally_results_sparse(group_id, shape[0], shape[1], bins, values);
+  }
+
+  void tally_read_results_sparse_c(Tally* tally, hid_t group_id)
+  {
+    const auto& shape {tally->results_shape()};
+    tally->sparse_results().clear();
+    read_tally_results_sparse(group_id, shape[0], shape[1],
+      tally->sparse_results());
+  }
+
+  void tally_accumulate_sparse_c(Tally* tally, double total_weight,
+    double total_source)
+  {accumulate_sparse_results(*tally, total_weight, total_source);}
+
+  void tally_reset_sparse_c(Tally* tally) {tally->sparse_results().clear();}
+
   int tally_get_n_scores_c(Tally* tally) {return tally->scores_.size();}
 
   int tally_get_score_c(Tally* tally, int i) {return tally->scores_[i];}
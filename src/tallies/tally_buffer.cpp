@@ -0,0 +1,151 @@
+#include "openmc/tallies/tally_buffer.h"
+
+#include "openmc/settings.h"
+
+#include <algorithm> // for sort
+#include <utility> // for pair
+
+namespace openmc {
+
+//==============================================================================
+// Constants
+//==============================================================================
+
+//! Maximum number of result bins of a tally with dense buffers. Dense buffers
+//! are reduced in full every generation, so large tallies that are scored
+//! sparsely are cheaper to buffer in a hash table.
+constexpr int64_t TALLY_BUFFER_DENSE_BINS {1 << 16};
+
+//! Approximate memory in bytes used by each entry of a sparse buffer
+constexpr double TALLY_BUFFER_ENTRY_BYTES {48.0};
+
+//==============================================================================
+// Global variables
+//==============================================================================
+
+namespace simulation {
+
+std::vector<std::vector<TallyBuffer>> tally_buffers;
+
+} // namespace simulation
+
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+void setup_tally_buffers()
+{
+  if (!settings::tally_buffers || model::active_tallies.empty()) {
+    simulation::tally_buffers.clear();
+    return;
+  }
+
+  // Consider the smallest tallies first so that as many tallies as possible
+  // have dense buffers
+  std::vector<std::pair<int64_t, int>> sizes;
+  for (int i_tally : model::active_tallies) {
+    const auto& shape {model::tallies[i_tally]->results_shape()};
+    sizes.emplace_back(shape[0]*shape[1], i_tally);
+  }
+  std::sort(sizes.begin(), sizes.end());
+
+  // Give dense buffers to small tallies while they fit in the memory allowed
+  // for each thread
+  std::vector<TallyBuffer> plan(model::tallies.size());
+  std::vector<int> sparse;
+  double memory = settings::tally_buffer_memory * 1.0e6;
+  for (const auto& size : sizes) {
+    auto& buffer {plan[size.second]};
+    buffer.n_scores_ = model::tallies[size.second]->results_shape()[1];
+
+    double bytes = size.first * sizeof(double);
+    if (size.first <= TALLY_BUFFER_DENSE_BINS && bytes <= memory) {
+      buffer.mode_ = TallyBuffer::Mode::dense;
+      buffer.dense_.assign(size.first, 0.0);
+      memory -= bytes;
+    } else {
+      sparse.push_back(size.second);
+    }
+  }
+
+  // The rest of the memory is divided evenly among sparse buffers. Tallies
+  // that get no memory at all are scored atomically.
+  for (int i_tally : sparse) {
+    auto& buffer {plan[i_tally]};
+    buffer.max_entries_ = memory / sparse.size() / TALLY_BUFFER_ENTRY_BYTES;
+    if (buffer.max_entries_ > 0) buffer.mode_ = TallyBuffer::Mode::sparse;
+  }
+
+  // Keep the existing buffers if they are the same, which is the case for
+  // every batch after the first active batch
+#ifdef _OPENMP
+  int n_threads = omp_get_max_threads();
+#else
+  int n_threads = 1;
+#endif
+  auto& buffers {simulation::tally_buffers};
+  bool same = buffers.size() == n_threads && buffers[0].size() == plan.size();
+  for (int i = 0; same && i < plan.size(); ++i) {
+    const auto& b {buffers[0][i]};
+    same = b.mode_ == plan[i].mode_ && b.n_scores_ == plan[i].n_scores_
+      && b.dense_.size() == plan[i].dense_.size()
+      && b.max_entries_ == plan[i].max_entries_;
+  }
+  if (!same) buffers.assign(n_threads, plan);
+}
+
+void reduce_tally_buffers()
+{
+  auto& buffers {simulation::tally_buffers};
+  if (buffers.empty()) return;
+
+  #pragma omp parallel
+  {
+    // The entries of dense buffers are divided among the threads, and each
+    // entry is summed over all the buffers
+    for (int i_tally : model::active_tallies) {
+      const auto& first {buffers[0][i_tally]};
+      if (first.mode_ != TallyBuffer::Mode::dense) continue;
+
+      const auto& tally {*model::tallies[i_tally]};
+      int n_scores = first.n_scores_;
+      int64_t size = first.dense_.size();
+
+      #pragma omp for schedule(static)
+      for (int64_t k = 0; k < size; ++k) {
+        double sum = 0.0;
+        for (auto& b : buffers) {
+          sum += b[i_tally].dense_[k];
+          b[i_tally].dense_[k] = 0.0;
+        }
+        if (sum != 0.0) {
+          tally.results(k / n_scores, k % n_scores)[RESULT_VALUE] += sum;
+        }
+      }
+    }
+
+    // Sparse buffers are divided among the threads. Few threads score to the
+    // same bins, so the atomic adds are rarely contended.
+    #pragma omp for schedule(dynamic)
+    for (int t = 0; t < buffers.size(); ++t) {
+      for (int i_tally : model::active_tallies) {
+        auto& buffer {buffers[t][i_tally]};
+        if (buffer.mode_ != TallyBuffer::Mode::sparse || buffer.sparse_.empty()) {
+          continue;
+        }
+
+        const auto& tally {*model::tallies[i_tally]};
+        int n_scores = buffer.n_scores_;
+        for (const auto& entry : buffer.sparse_) {
+          double* result = tally.results(entry.first / n_scores,
+            entry.first % n_scores) + RESULT_VALUE;
+          #pragma omp atomic
+          *result += entry.second;
+        }
+        buffer.sparse_.clear();
+      }
+    }
+  }
+}
+
+} // namespace openmc
@@ -14,7 +14,9 @@
 #include "openmc/tallies/filter.h"
 #include "openmc/tallies/filter_delayedgroup.h"
 #include "openmc/tallies/filter_energy.h"
+#include "openmc/tallies/tally_buffer.h"
 
+#include <algorithm> // for find
 #include <string>
 
 namespace openmc {
@@ -29,12 +31,14 @@ FilterBinIter::FilterBinIter(const Tally& tally, const Particle* p)
   // Find all valid bins in each relevant filter if they have not already been
   // found for this event.
   for (auto i_filt : tally_.filters()) {
-    auto& match {simulation::filter_matches[i_filt]};
+    auto& match {filter_match(i_filt)};
     if (!match.bins_present_) {
       match.bins_.clear();
       match.weights_.clear();
       model::tally_filters[i_filt]->get_all_bins(p, tally_.estimator_, match);
       match.bins_present_ = true;
+      simulation::filter_matches_found.push_back(
+        simulation::filter_match_index[i_filt]);
     }
 
     // If there are no valid bins for this filter, then there are no valid
@@ -62,7 +66,7 @@ FilterBinIter::FilterBinIter(const Tally& tally, bool end)
   }
 
   for (auto i_filt : tally_.filters()) {
-    auto& match {simulation::filter_matches[i_filt]};
+    auto& match {filter_match(i_filt)};
     if (!match.bins_present_) {
       match.bins_.clear();
       match.weights_.clear();
@@ -72,6 +76,8 @@ FilterBinIter::FilterBinIter(const Tally& tally, bool end)
         match.weights_.push_back(1.0);
       }
       match.bins_present_ = true;
+      simulation::filter_matches_found.push_back(
+        simulation::filter_match_index[i_filt]);
     }
 
     if (match.bins_.size() == 0) {
@@ -95,7 +101,7 @@ FilterBinIter::operator++()
   bool done_looping = true;
   for (int i = tally_.filters().size()-1; i >= 0; --i) {
     auto i_filt = tally_.filters(i);
-    auto& match {simulation::filter_matches[i_filt]};
+    auto& match {filter_match(i_filt)};
     if (match.i_bin_ < match.bins_.size()-1) {
       // The bin for this filter can be incremented.  Increment it and do not
       // touch any of the remaining filters.
@@ -128,7 +134,7 @@ FilterBinIter::compute_index_weight()
   weight_ = 1.;
   for (auto i = 0; i < tally_.filters().size(); ++i) {
     auto i_filt = tally_.filters(i);
-    auto& match {simulation::filter_matches[i_filt]};
+    auto& match {filter_match(i_filt)};
     auto i_bin = match.i_bin_;
     //TODO: off-by-one
     index_ += (match.bins_[i_bin] - 1) * tally_.strides(i);
@@ -148,7 +154,7 @@ score_fission_delayed_dg(int i_tally, int d_bin, double score, int score_index)
   // Save the original delayed group bin
   const Tally& tally {*model::tallies[i_tally]};
   auto i_filt = tally.filters(tally.delayedgroup_filter_);
-  auto& dg_match {simulation::filter_matches[i_filt]};
+  auto& dg_match {filter_match(i_filt)};
   auto i_bin = dg_match.i_bin_;
   auto original_bin = dg_match.bins_[i_bin];
   dg_match.bins_[i_bin] = d_bin;
@@ -157,17 +163,15 @@ score_fission_delayed_dg(int i_tally, int d_bin, double score, int score_index)
   auto filter_index = 1;
   for (auto i = 0; i < tally.filters().size(); ++i) {
     auto i_filt = tally.filters(i);
-    auto& match {simulation::filter_matches[i_filt]};
+    auto& match {filter_match(i_filt)};
     auto i_bin = match.i_bin_;
     //TODO: off-by-one
     filter_index += (match.bins_[i_bin] - 1) * tally.strides(i);
   }
 
   // Update the tally result
-  auto results = tally_results(i_tally);
   //TODO: off-by-one
-  #pragma omp atomic
-  results(filter_index-1, score_index, RESULT_VALUE) += score;
+  add_tally_result(i_tally, tally, filter_index-1, score_index, score);
 
   // Reset the original delayed group bin
   dg_match.bins_[i_bin] = original_bin;
@@ -182,10 +186,9 @@ void
 score_fission_eout(const Particle* p, int i_tally, int i_score, int score_bin)
 {
   const Tally& tally {*model::tallies[i_tally]};
-  auto results = tally_results(i_tally);
   auto i_eout_filt = tally.filters()[tally.energyout_filter_];
-  auto i_bin = simulation::filter_matches[i_eout_filt].i_bin_;
-  auto bin_energyout = simulation::filter_matches[i_eout_filt].bins_[i_bin];
+  auto i_bin = filter_match(i_eout_filt).i_bin_;
+  auto bin_energyout = filter_match(i_eout_filt).bins_[i_bin];
 
   const EnergyoutFilter& eo_filt
     {*dynamic_cast<EnergyoutFilter*>(model::tally_filters[i_eout_filt].get())};
@@ -222,7 +225,7 @@ score_fission_eout(const Particle* p, int i_tally, int i_score, int score_bin)
       g_out = eo_filt.n_bins_ - g_out + 1;
 
       // change outgoing energy bin
-      simulation::filter_matches[i_eout_filt].bins_[i_bin] = g_out;
+      filter_match(i_eout_filt).bins_[i_bin] = g_out;
 
     } else {
 
@@ -240,7 +243,7 @@ score_fission_eout(const Particle* p, int i_tally, int i_score, int score_bin)
         //TODO: off-by-one
         auto i_match = lower_bound_index(eo_filt.bins_.begin(),
           eo_filt.bins_.end(), E_out) + 1;
-        simulation::filter_matches[i_eout_filt].bins_[i_bin] = i_match;
+        filter_match(i_eout_filt).bins_[i_bin] = i_match;
       }
 
     }
@@ -254,14 +257,13 @@ score_fission_eout(const Particle* p, int i_tally, int i_score, int score_bin)
       int filter_index = 1;
       for (auto j = 0; j < tally.filters().size(); ++j) {
         auto i_filt = tally.filters(j);
-        auto& match {simulation::filter_matches[i_filt]};
+        auto& match {filter_match(i_filt)};
         auto i_bin = match.i_bin_;
         filter_index += (match.bins_[i_bin] - 1) * tally.strides(j);
       }
 
       // Update tally results
-      #pragma omp atomic
-      results(filter_index-1, i_score, RESULT_VALUE) += score;
+      add_tally_result(i_tally, tally, filter_index-1, i_score, score);
 
     } else if (score_bin == SCORE_DELAYED_NU_FISSION && g != 0) {
 
@@ -282,7 +284,7 @@ score_fission_eout(const Particle* p, int i_tally, int i_score, int score_bin)
             double filter_weight = 1.;
             for (auto j = 0; j < tally.filters().size(); ++j) {
               auto i_filt = tally.filters(j);
-              auto& match {simulation::filter_matches[i_filt]};
+              auto& match {filter_match(i_filt)};
               auto i_bin = match.i_bin_;
               filter_index += (match.bins_[i_bin] - 1) * tally.strides(j);
               filter_weight *= match.weights_[i_bin];
@@ -301,35 +303,36 @@ score_fission_eout(const Particle* p, int i_tally, int i_score, int score_bin)
         double filter_weight = 1.;
         for (auto j = 0; j < tally.filters().size(); ++j) {
           auto i_filt = tally.filters(j);
-          auto& match {simulation::filter_matches[i_filt]};
+          auto& match {filter_match(i_filt)};
           auto i_bin = match.i_bin_;
           filter_index += (match.bins_[i_bin] - 1) * tally.strides(j);
           filter_weight *= match.weights_[i_bin];
         }
 
         // Update tally results
-        #pragma omp atomic
-        results(filter_index-1, i_score, RESULT_VALUE) += score*filter_weight;
+        add_tally_result(i_tally, tally, filter_index-1, i_score,
+          score*filter_weight);
       }
     }
   }
 
   // Reset outgoing energy bin and score index
-  simulation::filter_matches[i_eout_filt].bins_[i_bin] = bin_energyout;
+  filter_match(i_eout_filt).bins_[i_bin] = bin_energyout;
 }
 
 //! Update tally results for continuous-energy tallies with any estimator.
 //
 //! For analog tallies, the flux estimate depends on the score type so the flux
 //! argument is really just used for filter weights.  The atom_density argument
-//! is not used for analog tallies.
+//! is not used for analog tallies.  The estimator and whether survival biasing
+//! is on are template parameters so that each specialization only contains the
+//! branches that apply to it.
 
-void
+template<int estimator, bool survival> void
 score_general_ce(const Particle* p, int i_tally, int start_index,
   int filter_index, int i_nuclide, double atom_density, double flux)
 {
   const Tally& tally {*model::tallies[i_tally]};
-  auto results = tally_results(i_tally);
 
   // Get the pre-collision energy of the particle.
   auto E = p->last_E;
@@ -347,11 +350,11 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_FLUX:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
+      if (estimator == ESTIMATOR_ANALOG) {
         // All events score to a flux bin. We actually use a collision estimator
         // in place of an analog one since there is no way to count 'events'
         // exactly for the flux
-        if (settings::survival_biasing) {
+        if (survival) {
           // We need to account for the fact that some weight was already
           // absorbed
           score = p->last_wgt + p->absorb_wgt;
@@ -372,10 +375,10 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_TOTAL:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
+      if (estimator == ESTIMATOR_ANALOG) {
         // All events will score to the total reaction rate. We can just use
         // use the weight of the particle entering the collision as the score
-        if (settings::survival_biasing) {
+        if (survival) {
           // We need to account for the fact that some weight was already
           // absorbed
           score = (p->last_wgt + p->absorb_wgt) * flux;
@@ -394,11 +397,11 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_INVERSE_VELOCITY:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
+      if (estimator == ESTIMATOR_ANALOG) {
         // All events score to an inverse velocity bin. We actually use a
         // collision estimator in place of an analog one since there is no way
         // to count 'events' exactly for the inverse velocity
-        if (settings::survival_biasing) {
+        if (survival) {
           // We need to account for the fact that some weight was already
           // absorbed
           score = p->last_wgt + p->absorb_wgt;
@@ -415,7 +418,7 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_SCATTER:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
+      if (estimator == ESTIMATOR_ANALOG) {
         // Skip any event where the particle didn't scatter
         if (p->event != EVENT_SCATTER) continue;
         // Since only scattering events make it here, again we can use the
@@ -456,8 +459,8 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_ABSORPTION:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival) {
           // No absorption events actually occur if survival biasing is on --
           // just use weight absorbed in survival biasing
           score = p->absorb_wgt * flux;
@@ -481,8 +484,8 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
 
     case SCORE_FISSION:
       if (simulation::material_xs.absorption == 0) continue;
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival) {
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // fission
@@ -515,8 +518,8 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
 
     case SCORE_NU_FISSION:
       if (simulation::material_xs.absorption == 0) continue;
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing || p->fission) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival || p->fission) {
           if (tally.energyout_filter_ != C_NONE) {
             // Fission has multiple outgoing neutrons so this helper function
             // is used to handle scoring the multiple filter bins.
@@ -524,7 +527,7 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
             continue;
           }
         }
-        if (settings::survival_biasing) {
+        if (survival) {
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // nu-fission
@@ -558,8 +561,8 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
 
     case SCORE_PROMPT_NU_FISSION:
       if (simulation::material_xs.absorption == 0) continue;
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing || p->fission) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival || p->fission) {
           if (tally.energyout_filter_ != C_NONE) {
             // Fission has multiple outgoing neutrons so this helper function
             // is used to handle scoring the multiple filter bins.
@@ -567,7 +570,7 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
             continue;
           }
         }
-        if (settings::survival_biasing) {
+        if (survival) {
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // prompt-nu-fission
@@ -620,8 +623,8 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
 
     case SCORE_DELAYED_NU_FISSION:
       if (simulation::material_xs.absorption == 0) continue;
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing || p->fission) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival || p->fission) {
           if (tally.energyout_filter_ != C_NONE) {
             // Fission has multiple outgoing neutrons so this helper function
             // is used to handle scoring the multiple filter bins.
@@ -629,7 +632,7 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
             continue;
           }
         }
-        if (settings::survival_biasing) {
+        if (survival) {
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // delayed-nu-fission
@@ -764,8 +767,8 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
 
     case SCORE_DECAY_RATE:
       if (simulation::material_xs.absorption == 0) continue;
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival) {
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // delayed-nu-fission
@@ -951,8 +954,8 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
       score = 0.;
       // Kappa-fission values are determined from the Q-value listed for the
       // fission cross section.
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival) {
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // fission scaled by the Q-value
@@ -1013,7 +1016,7 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
 
 
     case ELASTIC:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
+      if (estimator == ESTIMATOR_ANALOG) {
         // Check if event MT matches
         if (p->event_MT != ELASTIC) continue;
         score = p->last_wgt * flux;
@@ -1044,8 +1047,8 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
       //continue;
       if (simulation::material_xs.absorption == 0.) continue;
       score = 0.;
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival) {
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // fission scaled by the Q-value
@@ -1127,7 +1130,7 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
     case N_GAMMA:
     case N_P:
     case N_A:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
+      if (estimator == ESTIMATOR_ANALOG) {
         // Check if the event MT matches
         if (p->event_MT != score_bin) continue;
         score = p->last_wgt * flux;
@@ -1161,7 +1164,7 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
 
 
     default:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
+      if (estimator == ESTIMATOR_ANALOG) {
         // Any other score is assumed to be a MT number. Thus, we just need
         // to check if it matches the MT number of the event
         if (p->event_MT != score_bin) continue;
@@ -1221,32 +1224,31 @@ score_general_ce(const Particle* p, int i_tally, int start_index,
         score);
 
     // Update tally results
-    #pragma omp atomic
-    results(filter_index-1, score_index, RESULT_VALUE) += score;
+    add_tally_result(i_tally, tally, filter_index-1, score_index, score);
   }
 }
 
 //! Update tally results for multigroup tallies with any estimator.
 //
 //! For analog tallies, the flux estimate depends on the score type so the flux
-//! argument is really just used for filter weights.
+//! argument is really just used for filter weights.  As for score_general_ce,
+//! the estimator and survival biasing are template parameters.
 
-void
+template<int estimator, bool survival> void
 score_general_mg(const Particle* p, int i_tally, int start_index,
   int filter_index, int i_nuclide, double atom_density, double flux)
 {
   const Tally& tally {*model::tallies[i_tally]};
-  auto results = tally_results(i_tally);
 
   //TODO: off-by-one throughout on p->material
 
   // Set the direction and group to use with get_xs
   const double* p_uvw;
   int p_g;
-  if (tally.estimator_ == ESTIMATOR_ANALOG
-    || tally.estimator_ == ESTIMATOR_COLLISION) {
+  if (estimator == ESTIMATOR_ANALOG
+    || estimator == ESTIMATOR_COLLISION) {
 
-    if (settings::survival_biasing) {
+    if (survival) {
 
       // Then we either are alive and had a scatter (and so g changed),
       // or are dead and g did not change
@@ -1297,11 +1299,11 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_FLUX:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
+      if (estimator == ESTIMATOR_ANALOG) {
         // All events score to a flux bin. We actually use a collision estimator
         // in place of an analog one since there is no way to count 'events'
         // exactly for the flux
-        if (settings::survival_biasing) {
+        if (survival) {
           // We need to account for the fact that some weight was already
           // absorbed
           score = p->last_wgt + p->absorb_wgt;
@@ -1316,10 +1318,10 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_TOTAL:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
+      if (estimator == ESTIMATOR_ANALOG) {
         // All events will score to the total reaction rate. We can just use
         // use the weight of the particle entering the collision as the score
-        if (settings::survival_biasing) {
+        if (survival) {
           // We need to account for the fact that some weight was already
           // absorbed
           score = p->last_wgt + p->absorb_wgt;
@@ -1344,12 +1346,12 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_INVERSE_VELOCITY:
-      if (tally.estimator_ == ESTIMATOR_ANALOG
-        || tally.estimator_ == ESTIMATOR_COLLISION) {
+      if (estimator == ESTIMATOR_ANALOG
+        || estimator == ESTIMATOR_COLLISION) {
         // All events score to an inverse velocity bin. We actually use a
         // collision estimator in place of an analog one since there is no way
         // to count 'events' exactly for the inverse velocity
-        if (settings::survival_biasing) {
+        if (survival) {
           // We need to account for the fact that some weight was already
           // absorbed
           score = p->last_wgt + p->absorb_wgt;
@@ -1378,7 +1380,7 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_SCATTER:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
+      if (estimator == ESTIMATOR_ANALOG) {
         // Skip any event where the particle didn't scatter
         if (p->event != EVENT_SCATTER) continue;
         // Since only scattering events make it here, again we can use the
@@ -1404,7 +1406,7 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_NU_SCATTER:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
+      if (estimator == ESTIMATOR_ANALOG) {
         // Skip any event where the particle didn't scatter
         if (p->event != EVENT_SCATTER) continue;
         // For scattering production, we need to use the pre-collision weight
@@ -1433,8 +1435,8 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_ABSORPTION:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival) {
           // No absorption events actually occur if survival biasing is on --
           // just use weight absorbed in survival biasing
           score = p->absorb_wgt * flux;
@@ -1462,8 +1464,8 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_FISSION:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival) {
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // fission
@@ -1497,8 +1499,8 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_NU_FISSION:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing || p->fission) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival || p->fission) {
           if (tally.energyout_filter_ != C_NONE) {
             // Fission has multiple outgoing neutrons so this helper function
             // is used to handle scoring the multiple filter bins.
@@ -1506,7 +1508,7 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
             continue;
           }
         }
-        if (settings::survival_biasing) {
+        if (survival) {
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // nu-fission
@@ -1547,8 +1549,8 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_PROMPT_NU_FISSION:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing || p->fission) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival || p->fission) {
           if (tally.energyout_filter_ != C_NONE) {
             // Fission has multiple outgoing neutrons so this helper function
             // is used to handle scoring the multiple filter bins.
@@ -1556,7 +1558,7 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
             continue;
           }
         }
-        if (settings::survival_biasing) {
+        if (survival) {
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // prompt-nu-fission
@@ -1601,8 +1603,8 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_DELAYED_NU_FISSION:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing || p->fission) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival || p->fission) {
           if (tally.energyout_filter_ != C_NONE) {
             // Fission has multiple outgoing neutrons so this helper function
             // is used to handle scoring the multiple filter bins.
@@ -1610,7 +1612,7 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
             continue;
           }
         }
-        if (settings::survival_biasing) {
+        if (survival) {
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // delayed-nu-fission
@@ -1731,8 +1733,8 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_DECAY_RATE:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival) {
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // delayed-nu-fission
@@ -1883,8 +1885,8 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
 
 
     case SCORE_KAPPA_FISSION:
-      if (tally.estimator_ == ESTIMATOR_ANALOG) {
-        if (settings::survival_biasing) {
+      if (estimator == ESTIMATOR_ANALOG) {
+        if (survival) {
           // No fission events occur if survival biasing is on -- need to
           // calculate fraction of absorptions that would have resulted in
           // fission scaled by the Q-value
@@ -1929,31 +1931,139 @@ score_general_mg(const Particle* p, int i_tally, int start_index,
     }
 
     // Update tally results
-    #pragma omp atomic
-    results(filter_index-1, score_index, RESULT_VALUE) += score;
+    add_tally_result(i_tally, tally, filter_index-1, score_index, score);
+  }
+}
+
+//! Scoring function specialized for an estimator, the run mode, and survival
+//! biasing.  The arguments are the same as for score_general_ce.
+using ScoreFunction = void (*)(const Particle* p, int i_tally, int start_index,
+  int filter_index, int i_nuclide, double atom_density, double flux);
+
+//! Select the specialized scoring function for tallies with a given estimator.
+//
+//! The run mode and survival biasing do not change during a simulation, so the
+//! function is selected once per event rather than tested for every score.
+
+template<int estimator> ScoreFunction
+score_function()
+{
+  if (settings::run_CE) {
+    if (settings::survival_biasing) return score_general_ce<estimator, true>;
+    return score_general_ce<estimator, false>;
+  } else {
+    if (settings::survival_biasing) return score_general_mg<estimator, true>;
+    return score_general_mg<estimator, false>;
+  }
+}
+
+//! Add the reaction rate of one score for every nuclide in a material.
+//
+//! The score is dispatched once for all nuclides rather than once per nuclide.
+//! The loop is not vectorized: the cross sections are gathered from each
+//! nuclide's micro_xs and the results go through add_tally_result to strided
+//! result bins.
+//! \param xs Function that returns the cross section of the score from the
+//!   microscopic cross sections of a nuclide
+
+template<typename F> void
+score_nuclides_ce(const Tally& tally, int i_tally, const Material& material,
+  int i_bin, int i_score, double flux, F xs)
+{
+  int n_scores = tally.scores_.size();
+  for (int i = 0; i < material.nuclide_.size(); ++i) {
+    auto i_nuclide = material.nuclide_[i];
+    double score = xs(simulation::micro_xs[i_nuclide])
+      * material.atom_density_(i) * flux;
+    add_tally_result(i_tally, tally, i_bin, i_nuclide*n_scores + i_score,
+      score);
+  }
+}
+
+//! Tally the rates of every nuclide in a continuous-energy material one score
+//! at a time rather than one nuclide at a time.
+//
+//! Only scores that are a microscopic cross section times the atom density
+//! and flux are supported.
+//! \return Whether the tally could be scored this way
+
+bool
+score_all_nuclides_ce(const Particle* p, int i_tally, double flux,
+  int filter_index)
+{
+  const Tally& tally {*model::tallies[i_tally]};
+  if (tally.deriv_ != C_NONE) return false;
+  for (auto score_bin : tally.scores_) {
+    switch (score_bin) {
+    case SCORE_FLUX: case SCORE_TOTAL: case SCORE_SCATTER:
+    case SCORE_ABSORPTION: case SCORE_FISSION: case SCORE_NU_FISSION:
+    case N_GAMMA: case N_P: case N_A: case N_2N: case N_3N: case N_4N:
+      break;
+    default:
+      return false;
+    }
+  }
+
+  //TODO: off-by-one
+  const Material& material {*model::materials[p->material-1]};
+  int i_bin = filter_index - 1;
+  int n_scores = tally.scores_.size();
+  for (auto i = 0; i < n_scores; ++i) {
+    switch (tally.scores_[i]) {
+    case SCORE_FLUX:
+      for (auto i_nuclide : material.nuclide_) {
+        add_tally_result(i_tally, tally, i_bin, i_nuclide*n_scores + i, flux);
+      }
+      break;
+    case SCORE_TOTAL:
+      score_nuclides_ce(tally, i_tally, material, i_bin, i, flux,
+        [](const NuclideMicroXS& m) {return m.total;});
+      break;
+    case SCORE_SCATTER:
+      score_nuclides_ce(tally, i_tally, material, i_bin, i, flux,
+        [](const NuclideMicroXS& m) {return m.total - m.absorption;});
+      break;
+    case SCORE_ABSORPTION:
+      score_nuclides_ce(tally, i_tally, material, i_bin, i, flux,
+        [](const NuclideMicroXS& m) {return m.absorption;});
+      break;
+    case SCORE_FISSION:
+      if (simulation::material_xs.absorption == 0) continue;
+      score_nuclides_ce(tally, i_tally, material, i_bin, i, flux,
+        [](const NuclideMicroXS& m) {return m.fission;});
+      break;
+    case SCORE_NU_FISSION:
+      if (simulation::material_xs.absorption == 0) continue;
+      score_nuclides_ce(tally, i_tally, material, i_bin, i, flux,
+        [](const NuclideMicroXS& m) {return m.nu_fission;});
+      break;
+    default:
+      // Depletion reactions
+      int m = std::find(DEPLETION_RX.begin(), DEPLETION_RX.end(),
+        tally.scores_[i]) - DEPLETION_RX.begin();
+      score_nuclides_ce(tally, i_tally, material, i_bin, i, flux,
+        [m](const NuclideMicroXS& micro) {return micro.reaction[m];});
+    }
   }
+  return true;
 }
 
 //! Tally rates for when the user requests a tally on all nuclides.
 
 void
 score_all_nuclides(const Particle* p, int i_tally, double flux,
-  int filter_index)
+  int filter_index, ScoreFunction score_general)
 {
   const Tally& tally {*model::tallies[i_tally]};
   const Material& material {*model::materials[p->material-1]};
 
   // Score all individual nuclide reaction rates.
-  for (auto i = 0; i < material.nuclide_.size(); ++i) {
-    auto i_nuclide = material.nuclide_[i];
-    auto atom_density = material.atom_density_(i);
-
-    //TODO: consider replacing this "if" with pointers or templates
-    if (settings::run_CE) {
-      score_general_ce(p, i_tally, i_nuclide*tally.scores_.size(), filter_index,
-        i_nuclide, atom_density, flux);
-    } else {
-      score_general_mg(p, i_tally, i_nuclide*tally.scores_.size(), filter_index,
+  if (!settings::run_CE
+    || !score_all_nuclides_ce(p, i_tally, flux, filter_index)) {
+    for (auto i = 0; i < material.nuclide_.size(); ++i) {
+      auto i_nuclide = material.nuclide_[i];
+      auto atom_density = material.atom_density_(i);
+      score_general(p, i_tally, i_nuclide*tally.scores_.size(), filter_index,
         i_nuclide, atom_density, flux);
     }
   }
@@ -1962,19 +2072,15 @@ score_all_nuclides(const Particle* p, int i_tally, double flux,
   int i_nuclide = -1;
   double atom_density = 0.;
   auto n_nuclides = data::nuclides.size();
-  //TODO: consider replacing this "if" with pointers or templates
-  if (settings::run_CE) {
-    score_general_ce(p, i_tally, n_nuclides*tally.scores_.size(), filter_index,
-      i_nuclide, atom_density, flux);
-  } else {
-    score_general_mg(p, i_tally, n_nuclides*tally.scores_.size(), filter_index,
-      i_nuclide, atom_density, flux);
-  }
+  score_general(p, i_tally, n_nuclides*tally.scores_.size(), filter_index,
+    i_nuclide, atom_density, flux);
 }
 
 void score_analog_tally_ce(const Particle* p)
 {
-  for (auto i_tally : model::active_analog_tallies) {
+  auto score_general = score_function<ESTIMATOR_ANALOG>();
+
+  for (auto i_tally : model::analog_tally_dispatch.tallies(p)) {
     const Tally& tally {*model::tallies[i_tally]};
 
     // Initialize an iterator over valid filter bin combinations.  If there are
@@ -2000,7 +2106,7 @@ void score_analog_tally_ce(const Particle* p)
           // tallies.
           //TODO: off-by-one
           if (i_nuclide == p->event_nuclide-1 || i_nuclide == -1)
-            score_general_ce(p, i_tally, i*tally.scores_.size(), filter_index,
+            score_general(p, i_tally, i*tally.scores_.size(), filter_index,
               -1, -1., filter_weight);
         }
 
@@ -2009,12 +2115,12 @@ void score_analog_tally_ce(const Particle* p)
         // can take advantage of the fact that we know exactly how nuclide
         // bins correspond to nuclide indices.  First, tally the nuclide.
         auto i = p->event_nuclide;
-        score_general_ce(p, i_tally, i*tally.scores_.size(), filter_index,
+        score_general(p, i_tally, i*tally.scores_.size(), filter_index,
           -1, -1., filter_weight);
 
         // Now tally the total material.
         i = tally.nuclides_.size();
-        score_general_ce(p, i_tally, i*tally.scores_.size(), filter_index,
+        score_general(p, i_tally, i*tally.scores_.size(), filter_index,
           -1, -1., filter_weight);
       }
     }
@@ -2027,13 +2133,14 @@ void score_analog_tally_ce(const Particle* p)
   }
 
   // Reset all the filter matches for the next tally event.
-  for (auto& match : simulation::filter_matches)
-    match.bins_present_ = false;
+  reset_filter_matches();
 }
 
 void score_analog_tally_mg(const Particle* p)
 {
-  for (auto i_tally : model::active_analog_tallies) {
+  auto score_general = score_function<ESTIMATOR_ANALOG>();
+
+  for (auto i_tally : model::analog_tally_dispatch.tallies(p)) {
     const Tally& tally {*model::tallies[i_tally]};
 
     // Initialize an iterator over valid filter bin combinations.  If there are
@@ -2063,7 +2170,7 @@ void score_analog_tally_mg(const Particle* p)
           atom_density = model::materials[p->material-1]->atom_density_(j);
         }
 
-        score_general_mg(p, i_tally, i*tally.scores_.size(), filter_index,
+        score_general(p, i_tally, i*tally.scores_.size(), filter_index,
           i_nuclide, atom_density, filter_weight);
       }
     }
@@ -2076,8 +2183,7 @@ void score_analog_tally_mg(const Particle* p)
   }
 
   // Reset all the filter matches for the next tally event.
-  for (auto& match : simulation::filter_matches)
-    match.bins_present_ = false;
+  reset_filter_matches();
 }
 
 void
@@ -2085,8 +2191,9 @@ score_tracklength_tally(const Particle* p, double distance)
 {
   // Determine the tracklength estimate of the flux
   double flux = p->wgt * distance;
+  auto score_general = score_function<ESTIMATOR_TRACKLENGTH>();
 
-  for (auto i_tally : model::active_tracklength_tallies) {
+  for (auto i_tally : model::tracklength_tally_dispatch.tallies(p)) {
     const Tally& tally {*model::tallies[i_tally]};
 
     // Initialize an iterator over valid filter bin combinations.  If there are
@@ -2104,7 +2211,8 @@ score_tracklength_tally(const Particle* p, double distance)
       // Loop over nuclide bins.
       if (tally.all_nuclides_) {
         if (p->material != MATERIAL_VOID)
-          score_all_nuclides(p, i_tally, flux*filter_weight, filter_index);
+          score_all_nuclides(p, i_tally, flux*filter_weight, filter_index,
+            score_general);
 
       } else {
         for (auto i = 0; i < tally.nuclides_.size(); ++i) {
@@ -2123,14 +2231,8 @@ score_tracklength_tally(const Particle* p, double distance)
             }
           }
 
-          //TODO: consider replacing this "if" with pointers or templates
-          if (settings::run_CE) {
-            score_general_ce(p, i_tally, i*tally.scores_.size(), filter_index,
-              i_nuclide, atom_density, flux*filter_weight);
-          } else {
-            score_general_mg(p, i_tally, i*tally.scores_.size(), filter_index,
-              i_nuclide, atom_density, flux*filter_weight);
-          }
+          score_general(p, i_tally, i*tally.scores_.size(), filter_index,
+            i_nuclide, atom_density, flux*filter_weight);
         }
       }
 
@@ -2144,8 +2246,7 @@ score_tracklength_tally(const Particle* p, double distance)
   }
 
   // Reset all the filter matches for the next tally event.
-  for (auto& match : simulation::filter_matches)
-    match.bins_present_ = false;
+  reset_filter_matches();
 }
 
 void score_collision_tally(const Particle* p)
@@ -2157,8 +2258,9 @@ void score_collision_tally(const Particle* p)
   } else {
     flux = (p->last_wgt + p->absorb_wgt) / simulation::material_xs.total;
   }
+  auto score_general = score_function<ESTIMATOR_COLLISION>();
 
-  for (auto i_tally : model::active_collision_tallies) {
+  for (auto i_tally : model::collision_tally_dispatch.tallies(p)) {
     const Tally& tally {*model::tallies[i_tally]};
 
     // Initialize an iterator over valid filter bin combinations.  If there are
@@ -2175,7 +2277,8 @@ void score_collision_tally(const Particle* p)
 
       // Loop over nuclide bins.
       if (tally.all_nuclides_) {
-        score_all_nuclides(p, i_tally, flux*filter_weight, filter_index);
+        score_all_nuclides(p, i_tally, flux*filter_weight, filter_index,
+          score_general);
 
       } else {
         for (auto i = 0; i < tally.nuclides_.size(); ++i) {
@@ -2192,14 +2295,8 @@ void score_collision_tally(const Particle* p)
             atom_density = model::materials[p->material-1]->atom_density_(j);
           }
 
-          //TODO: consider replacing this "if" with pointers or templates
-          if (settings::run_CE) {
-            score_general_ce(p, i_tally, i*tally.scores_.size(), filter_index,
-              i_nuclide, atom_density, flux*filter_weight);
-          } else {
-            score_general_mg(p, i_tally, i*tally.scores_.size(), filter_index,
-              i_nuclide, atom_density, flux*filter_weight);
-          }
+          score_general(p, i_tally, i*tally.scores_.size(), filter_index,
+            i_nuclide, atom_density, flux*filter_weight);
         }
       }
     }
@@ -2212,8 +2309,7 @@ void score_collision_tally(const Particle* p)
   }
 
   // Reset all the filter matches for the next tally event.
-  for (auto& match : simulation::filter_matches)
-    match.bins_present_ = false;
+  reset_filter_matches();
 }
 
 void
@@ -2224,7 +2320,6 @@ score_surface_tally(const Particle* p, const std::vector<int>& tallies)
 
   for (auto i_tally : tallies) {
     const Tally& tally {*model::tallies[i_tally]};
-    auto results = tally_results(i_tally);
 
     // Initialize an iterator over valid filter bin combinations.  If there are
     // no valid combinations, use a continue statement to ensure we skip the
@@ -2245,8 +2340,7 @@ score_surface_tally(const Particle* p, const std::vector<int>& tallies)
       for (auto score_index = 0; score_index < tally.scores_.size();
            ++score_index) {
         //TODO: off-by-one
-        #pragma omp atomic
-        results(filter_index-1, score_index, RESULT_VALUE) += score;
+        add_tally_result(i_tally, tally, filter_index-1, score_index, score);
       }
     }
 
@@ -2258,8 +2352,7 @@ score_surface_tally(const Particle* p, const std::vector<int>& tallies)
   }
 
   // Reset all the filter matches for the next tally event.
-  for (auto& match : simulation::filter_matches)
-    match.bins_present_ = false;
+  reset_filter_matches();
 }
 
 } // namespace openmc
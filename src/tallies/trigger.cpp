@@ -33,9 +33,14 @@ get_tally_uncertainty(int i_tally, int score_index, int filter_index)
   //TODO: off-by-one
   int err = openmc_tally_get_n_realizations(i_tally+1, &n);
 
-  auto results = tally_results(i_tally);
-  auto sum = results(filter_index, score_index, RESULT_SUM);
-  auto sum_sq = results(filter_index, score_index, RESULT_SUM_SQ);
+  // Results of sparse tallies that were never scored to are not stored
+  const auto& tally {*model::tallies[i_tally]};
+  const double* results = tally.sparse_
+    ? tally.sparse_results().find(filter_index)
+    : tally.results(filter_index, 0);
+  if (!results) return {0., 0.};
+  auto sum = results[3*score_index + RESULT_SUM];
+  auto sum_sq = results[3*score_index + RESULT_SUM_SQ];
 
   auto mean = sum / n;
   double std_dev = std::sqrt((sum_sq/n - mean*mean) / (n-1));
@@ -65,10 +70,8 @@ check_tally_triggers(double& ratio, int& tally_id, int& score)
     if (n_reals < 2) continue;
 
     for (const auto& trigger : t.triggers_) {
-      const auto& results = tally_results(i_tally);
-      for (auto filter_index = 0; filter_index < results.shape()[0];
-           ++filter_index) {
-        for (auto score_index = 0; score_index < results.shape()[1];
+      auto check_filter_bin = [&](int filter_index) {
+        for (auto score_index = 0; score_index < t.results_shape()[1];
              ++score_index) {
           // Compute the tally uncertainty metrics.
           auto uncert_pair = get_tally_uncertainty(i_tally, score_index,
@@ -103,6 +106,23 @@ check_tally_triggers(double& ratio, int& tally_id, int& score)
             tally_id = t.id_;
           }
         }
+      };
+
+      // Filter bins of sparse tallies that were never scored to have no
+      // uncertainty, so only the allocated blocks are checked
+      if (t.sparse_) {
+        const auto& sparse {t.sparse_results()};
+        for (auto i_block : sparse.blocks()) {
+          auto start = sparse.block_start(i_block);
+          for (auto i = 0; i < sparse.block_length(i_block); ++i) {
+            check_filter_bin(start + i);
+          }
+        }
+      } else {
+        for (auto filter_index = 0; filter_index < t.results_shape()[0];
+             ++filter_index) {
+          check_filter_bin(filter_index);
+        }
       }
     }
   }
@@ -12,6 +12,7 @@
 #include "openmc/output.h"
 #include "openmc/random_lcg.h"
 #include "openmc/settings.h"
+#include "openmc/surface.h"
 #include "openmc/timer.h"
 #include "openmc/xml_interface.h"
 
@@ -21,8 +22,8 @@
 #include "xtensor/xadapt.hpp"
 #include "xtensor/xview.hpp"
 
-#include <algorithm> // for copy
-#include <cmath> // for pow, sqrt
+#include <algorithm> // for copy, find, max, min
+#include <cmath> // for cos, pow, sin, sqrt
 #include <sstream>
 #include <unordered_set>
 
@@ -36,6 +37,28 @@ namespace model {
 std::vector<VolumeCalculation> volume_calcs;
 }
 
+//==============================================================================
+// Non-member functions
+//==============================================================================
+
+//! Estimate the variance of a ratio of sums of paired samples x and y
+//
+//! \param[in] ratio Ratio of the sum of x to the sum of y
+//! \param[in] sum_x_sq Sum of x^2
+//! \param[in] sum_xy Sum of x*y
+//! \param[in] sum_y Sum of y
+//! \param[in] sum_y_sq Sum of y^2
+//! \param[in] n Number of samples
+//! \return Variance of the ratio
+double ratio_variance(double ratio, double sum_x_sq, double sum_xy,
+  double sum_y, double sum_y_sq, double n)
+{
+  if (n <= 1.0 || sum_y <= 0.0) return 0.0;
+  double mean_y = sum_y / n;
+  double s = sum_x_sq - 2.0*ratio*sum_xy + ratio*ratio*sum_y_sq;
+  return std::max(0.0, s / (n*(n - 1.0)*mean_y*mean_y));
+}
+
 //==============================================================================
 // VolumeCalculation implementation
 //==============================================================================
@@ -59,7 +82,7 @@ VolumeCalculation::VolumeCalculation(pugi::xml_node node)
   domain_ids_ = get_node_array<int>(node, "domain_ids");
   lower_left_ = get_node_array<double>(node, "lower_left");
   upper_right_ = get_node_array<double>(node, "upper_right");
-  n_samples_ = std::stoi(get_node_value(node, "samples"));
+  n_samples_ = std::stoll(get_node_value(node, "samples"));
 
   // Ensure there are no duplicates by copying elements to a set and then
   // comparing the length with the original vector
@@ -69,19 +92,85 @@ VolumeCalculation::VolumeCalculation(pugi::xml_node node)
       "must be unique."};
   }
 
+  // Read how volumes are estimated
+  if (check_for_node(node, "estimator")) {
+    std::string estimator = get_node_value(node, "estimator", true, true);
+    if (estimator == "hit") {
+      estimator_ = Estimator::hit;
+    } else if (estimator == "ray") {
+      estimator_ = Estimator::ray;
+    } else {
+      fatal_error("Unrecognized estimator for stochastic volume "
+        "calculation: " + estimator);
+    }
+  }
+
+  // Read the trigger on the uncertainty of the domain volumes
+  if (check_for_node(node, "threshold")) {
+    pugi::xml_node threshold_node = node.child("threshold");
+
+    // A single threshold applies to every domain
+    thresholds_ = get_node_array<double>(threshold_node, "threshold");
+    if (thresholds_.size() != 1 && thresholds_.size() != domain_ids_.size()) {
+      fatal_error("Volume calculation trigger must have a single threshold "
+        "or one threshold for each domain.");
+    }
+    for (double t : thresholds_) {
+      if (t <= 0.0) {
+        fatal_error("Volume calculation trigger threshold must be positive.");
+      }
+    }
+
+    std::string tmp = get_node_value(threshold_node, "type", true, true);
+    if (tmp == "variance") {
+      trigger_type_ = TriggerMetric::variance;
+    } else if (tmp == "std_dev") {
+      trigger_type_ = TriggerMetric::standard_deviation;
+    } else if (tmp == "rel_err") {
+      trigger_type_ = TriggerMetric::relative_error;
+    } else {
+      fatal_error("Invalid volume calculation trigger type '" + tmp
+        + "' provided.");
+    }
+
+    if (check_for_node(threshold_node, "max_iterations")) {
+      max_iterations_ = std::stoi(get_node_value(threshold_node,
+        "max_iterations"));
+      if (max_iterations_ <= 0) {
+        fatal_error("Maximum number of volume calculation iterations must be "
+          "positive.");
+      }
+    }
+  }
 }
 
-std::vector<VolumeCalculation::Result> VolumeCalculation::execute() const
+std::vector<VolumeCalculation::Result> VolumeCalculation::execute()
 {
-  // Shared data that is collected from all threads
+  // Map indices of cells, materials, or universes to domains so that the
+  // domains containing a point are found without searching
   int n = domain_ids_.size();
-  std::vector<std::vector<int>> master_indices(n); // List of material indices for each domain
-  std::vector<std::vector<int>> master_hits(n); // Number of hits for each material in each domain
+  const std::unordered_map<int32_t, int32_t>* map;
+  if (domain_type_ == FILTER_MATERIAL) {
+    domain_index_.assign(model::materials.size(), C_NONE);
+    map = &model::material_map;
+  } else if (domain_type_ == FILTER_CELL) {
+    domain_index_.assign(model::cells.size(), C_NONE);
+    map = &model::cell_map;
+  } else {
+    domain_index_.assign(model::universes.size(), C_NONE);
+    map = &model::universe_map;
+  }
+  for (int i_domain = 0; i_domain < n; ++i_domain) {
+    auto it = map->find(domain_ids_[i_domain]);
+    if (it != map->end()) domain_index_[it->second] = i_domain;
+  }
+  n_columns_ = domain_type_ == FILTER_MATERIAL ?
+    2 : model::materials.size() + 2;
 
   // Divide work over MPI processes
-  int min_samples = n_samples_ / mpi::n_procs;
-  int remainder = n_samples_ % mpi::n_procs;
-  int i_start, i_end;
+  int64_t min_samples = n_samples_ / mpi::n_procs;
+  int64_t remainder = n_samples_ % mpi::n_procs;
+  int64_t i_start, i_end;
   if (mpi::rank < remainder) {
     i_start = (min_samples + 1)*mpi::rank;
     i_end = i_start + min_samples + 1;
@@ -90,103 +179,309 @@ std::vector<VolumeCalculation::Result> VolumeCalculation::execute() const
     i_end = i_start + min_samples;
   }
 
-  #pragma omp parallel
-  {
-    // Variables that are private to each thread
-    std::vector<std::vector<int>> indices(n);
-    std::vector<std::vector<int>> hits(n);
-    Particle p;
-    p.initialize();
-
-    prn_set_stream(STREAM_VOLUME);
-
-    // Sample locations and count hits
-    #pragma omp for
-    for (int i = i_start; i < i_end; i++) {
-      set_particle_seed(i);
-
-      p.n_coord = 1;
-      Position xi {prn(), prn(), prn()};
-      Position r {lower_left_ + xi*(upper_right_ - lower_left_)};
-      // TODO: assign directly when xyz is Position
-      std::copy(&r.x, &r.x + 3, p.coord[0].xyz);
-      p.coord[0].uvw[0] = 0.5;
-      p.coord[1].uvw[1] = 0.5;
-      p.coord[2].uvw[2] = 0.5;
-
-      // If this location is not in the geometry at all, move on to next block
-      if (!find_cell(&p, false)) continue;
-
-      // TODO: off-by-one
-      int i_material = p.material == MATERIAL_VOID ? p.material : p.material - 1;
+  // Scores on this process accumulated over all iterations, and the scores of
+  // each thread in the current iteration
+  Scores master_scores {create_scores()};
+#ifdef _OPENMP
+  int n_threads = omp_get_max_threads();
+#else
+  int n_threads = 1;
+#endif
+  std::vector<Scores> thread_scores(n_threads, master_scores);
 
-      if (domain_type_ == FILTER_MATERIAL) {
-        if (i_material != MATERIAL_VOID) {
-          for (int i_domain = 0; i_domain < n; i_domain++) {
-            if (model::materials[i_material]->id_ == domain_ids_[i_domain]) {
-              this->check_hit(i_material, indices[i_domain], hits[i_domain]);
-              break;
-            }
-          }
-        }
-      } else if (domain_type_ == FILTER_CELL) {
-        for (int level = 0; level < p.n_coord; ++level) {
-          for (int i_domain=0; i_domain < n; i_domain++) {
-            if (model::cells[p.coord[level].cell]->id_ == domain_ids_[i_domain]) {
-              this->check_hit(i_material, indices[i_domain], hits[i_domain]);
-              break;
-            }
-          }
+  std::vector<Result> results;
+  int iterations = 0;
+  while (true) {
+    ++iterations;
+
+    #pragma omp parallel
+    {
+      // Variables that are private to each thread
+#ifdef _OPENMP
+      Scores& scores {thread_scores[omp_get_thread_num()]};
+#else
+      Scores& scores {thread_scores[0]};
+#endif
+      xt::xtensor<double, 2> lengths;
+      if (estimator_ == Estimator::ray) {
+        lengths = xt::zeros<double>({static_cast<std::size_t>(n),
+          static_cast<std::size_t>(n_columns_)});
+      }
+      std::vector<int> touched;
+      std::vector<int> domains;
+      Particle p;
+      p.initialize();
+
+      prn_set_stream(STREAM_VOLUME);
+
+      // Sample points or lines and score each domain
+      #pragma omp for
+      for (int64_t i = i_start; i < i_end; i++) {
+        set_particle_seed((iterations - 1)*n_samples_ + i);
+
+        if (estimator_ == Estimator::ray) {
+          this->sample_ray(p, scores, lengths, touched, domains);
+        } else {
+          this->sample_point(p, scores, domains);
         }
-      } else if (domain_type_ == FILTER_UNIVERSE) {
-        for (int level = 0; level < p.n_coord; ++level) {
-          for (int i_domain = 0; i_domain < n; ++i_domain) {
-            if (model::universes[p.coord[level].universe]->id_ == domain_ids_[i_domain]) {
-              check_hit(i_material, indices[i_domain], hits[i_domain]);
-              break;
-            }
+      }
+
+      // Add the scores of every thread for this iteration into the
+      // accumulated scores. The entries are divided among the threads, and
+      // each entry is summed in thread order so that results do not depend on
+      // scheduling. Thread scores are zeroed for the next iteration.
+      for (auto member : {&Scores::sum, &Scores::sum_sq, &Scores::sum_xy}) {
+        double* to = (master_scores.*member).data();
+        int size = (master_scores.*member).size();
+        #pragma omp for schedule(static)
+        for (int k = 0; k < size; ++k) {
+          for (auto& s : thread_scores) {
+            double* from = (s.*member).data();
+            to[k] += from[k];
+            from[k] = 0.0;
           }
         }
       }
+
+      prn_set_stream(STREAM_TRACKING);
+    } // omp parallel
+
+    // Compute results from the samples on all processes
+    results = compute_results(master_scores,
+      static_cast<double>(n_samples_)*iterations);
+    for (auto& result : results) {
+      result.iterations = iterations;
     }
 
-    // At this point, each thread has its own pair of index/hits lists and we now
-    // need to reduce them. OpenMP is not nearly smart enough to do this on its own,
-    // so we have to manually reduce them
+    // Keep going until the uncertainty of every domain volume is below its
+    // threshold or the maximum number of iterations is reached
+    bool more {false};
+    if (mpi::master && trigger_type_ != TriggerMetric::not_active) {
+      more = trigger_unmet(results);
+      if (more && iterations == max_iterations_) {
+        warning("Volume calculation trigger not satisfied after the maximum of "
+          + std::to_string(max_iterations_) + " iterations.");
+        more = false;
+      }
+    }
+#ifdef OPENMC_MPI
+    MPI_Bcast(&more, 1, MPI_C_BOOL, 0, mpi::intracomm);
+#endif
+    if (!more) break;
+  }
 
-#ifdef _OPENMP
-    #pragma omp for ordered schedule(static)
-    for (int i = 0; i < omp_get_num_threads(); ++i) {
-      #pragma omp ordered
-      for (int i_domain = 0; i_domain < n; ++i_domain) {
-        for (int j = 0; j < indices[i_domain].size(); ++j) {
-          // Check if this material has been added to the master list and if so,
-          // accumulate the number of hits
-          bool already_added = false;
-          for (int k = 0; k < master_indices[i_domain].size(); k++) {
-            if (indices[i_domain][j] == master_indices[i_domain][k]) {
-              master_hits[i_domain][k] += hits[i_domain][j];
-              already_added = true;
-            }
-          }
-          if (!already_added) {
-            // If we made it here, the material hasn't yet been added to the master
-            // list, so add entries to the master indices and master hits lists
-            master_indices[i_domain].push_back(indices[i_domain][j]);
-            master_hits[i_domain].push_back(hits[i_domain][j]);
-          }
+  return results;
+}
+
+VolumeCalculation::Scores VolumeCalculation::create_scores() const
+{
+  std::size_t n = domain_ids_.size();
+  std::size_t m = n_columns_;
+
+  Scores scores;
+  scores.sum = xt::zeros<double>({n + 1, m});
+  if (estimator_ == Estimator::ray) {
+    scores.sum_sq = xt::zeros<double>({n + 1, m});
+    scores.sum_xy = xt::zeros<double>({n + 1, m});
+  }
+  return scores;
+}
+
+void VolumeCalculation::sample_point(Particle& p, Scores& scores,
+  std::vector<int>& domains) const
+{
+  p.n_coord = 1;
+  Position xi {prn(), prn(), prn()};
+  Position r {lower_left_ + xi*(upper_right_ - lower_left_)};
+  // TODO: assign directly when xyz is Position
+  std::copy(&r.x, &r.x + 3, p.coord[0].xyz);
+  p.coord[0].uvw[0] = 0.5;
+  p.coord[0].uvw[1] = 0.5;
+  p.coord[0].uvw[2] = 0.5;
+
+  // If this location is not in the geometry at all, move on to next block
+  if (!find_cell(&p, false)) return;
+
+  // Score a hit for the material and in total for each domain
+  int j = column(p.material);
+  find_domains(p, domains);
+  for (int i_domain : domains) {
+    scores.sum(i_domain, j) += 1.0;
+    scores.sum(i_domain, n_columns_ - 1) += 1.0;
+  }
+}
+
+void VolumeCalculation::sample_ray(Particle& p, Scores& scores,
+  xt::xtensor<double, 2>& lengths, std::vector<int>& touched,
+  std::vector<int>& domains) const
+{
+  // Sample an isotropic direction and two directions perpendicular to it
+  double mu = 2.0*prn() - 1.0;
+  double phi = 2.0*PI*prn();
+  double sin_theta = std::sqrt(1.0 - mu*mu);
+  Direction u {sin_theta*std::cos(phi), sin_theta*std::sin(phi), mu};
+  Direction a = std::abs(u.x) < std::abs(u.y) ?
+    Direction{0.0, u.z, -u.y} : Direction{u.z, 0.0, -u.x};
+  a /= a.norm();
+  Direction b {u.y*a.z - u.z*a.y, u.z*a.x - u.x*a.z, u.x*a.y - u.y*a.x};
+
+  // Sample a line in direction u uniformly over the rectangle that the
+  // bounding box projects onto in the plane perpendicular to u. Integrating
+  // the chord length in a domain over this rectangle gives its volume.
+  Position center {0.5*(lower_left_ + upper_right_)};
+  Position half {0.5*(upper_right_ - lower_left_)};
+  double extent_a = std::abs(a.x)*half.x + std::abs(a.y)*half.y
+    + std::abs(a.z)*half.z;
+  double extent_b = std::abs(b.x)*half.x + std::abs(b.y)*half.y
+    + std::abs(b.z)*half.z;
+  double area = 4.0*extent_a*extent_b;
+  Position r {center + (2.0*prn() - 1.0)*extent_a*a
+    + (2.0*prn() - 1.0)*extent_b*b};
+
+  // Clip the line to the bounding box
+  double t_min = -INFTY;
+  double t_max = INFTY;
+  for (int i = 0; i < 3; ++i) {
+    if (u[i] == 0.0) {
+      if (r[i] < lower_left_[i] || r[i] > upper_right_[i]) return;
+      continue;
+    }
+    double t1 = (lower_left_[i] - r[i]) / u[i];
+    double t2 = (upper_right_[i] - r[i]) / u[i];
+    t_min = std::max(t_min, std::min(t1, t2));
+    t_max = std::min(t_max, std::max(t1, t2));
+  }
+  if (t_min >= t_max) return;
+
+  // Entries of the chord lengths in each domain and material that are set
+  // along this line. An entry may be listed more than once.
+  touched.clear();
+
+  // Trace the line through the geometry, relocating the particle at each
+  // boundary it crosses
+  r += t_min*u;
+  double remaining = t_max - t_min;
+  p.surface = 0;
+  const Universe& root {*model::universes[model::root_universe]};
+  while (true) {
+    p.n_coord = 1;
+    p.coord[0].xyz[0] = r.x;
+    p.coord[0].xyz[1] = r.y;
+    p.coord[0].xyz[2] = r.z;
+    p.coord[0].uvw[0] = u.x;
+    p.coord[0].uvw[1] = u.y;
+    p.coord[0].uvw[2] = u.z;
+    p.coord[0].universe = model::root_universe;
+
+    double d;
+    int surface_crossed;
+    if (find_cell(&p, false)) {
+      int lattice_translation[3];
+      int next_level;
+      distance_to_boundary(&p, &d, &surface_crossed, lattice_translation,
+                           &next_level);
+
+      int j = column(p.material);
+      find_domains(p, domains);
+      for (int i_domain : domains) {
+        if (lengths(i_domain, n_columns_ - 1) == 0.0) {
+          touched.push_back(i_domain*n_columns_ + n_columns_ - 1);
+        }
+        if (lengths(i_domain, j) == 0.0) {
+          touched.push_back(i_domain*n_columns_ + j);
+        }
+        lengths(i_domain, j) += std::min(d, remaining);
+        lengths(i_domain, n_columns_ - 1) += std::min(d, remaining);
+      }
+    } else {
+      // The line is outside the geometry, so it can only enter it again
+      // through a surface bounding a cell of the root universe
+      d = INFTY;
+      int32_t token;
+      for (auto i_cell : root.cells_) {
+        auto dist = model::cells[i_cell]->distance(r, u, p.surface);
+        if (dist.first < d) {
+          d = dist.first;
+          token = dist.second;
         }
       }
+      if (d < remaining) {
+        const Surface& surf {*model::surfaces[std::abs(token) - 1]};
+        surface_crossed = u.dot(surf.normal(r + d*u)) > 0.0 ?
+          std::abs(token) : -std::abs(token);
+      }
     }
-#else
-    master_indices = indices;
-    master_hits = hits;
-#endif
+    if (d >= remaining) break;
+
+    // Move to the boundary. Lattice crossings are resolved by the direction
+    // of travel when the particle is located again.
+    r += d*u;
+    remaining -= d;
+    p.surface = surface_crossed;
+  }
+
+  // The volume estimated by this line is the chord length times the area of
+  // the rectangle lines were sampled over. Domain volumes are estimated as a
+  // fraction of the volume estimated for the whole bounding box, which has
+  // much smaller variance than the volume estimates themselves.
+  double y = area*(t_max - t_min);
+  for (int k : touched) {
+    double x = area*lengths.data()[k];
+    scores.sum.data()[k] += x;
+    scores.sum_sq.data()[k] += x*x;
+    scores.sum_xy.data()[k] += x*y;
+    lengths.data()[k] = 0.0;
+  }
+  int n = domain_ids_.size();
+  scores.sum(n, n_columns_ - 1) += y;
+  scores.sum_sq(n, n_columns_ - 1) += y*y;
+  scores.sum_xy(n, n_columns_ - 1) += y*y;
+}
+
+void VolumeCalculation::find_domains(const Particle& p,
+  std::vector<int>& domains) const
+{
+  domains.clear();
+
+  if (domain_type_ == FILTER_MATERIAL) {
+    if (p.material != MATERIAL_VOID) {
+      int i_domain = domain_index_[p.material - 1];
+      if (i_domain != C_NONE) domains.push_back(i_domain);
+    }
+  } else if (domain_type_ == FILTER_CELL) {
+    for (int level = 0; level < p.n_coord; ++level) {
+      int i_domain = domain_index_[p.coord[level].cell];
+      if (i_domain != C_NONE) domains.push_back(i_domain);
+    }
+  } else if (domain_type_ == FILTER_UNIVERSE) {
+    for (int level = 0; level < p.n_coord; ++level) {
+      int i_domain = domain_index_[p.coord[level].universe];
+      if (i_domain != C_NONE) domains.push_back(i_domain);
+    }
+  }
+}
 
-    prn_set_stream(STREAM_TRACKING);
-  } // omp parallel
+std::vector<VolumeCalculation::Result> VolumeCalculation::compute_results(
+  const Scores& scores, double n_total) const
+{
+  int n = domain_ids_.size();
 
-  // Reduce hits onto master process
+  // Reduce scores onto master process
+#ifdef OPENMC_MPI
+  Scores reduced;
+  const Scores& master_scores {mpi::master ? reduced : scores};
+  if (mpi::master) reduced = create_scores();
+  MPI_Reduce(scores.sum.data(), reduced.sum.data(), scores.sum.size(),
+    MPI_DOUBLE, MPI_SUM, 0, mpi::intracomm);
+  if (estimator_ == Estimator::ray) {
+    MPI_Reduce(scores.sum_sq.data(), reduced.sum_sq.data(),
+      scores.sum_sq.size(), MPI_DOUBLE, MPI_SUM, 0, mpi::intracomm);
+    MPI_Reduce(scores.sum_xy.data(), reduced.sum_xy.data(),
+      scores.sum_xy.size(), MPI_DOUBLE, MPI_SUM, 0, mpi::intracomm);
+  }
+#else
+  const Scores& master_scores {scores};
+#endif
 
   // Determine volume of bounding box
   Position d {upper_right_ - lower_left_};
@@ -194,6 +489,13 @@ std::vector<VolumeCalculation::Result> VolumeCalculation::execute() const
 
   // Set size for members of the Result struct
   std::vector<Result> results(n);
+  if (!mpi::master) return results;
+
+  // Scores for the whole bounding box
+  int total = n_columns_ - 1;
+  double box_sum = master_scores.sum(n, total);
+  double box_sum_sq = 0.0;
+  if (estimator_ == Estimator::ray) box_sum_sq = master_scores.sum_sq(n, total);
 
   for (int i_domain = 0; i_domain < n; ++i_domain) {
     // Get reference to result for this domain
@@ -204,71 +506,69 @@ std::vector<VolumeCalculation::Result> VolumeCalculation::execute() const
     auto n_nuc = data::nuclides.size();
     xt::xtensor<double, 2> atoms({n_nuc, 2}, 0.0);
 
-#ifdef OPENMC_MPI
-    if (mpi::master) {
-      for (int j = 1; j < mpi::n_procs; j++) {
-        int q;
-        MPI_Recv(&q, 1, MPI_INTEGER, j, 0, mpi::intracomm, MPI_STATUS_IGNORE);
-        int buffer[2*q];
-        MPI_Recv(&buffer[0], 2*q, MPI_INTEGER, j, 1, mpi::intracomm, MPI_STATUS_IGNORE);
-        for (int k = 0; k < q; ++k) {
-          for (int m = 0; m < master_indices[i_domain].size(); ++m) {
-            if (buffer[2*k] == master_indices[i_domain][m]) {
-              master_hits[i_domain][m] += buffer[2*k + 1];
-              break;
-            }
-          }
-        }
+    for (int j = 0; j < total; ++j) {
+      double sum = master_scores.sum(i_domain, j);
+      if (sum == 0.0) continue;
+
+      // Fraction of the bounding box occupied by the material in this domain
+      double f, var_f;
+      if (estimator_ == Estimator::ray) {
+        f = box_sum > 0.0 ? sum / box_sum : 0.0;
+        var_f = ratio_variance(f, master_scores.sum_sq(i_domain, j),
+          master_scores.sum_xy(i_domain, j), box_sum, box_sum_sq, n_total);
+      } else {
+        f = sum / n_total;
+        var_f = f*(1.0 - f)/n_total;
       }
-    } else {
-      int q = master_indices[i_domain].size();
-      int buffer[2*q];
-      for (int k = 0; k < q; ++k) {
-        buffer[2*k] = master_indices[i_domain][k];
-        buffer[2*k + 1] = master_hits[i_domain][k];
+
+      // Find the material of this column
+      int i_material;
+      if (domain_type_ == FILTER_MATERIAL) {
+        i_material = model::material_map.at(domain_ids_[i_domain]);
+      } else if (j == 0) {
+        continue;
+      } else {
+        i_material = j - 1;
       }
 
-      MPI_Send(&q, 1, MPI_INTEGER, 0, 0, mpi::intracomm);
-      MPI_Send(&buffer[0], 2*q, MPI_INTEGER, 0, 1, mpi::intracomm);
-    }
-#endif
+      // Nuclide indices only refer to continuous-energy data
+      if (!settings::run_CE) continue;
 
-    if (mpi::master) {
-      int total_hits = 0;
-      for (int j = 0; j < master_indices[i_domain].size(); ++j) {
-        total_hits += master_hits[i_domain][j];
-        double f = static_cast<double>(master_hits[i_domain][j]) / n_samples_;
-        double var_f = f*(1.0 - f)/n_samples_;
-
-        int i_material = master_indices[i_domain][j];
-        if (i_material == MATERIAL_VOID) continue;
-
-        const auto& mat = model::materials[i_material];
-        for (int k = 0; k < mat->nuclide_.size(); ++k) {
-          // Accumulate nuclide density
-          int i_nuclide = mat->nuclide_[k];
-          atoms(i_nuclide, 0) += mat->atom_density_[k] * f;
-          atoms(i_nuclide, 1) += std::pow(mat->atom_density_[k], 2) * var_f;
-        }
+      const auto& mat = model::materials[i_material];
+      for (int k = 0; k < mat->nuclide_.size(); ++k) {
+        // Accumulate nuclide density
+        int i_nuclide = mat->nuclide_[k];
+        atoms(i_nuclide, 0) += mat->atom_density_[k] * f;
+        atoms(i_nuclide, 1) += std::pow(mat->atom_density_[k], 2) * var_f;
       }
+    }
 
-      // Determine volume
-      result.volume[0] = static_cast<double>(total_hits) / n_samples_ * volume_sample;
+    // Determine volume
+    double sum = master_scores.sum(i_domain, total);
+    if (estimator_ == Estimator::ray) {
+      double f = box_sum > 0.0 ? sum / box_sum : 0.0;
+      result.volume[0] = f * volume_sample;
+      result.volume[1] = std::sqrt(ratio_variance(f,
+        master_scores.sum_sq(i_domain, total),
+        master_scores.sum_xy(i_domain, total), box_sum, box_sum_sq,
+        n_total)) * volume_sample;
+    } else {
+      result.volume[0] = sum / n_total * volume_sample;
       result.volume[1] = std::sqrt(result.volume[0]
-        * (volume_sample - result.volume[0]) / n_samples_);
-
-      for (int j = 0; j < n_nuc; ++j) {
-        // Determine total number of atoms. At this point, we have values in
-        // atoms/b-cm. To get to atoms we multiply by 10^24 V.
-        double mean = 1.0e24 * volume_sample * atoms(j, 0);
-        double stdev = 1.0e24 * volume_sample * std::sqrt(atoms(j, 1));
-
-        // Convert full arrays to vectors
-        if (mean > 0.0) {
-          result.nuclides.push_back(j);
-          result.atoms.push_back(mean);
-          result.uncertainty.push_back(stdev);
-        }
+        * (volume_sample - result.volume[0]) / n_total);
+    }
+
+    for (int j = 0; j < n_nuc; ++j) {
+      // Determine total number of atoms. At this point, we have values in
+      // atoms/b-cm. To get to atoms we multiply by 10^24 V.
+      double mean = 1.0e24 * volume_sample * atoms(j, 0);
+      double stdev = 1.0e24 * volume_sample * std::sqrt(atoms(j, 1));
+
+      // Convert full arrays to vectors
+      if (mean > 0.0) {
+        result.nuclides.push_back(j);
+        result.atoms.push_back(mean);
+        result.uncertainty.push_back(stdev);
       }
     }
   }
@@ -276,6 +576,42 @@ std::vector<VolumeCalculation::Result> VolumeCalculation::execute() const
   return results;
 }
 
+bool VolumeCalculation::trigger_unmet(const std::vector<Result>& results) const
+{
+  int n_unmet = 0;
+  for (int i = 0; i < results.size(); ++i) {
+    const auto& result {results[i]};
+    double value;
+    switch (trigger_type_) {
+    case TriggerMetric::variance:
+      value = result.volume[1]*result.volume[1];
+      break;
+    case TriggerMetric::standard_deviation:
+      value = result.volume[1];
+      break;
+    case TriggerMetric::relative_error:
+      // A domain that no sample has reached, such as one outside the bounding
+      // box, has no relative error and is left out
+      if (result.volume[0] == 0.0) continue;
+      value = result.volume[1] / result.volume[0];
+      break;
+    default:
+      value = 0.0;
+    }
+
+    double threshold = thresholds_.size() == 1 ?
+      thresholds_[0] : thresholds_[i];
+    if (value > threshold) ++n_unmet;
+  }
+
+  std::stringstream msg;
+  msg << "  Iteration " << results[0].iterations << ": " << n_unmet << " of "
+    << results.size() << " domains above threshold";
+  write_message(msg, 6);
+
+  return n_unmet > 0;
+}
+
 void VolumeCalculation::to_hdf5(const std::string& filename,
   const std::vector<Result>& results) const
 {
@@ -306,6 +642,31 @@ void VolumeCalculation::to_hdf5(const std::string& filename,
   else if (domain_type_ == FILTER_UNIVERSE) {
     write_attribute(file_id, "domain_type", "universe");
   }
+  write_attribute(file_id, "estimator",
+    estimator_ == Estimator::ray ? "ray" : "hit");
+  write_attribute(file_id, "iterations",
+    results.empty() ? 1 : results[0].iterations);
+  if (trigger_type_ != TriggerMetric::not_active) {
+    if (thresholds_.size() == 1) {
+      write_attribute(file_id, "threshold", thresholds_[0]);
+    } else {
+      write_attribute(file_id, "threshold", thresholds_);
+    }
+    write_attribute(file_id, "max_iterations", max_iterations_);
+    switch (trigger_type_) {
+    case TriggerMetric::variance:
+      write_attribute(file_id, "trigger_type", "variance");
+      break;
+    case TriggerMetric::standard_deviation:
+      write_attribute(file_id, "trigger_type", "std_dev");
+      break;
+    case TriggerMetric::relative_error:
+      write_attribute(file_id, "trigger_type", "rel_err");
+      break;
+    default:
+      break;
+    }
+  }
 
   for (int i = 0; i < domain_ids_.size(); ++i)
   {
@@ -341,27 +702,6 @@ void VolumeCalculation::to_hdf5(const std::string& filename,
   file_close(file_id);
 }
 
-void VolumeCalculation::check_hit(int i_material, std::vector<int>& indices,
-  std::vector<int>& hits) const
-{
-
-  // Check if this material was previously hit and if so, increment count
-  bool already_hit = false;
-  for (int j = 0; j < indices.size(); j++) {
-    if (indices[j] == i_material) {
-      hits[j]++;
-      already_hit = true;
-    }
-  }
-
-  // If the material was not previously hit, append an entry to the material
-  // indices and hits lists
-  if (!already_hit) {
-    indices.push_back(i_material);
-    hits.push_back(1);
-  }
-}
-
 } // namespace openmc
 
 //==============================================================================
@@ -384,7 +724,7 @@ int openmc_calculate_volumes() {
     }
 
     // Run volume calculation
-    const auto& vol_calc {model::volume_calcs[i]};
+    auto& vol_calc {model::volume_calcs[i]};
     auto results = vol_calc.execute();
 
     if (mpi::master) {
@@ -397,6 +737,12 @@ int openmc_calculate_volumes() {
         domain_type = "  Universe ";
       }
 
+      if (vol_calc.trigger_type_ != VolumeCalculation::TriggerMetric::not_active
+          && !results.empty()) {
+        write_message("  Trigger checked over " +
+          std::to_string(results[0].iterations) + " iterations", 4);
+      }
+
       // Display domain volumes
       for (int j = 0; j < vol_calc.domain_ids_.size(); j++) {
         std::stringstream msg;
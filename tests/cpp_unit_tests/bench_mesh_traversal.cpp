@@ -0,0 +1,96 @@
+//! Microbenchmark of the traversal of regular meshes by tracks. Random
+//! isotropic tracks of a fixed length, 10% of them along the x axis, start
+//! anywhere in a box slightly larger than a 20 cm mesh. The rate of
+//! RegularMesh::bins_crossed is reported next to the rate of the traversal it
+//! replaced for 2-D and 3-D meshes of several sizes and track lengths.
+//!
+//! Usage: bench_mesh_traversal [seconds per case]
+
+#include <algorithm> // for max
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib> // for atof
+#include <random>
+#include <vector>
+
+#include "mesh_reference.h"
+
+using namespace openmc;
+
+namespace {
+
+//! Number of distinct tracks that are traversed repeatedly
+constexpr int N_TRACKS {20000};
+
+//! Traverse tracks repeatedly for about the given time and return the number
+//! of tracks per second and mesh bins per track
+template<typename F> std::pair<double, double>
+time_traversal(const std::vector<Particle>& particles, double seconds, F f)
+{
+  using clock = std::chrono::steady_clock;
+  std::vector<int> bins;
+  std::vector<double> lengths;
+  long n = 0;
+  long n_bins = 0;
+  auto start = clock::now();
+  double elapsed = 0.0;
+  while (elapsed < seconds) {
+    for (const auto& p : particles) {
+      bins.clear();
+      lengths.clear();
+      f(&p, bins, lengths);
+      n_bins += bins.size();
+    }
+    n += particles.size();
+    elapsed = std::chrono::duration<double>(clock::now() - start).count();
+  }
+  return {n / elapsed, static_cast<double>(n_bins) / n};
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  double seconds = argc > 1 ? std::atof(argv[1]) : 0.5;
+
+  std::mt19937_64 rng {12345};
+  std::uniform_real_distribution<double> uniform {0.0, 1.0};
+
+  std::printf("%4s %6s %8s %14s %14s %8s %12s\n", "dim", "n", "length",
+    "old tracks/s", "new tracks/s", "speedup", "bins/track");
+  for (int n_dimension : {2, 3}) {
+    for (int n : {10, 100, 1000}) {
+      for (double distance : {0.1, 1.0, 10.0, 40.0}) {
+        auto m = make_cubic_mesh(n_dimension, n, -10.0, 10.0);
+
+        std::vector<Particle> particles(N_TRACKS);
+        for (auto& p : particles) {
+          double mu = 2.0*uniform(rng) - 1.0;
+          double phi = 2.0*PI*uniform(rng);
+          double s = std::sqrt(1.0 - mu*mu);
+          Direction u {s*std::cos(phi), s*std::sin(phi), mu};
+          if (uniform(rng) < 0.1) u = {1.0, 0.0, 0.0};
+          for (int i = 0; i < 3; ++i) {
+            p.last_xyz[i] = -12.0 + 24.0*uniform(rng);
+            p.coord[0].xyz[i] = p.last_xyz[i] + distance*u[i];
+            p.coord[0].uvw[i] = u[i];
+          }
+        }
+
+        auto old_rate = time_traversal(particles, seconds,
+          [&m](const Particle* p, std::vector<int>& bins,
+               std::vector<double>& lengths)
+          {bins_crossed_reference(m, p, bins, lengths);});
+        auto new_rate = time_traversal(particles, seconds,
+          [&m](const Particle* p, std::vector<int>& bins,
+               std::vector<double>& lengths)
+          {m.bins_crossed(p, bins, lengths);});
+
+        std::printf("%4d %6d %8.1f %14.3e %14.3e %8.1f %12.1f\n", n_dimension,
+          n, distance, old_rate.first, new_rate.first,
+          new_rate.first / old_rate.first, new_rate.second);
+      }
+    }
+  }
+}
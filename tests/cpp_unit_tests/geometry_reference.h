@@ -0,0 +1,97 @@
+#ifndef OPENMC_TESTS_GEOMETRY_REFERENCE_H
+#define OPENMC_TESTS_GEOMETRY_REFERENCE_H
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "pugixml.hpp"
+
+#include "openmc/cell.h"
+#include "openmc/position.h"
+#include "openmc/surface.h"
+
+namespace openmc {
+
+//==============================================================================
+//! Read surfaces from the <surface> elements of a geometry XML string into the
+//! global surfaces array and pack their equations as initialization does. At
+//! least one surface must have a boundary condition.
+//==============================================================================
+
+inline void
+load_surfaces(const std::string& geometry_xml)
+{
+  pugi::xml_document doc;
+  doc.load_string(geometry_xml.c_str());
+  read_surfaces(doc.child("geometry"));
+  for (const Surface* surf : model::surfaces) {
+    model::surface_pack.push_back(*surf);
+  }
+}
+
+//==============================================================================
+//! Create a material-filled cell from a region given in infix notation and
+//! append it to the global cells array.
+//
+//! \param id Unique ID of the cell
+//! \param region Region specification in terms of surface IDs
+//! \return Index of the cell in the global cells array
+//==============================================================================
+
+inline int32_t
+add_cell(int32_t id, const std::string& region)
+{
+  pugi::xml_document doc;
+  pugi::xml_node node = doc.append_child("cell");
+  node.append_attribute("id") = id;
+  node.append_attribute("material") = 1;
+  node.append_attribute("region") = region.c_str();
+  model::cells.push_back(new CSGCell(node));
+  return model::cells.size() - 1;
+}
+
+//==============================================================================
+//! Determine if a cell contains a point by evaluating the RPN form of its
+//! region with a stack of booleans, as CSGCell::contains_complex did before
+//! regions were compiled to short-circuiting branches.
+//
+//! \param c Cell whose region is evaluated
+//! \param r The 3D Cartesian coordinate to check
+//! \param u A direction used to break ties on surfaces
+//! \param on_surface The signed index of a surface that r is known to be on
+//==============================================================================
+
+inline bool
+contains_reference(const Cell& c, Position r, Direction u,
+  int32_t on_surface)
+{
+  std::vector<bool> stack;
+  for (int32_t token : c.rpn_) {
+    if (token == OP_UNION) {
+      bool right = stack.back();
+      stack.pop_back();
+      stack.back() = stack.back() || right;
+    } else if (token == OP_INTERSECTION) {
+      bool right = stack.back();
+      stack.pop_back();
+      stack.back() = stack.back() && right;
+    } else if (token == OP_COMPLEMENT) {
+      stack.back() = !stack.back();
+    } else if (token == on_surface) {
+      stack.push_back(true);
+    } else if (-token == on_surface) {
+      stack.push_back(false);
+    } else {
+      // Note the off-by-one indexing
+      bool sense = model::surfaces[std::abs(token)-1]->sense(r, u);
+      stack.push_back(sense == (token > 0));
+    }
+  }
+
+  // A cell without a region specification fills all space
+  return stack.empty() ? true : stack.back();
+}
+
+} // namespace openmc
+#endif // OPENMC_TESTS_GEOMETRY_REFERENCE_H
@@ -0,0 +1,173 @@
+#ifndef OPENMC_TESTS_MESH_REFERENCE_H
+#define OPENMC_TESTS_MESH_REFERENCE_H
+
+#include <cmath>
+#include <vector>
+
+#include "xtensor/xsort.hpp"
+#include "xtensor/xtensor.hpp"
+
+#include "openmc/constants.h"
+#include "openmc/mesh.h"
+#include "openmc/particle.h"
+
+namespace openmc {
+
+//==============================================================================
+//! Track traversal of a regular mesh as it was done before
+//! RegularMesh::bins_crossed used a DDA. It finds the nearest mesh surface with
+//! an argmin over heap-allocated distances at every crossing, and walks toward
+//! the mesh one surface at a time for tracks that start outside of it, giving
+//! up after MAX_SEARCH_ITER surfaces.
+//
+//! \param[in] m Mesh to traverse
+//! \param[in] p Particle whose last track is traversed
+//! \param[out] bins Mesh bins crossed by the track
+//! \param[out] lengths Fraction of the track length in each bin
+//! \return Whether the track was dropped by the search for the mesh
+//==============================================================================
+
+inline bool
+bins_crossed_reference(const RegularMesh& m, const Particle* p,
+  std::vector<int>& bins, std::vector<double>& lengths)
+{
+  constexpr int MAX_SEARCH_ITER = 100;
+
+  // ========================================================================
+  // Determine if the track intersects the tally mesh.
+
+  Position last_r {p->last_xyz};
+  Position r {p->coord[0].xyz};
+  Direction u {p->coord[0].uvw};
+
+  Position r0 = last_r + TINY_BIT*u;
+  Position r1 = r - TINY_BIT*u;
+
+  // Determine indices for starting and ending location.
+  int n = m.n_dimension_;
+  xt::xtensor<int, 1> ijk0 = xt::empty<int>({n});
+  bool start_in_mesh;
+  m.get_indices(r0, ijk0.data(), &start_in_mesh);
+  xt::xtensor<int, 1> ijk1 = xt::empty<int>({n});
+  bool end_in_mesh;
+  m.get_indices(r1, ijk1.data(), &end_in_mesh);
+
+  // Check if the track intersects any part of the mesh.
+  if (!start_in_mesh && !end_in_mesh) {
+    if (!m.intersects(r0, r1)) return false;
+  }
+
+  // ========================================================================
+  // Figure out which mesh cell to tally.
+
+  r0 = last_r;
+  r1 = r;
+  double total_distance = (r1 - r0).norm();
+
+  if (!start_in_mesh) {
+    xt::xtensor<double, 1> d = xt::zeros<double>({n});
+    if (total_distance < 2*TINY_BIT) return false;
+
+    int search_iter = 0;
+    int j;
+    while (xt::any(ijk0 < 1) || xt::any(ijk0 > m.shape_)) {
+      if (search_iter == MAX_SEARCH_ITER) return true;
+
+      for (j = 0; j < n; ++j) {
+        if (std::fabs(u[j]) < FP_PRECISION) {
+          d(j) = INFTY;
+        } else if (u[j] > 0.0) {
+          double xyz_cross = m.lower_left_[j] + ijk0(j) * m.width_[j];
+          d(j) = (xyz_cross - r0[j]) / u[j];
+        } else {
+          double xyz_cross = m.lower_left_[j] + (ijk0(j) - 1) * m.width_[j];
+          d(j) = (xyz_cross - r0[j]) / u[j];
+        }
+      }
+
+      j = xt::argmin(d)(0);
+      if (u[j] > 0.0) {
+        ++ijk0(j);
+      } else {
+        --ijk0(j);
+      }
+
+      ++search_iter;
+    }
+
+    r0 += d(j) * u;
+  }
+
+  while (true) {
+    if (ijk0 == ijk1) {
+      // The track ends in this cell.
+      double distance = (r1 - r0).norm();
+      bins.push_back(m.get_bin_from_indices(ijk0.data()));
+      lengths.push_back(distance / total_distance);
+      break;
+    }
+
+    // The track exits this cell.
+    xt::xtensor<double, 1> d = xt::zeros<double>({n});
+    for (int k = 0; k < n; ++k) {
+      if (std::fabs(u[k]) < FP_PRECISION) {
+        d(k) = INFTY;
+      } else if (u[k] > 0) {
+        double xyz_cross = m.lower_left_[k] + ijk0(k) * m.width_[k];
+        d(k) = (xyz_cross - r0[k]) / u[k];
+      } else {
+        double xyz_cross = m.lower_left_[k] + (ijk0(k) - 1) * m.width_[k];
+        d(k) = (xyz_cross - r0[k]) / u[k];
+      }
+    }
+
+    auto j = xt::argmin(d)(0);
+    double distance = d(j);
+    bins.push_back(m.get_bin_from_indices(ijk0.data()));
+    lengths.push_back(distance / total_distance);
+
+    r0 += distance * u;
+
+    if (u[j] > 0.0) {
+      ++ijk0(j);
+    } else {
+      --ijk0(j);
+    }
+
+    if (xt::any(ijk0 < 1) || xt::any(ijk0 > m.shape_)) break;
+  }
+  return false;
+}
+
+//==============================================================================
+//! Make a mesh with the same number of elements and extent in each dimension
+//
+//! \param[in] n_dimension Number of dimensions
+//! \param[in] n Number of elements in each dimension
+//! \param[in] lower Lower coordinate in each dimension
+//! \param[in] upper Upper coordinate in each dimension
+//==============================================================================
+
+inline RegularMesh
+make_cubic_mesh(int n_dimension, int n, double lower, double upper)
+{
+  RegularMesh m;
+  m.n_dimension_ = n_dimension;
+  std::vector<std::size_t> shape {static_cast<std::size_t>(n_dimension)};
+  m.shape_ = xt::xarray<int>::from_shape(shape);
+  m.lower_left_ = xt::xarray<double>::from_shape(shape);
+  m.upper_right_ = xt::xarray<double>::from_shape(shape);
+  m.width_ = xt::xarray<double>::from_shape(shape);
+  for (int i = 0; i < n_dimension; ++i) {
+    m.shape_[i] = n;
+    m.lower_left_[i] = lower;
+    m.upper_right_[i] = upper;
+    m.width_[i] = (upper - lower) / n;
+  }
+  m.volume_frac_ = 1.0 / m.n_bins();
+  return m;
+}
+
+} // namespace openmc
+
+#endif // OPENMC_TESTS_MESH_REFERENCE_H
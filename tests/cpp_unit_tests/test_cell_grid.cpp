@@ -0,0 +1,225 @@
+//! Check the candidate cells of a CellGrid against a linear search over all
+//! cells. Boxes, spheres, unions of spheres, cylinders, half-spaces and
+//! complemented regions are placed at random, and every cell containing a
+//! point must be listed in the grid bin of the point. Points are sampled at
+//! random, on the faces of the boxes, and on either side of the boundaries
+//! between grid bins.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "geometry_reference.h"
+
+using namespace openmc;
+
+namespace {
+
+//! Half-width of the region in which cells are placed
+constexpr double HALF_WIDTH {10.0};
+
+//! Number of cells of each kind
+constexpr int N_BOXES {150};
+constexpr int N_SPHERES {50};
+constexpr int N_UNIONS {10};
+constexpr int N_CYLINDERS {20};
+constexpr int N_HALFSPACES {10};
+constexpr int N_COMPLEMENTS {10};
+
+//! Number of points sampled in each way
+constexpr int N_POINTS {20000};
+
+int n_failures {0};
+
+//! Report a failed check
+void fail(const std::string& message)
+{
+  if (n_failures++ < 20) std::printf("%s\n", message.c_str());
+}
+
+//! Check that every cell containing a point is a candidate in its grid bin
+void check_point(const CellGrid& grid, const std::vector<int32_t>& cells,
+  Position r, Direction u)
+{
+  int bin = grid.get_bin(r);
+  for (int32_t i_cell : cells) {
+    if (!model::cells[i_cell]->contains(r, u, 0)) continue;
+    const int32_t* end = grid.cend(bin);
+    if (std::find(grid.cbegin(bin), end, i_cell) == end) {
+      char buffer[256];
+      std::snprintf(buffer, sizeof(buffer), "cell %d contains (%.17g, %.17g, "
+        "%.17g) but is not a candidate in bin %d", model::cells[i_cell]->id_,
+        r.x, r.y, r.z, bin);
+      fail(buffer);
+    }
+  }
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937_64 rng {12345};
+  std::uniform_real_distribution<double> uniform {0.0, 1.0};
+  auto coord = [&](double half_width) {
+    return half_width*(2.0*uniform(rng) - 1.0);
+  };
+  auto isotropic = [&]() {
+    double mu = 2.0*uniform(rng) - 1.0;
+    double phi = 2.0*PI*uniform(rng);
+    double s = std::sqrt(1.0 - mu*mu);
+    return Direction{s*std::cos(phi), s*std::sin(phi), mu};
+  };
+
+  // ===========================================================================
+  // Build surfaces and the regions of the cells in terms of them
+
+  std::string xml {"<geometry>"};
+  int n_surfaces = 0;
+  auto add_surface = [&](const std::string& type, std::vector<double> c) {
+    xml += "<surface id=\"" + std::to_string(++n_surfaces) + "\" type=\"" +
+      type + "\" boundary=\"vacuum\" coeffs=\"";
+    for (double x : c) xml += std::to_string(x) + " ";
+    xml += "\" />";
+    return std::to_string(n_surfaces);
+  };
+  auto add_sphere = [&]() {
+    return add_surface("sphere", {coord(HALF_WIDTH), coord(HALF_WIDTH),
+      coord(HALF_WIDTH), 0.5 + 2.5*uniform(rng)});
+  };
+
+  std::vector<std::string> regions;
+  std::vector<std::array<std::pair<double, std::string>, 6>> boxes;
+  for (int i = 0; i < N_BOXES; ++i) {
+    std::array<std::pair<double, std::string>, 6> faces;
+    for (int j = 0; j < 3; ++j) {
+      std::string type = "xyz"[j] + std::string("-plane");
+      double lower = std::stod(std::to_string(coord(HALF_WIDTH)));
+      double upper = lower + 0.2 + 3.0*uniform(rng);
+      upper = std::stod(std::to_string(upper));
+      faces[2*j] = {lower, add_surface(type, {lower})};
+      faces[2*j + 1] = {upper, add_surface(type, {upper})};
+    }
+    regions.push_back(faces[0].second + " -" + faces[1].second + " " +
+      faces[2].second + " -" + faces[3].second + " " + faces[4].second +
+      " -" + faces[5].second);
+    boxes.push_back(faces);
+  }
+  for (int i = 0; i < N_SPHERES; ++i) {
+    regions.push_back("-" + add_sphere());
+  }
+  for (int i = 0; i < N_UNIONS; ++i) {
+    std::string left = add_sphere();
+    regions.push_back("-" + left + " | -" + add_sphere());
+  }
+  for (int i = 0; i < N_CYLINDERS; ++i) {
+    // Cylinders are unbounded along their axis
+    std::string type = "xyz"[i % 3] + std::string("-cylinder");
+    regions.push_back("-" + add_surface(type, {coord(HALF_WIDTH),
+      coord(HALF_WIDTH), 0.5 + 2.5*uniform(rng)}));
+  }
+  for (int i = 0; i < N_HALFSPACES; ++i) {
+    std::string type = "xyz"[i % 3] + std::string("-plane");
+    std::string sign = i % 2 ? "-" : "";
+    regions.push_back(sign + add_surface(type, {coord(HALF_WIDTH)}));
+  }
+  for (int i = 0; i < N_COMPLEMENTS; ++i) {
+    // The complement of a bounded region is unbounded
+    regions.push_back("~(-" + add_sphere() + ")");
+  }
+  xml += "</geometry>";
+  load_surfaces(xml);
+
+  // Interleave the kinds of cells so that bounded and unbounded cells are
+  // mixed in the order used to build the grid
+  std::shuffle(regions.begin(), regions.end(), rng);
+  std::vector<int32_t> cells;
+  for (int i = 0; i < regions.size(); ++i) {
+    cells.push_back(add_cell(i + 1, regions[i]));
+  }
+
+  CellGrid grid {cells};
+  if (grid.empty()) fail("no grid was formed");
+
+  // Candidates must be listed in the order of the cells
+  int n_bins = grid.get_bin({INFTY, INFTY, INFTY}) + 1;
+  for (int bin = 0; bin < n_bins; ++bin) {
+    if (!std::is_sorted(grid.cbegin(bin), grid.cend(bin))) {
+      fail("candidates in bin " + std::to_string(bin) + " are out of order");
+    }
+  }
+
+  // ===========================================================================
+  // Random points, including points outside the extent of the grid
+
+  for (int i = 0; i < N_POINTS; ++i) {
+    Position r {coord(1.5*HALF_WIDTH), coord(1.5*HALF_WIDTH),
+      coord(1.5*HALF_WIDTH)};
+    check_point(grid, cells, r, isotropic());
+  }
+
+  // ===========================================================================
+  // Points on the faces of boxes, which are contained by the box when the
+  // direction points into it
+
+  for (int i = 0; i < N_POINTS; ++i) {
+    int i_box = uniform(rng)*boxes.size();
+    const auto& faces = boxes[i_box];
+    Position r;
+    for (int j = 0; j < 3; ++j) {
+      r[j] = faces[2*j].first + uniform(rng)*
+        (faces[2*j + 1].first - faces[2*j].first);
+    }
+    int face = uniform(rng)*6;
+    r[face / 2] = faces[face].first;
+    check_point(grid, cells, r, isotropic());
+  }
+
+  // ===========================================================================
+  // Points on either side of a boundary between bins, found by bisecting a
+  // line along an axis between points in different bins
+
+  for (int i = 0; i < N_POINTS; ++i) {
+    int axis = uniform(rng)*3;
+    Position a {coord(HALF_WIDTH), coord(HALF_WIDTH), coord(HALF_WIDTH)};
+    Position b {a};
+    a[axis] = coord(1.5*HALF_WIDTH);
+    b[axis] = a[axis] + 0.5*HALF_WIDTH*uniform(rng);
+    if (grid.get_bin(a) == grid.get_bin(b)) continue;
+    while (true) {
+      Position mid {a};
+      mid[axis] = 0.5*(a[axis] + b[axis]);
+      if (mid[axis] == a[axis] || mid[axis] == b[axis]) break;
+      if (grid.get_bin(mid) == grid.get_bin(a)) {
+        a = mid;
+      } else {
+        b = mid;
+      }
+    }
+    Direction u = isotropic();
+    check_point(grid, cells, a, u);
+    check_point(grid, cells, b, u);
+  }
+
+  // ===========================================================================
+  // Cells that are all unbounded cannot form a grid
+
+  std::vector<int32_t> unbounded;
+  for (int32_t i_cell : cells) {
+    if (model::cells[i_cell]->region_.front() == OP_COMPLEMENT) {
+      unbounded.push_back(i_cell);
+    }
+  }
+  if (unbounded.size() != N_COMPLEMENTS) {
+    fail("found " + std::to_string(unbounded.size()) + " complemented cells");
+  }
+  if (!CellGrid{unbounded}.empty()) {
+    fail("a grid was formed from unbounded cells");
+  }
+
+  return n_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+//! Check incoherent scattering for a synthetic high-Z element. The scattering
+//! cosines sampled from the tabulated angular distribution (compton_tables)
+//! are compared with those sampled by rejection on the form factor at several
+//! energies using a two-sample chi-squared statistic. The guide table lookup
+//! into the Compton profile CDFs is compared with a binary search, including
+//! CDFs with flat regions and values at or beyond the end of the CDF, for
+//! which the index is clamped to the last interval.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <hdf5.h>
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+#include "openmc/constants.h"
+#include "openmc/hdf5_interface.h"
+#include "openmc/photon.h"
+#include "openmc/random_lcg.h"
+#include "openmc/search.h"
+#include "openmc/settings.h"
+
+using namespace openmc;
+
+namespace {
+
+//! Atomic number of the element
+constexpr int Z {82};
+
+//! Number of cosines sampled with each method at each energy
+constexpr int N_SAMPLES {200000};
+
+//! Number of equal-width cosine bins in the histograms
+constexpr int N_BINS {50};
+
+int n_failures {0};
+
+//! Report a failed check
+void fail(const std::string& message)
+{
+  if (n_failures++ < 20) std::printf("%s\n", message.c_str());
+}
+
+//! Write a tabulated function with a single linear-linear region
+void write_tabulated(hid_t group, const char* name,
+  const std::vector<double>& x, const std::vector<double>& y)
+{
+  xt::xtensor<double, 2> xy({2, x.size()});
+  for (int i = 0; i < x.size(); ++i) {
+    xy(0, i) = x[i];
+    xy(1, i) = y[i];
+  }
+  write_dataset(group, name, xy);
+  hid_t dset = open_dataset(group, name);
+  write_attribute(dset, "breakpoints", std::vector<int>{int(x.size())});
+  write_attribute(dset, "interpolation", std::vector<int>{2});
+  close_dataset(dset);
+}
+
+//! Write a cross section with a threshold index
+void write_xs(hid_t group, const std::vector<double>& xs)
+{
+  write_dataset(group, "xs", xs);
+  hid_t dset = open_dataset(group, "xs");
+  write_attribute(dset, "threshold_idx", 0);
+  close_dataset(dset);
+}
+
+//! Write photon interaction data for an element to a group. The incoherent
+//! scattering function rises from zero to Z over a momentum transfer of about
+//! one inverse angstrom, and the Compton profiles have flat regions at the
+//! start and end of their CDFs and a large weight in their last interval.
+void write_element(hid_t group, const std::vector<double>& pz)
+{
+  write_attribute(group, "Z", Z);
+
+  std::vector<double> energy;
+  for (int i = 0; i <= 100; ++i) {
+    energy.push_back(1.0e3*std::pow(10.0, 0.05*i));
+  }
+  write_dataset(group, "energy", energy);
+  std::vector<double> xs(energy.size(), 1.0);
+
+  hid_t rgroup = create_group(group, "coherent");
+  write_dataset(rgroup, "xs", xs);
+  write_tabulated(rgroup, "integrated_scattering_factor", {0.0, 1.0e9},
+    {1.0, 1.0});
+  close_group(rgroup);
+
+  std::vector<double> x {0.0};
+  std::vector<double> s {0.0};
+  for (int i = 0; i <= 140; ++i) {
+    x.push_back(1.0e-3*std::pow(10.0, 0.05*i));
+    double t = x.back()*x.back();
+    s.push_back(Z*t/(1.0 + t));
+  }
+  rgroup = create_group(group, "incoherent");
+  write_dataset(rgroup, "xs", xs);
+  write_tabulated(rgroup, "scattering_factor", x, s);
+  close_group(rgroup);
+
+  for (const char* name : {"pair_production_electron", "photoelectric"}) {
+    rgroup = create_group(group, name);
+    write_dataset(rgroup, "xs", xs);
+    close_group(rgroup);
+  }
+
+  // Fixed-length designators of the subshells
+  rgroup = create_group(group, "subshells");
+  std::vector<double> binding_energy {88.0e3, 15.9e3, 3.85e3};
+  std::vector<double> n_electrons {2.0, 2.0, 78.0};
+  hid_t dtype = H5Tcopy(H5T_C_S1);
+  H5Tset_size(dtype, 3);
+  hsize_t dims[] {3};
+  hid_t dspace = H5Screate_simple(1, dims, nullptr);
+  hid_t attr = H5Acreate(rgroup, "designators", dtype, dspace, H5P_DEFAULT,
+    H5P_DEFAULT);
+  H5Awrite(attr, dtype, "K\0\0L1\0M1\0");
+  H5Aclose(attr);
+  H5Sclose(dspace);
+  H5Tclose(dtype);
+  int i = 0;
+  for (const char* name : {"K", "L1", "M1"}) {
+    hid_t tgroup = create_group(rgroup, name);
+    write_attribute(tgroup, "binding_energy", binding_energy[i]);
+    write_attribute(tgroup, "num_electrons", n_electrons[i]);
+    write_xs(tgroup, xs);
+    close_group(tgroup);
+    ++i;
+  }
+  close_group(rgroup);
+
+  int n = pz.size();
+  xt::xtensor<double, 2> J({3, pz.size()});
+  for (int j = 0; j < n; ++j) {
+    J(0, j) = std::exp(-pz[j]);
+    J(1, j) = (j < 3 || pz[j] > 2.0) ? 0.0 : 1.0;
+    J(2, j) = j == n - 1 ? 50.0 : 0.1*pz[j];
+  }
+  rgroup = create_group(group, "compton_profiles");
+  write_dataset(rgroup, "num_electrons", n_electrons);
+  write_dataset(rgroup, "binding_energy", binding_energy);
+  write_dataset(rgroup, "J", J);
+  write_dataset(rgroup, "pz", pz);
+  close_group(rgroup);
+}
+
+//! Histogram the cosines sampled for a photon energy
+std::vector<double> sample_mu(const PhotonInteraction& element, double E,
+  bool tables)
+{
+  settings::compton_tables = tables;
+  std::vector<double> counts(N_BINS, 0.0);
+  double alpha = E/MASS_ELECTRON_EV;
+  for (int i = 0; i < N_SAMPLES; ++i) {
+    double alpha_out, mu;
+    int i_shell;
+    element.compton_scatter(alpha, false, &alpha_out, &mu, &i_shell);
+    int bin = std::min(static_cast<int>(0.5*(mu + 1.0)*N_BINS), N_BINS - 1);
+    counts[bin] += 1.0;
+  }
+  return counts;
+}
+
+} // namespace
+
+int main()
+{
+  // Read the element from an in-memory file, tabulating the incoherent
+  // scattering angular distribution as the compton_tables setting does
+  std::vector<double> pz;
+  for (int j = 0; j <= 30; ++j) pz.push_back(0.1*j);
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  H5Pset_fapl_core(fapl, 1 << 20, false);
+  hid_t file = H5Fcreate("compton.h5", H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+  H5Pclose(fapl);
+  hid_t group = create_group(file, "Pb");
+  write_element(group, pz);
+
+  settings::electron_treatment = ELECTRON_LED;
+  settings::compton_tables = true;
+  PhotonInteraction element {group, 0};
+  close_group(group);
+  H5Fclose(file);
+
+  // ===========================================================================
+  // Sampled scattering cosines. The statistic has about N_BINS - 1 degrees of
+  // freedom, and a bound six standard deviations above its mean is only
+  // exceeded by chance with negligible probability.
+
+  openmc_set_seed(1);
+  for (double E : {2.0e4, 1.5e5, 1.0e6, 8.0e6}) {
+    std::vector<double> rejection = sample_mu(element, E, false);
+    std::vector<double> tabulated = sample_mu(element, E, true);
+    double chi_sq = 0.0;
+    int dof = -1;
+    for (int i = 0; i < N_BINS; ++i) {
+      double n = rejection[i] + tabulated[i];
+      if (n == 0.0) continue;
+      chi_sq += std::pow(rejection[i] - tabulated[i], 2)/n;
+      ++dof;
+    }
+    if (chi_sq > dof + 6.0*std::sqrt(2.0*dof)) {
+      fail("cosines at " + std::to_string(E) + " eV differ: chi-squared is " +
+        std::to_string(chi_sq) + " for " + std::to_string(dof) +
+        " degrees of freedom");
+    }
+  }
+
+  // ===========================================================================
+  // Compton profile CDF lookup
+
+  std::mt19937_64 rng {12345};
+  std::uniform_real_distribution<double> uniform {0.0, 1.0};
+  int n = pz.size();
+  for (int shell = 0; shell < 3; ++shell) {
+    auto cdf = xt::view(element.profile_cdf_, shell, xt::all());
+    double c_total = cdf(n - 1);
+
+    // Random values, the CDF values themselves and their neighbors
+    std::vector<double> values {0.0, c_total};
+    for (int i = 0; i < 10000; ++i) values.push_back(uniform(rng)*c_total);
+    for (int i = 0; i < n; ++i) {
+      values.push_back(cdf(i));
+      values.push_back(std::nextafter(cdf(i), 0.0));
+      if (i < n - 1) values.push_back(std::nextafter(cdf(i), INFTY));
+    }
+    for (double c : values) {
+      if (c > c_total) continue;
+      int i = element.profile_cdf_index(shell, c);
+      int expected = lower_bound_index(cdf.cbegin(), cdf.cend(), c);
+      if (i != expected) {
+        char buffer[256];
+        std::snprintf(buffer, sizeof(buffer), "shell %d: index of %.17g is %d "
+          "rather than %d", shell, c, i, expected);
+        fail(buffer);
+      }
+    }
+
+    // Values beyond the end of the CDF are in the last interval
+    for (double c : {std::nextafter(c_total, INFTY), 1.5*c_total}) {
+      int i = element.profile_cdf_index(shell, c);
+      if (i != n - 2) {
+        fail("shell " + std::to_string(shell) + ": index beyond the end is " +
+          std::to_string(i));
+      }
+    }
+  }
+
+  // The last interval of the third shell holds most of its weight
+  auto cdf = xt::view(element.profile_cdf_, 2, xt::all());
+  if (cdf(n - 2) > 0.5*cdf(n - 1)) fail("last interval has little weight");
+
+  return n_failures == 0 ? 0 : 1;
+}
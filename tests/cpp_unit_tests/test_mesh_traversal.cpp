@@ -0,0 +1,125 @@
+//! Compare the traversal of regular meshes by RegularMesh::bins_crossed with
+//! the traversal it replaced. Every track must cross the same bins, with the
+//! same fraction of its length in each, except for tracks that the old search
+//! for the mesh gave up on.
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mesh_reference.h"
+
+using namespace openmc;
+
+namespace {
+
+//! Largest allowed difference in the fraction of a track in a bin
+constexpr double LENGTH_TOLERANCE {1.0e-10};
+
+int n_failures {0};
+int n_dropped {0};
+
+//! Traverse a track with both methods and report any difference
+void check_track(const RegularMesh& m, const std::string& kind,
+  const Position& r0, const Direction& u, double distance)
+{
+  Particle p;
+  for (int i = 0; i < 3; ++i) {
+    p.last_xyz[i] = r0[i];
+    p.coord[0].xyz[i] = r0[i] + distance*u[i];
+    p.coord[0].uvw[i] = u[i];
+  }
+
+  std::vector<int> bins, ref_bins;
+  std::vector<double> lengths, ref_lengths;
+  m.bins_crossed(&p, bins, lengths);
+  if (bins_crossed_reference(m, &p, ref_bins, ref_lengths)) {
+    ++n_dropped;
+    return;
+  }
+
+  bool same = bins == ref_bins;
+  for (int i = 0; same && i < lengths.size(); ++i) {
+    same = std::abs(lengths[i] - ref_lengths[i]) <= LENGTH_TOLERANCE;
+  }
+  if (same) return;
+
+  if (n_failures++ < 10) {
+    std::printf("%dD mesh with %d elements, %s track from (%.17g, %.17g, "
+      "%.17g) along (%.17g, %.17g, %.17g) for %.17g cm\n", m.n_dimension_,
+      static_cast<int>(m.shape_[0]), kind.c_str(), r0.x, r0.y, r0.z, u.x, u.y,
+      u.z, distance);
+    for (int i = 0; i < std::max(bins.size(), ref_bins.size()); ++i) {
+      if (i < bins.size()) {
+        std::printf("  %8d %.17g", bins[i], lengths[i]);
+      } else {
+        std::printf("  %8s %23s", "", "");
+      }
+      if (i < ref_bins.size()) {
+        std::printf("  %8d %.17g", ref_bins[i], ref_lengths[i]);
+      }
+      std::printf("\n");
+    }
+  }
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937_64 rng {12345};
+  std::uniform_real_distribution<double> uniform {0.0, 1.0};
+  auto isotropic = [&]() {
+    double mu = 2.0*uniform(rng) - 1.0;
+    double phi = 2.0*PI*uniform(rng);
+    double s = std::sqrt(1.0 - mu*mu);
+    return Direction{s*std::cos(phi), s*std::sin(phi), mu};
+  };
+
+  constexpr double LOWER {-10.0};
+  constexpr double UPPER {10.0};
+  int n_tracks = 0;
+
+  for (int n_dimension : {1, 2, 3}) {
+    for (int n : {1, 7, 40}) {
+      auto m = make_cubic_mesh(n_dimension, n, LOWER, UPPER);
+      double width = (UPPER - LOWER) / n;
+
+      // Starting points inside and around the mesh
+      auto start = [&]() {
+        return Position{-12.0 + 24.0*uniform(rng), -12.0 + 24.0*uniform(rng),
+          -12.0 + 24.0*uniform(rng)};
+      };
+      // A random mesh plane in dimension i
+      auto plane = [&](int i) {
+        return LOWER + width*std::uniform_int_distribution<int>{0, n}(rng);
+      };
+
+      for (int k = 0; k < 4000; ++k) {
+        double distance = 40.0*uniform(rng)*uniform(rng);
+        int i = std::uniform_int_distribution<int>{0, n_dimension - 1}(rng);
+        Direction axis {0.0, 0.0, 0.0};
+        axis[i] = uniform(rng) < 0.5 ? -1.0 : 1.0;
+
+        // Oblique and axis-parallel tracks from anywhere
+        check_track(m, "oblique", start(), isotropic(), distance);
+        check_track(m, "axis-parallel", start(), axis, distance);
+
+        // Tracks that start on a mesh plane and leave it, either obliquely or
+        // perpendicular to it
+        Position r0 = start();
+        r0[i] = plane(i);
+        check_track(m, "oblique from plane", r0, isotropic(), distance);
+        check_track(m, "perpendicular from plane", r0, axis, distance);
+
+        n_tracks += 4;
+      }
+    }
+  }
+
+  std::printf("%d of %d tracks differ, %d were dropped by the old search\n",
+    n_failures, n_tracks, n_dropped);
+  return n_failures == 0 ? 0 : 1;
+}
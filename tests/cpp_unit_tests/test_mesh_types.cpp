@@ -0,0 +1,320 @@
+//! Check rectilinear and cylindrical meshes. Bins are looked up at known
+//! positions, the volume fractions used for uniform fission site weighting are
+//! compared with their analytic values, and the bins crossed by tracks are
+//! compared with those found by sampling many points along each track. A
+//! rectilinear mesh with uniform spacing must also be traversed in the same
+//! way as the equivalent regular mesh.
+
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mesh_reference.h"
+
+using namespace openmc;
+
+namespace {
+
+//! Number of points sampled along each track
+constexpr int N_SAMPLES {20000};
+
+//! Largest allowed difference in the fraction of a track in a bin between the
+//! traversal and sampling, which resolves the fraction to about 1/N_SAMPLES
+//! at each of the (at most two) times the track enters the bin
+constexpr double SAMPLE_TOLERANCE {5.0 / N_SAMPLES};
+
+//! Largest allowed difference between quantities that should agree to
+//! round-off
+constexpr double TOLERANCE {1.0e-10};
+
+int n_failures {0};
+
+//! Report a failed check
+void fail(const std::string& message)
+{
+  if (n_failures++ < 20) std::printf("%s\n", message.c_str());
+}
+
+//! Make a particle whose last track goes from r0 along u for a distance
+Particle make_track(Position r0, Direction u, double distance)
+{
+  Particle p;
+  for (int i = 0; i < 3; ++i) {
+    p.last_xyz[i] = r0[i];
+    p.coord[0].xyz[i] = r0[i] + distance*u[i];
+    p.coord[0].uvw[i] = u[i];
+  }
+  return p;
+}
+
+//! Check the bin of a position and, if it is in the mesh, its indices
+void check_bin(const Mesh& m, const std::string& name, Position r, int i,
+  int j, int k)
+{
+  int bin = m.get_bin(r);
+  int expected = i < 0 ? -1 : ((k - 1)*m.shape_[1] + (j - 1))*m.shape_[0] + i;
+  if (bin != expected) {
+    fail(name + ": bin at (" + std::to_string(r.x) + ", " +
+      std::to_string(r.y) + ", " + std::to_string(r.z) + ") is " +
+      std::to_string(bin) + " rather than " + std::to_string(expected));
+  }
+  if (i < 0) return;
+
+  int ijk[3];
+  bool in_mesh;
+  m.get_indices(r, ijk, &in_mesh);
+  if (!in_mesh || ijk[0] != i || ijk[1] != j || ijk[2] != k) {
+    fail(name + ": wrong indices for bin " + std::to_string(expected));
+  }
+}
+
+//! Check that the volume fractions of a mesh sum to one and agree with the
+//! given function
+template<typename F>
+void check_volume_frac(const Mesh& m, const std::string& name, F expected)
+{
+  double sum = 0.0;
+  for (int bin = 1; bin <= m.n_bins(); ++bin) {
+    int ijk[3];
+    m.get_indices_from_bin(bin, ijk);
+    double frac = m.volume_frac(bin);
+    sum += frac;
+    if (std::abs(frac - expected(ijk)) > TOLERANCE) {
+      fail(name + ": volume fraction of bin " + std::to_string(bin) + " is " +
+        std::to_string(frac) + " rather than " + std::to_string(expected(ijk)));
+    }
+  }
+  if (std::abs(sum - 1.0) > TOLERANCE) {
+    fail(name + ": volume fractions sum to " + std::to_string(sum));
+  }
+}
+
+//! Compare the bins crossed by a track with those found by sampling the bin at
+//! the midpoints of many equal segments of the track
+void check_track_sampled(const Mesh& m, const std::string& name, Position r0,
+  Direction u, double distance)
+{
+  Particle p = make_track(r0, u, distance);
+  std::vector<int> bins;
+  std::vector<double> lengths;
+  m.bins_crossed(&p, bins, lengths);
+
+  std::map<int, double> crossed;
+  for (int i = 0; i < bins.size(); ++i) crossed[bins[i]] += lengths[i];
+
+  std::map<int, double> sampled;
+  for (int i = 0; i < N_SAMPLES; ++i) {
+    int bin = m.get_bin(r0 + ((i + 0.5) / N_SAMPLES * distance)*u);
+    if (bin >= 0) sampled[bin] += 1.0 / N_SAMPLES;
+  }
+
+  // Bins that a track only grazes may be missed by either method
+  bool same = true;
+  for (const auto& b : crossed) {
+    double f = sampled.count(b.first) ? sampled[b.first] : 0.0;
+    if (std::abs(b.second - f) > SAMPLE_TOLERANCE) same = false;
+  }
+  for (const auto& b : sampled) {
+    if (!crossed.count(b.first) && b.second > SAMPLE_TOLERANCE) same = false;
+  }
+  if (same) return;
+
+  char buffer[256];
+  std::snprintf(buffer, sizeof(buffer), "%s: track from (%.17g, %.17g, %.17g) "
+    "along (%.17g, %.17g, %.17g) for %.17g cm", name.c_str(), r0.x, r0.y, r0.z,
+    u.x, u.y, u.z, distance);
+  fail(buffer);
+  for (const auto& b : crossed) {
+    std::printf("  crossed %6d %.6f\n", b.first, b.second);
+  }
+  for (const auto& b : sampled) {
+    std::printf("  sampled %6d %.6f\n", b.first, b.second);
+  }
+}
+
+//! Compare the traversal of a regular mesh with that of a rectilinear mesh
+//! with the same mesh surfaces
+void check_track_regular(const RegularMesh& regular,
+  const RectilinearMesh& rectilinear, Position r0, Direction u,
+  double distance)
+{
+  Particle p = make_track(r0, u, distance);
+  std::vector<int> bins, ref_bins;
+  std::vector<double> lengths, ref_lengths;
+  rectilinear.bins_crossed(&p, bins, lengths);
+  regular.bins_crossed(&p, ref_bins, ref_lengths);
+
+  bool same = bins == ref_bins;
+  for (int i = 0; same && i < lengths.size(); ++i) {
+    same = std::abs(lengths[i] - ref_lengths[i]) <= TOLERANCE;
+  }
+  if (same) return;
+
+  char buffer[256];
+  std::snprintf(buffer, sizeof(buffer), "rectilinear %d: track from (%.17g, "
+    "%.17g, %.17g) along (%.17g, %.17g, %.17g) for %.17g cm differs from the "
+    "regular mesh", static_cast<int>(regular.shape_[0]), r0.x, r0.y, r0.z,
+    u.x, u.y, u.z, distance);
+  fail(buffer);
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937_64 rng {12345};
+  std::uniform_real_distribution<double> uniform {0.0, 1.0};
+  auto isotropic = [&]() {
+    double mu = 2.0*uniform(rng) - 1.0;
+    double phi = 2.0*PI*uniform(rng);
+    double s = std::sqrt(1.0 - mu*mu);
+    return Direction{s*std::cos(phi), s*std::sin(phi), mu};
+  };
+  auto point = [&](double half_width) {
+    return Position{half_width*(2.0*uniform(rng) - 1.0),
+      half_width*(2.0*uniform(rng) - 1.0), half_width*(2.0*uniform(rng) - 1.0)};
+  };
+
+  // ===========================================================================
+  // Rectilinear mesh with uneven spacing
+
+  RectilinearMesh rect;
+  if (rect.set_grid({{{-10.0, -3.0, 0.0, 1.0, 10.0}, {-5.0, 5.0},
+                      {0.0, 2.0, 7.0}}}) != 0) {
+    fail("rectilinear: valid grid rejected");
+  }
+  if (rect.n_bins() != 8) fail("rectilinear: wrong number of bins");
+  check_bin(rect, "rectilinear", {-9.0, 0.0, 1.0}, 1, 1, 1);
+  check_bin(rect, "rectilinear", {0.5, 4.0, 1.0}, 3, 1, 1);
+  check_bin(rect, "rectilinear", {5.0, -4.0, 6.0}, 4, 1, 2);
+  check_bin(rect, "rectilinear", {-1.0, 0.0, 3.0}, 2, 1, 2);
+  check_bin(rect, "rectilinear", {-11.0, 0.0, 1.0}, -1, 0, 0);
+  check_bin(rect, "rectilinear", {0.0, 6.0, 1.0}, -1, 0, 0);
+  check_bin(rect, "rectilinear", {0.0, 0.0, 8.0}, -1, 0, 0);
+
+  check_volume_frac(rect, "rectilinear", [&](const int* ijk) {
+    double frac = 1.0;
+    for (int i = 0; i < 3; ++i) {
+      const auto& g {rect.grid_[i]};
+      frac *= (g[ijk[i]] - g[ijk[i] - 1]) / (g.back() - g.front());
+    }
+    return frac;
+  });
+
+  if (rect.set_grid({{{0.0, 1.0}, {1.0, 1.0}, {0.0, 1.0}}}) == 0) {
+    fail("rectilinear: grid with coincident surfaces accepted");
+  }
+  if (rect.set_grid({{{0.0}, {0.0, 1.0}, {0.0, 1.0}}}) == 0) {
+    fail("rectilinear: grid with a single surface accepted");
+  }
+  rect.set_grid({{{-10.0, -3.0, 0.0, 1.0, 10.0}, {-5.0, 5.0},
+                  {0.0, 2.0, 7.0}}});
+
+  for (int k = 0; k < 2000; ++k) {
+    double distance = 30.0*uniform(rng);
+    check_track_sampled(rect, "rectilinear", point(12.0), isotropic(),
+      distance);
+  }
+
+  // ===========================================================================
+  // Rectilinear meshes with the same surfaces as regular meshes
+
+  for (int n : {1, 7, 40}) {
+    auto regular = make_cubic_mesh(3, n, -10.0, 10.0);
+    std::vector<double> g;
+    for (int i = 0; i <= n; ++i) g.push_back(-10.0 + i*regular.width_[0]);
+    RectilinearMesh uniform_rect;
+    uniform_rect.set_grid({{g, g, g}});
+
+    for (int bin = 1; bin <= regular.n_bins(); ++bin) {
+      if (std::abs(uniform_rect.volume_frac(bin) - regular.volume_frac(bin))
+          > TOLERANCE) {
+        fail("rectilinear " + std::to_string(n) + ": volume fraction of bin " +
+          std::to_string(bin) + " differs from the regular mesh");
+      }
+    }
+
+    for (int k = 0; k < 4000; ++k) {
+      Position r0 = point(12.0);
+      if (uniform_rect.get_bin(r0) != regular.get_bin(r0)) {
+        fail("rectilinear " + std::to_string(n) + ": bin differs from the "
+          "regular mesh");
+      }
+      double distance = 40.0*uniform(rng)*uniform(rng);
+      check_track_regular(regular, uniform_rect, r0, isotropic(), distance);
+      Direction axis {0.0, 0.0, 0.0};
+      axis[k % 3] = uniform(rng) < 0.5 ? -1.0 : 1.0;
+      check_track_regular(regular, uniform_rect, r0, axis, distance);
+    }
+  }
+
+  // ===========================================================================
+  // Cylindrical meshes covering part of and every azimuthal angle
+
+  CylindricalMesh cyl;
+  cyl.origin_ = {1.0, -2.0, 0.5};
+  if (cyl.set_grid({{{0.0, 1.0, 3.0, 6.0}, {0.0, 0.5*PI, PI, 1.5*PI},
+                     {-4.0, 0.0, 4.0}}}) != 0) {
+    fail("cylindrical: valid grid rejected");
+  }
+  if (cyl.n_bins() != 18) fail("cylindrical: wrong number of bins");
+  check_bin(cyl, "cylindrical", {1.5, -1.5, 0.0}, 1, 1, 1);
+  check_bin(cyl, "cylindrical", {-1.0, -1.0, 1.0}, 2, 2, 2);
+  check_bin(cyl, "cylindrical", {-3.0, -4.0, 4.0}, 3, 3, 2);
+  check_bin(cyl, "cylindrical", {1.0, -2.0, 1.0}, 1, 1, 2);
+  check_bin(cyl, "cylindrical", {3.0, -4.0, 1.0}, -1, 0, 0);
+  check_bin(cyl, "cylindrical", {8.0, -2.0, 1.0}, -1, 0, 0);
+  check_bin(cyl, "cylindrical", {2.0, -2.0, 5.0}, -1, 0, 0);
+
+  auto cylindrical_frac = [&](const int* ijk) {
+    const auto& r {cyl.grid_[0]};
+    const auto& phi {cyl.grid_[1]};
+    const auto& z {cyl.grid_[2]};
+    int i = ijk[0];
+    int j = ijk[1];
+    int k = ijk[2];
+    return (r[i]*r[i] - r[i-1]*r[i-1])*(phi[j] - phi[j-1])*(z[k] - z[k-1])
+      / ((r.back()*r.back() - r.front()*r.front())
+         *(phi.back() - phi.front())*(z.back() - z.front()));
+  };
+  check_volume_frac(cyl, "cylindrical", cylindrical_frac);
+
+  if (cyl.set_grid({{{-1.0, 1.0}, {0.0, PI}, {0.0, 1.0}}}) == 0) {
+    fail("cylindrical: negative radius accepted");
+  }
+  if (cyl.set_grid({{{0.0, 1.0}, {0.0, 7.0}, {0.0, 1.0}}}) == 0) {
+    fail("cylindrical: angle beyond 2*pi accepted");
+  }
+  cyl.set_grid({{{0.0, 1.0, 3.0, 6.0}, {0.0, 0.5*PI, PI, 1.5*PI},
+                 {-4.0, 0.0, 4.0}}});
+
+  for (int k = 0; k < 2000; ++k) {
+    double distance = 20.0*uniform(rng);
+    check_track_sampled(cyl, "cylindrical", cyl.origin_ + point(8.0),
+      isotropic(), distance);
+  }
+
+  CylindricalMesh annulus;
+  annulus.set_grid({{{2.0, 4.0, 5.0}, {0.0, 2.0*PI}, {0.0, 10.0}}});
+  check_bin(annulus, "annulus", {0.0, 3.0, 5.0}, 1, 1, 1);
+  check_bin(annulus, "annulus", {-3.0, -3.0, 5.0}, 2, 1, 1);
+  check_bin(annulus, "annulus", {4.5, 0.0, 5.0}, 2, 1, 1);
+  check_bin(annulus, "annulus", {1.0, 1.0, 5.0}, -1, 0, 0);
+  check_volume_frac(annulus, "annulus", [](const int* ijk) {
+    return ijk[0] == 1 ? 12.0/21.0 : 9.0/21.0;
+  });
+
+  for (int k = 0; k < 2000; ++k) {
+    double distance = 20.0*uniform(rng);
+    Position r0 = point(7.0);
+    r0.z += 5.0;
+    check_track_sampled(annulus, "annulus", r0, isotropic(), distance);
+  }
+
+  std::printf("%d checks of rectilinear and cylindrical meshes failed\n",
+    n_failures);
+  return n_failures == 0 ? 0 : 1;
+}
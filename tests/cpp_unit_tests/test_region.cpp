@@ -0,0 +1,174 @@
+//! Check the compiled form of region expressions. Random regions of nested
+//! intersections, unions and complements are evaluated at random points by
+//! CSGCell::contains and by a stack evaluation of their RPN form, with and
+//! without a surface that the point is known to be on. Some points lie exactly
+//! on axis-aligned planes so that ties are broken by the direction.
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "geometry_reference.h"
+
+using namespace openmc;
+
+namespace {
+
+//! Number of surfaces that regions are built from
+constexpr int N_SURFACES {16};
+
+//! Number of random regions
+constexpr int N_REGIONS {2000};
+
+//! Number of points at which each region is evaluated
+constexpr int N_POINTS {200};
+
+//! Largest depth of nesting of the operators in a region
+constexpr int MAX_DEPTH {5};
+
+int n_failures {0};
+
+//! Report a failed check
+void fail(const std::string& message)
+{
+  if (n_failures++ < 20) std::printf("%s\n", message.c_str());
+}
+
+//! Make a random region specification of at most the given depth
+std::string random_region(std::mt19937_64& rng, int depth)
+{
+  std::uniform_real_distribution<double> uniform {0.0, 1.0};
+  std::uniform_int_distribution<int> surface {1, N_SURFACES};
+  if (depth == 0 || uniform(rng) < 0.25) {
+    return (uniform(rng) < 0.5 ? "-" : "") + std::to_string(surface(rng));
+  }
+
+  std::string left = random_region(rng, depth - 1);
+  switch (std::uniform_int_distribution<int>{0, 5}(rng)) {
+    case 0:
+      return "(" + left + " " + random_region(rng, depth - 1) + ")";
+    case 1:
+      return "(" + left + " | " + random_region(rng, depth - 1) + ")";
+    case 2:
+      return "~(" + left + ")";
+    case 3:
+      // Operands without parentheses are grouped by operator precedence
+      return left + " " + random_region(rng, depth - 1);
+    case 4:
+      return left + " | " + random_region(rng, depth - 1);
+    default:
+      return "~" + left;
+  }
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937_64 rng {12345};
+  std::uniform_real_distribution<double> uniform {0.0, 1.0};
+  auto coord = [&]() {return 2.0*uniform(rng) - 1.0;};
+
+  // Surfaces of every kind passing through the region around the origin, with
+  // the positions of the axis-aligned planes kept to place points on them
+  std::string xml {"<geometry>"};
+  std::vector<std::pair<int, double>> planes;
+  for (int id = 1; id <= N_SURFACES; ++id) {
+    std::string type;
+    std::string coeffs;
+    auto add = [&](double c) {coeffs += std::to_string(c) + " ";};
+    switch (id % 8) {
+      case 0:
+        type = "xyz"[id % 3] + std::string("-plane");
+        planes.push_back({id % 3, std::stod(std::to_string(0.5*coord()))});
+        add(planes.back().second);
+        break;
+      case 1:
+        type = "plane";
+        for (int i = 0; i < 3; ++i) add(coord());
+        add(0.3*coord());
+        break;
+      case 2:
+        type = "xyz"[id % 3] + std::string("-cylinder");
+        add(0.3*coord());
+        add(0.3*coord());
+        add(0.2 + 0.6*uniform(rng));
+        break;
+      case 3:
+        type = "sphere";
+        for (int i = 0; i < 3; ++i) add(0.5*coord());
+        add(0.3 + 0.7*uniform(rng));
+        break;
+      case 4:
+        type = "xyz"[id % 3] + std::string("-cone");
+        for (int i = 0; i < 3; ++i) add(0.5*coord());
+        add(0.1 + uniform(rng));
+        break;
+      case 5:
+        type = "quadric";
+        for (int i = 0; i < 9; ++i) add(coord());
+        add(-0.2*uniform(rng));
+        break;
+      default:
+        type = "xyz"[id % 3] + std::string("-plane");
+        planes.push_back({id % 3, std::stod(std::to_string(0.5*coord()))});
+        add(planes.back().second);
+    }
+    xml += "<surface id=\"" + std::to_string(id) + "\" type=\"" + type +
+      "\" coeffs=\"" + coeffs + "\" boundary=\"vacuum\" />";
+  }
+  xml += "</geometry>";
+  load_surfaces(xml);
+
+  int n_complex = 0;
+  for (int i = 0; i < N_REGIONS; ++i) {
+    std::string region = random_region(rng, MAX_DEPTH);
+    const Cell& c {*model::cells[add_cell(i + 1, region)]};
+    if (!c.simple_) ++n_complex;
+
+    for (int j = 0; j < N_POINTS; ++j) {
+      Position r {1.2*coord(), 1.2*coord(), 1.2*coord()};
+      double mu = coord();
+      double phi = 2.0*PI*uniform(rng);
+      double s = std::sqrt(1.0 - mu*mu);
+      Direction u {s*std::cos(phi), s*std::sin(phi), mu};
+
+      // Place some points exactly on an axis-aligned plane
+      if (uniform(rng) < 0.2) {
+        int i_plane = uniform(rng)*planes.size();
+        r[planes[i_plane].first] = planes[i_plane].second;
+      }
+
+      // The point may be known to be on a surface of the cell, on a surface
+      // that is not part of the cell, or on no surface
+      int32_t on_surface = 0;
+      double x = uniform(rng);
+      if (x < 0.5) {
+        on_surface = c.halfspaces_[static_cast<int>(
+          uniform(rng)*c.halfspaces_.size())];
+        if (uniform(rng) < 0.5) on_surface = -on_surface;
+      } else if (x < 0.75) {
+        on_surface = 1 + static_cast<int>(uniform(rng)*N_SURFACES);
+        if (uniform(rng) < 0.5) on_surface = -on_surface;
+      }
+
+      bool in = c.contains(r, u, on_surface);
+      if (in != contains_reference(c, r, u, on_surface)) {
+        char buffer[256];
+        std::snprintf(buffer, sizeof(buffer), "at (%.17g, %.17g, %.17g) on "
+          "surface %d: contains is %d", r.x, r.y, r.z, on_surface, in);
+        fail("region " + region + " " + buffer);
+      }
+    }
+  }
+
+  // Most regions should have been compiled rather than evaluated as simple
+  // intersections
+  if (n_complex < N_REGIONS / 2) {
+    fail("only " + std::to_string(n_complex) + " regions are complex");
+  }
+
+  return n_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+//! Check SurfaceBatch::distances against Surface::distance. A batch holds
+//! several surfaces of each kind with half-spaces of either sense, and the
+//! distances along random rays must be identical to those computed one surface
+//! at a time. Rays also start on a surface, which is then given as the surface
+//! the point is known to be on.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "geometry_reference.h"
+
+using namespace openmc;
+
+namespace {
+
+//! Number of surfaces of each kind
+constexpr int N_PER_KIND {5};
+
+//! Number of rays
+constexpr int N_RAYS {20000};
+
+int n_failures {0};
+
+//! Report a failed check
+void fail(const std::string& message)
+{
+  if (n_failures++ < 20) std::printf("%s\n", message.c_str());
+}
+
+} // namespace
+
+int main()
+{
+  std::mt19937_64 rng {12345};
+  std::uniform_real_distribution<double> uniform {0.0, 1.0};
+  auto coord = [&]() {return 2.0*uniform(rng) - 1.0;};
+  auto isotropic = [&]() {
+    double mu = coord();
+    double phi = 2.0*PI*uniform(rng);
+    double s = std::sqrt(1.0 - mu*mu);
+    return Direction{s*std::cos(phi), s*std::sin(phi), mu};
+  };
+
+  // Surfaces of every kind passing through the region around the origin,
+  // including quadrics that are not of any simpler kind
+  std::string xml {"<geometry>"};
+  int n_surfaces = 0;
+  auto add_surface = [&](const std::string& type, std::vector<double> c) {
+    xml += "<surface id=\"" + std::to_string(++n_surfaces) + "\" type=\"" +
+      type + "\" boundary=\"vacuum\" coeffs=\"";
+    for (double x : c) xml += std::to_string(x) + " ";
+    xml += "\" />";
+  };
+  for (int i = 0; i < N_PER_KIND; ++i) {
+    for (std::string axis : {"x", "y", "z"}) {
+      add_surface(axis + "-plane", {0.5*coord()});
+      add_surface(axis + "-cylinder", {0.3*coord(), 0.3*coord(),
+        0.2 + 0.6*uniform(rng)});
+      add_surface(axis + "-cone", {0.5*coord(), 0.5*coord(), 0.5*coord(),
+        0.1 + uniform(rng)});
+    }
+    add_surface("plane", {coord(), coord(), coord(), 0.3*coord()});
+    add_surface("sphere", {0.5*coord(), 0.5*coord(), 0.5*coord(),
+      0.3 + 0.7*uniform(rng)});
+    add_surface("quadric", {coord(), coord(), coord(), coord(), coord(),
+      coord(), coord(), coord(), coord(), -0.2*uniform(rng)});
+  }
+  xml += "</geometry>";
+  load_surfaces(xml);
+
+  // Half-spaces of every surface, in an order that interleaves the kinds
+  std::vector<int32_t> halfspaces;
+  for (int i = 1; i <= n_surfaces; ++i) {
+    halfspaces.push_back(uniform(rng) < 0.5 ? -i : i);
+  }
+  std::shuffle(halfspaces.begin(), halfspaces.end(), rng);
+  SurfaceBatch batch {halfspaces};
+  if (batch.empty()) fail("batch is empty");
+
+  std::vector<double> d(halfspaces.size());
+  for (int i = 0; i < N_RAYS; ++i) {
+    Position r {1.2*coord(), 1.2*coord(), 1.2*coord()};
+    Direction u = isotropic();
+
+    // Start half of the rays on the nearest surface crossed by a random ray,
+    // given as the surface the point is on from either side. The point is
+    // moved off the surface by more than FP_COINCIDENT so that only the
+    // surface it is known to be on is treated as coincident.
+    int32_t on_surface = 0;
+    if (i % 2 == 1) {
+      double d_min = INFTY;
+      for (int32_t token : halfspaces) {
+        // Note the off-by-one indexing
+        double dist = model::surfaces[std::abs(token)-1]->distance(r, u, false);
+        if (dist < d_min) {
+          d_min = dist;
+          on_surface = uniform(rng) < 0.5 ? -token : token;
+        }
+      }
+      if (d_min == INFTY) continue;
+      r += (d_min + 1.0e-9*coord())*u;
+      u = isotropic();
+    }
+
+    batch.distances(r, u, on_surface, d.data());
+    for (int j = 0; j < halfspaces.size(); ++j) {
+      int32_t token = halfspaces[j];
+      const Surface& surf {*model::surfaces[std::abs(token)-1]};
+      double expected = surf.distance(r, u, token == on_surface);
+      if (d[j] != expected) {
+        char buffer[256];
+        std::snprintf(buffer, sizeof(buffer), "surface %d of kind %d from "
+          "(%.17g, %.17g, %.17g) along (%.17g, %.17g, %.17g) on surface %d: "
+          "distance %.17g rather than %.17g", surf.id_,
+          static_cast<int>(surf.kind()), r.x, r.y, r.z, u.x, u.y, u.z,
+          on_surface, d[j], expected);
+        fail(buffer);
+      }
+    }
+  }
+
+  return n_failures == 0 ? 0 : 1;
+}
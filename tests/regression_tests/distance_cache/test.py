@@ -0,0 +1,59 @@
+import numpy as np
+import openmc
+
+from tests.testing_harness import ComparisonTestHarness, lattice_mg
+
+
+def set_distance_cache(distance_cache):
+    def setup(model):
+        model.settings.distance_cache = distance_cache
+    return setup
+
+
+def compare_cache(name, results, reference):
+    # A saved distance reduced by the distance travelled can differ from a
+    # recomputed one by round-off, so tallies only agree to round-off
+    for tally_id, (ref_s, ref_s_sq) in reference.items():
+        s, s_sq = results[tally_id]
+        assert np.any(s != 0.0), 'Tally {} has no scores'.format(tally_id)
+        assert np.allclose(s, ref_s, rtol=1e-8, atol=0.0), \
+            'Tally {} differs with the distance cache'.format(tally_id)
+        assert np.allclose(s_sq, ref_s_sq, rtol=1e-8, atol=0.0), \
+            'Tally {} differs with the distance cache'.format(tally_id)
+
+
+def test_distance_cache():
+    # Pins in assembly lattices in a core lattice, so that particles cross
+    # surfaces on the pin level many times between crossings on the lattice
+    # levels
+    model = lattice_mg()
+    pin_cells = sorted((c for c in model.geometry.get_all_cells().values()
+                        if c.name in ('fuel', 'clad', 'water')),
+                       key=lambda c: c.id)
+
+    mesh = openmc.Mesh()
+    mesh.dimension = [6, 6, 1]
+    mesh.lower_left = [-3.78, -3.78, -10.0]
+    mesh.upper_right = [3.78, 3.78, 10.0]
+
+    tallies = []
+    for estimator in ('tracklength', 'collision'):
+        t = openmc.Tally()
+        t.filters = [openmc.CellFilter(pin_cells)]
+        t.scores = ['flux', 'total', 'fission']
+        t.estimator = estimator
+        tallies.append(t)
+
+        t = openmc.Tally()
+        t.filters = [openmc.MeshFilter(mesh)]
+        t.scores = ['flux', 'absorption']
+        t.estimator = estimator
+        tallies.append(t)
+    model.tallies = tallies
+
+    variants = [('cache on', set_distance_cache(True)),
+                ('cache off', set_distance_cache(False))]
+    harness = ComparisonTestHarness(
+        'statepoint.10.h5', model, variants, compare=compare_cache,
+        mg_library={'absorption_scales': (1.0, 0.1, 0.02)})
+    harness.main()
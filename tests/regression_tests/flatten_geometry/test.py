@@ -0,0 +1,41 @@
+import openmc
+
+from tests.testing_harness import ComparisonTestHarness, lattice_mg
+
+
+def set_flatten_geometry(flatten_geometry):
+    def setup(model):
+        model.settings.flatten_geometry = flatten_geometry
+    return setup
+
+
+def test_flatten_geometry():
+    # Pins in assembly lattices in a core lattice, where each of the 32
+    # instances of the fuel cell has one of four materials
+    model = lattice_mg(num_materials=6)
+    mats = sorted(model.materials, key=lambda m: m.id)
+    cells = {c.name: c for c in model.geometry.get_all_cells().values()
+             if c.name}
+    fuel_mats = [mats[0], mats[3], mats[4], mats[5]]
+    cells['fuel'].fill = [fuel_mats[i % 4] for i in range(32)]
+
+    tallies = []
+    for name in ('fuel', 'water'):
+        t = openmc.Tally()
+        t.filters = [openmc.DistribcellFilter(cells[name])]
+        t.scores = ['flux', 'absorption', 'fission']
+        tallies.append(t)
+
+    t = openmc.Tally()
+    t.filters = [openmc.MaterialFilter(fuel_mats)]
+    t.scores = ['flux', 'nu-fission']
+    tallies.append(t)
+    model.tallies = tallies
+
+    # Instances are looked up through the flattened hierarchy in the last run
+    mg_library = {'absorption_scales': (1.0, 0.1, 0.02, 0.8, 1.2, 1.5)}
+    variants = [('not flattened', set_flatten_geometry(False)),
+                ('flattened', set_flatten_geometry(True))]
+    harness = ComparisonTestHarness('statepoint.10.h5', model, variants,
+                                    mg_library=mg_library)
+    harness.main()
@@ -0,0 +1,115 @@
+import numpy as np
+import openmc
+from openmc.examples import slab_mg
+
+from tests.testing_harness import ComparisonTestHarness
+
+
+def make_meshes(first_id):
+    # A regular mesh and a rectilinear mesh with the same mesh surfaces, which
+    # are exact in binary, enclosing every fission site
+    regular = openmc.Mesh(mesh_id=first_id)
+    regular.dimension = [4, 1, 1]
+    regular.lower_left = [0.0, -4096.0, -4096.0]
+    regular.upper_right = [1000.0, 4096.0, 4096.0]
+
+    rectilinear = openmc.Mesh(mesh_id=first_id + 1)
+    rectilinear.type = 'rectilinear'
+    rectilinear.x_grid = [0.0, 250.0, 500.0, 750.0, 1000.0]
+    rectilinear.y_grid = [-4096.0, 4096.0]
+    rectilinear.z_grid = [-4096.0, 4096.0]
+
+    # A cylindrical mesh about the z axis with unequal elements, one of which
+    # is on the side of the reflective plane where there are no sites
+    cylindrical = openmc.Mesh(mesh_id=first_id + 2)
+    cylindrical.type = 'cylindrical'
+    cylindrical.r_grid = [0.0, 250.0, 500.0, 5000.0]
+    cylindrical.phi_grid = [0.0, np.pi/2, 3*np.pi/2, 2*np.pi]
+    cylindrical.z_grid = [-5000.0, 0.0, 5000.0]
+    cylindrical.origin = [0.0, 0.0, 0.0]
+
+    return regular, rectilinear, cylindrical
+
+
+def set_ufs_mesh(mesh):
+    def setup(model):
+        model.settings.ufs_mesh = mesh
+    return setup
+
+
+def check_meshes(sp, meshes):
+    # Meshes read back from the statepoint match those in the model
+    for mesh in meshes:
+        sp_mesh = sp.meshes[mesh.id]
+        assert sp_mesh.type == mesh.type
+        assert tuple(sp_mesh.dimension) == tuple(mesh.dimension)
+        for name in ('x_grid', 'y_grid', 'z_grid', 'r_grid', 'phi_grid',
+                     'origin'):
+            if getattr(mesh, name) is not None:
+                assert np.allclose(getattr(sp_mesh, name),
+                                   getattr(mesh, name))
+
+
+def compare_ufs(name, results, reference):
+    # Tallies on the regular and rectilinear meshes agree to round-off in the
+    # track lengths
+    for k, tallies in (results, reference):
+        for score in ('flux', 'current'):
+            s, s_sq = tallies['regular ' + score]
+            ref_s, ref_s_sq = tallies['rectilinear ' + score]
+            assert np.allclose(s, ref_s, rtol=1e-12, atol=0.0)
+            assert np.allclose(s_sq, ref_s_sq, rtol=1e-12, atol=0.0)
+
+    # UFS on a regular mesh and on a rectilinear mesh with the same mesh
+    # surfaces weights sites identically, so eigenvalues and tallies must
+    # agree. UFS on the cylindrical mesh weights sites differently.
+    if name != 'regular':
+        return
+    k, tallies = results
+    ref_k, ref_tallies = reference
+    assert k.n == ref_k.n
+    assert k.s == ref_k.s
+    for tally_name, (s, s_sq) in tallies.items():
+        ref_s, ref_s_sq = ref_tallies[tally_name]
+        assert np.array_equal(s, ref_s), \
+            'Tally "{}" differs with regular UFS mesh'.format(tally_name)
+        assert np.array_equal(s_sq, ref_s_sq), \
+            'Tally "{}" differs with regular UFS mesh'.format(tally_name)
+
+
+def test_mesh_types():
+    model = slab_mg()
+
+    # Meshes for tallies and separate copies for UFS, since meshes in the
+    # settings and tallies must have different IDs
+    tally_meshes = make_meshes(1)
+    ufs_meshes = make_meshes(11)
+
+    for mesh in tally_meshes:
+        flux_tally = openmc.Tally(name=mesh.type + ' flux')
+        flux_tally.filters = [openmc.MeshFilter(mesh),
+                              openmc.EnergyFilter([0.0, 0.625, 20.0e6])]
+        flux_tally.scores = ['flux', 'fission']
+
+        current_tally = openmc.Tally(name=mesh.type + ' current')
+        current_tally.filters = [openmc.MeshSurfaceFilter(mesh)]
+        current_tally.scores = ['current']
+
+        model.tallies += [flux_tally, current_tally]
+
+    regular, rectilinear, cylindrical = ufs_meshes
+    model.settings.ufs_mesh = rectilinear
+
+    def results(sp):
+        check_meshes(sp, tally_meshes + (model.settings.ufs_mesh,))
+        return sp.k_combined, {t.name: (t.sum.copy(), t.sum_sq.copy())
+                               for t in sp.tallies.values()}
+
+    # Runs with UFS on each mesh are compared with the run with UFS on the
+    # rectilinear mesh in the model
+    variants = [(mesh.type, set_ufs_mesh(mesh))
+                for mesh in (cylindrical, regular, rectilinear)]
+    harness = ComparisonTestHarness('statepoint.10.h5', model, variants,
+                                    results=results, compare=compare_ufs,
+                                    mg_library={})
+    harness.main()
@@ -0,0 +1,36 @@
+import openmc
+
+from tests.testing_harness import ComparisonTestHarness, lattice_mg
+
+
+def set_neighbor_sweep(neighbor_sweep):
+    def setup(model):
+        model.settings.neighbor_sweep = neighbor_sweep
+    return setup
+
+
+def test_neighbor_sweep():
+    # Pins in assembly lattices in a core lattice, bounded by periodic
+    # x-planes and reflective y- and z-planes, which rays of the sweep cross
+    # many times
+    model = lattice_mg(periodic=True)
+    pin_cells = sorted((c for c in model.geometry.get_all_cells().values()
+                        if c.name in ('fuel', 'clad', 'water')),
+                       key=lambda c: c.id)
+
+    tallies = []
+    for estimator in ('tracklength', 'collision'):
+        t = openmc.Tally()
+        t.filters = [openmc.CellFilter(pin_cells)]
+        t.scores = ['flux', 'total', 'fission']
+        t.estimator = estimator
+        tallies.append(t)
+    model.tallies = tallies
+
+    # The sweep uses no random numbers, so results must be identical
+    variants = [('sweep', set_neighbor_sweep(200)),
+                ('no sweep', set_neighbor_sweep(0))]
+    harness = ComparisonTestHarness(
+        'statepoint.10.h5', model, variants,
+        mg_library={'absorption_scales': (1.0, 0.1, 0.02)})
+    harness.main()
@@ -0,0 +1,121 @@
+import os
+
+import h5py
+import openmc
+
+from tests.testing_harness import PyAPITestHarness
+from tests.regression_tests import config
+
+
+def make_model(overlap):
+    model = openmc.model.Model()
+
+    fuel = openmc.Material(1)
+    fuel.add_nuclide('U235', 1.0)
+    fuel.set_density('g/cc', 10.0)
+    water = openmc.Material(2)
+    water.add_nuclide('H1', 2.0)
+    water.add_nuclide('O16', 1.0)
+    water.set_density('g/cc', 1.0)
+    model.materials += [fuel, water]
+
+    # A pin cell universe. When overlap is requested, the fuel radius used in
+    # the moderator region is smaller than that of the fuel cell itself.
+    fuel_or = openmc.ZCylinder(R=0.4)
+    mod_ir = openmc.ZCylinder(R=0.3) if overlap else fuel_or
+    fuel_cell = openmc.Cell(10, fill=fuel, region=-fuel_or)
+    mod_cell = openmc.Cell(11, fill=water, region=+mod_ir)
+    pin = openmc.Universe(cells=[fuel_cell, mod_cell])
+
+    lattice = openmc.RectLattice()
+    lattice.lower_left = (-1.0, -1.0)
+    lattice.pitch = (1.0, 1.0)
+    lattice.universes = [[pin, pin], [pin, pin]]
+
+    # In the root universe, a water cell overlaps the corner of the lattice
+    # when overlap is requested
+    box = openmc.model.get_rectangular_prism(2.0, 2.0, boundary_type='vacuum')
+    zmin = openmc.ZPlane(z0=-1.0, boundary_type='vacuum')
+    zmax = openmc.ZPlane(z0=1.0, boundary_type='vacuum')
+    lattice_cell = openmc.Cell(1, fill=lattice, region=box & +zmin & -zmax)
+    if overlap:
+        corner = openmc.Sphere(x0=1.0, y0=1.0, R=0.5)
+        corner_cell = openmc.Cell(2, fill=water, region=-corner & box & +zmin
+                                  & -zmax)
+        root = openmc.Universe(cells=[lattice_cell, corner_cell])
+    else:
+        root = openmc.Universe(cells=[lattice_cell])
+    model.geometry = openmc.Geometry(root)
+
+    model.settings.run_mode = 'overlap check'
+    model.settings.seed = 1
+    model.settings.overlap_check = {
+        'samples': 10000,
+        'dimension': (20, 20, 4),
+        'refinement': 3
+    }
+    return model
+
+
+class OverlapCheckTestHarness(PyAPITestHarness):
+    def __init__(self, model, pairs):
+        super().__init__(None, model)
+        self._pairs = pairs
+
+    def _run_openmc(self):
+        openmc.check_overlaps(openmc_exec=config['exe'])
+
+    def _test_output_created(self):
+        assert os.path.exists('overlaps.h5'), 'Overlap file does not exist.'
+
+    def _get_results(self):
+        with h5py.File('overlaps.h5', 'r') as f:
+            universes = f['universes'][()]
+            cells = f['cells'][()]
+            counts = f['counts'][()]
+            points = f.attrs['points']
+            undefined = f.attrs['undefined_points']
+
+        # Check that exactly the expected pairs were found in each universe
+        # and that every pair was hit at least once
+        found = {(u, tuple(sorted(c))) for u, c in zip(universes, cells)}
+        assert found == self._pairs
+        assert all(counts > 0)
+        assert undefined == 0
+
+        outstr = 'points: {}\n'.format(points)
+        for u, c, n in zip(universes, cells, counts):
+            outstr += 'universe {}: cells {} {}: {}\n'.format(u, c[0], c[1], n)
+        return outstr
+
+    def _cleanup(self):
+        super()._cleanup()
+        if os.path.exists('overlaps.h5'):
+            os.remove('overlaps.h5')
+
+
+def test_overlap_check():
+    model = make_model(True)
+    pin_universe = [u for u in model.geometry.get_all_universes().values()
+                    if 10 in u.cells][0]
+    pairs = {(model.geometry.root_universe.id, (1, 2)),
+             (pin_universe.id, (10, 11))}
+    harness = OverlapCheckTestHarness(model, pairs)
+    harness.main()
+
+
+def test_no_overlaps():
+    model = make_model(False)
+    try:
+        model.export_to_xml()
+        openmc.check_overlaps(openmc_exec=config['exe'])
+        with h5py.File('overlaps.h5', 'r') as f:
+            assert f.attrs['points'] > 0
+            assert f.attrs['undefined_points'] == 0
+            assert f['cells'].shape[0] == 0
+            assert f['counts'].shape[0] == 0
+    finally:
+        for f in ('materials.xml', 'geometry.xml', 'settings.xml',
+                  'overlaps.h5'):
+            if os.path.exists(f):
+                os.remove(f)
@@ -0,0 +1,105 @@
+import os
+
+import h5py
+import numpy as np
+import openmc
+
+from tests.testing_harness import PyAPITestHarness
+from tests.regression_tests import config
+
+
+# Surfaces are placed so that voxel centers lie on them. Voxel plots are traced
+# as rays along z, so the z-plane is crossed by every ray while the x-plane and
+# cylinder are parallel to the rays that lie on them.
+X0 = 0.125
+Z0 = 0.375
+R = np.sqrt(0.375**2 + 0.125**2)
+
+
+def make_model():
+    model = openmc.model.Model()
+
+    mats = [openmc.Material() for _ in range(4)]
+    for m in mats:
+        m.add_nuclide('H1', 1.0)
+        m.set_density('g/cc', 1.0)
+    model.materials += mats
+
+    box = openmc.model.get_rectangular_prism(2.0, 2.0, boundary_type='vacuum')
+    zmin = openmc.ZPlane(z0=-1.0, boundary_type='vacuum')
+    zmax = openmc.ZPlane(z0=1.0, boundary_type='vacuum')
+    xplane = openmc.XPlane(x0=X0)
+    zplane = openmc.ZPlane(z0=Z0)
+    cyl = openmc.ZCylinder(R=R)
+    outer = box & +zmin & -zmax
+
+    cells = [
+        openmc.Cell(fill=mats[0], region=outer & -xplane & -zplane),
+        openmc.Cell(fill=mats[1], region=outer & +xplane & +cyl & -zplane),
+        openmc.Cell(fill=mats[2], region=outer & +xplane & -cyl & -zplane),
+        openmc.Cell(fill=mats[3], region=outer & +zplane)
+    ]
+    model.geometry = openmc.Geometry(openmc.Universe(cells=cells))
+
+    model.settings.run_mode = 'plot'
+    return model
+
+
+def make_plots():
+    plot = openmc.Plot()
+    plot.type = 'voxel'
+    plot.filename = 'voxels'
+    plot.origin = (0., 0., 0.)
+    plot.width = (2., 2., 2.)
+    plot.pixels = (8, 8, 8)
+    return openmc.Plots([plot])
+
+
+def expected_cells(cells):
+    """Cell IDs by voxel, with points on a surface placed in the cell that a
+    particle moving along +z is in."""
+    c = -1.0 + 0.25*(np.arange(8) + 0.5)
+    x, y, z = np.meshgrid(c, c, c, indexing='ij')
+    ids = np.empty(x.shape, dtype=int)
+    below = z < Z0
+    right = x > X0
+    inside = x**2 + y**2 <= R**2 + 1e-12
+    ids[:] = cells[3].id
+    ids[below & ~right] = cells[0].id
+    ids[below & right & ~inside] = cells[1].id
+    ids[below & right & inside] = cells[2].id
+    return ids
+
+
+class PlotSurfacesTestHarness(PyAPITestHarness):
+    def _build_inputs(self):
+        self._model.export_to_xml()
+        make_plots().export_to_xml()
+
+    def _run_openmc(self):
+        openmc.plot_geometry(openmc_exec=config['exe'])
+
+    def _test_output_created(self):
+        assert os.path.exists('voxels.h5'), 'Plot output file does not exist.'
+
+    def _get_results(self):
+        with h5py.File('voxels.h5', 'r') as f:
+            data = f['data'][()]
+        cells = list(self._model.geometry.root_universe.cells.values())
+        np.testing.assert_array_equal(data, expected_cells(cells))
+
+        outstr = ''
+        for cell in cells:
+            outstr += 'cell {}: {}\n'.format(cell.id,
+                                             np.count_nonzero(data == cell.id))
+        return outstr
+
+    def _cleanup(self):
+        super()._cleanup()
+        if os.path.exists('voxels.h5'):
+            os.remove('voxels.h5')
+
+
+def test_plot_surfaces():
+    harness = PlotSurfacesTestHarness(None, make_model())
+    harness.main()
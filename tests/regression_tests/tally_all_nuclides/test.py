@@ -0,0 +1,86 @@
+import glob
+
+import numpy as np
+import openmc
+
+from tests.testing_harness import PyAPITestHarness
+
+
+SCORES = ['total', 'scatter', 'absorption', 'fission', 'nu-fission',
+          '(n,gamma)']
+
+
+class AllNuclidesTestHarness(PyAPITestHarness):
+    """Compare tallies over all nuclides with the same tallies over an explicit
+    list of every nuclide. Since both are scored from the same histories, the
+    results must be identical."""
+
+    def _get_results(self):
+        statepoint = glob.glob(self._sp_name)[0]
+        outstr = ''
+        with openmc.StatePoint(statepoint) as sp:
+            for estimator in ('tracklength', 'collision'):
+                all_tally = sp.get_tally(name='all ' + estimator)
+                list_tally = sp.get_tally(name='list ' + estimator)
+                nuclides = list(all_tally.nuclides)
+                assert sorted(nuclides) == sorted(list_tally.nuclides)
+                for nuc in nuclides:
+                    for score in SCORES:
+                        all_values = all_tally.get_values(
+                            scores=[score], nuclides=[nuc])
+                        list_values = list_tally.get_values(
+                            scores=[score], nuclides=[nuc])
+                        assert np.array_equal(all_values, list_values), \
+                            '{} {} {} differs'.format(estimator, nuc, score)
+
+                outstr += '{}: {} nuclides, {} scores match\n'.format(
+                    estimator, len(nuclides), len(SCORES))
+        return outstr
+
+
+def test_tally_all_nuclides():
+    fuel = openmc.Material()
+    fuel.add_nuclide('U235', 0.05)
+    fuel.add_nuclide('Zr90', 0.5)
+    fuel.add_nuclide('O16', 1.0)
+    fuel.set_density('g/cm3', 6.0)
+    water = openmc.Material()
+    water.add_nuclide('H1', 2.0)
+    water.add_nuclide('O16', 1.0)
+    water.add_nuclide('B10', 1.0e-4)
+    water.set_density('g/cm3', 1.0)
+    steel = openmc.Material()
+    steel.add_nuclide('Fe56', 1.0)
+    steel.set_density('g/cm3', 7.9)
+    materials = openmc.Materials([fuel, water, steel])
+
+    r1 = openmc.Sphere(R=2.0)
+    r2 = openmc.Sphere(R=6.0)
+    r3 = openmc.Sphere(R=7.0, boundary_type='vacuum')
+    cells = [openmc.Cell(fill=fuel, region=-r1),
+             openmc.Cell(fill=water, region=+r1 & -r2),
+             openmc.Cell(fill=steel, region=+r2 & -r3)]
+    geometry = openmc.Geometry(openmc.Universe(cells=cells))
+
+    settings = openmc.Settings()
+    settings.run_mode = 'fixed source'
+    settings.batches = 5
+    settings.particles = 500
+    settings.source = openmc.Source(space=openmc.stats.Point())
+
+    cell_filter = openmc.CellFilter(cells)
+    energy_filter = openmc.EnergyFilter([0.0, 0.625, 20.0e6])
+    nuclides = ['U235', 'Zr90', 'O16', 'H1', 'B10', 'Fe56', 'total']
+    tallies = openmc.Tallies()
+    for estimator in ('tracklength', 'collision'):
+        for name, tally_nuclides in (('all', ['all']), ('list', nuclides)):
+            tally = openmc.Tally(name='{} {}'.format(name, estimator))
+            tally.filters = [cell_filter, energy_filter]
+            tally.nuclides = tally_nuclides
+            tally.scores = SCORES
+            tally.estimator = estimator
+            tallies.append(tally)
+
+    model = openmc.model.Model(geometry, materials, settings, tallies)
+    harness = AllNuclidesTestHarness('statepoint.5.h5', model)
+    harness.main()
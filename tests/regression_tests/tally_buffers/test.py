@@ -0,0 +1,64 @@
+import numpy as np
+import openmc
+from openmc.examples import slab_mg
+
+from tests.testing_harness import ComparisonTestHarness
+
+
+# Each case is run and compared with a run without tally buffers. With the
+# default memory limit the small tally gets a dense buffer and the mesh tally,
+# which is over the 2^16 bin limit for dense buffers, gets a hash table. A
+# small limit fills the hash table so that scores fall back to atomic updates,
+# and a zero limit sends every score to the shared results.
+CASES = [
+    {'enable': True},
+    {'enable': True, 'max_memory': 0.01},
+    {'enable': True, 'max_memory': 0.0},
+    {}
+]
+
+
+def set_tally_buffers(case):
+    def setup(model):
+        model.settings.tally_buffers = case
+    return setup
+
+
+def tally_means(sp):
+    return [(t.mean.copy(), t.std_dev.copy()) for t in sp.tallies.values()]
+
+
+def compare_means(case, results, reference):
+    # Buffered scores are added in a different order
+    for (mean, std_dev), (ref_mean, ref_std_dev) in zip(results, reference):
+        assert np.allclose(mean, ref_mean, rtol=1e-12, atol=0.0), \
+            'Tally means differ with tally buffers {}'.format(case)
+        assert np.allclose(std_dev, ref_std_dev, rtol=1e-8, atol=1e-14), \
+            'Tally uncertainties differ with tally buffers {}'.format(case)
+
+
+def test_tally_buffers():
+    model = slab_mg()
+
+    # A mesh tally with more bins than can be buffered densely
+    mesh = openmc.Mesh()
+    mesh.dimension = [400, 200, 1]
+    mesh.lower_left = [0.0, 0.0, 0.0]
+    mesh.upper_right = [929.45, 1000.0, 1000.0]
+    mesh_tally = openmc.Tally()
+    mesh_tally.filters = [openmc.MeshFilter(mesh)]
+    mesh_tally.scores = ['flux']
+
+    # A small tally that fits in a dense buffer
+    small_tally = openmc.Tally()
+    small_tally.filters = [openmc.MaterialFilter(model.materials),
+                           openmc.EnergyFilter([0.0, 0.625, 20.0e6])]
+    small_tally.scores = ['total', 'fission', 'scatter']
+
+    model.tallies = [mesh_tally, small_tally]
+
+    variants = [(case, set_tally_buffers(case)) for case in CASES]
+    harness = ComparisonTestHarness('statepoint.10.h5', model, variants,
+                                    results=tally_means, compare=compare_means,
+                                    mg_library={})
+    harness.main()
@@ -0,0 +1,118 @@
+import numpy as np
+import openmc
+from openmc.examples import slab_mg
+
+from tests.testing_harness import ComparisonTestHarness
+
+
+def set_tally_dispatch(tally_dispatch):
+    def setup(model):
+        model.settings.tally_dispatch = tally_dispatch
+    return setup
+
+
+def compare_dispatch(name, results, reference):
+    # Skipping tallies that cannot score does not change the order in which
+    # the others are scored, so results must be identical
+    for tally_id, (ref_s, ref_s_sq) in reference.items():
+        s, s_sq = results[tally_id]
+        assert np.any(s != 0.0), 'Tally {} has no scores'.format(tally_id)
+        assert np.array_equal(s, ref_s), \
+            'Tally {} differs with tally dispatch'.format(tally_id)
+        assert np.array_equal(s_sq, ref_s_sq), \
+            'Tally {} differs with tally dispatch'.format(tally_id)
+
+
+def test_tally_dispatch():
+    model = slab_mg(num_regions=3)
+    left, middle, right = sorted(model.geometry.root_universe.cells.values(),
+                                 key=lambda c: c.id)
+    mat_1, mat_2, mat_3 = sorted(model.materials, key=lambda m: m.id)
+
+    # Fill the middle cell with a universe of two cells, so that particles in
+    # it are in cells on two coordinate levels
+    x_mid = openmc.XPlane(x0=929.45/2)
+    inner_left = openmc.Cell(fill=mat_2, region=-x_mid)
+    inner_right = openmc.Cell(fill=mat_3, region=+x_mid)
+    middle.fill = openmc.Universe(cells=[inner_left, inner_right])
+
+    mesh = openmc.Mesh()
+    mesh.dimension = [6, 1, 1]
+    mesh.lower_left = [0.0, -1000.0, -1000.0]
+    mesh.upper_right = [929.45, 1000.0, 1000.0]
+
+    energies = [0.0, 0.625, 20.0e6]
+
+    # Tallies whose first filter is not a cell or material filter, tallies with
+    # several cell filters on one or more coordinate levels, tallies that are
+    # indexed by material, and tallies that can score anywhere, with each
+    # estimator
+    tallies = []
+    for estimator in ('analog', 'tracklength', 'collision'):
+        t = openmc.Tally()
+        t.filters = [openmc.EnergyFilter(energies),
+                     openmc.CellFilter([left, inner_right])]
+        t.scores = ['flux', 'total', 'fission']
+        t.estimator = estimator
+        tallies.append(t)
+
+        t = openmc.Tally()
+        t.filters = [openmc.MeshFilter(mesh),
+                     openmc.CellFilter([middle, right])]
+        t.scores = ['flux', 'absorption']
+        t.estimator = estimator
+        tallies.append(t)
+
+        t = openmc.Tally()
+        t.filters = [openmc.CellFilter([middle]),
+                     openmc.CellFilter([inner_left, inner_right]),
+                     openmc.EnergyFilter(energies)]
+        t.scores = ['flux', 'nu-fission']
+        t.estimator = estimator
+        tallies.append(t)
+
+        t = openmc.Tally()
+        t.filters = [openmc.CellFilter([inner_left, right]),
+                     openmc.CellFilter([left, middle])]
+        t.scores = ['flux', 'scatter']
+        t.estimator = estimator
+        tallies.append(t)
+
+        t = openmc.Tally()
+        t.filters = [openmc.MaterialFilter([mat_2, mat_3]),
+                     openmc.CellFilter([middle, right])]
+        t.scores = ['flux', 'total']
+        t.estimator = estimator
+        tallies.append(t)
+
+        t = openmc.Tally()
+        t.filters = [openmc.EnergyFilter(energies),
+                     openmc.MaterialFilter([mat_1])]
+        t.scores = ['flux']
+        t.estimator = estimator
+        tallies.append(t)
+
+        t = openmc.Tally()
+        t.scores = ['flux', 'absorption']
+        t.estimator = estimator
+        tallies.append(t)
+
+    # Scores that require an analog estimator
+    t = openmc.Tally()
+    t.filters = [openmc.CellFilter([inner_left]),
+                 openmc.EnergyoutFilter(energies),
+                 openmc.CellFilter([middle])]
+    t.scores = ['scatter', 'nu-fission']
+    tallies.append(t)
+
+    model.tallies = tallies
+
+    # Materials with different cross sections, so that results differ between
+    # cells and materials
+    mg_library = {'absorption_scales': (1.0, 0.8, 1.2)}
+    variants = [('dispatch off', set_tally_dispatch(False)),
+                ('dispatch on', set_tally_dispatch(True))]
+    harness = ComparisonTestHarness('statepoint.10.h5', model, variants,
+                                    compare=compare_dispatch,
+                                    mg_library=mg_library)
+    harness.main()
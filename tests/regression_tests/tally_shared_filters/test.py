@@ -0,0 +1,138 @@
+import copy
+from xml.etree import ElementTree as ET
+
+import numpy as np
+import openmc
+from openmc.examples import slab_mg
+
+from tests.testing_harness import ComparisonTestHarness
+
+
+class TallySharedFiltersTestHarness(ComparisonTestHarness):
+    def _build_inputs(self):
+        super()._build_inputs()
+
+        # The Python API writes equal filters only once, so give every tally
+        # its own copy of each of its filters. Equivalent copies then share
+        # their matches when tallies are scored.
+        tree = ET.parse('tallies.xml')
+        root = tree.getroot()
+        filters = {elem.get('id'): elem for elem in root.findall('filter')}
+        for elem in filters.values():
+            root.remove(elem)
+        position = len(root.findall('mesh'))
+        next_id = 1
+        for tally in root.findall('tally'):
+            filters_elem = tally.find('filters')
+            ids = []
+            for filter_id in filters_elem.text.split():
+                elem = copy.deepcopy(filters[filter_id])
+                elem.set('id', str(next_id))
+                root.insert(position, elem)
+                position += 1
+                ids.append(str(next_id))
+                next_id += 1
+            filters_elem.text = ' '.join(ids)
+        tree.write('tallies.xml')
+
+
+def compare_alone(name, results, reference):
+    for tally_id, (s, s_sq) in results.items():
+        ref_s, ref_s_sq = reference[tally_id]
+        assert np.array_equal(s, ref_s), \
+            'Tally {} differs with shared filters'.format(tally_id)
+        assert np.array_equal(s_sq, ref_s_sq), \
+            'Tally {} differs with shared filters'.format(tally_id)
+
+
+def set_tallies(tallies):
+    def setup(model):
+        model.tallies = tallies
+    return setup
+
+
+def test_tally_shared_filters():
+    model = slab_mg()
+    cell = model.geometry.root_universe.cells[
+        min(model.geometry.root_universe.cells)]
+
+    mesh = openmc.Mesh()
+    mesh.dimension = [10, 1, 1]
+    mesh.lower_left = [0.0, -1000.0, -1000.0]
+    mesh.upper_right = [1000.0, 1000.0, 1000.0]
+
+    energies = [0.0, 0.625, 20.0e6]
+    fine_energies = [0.0, 0.1, 0.625, 1.0e3, 1.0e6, 20.0e6]
+
+    # Tallies whose filters are copies of those of other tallies, in various
+    # orders and with various estimators, as well as filters of different
+    # types with the same bins, which are not shared
+    tallies = []
+    t = openmc.Tally()
+    t.filters = [openmc.EnergyFilter(energies), openmc.CellFilter([cell])]
+    t.scores = ['flux', 'total', 'fission']
+    tallies.append(t)
+
+    t = openmc.Tally()
+    t.filters = [openmc.CellFilter([cell]), openmc.EnergyFilter(energies)]
+    t.scores = ['flux', 'absorption']
+    t.estimator = 'collision'
+    tallies.append(t)
+
+    t = openmc.Tally()
+    t.filters = [openmc.EnergyFilter(energies), openmc.MeshFilter(mesh)]
+    t.scores = ['flux', 'nu-fission']
+    tallies.append(t)
+
+    t = openmc.Tally()
+    t.filters = [openmc.MeshFilter(mesh), openmc.EnergyFilter(fine_energies)]
+    t.scores = ['flux']
+    tallies.append(t)
+
+    t = openmc.Tally()
+    t.filters = [openmc.EnergyFilter(energies),
+                 openmc.EnergyoutFilter(energies),
+                 openmc.LegendreFilter(2)]
+    t.scores = ['scatter', 'nu-fission']
+    tallies.append(t)
+
+    t = openmc.Tally()
+    t.filters = [openmc.EnergyoutFilter(energies), openmc.LegendreFilter(2)]
+    t.scores = ['scatter']
+    tallies.append(t)
+
+    t = openmc.Tally()
+    t.filters = [openmc.MeshSurfaceFilter(mesh)]
+    t.scores = ['current']
+    tallies.append(t)
+
+    t = openmc.Tally()
+    t.filters = [openmc.MeshSurfaceFilter(mesh),
+                 openmc.EnergyFilter(energies)]
+    t.scores = ['current']
+    tallies.append(t)
+
+    t = openmc.Tally()
+    t.filters = [openmc.PolarFilter([0.0, 0.5, 1.0, np.pi]),
+                 openmc.EnergyFilter(fine_energies)]
+    t.scores = ['flux']
+    tallies.append(t)
+
+    t = openmc.Tally()
+    t.filters = [openmc.MuFilter([-1.0, 0.0, 1.0]),
+                 openmc.EnergyFilter(fine_energies)]
+    t.scores = ['scatter']
+    tallies.append(t)
+
+    model.tallies = tallies
+
+    # Tallies do not change the random number sequence, so each tally run
+    # alone, with no other filters to share matches with, gives the results
+    # it must have in the run with every tally
+    variants = [('tally {} alone'.format(t.id), set_tallies([t]))
+                for t in tallies]
+    variants.append(('all tallies', set_tallies(tallies)))
+    harness = TallySharedFiltersTestHarness(
+        'statepoint.10.h5', model, variants, compare=compare_alone,
+        mg_library={'order': 1})
+    harness.main()
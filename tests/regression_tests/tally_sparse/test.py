@@ -0,0 +1,74 @@
+import numpy as np
+import openmc
+from openmc.examples import slab_mg
+
+from tests.testing_harness import ComparisonTestHarness
+
+
+def set_storage(storage, restart_file=None):
+    def setup(model):
+        for tally in model.tallies:
+            tally.storage = storage
+        if restart_file is not None:
+            return {'restart_file': restart_file}
+    return setup
+
+
+def tally_sums_and_output(sp):
+    results = [(t.num_realizations, t.sum.copy(), t.sum_sq.copy())
+               for t in sp.tallies.values()]
+    with open('tallies.out') as fh:
+        return results, fh.read()
+
+
+def compare_storage(case, results, reference):
+    results, tallies_out = results
+    ref_results, ref_tallies_out = reference
+    for (n, s, s_sq), (ref_n, ref_s, ref_s_sq) in zip(results, ref_results):
+        assert n == ref_n, \
+            'Number of realizations differs for {}'.format(case)
+        assert np.array_equal(s, ref_s), \
+            'Tally sums differ for {} storage'.format(case)
+        assert np.array_equal(s_sq, ref_s_sq), \
+            'Tally sums of squares differ for {}'.format(case)
+    assert tallies_out == ref_tallies_out, \
+        'tallies.out differs for {}'.format(case)
+
+
+def test_tally_sparse():
+    model = slab_mg()
+    model.settings.statepoint = {'batches': [8, 13]}
+    model.settings.trigger_active = True
+    model.settings.trigger_max_batches = 13
+
+    # A mesh tally that extends well beyond where particles go, so that most of
+    # its bins are never scored to. The trigger cannot be satisfied, so it is
+    # checked on the scored bins of sparse tallies every batch up to the
+    # maximum.
+    mesh = openmc.Mesh()
+    mesh.dimension = [40, 50, 50]
+    mesh.lower_left = [-500.0, -5000.0, -5000.0]
+    mesh.upper_right = [1500.0, 5000.0, 5000.0]
+    mesh_tally = openmc.Tally()
+    mesh_tally.filters = [openmc.MeshFilter(mesh),
+                          openmc.EnergyFilter([0.0, 0.625, 20.0e6])]
+    mesh_tally.scores = ['flux', 'fission']
+    mesh_tally.triggers = [openmc.Trigger('std_dev', 1.0e-8)]
+    mesh_tally.triggers[0].scores = ['flux']
+
+    # A small tally in which every bin is scored to
+    small_tally = openmc.Tally()
+    small_tally.filters = [openmc.EnergyFilter([0.0, 0.625, 20.0e6])]
+    small_tally.scores = ['total', 'fission', 'scatter']
+
+    model.tallies = [mesh_tally, small_tally]
+
+    # Sparse storage is run both straight through and restarted from an
+    # intermediate statepoint, and compared with dense storage
+    variants = [('sparse', set_storage('sparse')),
+                ('restarted', set_storage('sparse', 'statepoint.08.h5')),
+                ('dense', set_storage('dense'))]
+    harness = ComparisonTestHarness('statepoint.13.h5', model, variants,
+                                    results=tally_sums_and_output,
+                                    compare=compare_storage, mg_library={})
+    harness.main()
@@ -0,0 +1,91 @@
+import glob
+import os
+
+import numpy as np
+import openmc
+
+from tests.testing_harness import PyAPITestHarness
+
+
+# Known volumes of the domains in the model below
+SPHERE = 4./3.*np.pi
+CYLINDER = np.pi*0.5**2*4.0
+BOX = 4.0**3
+
+
+class VolumeRayTest(PyAPITestHarness):
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+
+        fuel = openmc.Material(1)
+        fuel.add_nuclide('U235', 1.0e-3)
+        fuel.set_density('atom/b-cm', 1.0e-3)
+        water = openmc.Material(2)
+        water.add_nuclide('H1', 2.0e-2)
+        water.add_nuclide('O16', 1.0e-2)
+        water.set_density('atom/b-cm', 3.0e-2)
+        self._model.materials = openmc.Materials([fuel, water])
+
+        # A sphere and a cylinder, which do not intersect, inside a box
+        sphere = openmc.Sphere(R=1.0)
+        cyl = openmc.ZCylinder(x0=1.4, y0=1.4, R=0.5)
+        box = openmc.model.get_rectangular_prism(4.0, 4.0,
+                                                 boundary_type='vacuum')
+        zmin = openmc.ZPlane(z0=-2.0, boundary_type='vacuum')
+        zmax = openmc.ZPlane(z0=2.0, boundary_type='vacuum')
+        inside = box & +zmin & -zmax
+        sphere_cell = openmc.Cell(1, fill=fuel, region=-sphere)
+        cyl_cell = openmc.Cell(2, fill=fuel, region=-cyl & inside)
+        outer_cell = openmc.Cell(3, fill=water, region=+sphere & +cyl & inside)
+        root = openmc.Universe(0, cells=[sphere_cell, cyl_cell, outer_cell])
+        self._model.geometry = openmc.Geometry(root)
+
+        ll, ur = (-2., -2., -2.), (2., 2., 2.)
+        vol_calcs = [
+            openmc.VolumeCalculation([sphere_cell, cyl_cell, outer_cell],
+                                     20000, ll, ur),
+            openmc.VolumeCalculation([fuel, water], 20000, ll, ur),
+            openmc.VolumeCalculation([root], 20000, ll, ur)
+        ]
+        for vol_calc in vol_calcs:
+            vol_calc.estimator = 'ray'
+
+        self._model.settings.run_mode = 'volume'
+        self._model.settings.volume_calculations = vol_calcs
+
+        self._expected = [
+            {1: SPHERE, 2: CYLINDER, 3: BOX - SPHERE - CYLINDER},
+            {1: SPHERE + CYLINDER, 2: BOX - SPHERE - CYLINDER},
+            {0: BOX}
+        ]
+
+    def _get_results(self):
+        outstr = ''
+        filenames = sorted(glob.glob('volume_*.h5'))
+        assert len(filenames) == len(self._expected)
+        for i, (filename, expected) in enumerate(zip(filenames,
+                                                     self._expected)):
+            outstr += 'Volume calculation {}\n'.format(i)
+            volume_calc = openmc.VolumeCalculation.from_hdf5(filename)
+            assert volume_calc.estimator == 'ray'
+
+            # Each estimate must agree with the known volume
+            for uid, volume in sorted(volume_calc.volumes.items()):
+                assert abs(volume.n - expected[uid]) <= 4*volume.s + 1e-10
+                outstr += 'Domain {}: {:.8e} +/- {:.8e} cm^3\n'.format(
+                    uid, volume.n, volume.s)
+
+        return outstr
+
+    def _test_output_created(self):
+        pass
+
+    def _cleanup(self):
+        super()._cleanup()
+        for f in glob.glob('volume_*.h5'):
+            os.remove(f)
+
+
+def test_volume_calc_ray():
+    harness = VolumeRayTest('')
+    harness.main()
@@ -0,0 +1,105 @@
+import glob
+import os
+
+import numpy as np
+import openmc
+
+from tests.testing_harness import PyAPITestHarness
+
+
+class VolumeTriggerTest(PyAPITestHarness):
+    def __init__(self, *args, **kwargs):
+        super().__init__(*args, **kwargs)
+
+        water = openmc.Material(1)
+        water.add_nuclide('H1', 2.0e-2)
+        water.add_nuclide('O16', 1.0e-2)
+        water.set_density('atom/b-cm', 3.0e-2)
+        self._model.materials = openmc.Materials([water])
+
+        # A small sphere and a large shell around it inside a box
+        inner = openmc.Sphere(R=0.5)
+        outer = openmc.Sphere(R=1.5)
+        box = openmc.model.get_rectangular_prism(4.0, 4.0,
+                                                 boundary_type='vacuum')
+        zmin = openmc.ZPlane(z0=-2.0, boundary_type='vacuum')
+        zmax = openmc.ZPlane(z0=2.0, boundary_type='vacuum')
+        cells = [
+            openmc.Cell(1, fill=water, region=-inner),
+            openmc.Cell(2, fill=water, region=+inner & -outer),
+            openmc.Cell(3, fill=water, region=+outer & box & +zmin & -zmax)
+        ]
+        root = openmc.Universe(0, cells=cells)
+        self._model.geometry = openmc.Geometry(root)
+
+        # The samples in one iteration are far too few to meet either trigger,
+        # so the calculations must be repeated
+        ll, ur = (-2., -2., -2.), (2., 2., 2.)
+        hit = openmc.VolumeCalculation(cells, 1000, ll, ur)
+        hit.set_trigger(0.05, 'rel_err')
+        ray = openmc.VolumeCalculation(cells, 100, ll, ur)
+        ray.estimator = 'ray'
+        ray.set_trigger([0.02, 0.1, 0.1], 'std_dev')
+
+        # The outer cell lies outside a bounding box around the small sphere,
+        # so it is never hit and is left out of the relative error trigger
+        outside = openmc.VolumeCalculation([cells[0], cells[2]], 1000,
+                                           (-0.6, -0.6, -0.6),
+                                           (0.6, 0.6, 0.6))
+        outside.set_trigger(0.01, 'rel_err')
+
+        # A trigger that cannot be met stops at the maximum iterations
+        capped = openmc.VolumeCalculation(cells, 100, ll, ur)
+        capped.set_trigger(1.0e-6, 'std_dev', max_iterations=3)
+        self._vol_calcs = [hit, ray, outside, capped]
+
+        self._model.settings.run_mode = 'volume'
+        self._model.settings.volume_calculations = self._vol_calcs
+
+    def _get_results(self):
+        outstr = ''
+        filenames = sorted(glob.glob('volume_*.h5'))
+        assert len(filenames) == len(self._vol_calcs)
+        for i, (filename, vol_in) in enumerate(zip(filenames,
+                                                   self._vol_calcs)):
+            vol = openmc.VolumeCalculation.from_hdf5(filename)
+            assert vol.iterations > 1
+            assert vol.trigger_type == vol_in.trigger_type
+            assert np.all(vol.threshold == vol_in.threshold)
+            if vol_in.max_iterations is not None:
+                assert vol.max_iterations == vol_in.max_iterations
+                assert vol.iterations == vol.max_iterations
+            else:
+                assert vol.iterations < vol.max_iterations
+
+                # Every domain must meet its threshold, other than domains
+                # that are never hit under a relative error trigger
+                thresholds = np.broadcast_to(vol.threshold, len(vol.ids))
+                for uid, threshold in zip(vol.ids, thresholds):
+                    volume = vol.volumes[uid]
+                    if vol.trigger_type == 'rel_err':
+                        assert volume.n == 0.0 or \
+                            volume.s/volume.n < threshold
+                    else:
+                        assert volume.s < threshold
+
+            outstr += 'Volume calculation {}: {} iterations\n'.format(
+                i, vol.iterations)
+            for uid, volume in sorted(vol.volumes.items()):
+                outstr += 'Domain {}: {:.8e} +/- {:.8e} cm^3\n'.format(
+                    uid, volume.n, volume.s)
+
+        return outstr
+
+    def _test_output_created(self):
+        pass
+
+    def _cleanup(self):
+        super()._cleanup()
+        for f in glob.glob('volume_*.h5'):
+            os.remove(f)
+
+
+def test_volume_calc_trigger():
+    harness = VolumeTriggerTest('')
+    harness.main()
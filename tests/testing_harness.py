@@ -9,7 +9,7 @@ import sys
 
 import numpy as np
 import openmc
-from openmc.examples import pwr_core
+from openmc.examples import pwr_core, slab_mg
 
 from tests.regression_tests import config
 
@@ -344,3 +344,175 @@ class HashedPyAPITestHarness(PyAPITestHarness):
     def _get_results(self):
         """Digest info in the statepoint and return as a string."""
         return super()._get_results(True)
+
+
+class ComparisonTestHarness(HashedPyAPITestHarness):
+    """Specialized HashedPyAPITestHarness that runs a model several times with
+    different options and compares the results of each run with those of the
+    last run. The statepoint of the last run is the one that is hashed.
+
+    Parameters
+    ----------
+    statepoint_name : str
+        Name of the statepoint file that results are read from
+    model : openmc.model.Model
+        Model to run
+    variants : list of tuple
+        Pairs of a name and a function that modifies the model before a run.
+        The function may return a dictionary of extra arguments to
+        openmc.run(). The last variant gives the reference results.
+    results : callable, optional
+        Function that is given the statepoint of a run and returns its
+        results. Defaults to the sum and sum of squares of each tally, by ID.
+    compare : callable, optional
+        Function that is given the name of a variant, its results and the
+        reference results and asserts that they agree. Defaults to requiring
+        identical results for each tally.
+    mg_library : dict, optional
+        Keyword arguments to create_mg_library() for a multi-group library
+        that is written before the runs and removed afterwards
+
+    """
+
+    def __init__(self, statepoint_name, model, variants, results=None,
+                 compare=None, mg_library=None):
+        super().__init__(statepoint_name, model)
+        self._variants = variants
+        self._results = results if results is not None else tally_sums
+        self._compare = compare if compare is not None else compare_tally_sums
+        self._mg_library = mg_library
+
+    def _build_inputs(self):
+        if self._mg_library is not None:
+            create_mg_library(**self._mg_library)
+        super()._build_inputs()
+
+    def _run_variant(self, setup):
+        run_args = setup(self._model) or {}
+        self._build_inputs()
+
+        args = {'openmc_exec': config['exe']}
+        if config['mpi']:
+            args['mpi_args'] = [config['mpiexec'], '-n', config['mpi_np']]
+        args.update(run_args)
+        openmc.run(**args)
+
+        with openmc.StatePoint(self._sp_name) as sp:
+            return self._results(sp)
+
+    def _run_openmc(self):
+        results = [(name, self._run_variant(setup))
+                   for name, setup in self._variants]
+        reference = results[-1][1]
+        for name, variant_results in results[:-1]:
+            self._compare(name, variant_results, reference)
+
+    def _cleanup(self):
+        super()._cleanup()
+        if self._mg_library is not None:
+            f = self._mg_library.get('filename', '2g.h5')
+            if os.path.exists(f):
+                os.remove(f)
+
+
+def tally_sums(sp):
+    """Return the sum and sum of squares of each tally in a statepoint."""
+    return {t.id: (t.sum.copy(), t.sum_sq.copy()) for t in sp.tallies.values()}
+
+
+def compare_tally_sums(name, results, reference):
+    """Assert that tally sums from tally_sums() are identical."""
+    for tally_id, (ref_s, ref_s_sq) in reference.items():
+        s, s_sq = results[tally_id]
+        assert np.array_equal(s, ref_s), \
+            'Tally {} sums differ for {}'.format(tally_id, name)
+        assert np.array_equal(s_sq, ref_s_sq), \
+            'Tally {} sums of squares differ for {}'.format(tally_id, name)
+
+
+def create_mg_library(filename='2g.h5', order=0, absorption_scales=(1.0,)):
+    """Write a two-group library with a material for each absorption scale.
+
+    The materials are named mat_1, mat_2, ..., as in
+    openmc.examples.slab_mg(). Only the fission and absorption cross sections
+    are scaled.
+
+    """
+    groups = openmc.mgxs.EnergyGroups(group_edges=[0.0, 0.625, 20.0e6])
+    mg_cross_sections_file = openmc.MGXSLibrary(groups)
+
+    fission = np.array([0.002817, 0.097])
+    absorption = np.array([0.011525, 0.12218])
+    total = np.array([0.33588, 0.54628])
+    if order == 0:
+        scatter = [[[0.31980], [0.004555]],
+                   [[0.00000], [0.424100]]]
+    else:
+        scatter = [[[0.31980, 0.06694], [0.004555, -0.0003972]],
+                   [[0.00000, 0.00000], [0.424100, 0.05439000]]]
+
+    for i, scale in enumerate(absorption_scales):
+        mat = openmc.XSdata('mat_{}'.format(i + 1), groups)
+        mat.order = order
+        mat.set_fission(scale*fission)
+        mat.set_nu_fission(2.5*scale*fission)
+        mat.set_absorption(scale*absorption)
+        mat.set_scatter_matrix(scatter)
+        mat.set_total(total + (scale - 1.0)*absorption)
+        mat.set_chi([1., 0.])
+        mg_cross_sections_file.add_xsdata(mat)
+    mg_cross_sections_file.export_to_hdf5(filename)
+
+
+def lattice_mg(num_materials=3, periodic=False):
+    """Return a multi-group model of a 2x2 lattice of 3x3 pin lattices.
+
+    Each pin has a fuel, clad and water cell filled with mat_1, mat_2 and
+    mat_3 of create_mg_library(), and the centre of each assembly is a water
+    universe. Materials beyond the first three are only added to the model's
+    materials. The outer boundaries are reflective, except for the x-planes,
+    which are periodic if periodic is True.
+
+    """
+    model = slab_mg(num_regions=num_materials)
+    fuel, clad, water = sorted(model.materials, key=lambda m: m.id)[:3]
+
+    fuel_or = openmc.ZCylinder(R=0.4)
+    clad_or = openmc.ZCylinder(R=0.5)
+    pin = openmc.Universe(cells=[
+        openmc.Cell(name='fuel', fill=fuel, region=-fuel_or),
+        openmc.Cell(name='clad', fill=clad, region=+fuel_or & -clad_or),
+        openmc.Cell(name='water', fill=water, region=+clad_or)])
+    water_only = openmc.Universe(cells=[openmc.Cell(fill=water)])
+
+    assembly_lattice = openmc.RectLattice()
+    assembly_lattice.lower_left = (-1.89, -1.89)
+    assembly_lattice.pitch = (1.26, 1.26)
+    assembly_lattice.universes = [[pin, pin, pin],
+                                  [pin, water_only, pin],
+                                  [pin, pin, pin]]
+    assembly_lattice.outer = water_only
+    assembly = openmc.Universe(cells=[openmc.Cell(fill=assembly_lattice)])
+
+    core_lattice = openmc.RectLattice()
+    core_lattice.lower_left = (-3.78, -3.78)
+    core_lattice.pitch = (3.78, 3.78)
+    core_lattice.universes = [[assembly, assembly],
+                              [assembly, assembly]]
+
+    x_type = 'periodic' if periodic else 'reflective'
+    x_min = openmc.XPlane(x0=-3.78, boundary_type=x_type)
+    x_max = openmc.XPlane(x0=3.78, boundary_type=x_type)
+    if periodic:
+        x_max.periodic_surface = x_min
+    y_min = openmc.YPlane(y0=-3.78, boundary_type='reflective')
+    y_max = openmc.YPlane(y0=3.78, boundary_type='reflective')
+    z_min = openmc.ZPlane(z0=-10.0, boundary_type='reflective')
+    z_max = openmc.ZPlane(z0=10.0, boundary_type='reflective')
+    root_cell = openmc.Cell(fill=core_lattice, region=+x_min & -x_max &
+                            +y_min & -y_max & +z_min & -z_max)
+    model.geometry = openmc.Geometry(openmc.Universe(cells=[root_cell]))
+
+    model.settings.source = openmc.Source(space=openmc.stats.Box(
+        [-3.78, -3.78, -10.0], [3.78, 3.78, 10.0]))
+    return model
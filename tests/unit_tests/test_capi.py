@@ -358,6 +358,56 @@ def test_mesh(capi_init):
     assert msf.mesh == mesh
 
 
+def test_rectilinear_mesh(capi_init):
+    mesh = openmc.capi.RectilinearMesh()
+    assert mesh.type == 'rectilinear'
+    x_grid = [-10., 0., 1., 10.]
+    y_grid = [0., 5.]
+    z_grid = [-2., 0., 2., 7., 20.]
+    mesh.set_grid(x_grid, y_grid, z_grid)
+    assert mesh.x_grid == pytest.approx(x_grid)
+    assert mesh.y_grid == pytest.approx(y_grid)
+    assert mesh.z_grid == pytest.approx(z_grid)
+    assert mesh.dimension == (3, 1, 4)
+
+    with pytest.raises(exc.InvalidArgumentError):
+        mesh.set_grid([0., 0.], y_grid, z_grid)
+
+    meshes = openmc.capi.meshes
+    assert isinstance(meshes[mesh.id], openmc.capi.RectilinearMesh)
+    assert openmc.capi.Mesh().type == 'regular'
+
+    mf = openmc.capi.MeshFilter(mesh)
+    assert mf.mesh == mesh
+    assert isinstance(mf.mesh, openmc.capi.RectilinearMesh)
+
+
+def test_cylindrical_mesh(capi_init):
+    mesh = openmc.capi.CylindricalMesh()
+    assert mesh.type == 'cylindrical'
+    r_grid = [0., 0.2, 0.4, 0.63]
+    phi_grid = [0., np.pi/2, np.pi]
+    z_grid = [-1., 1.]
+    mesh.set_grid(r_grid, phi_grid, z_grid, origin=(0.1, 0., 0.))
+    assert mesh.r_grid == pytest.approx(r_grid)
+    assert mesh.phi_grid == pytest.approx(phi_grid)
+    assert mesh.z_grid == pytest.approx(z_grid)
+    assert mesh.origin == pytest.approx((0.1, 0., 0.))
+    assert mesh.dimension == (3, 2, 1)
+
+    with pytest.raises(exc.InvalidArgumentError):
+        mesh.set_grid([-1., 1.], phi_grid, z_grid)
+    with pytest.raises(exc.InvalidArgumentError):
+        mesh.set_grid(r_grid, [0., 7.], z_grid)
+
+    meshes = openmc.capi.meshes
+    assert isinstance(meshes[mesh.id], openmc.capi.CylindricalMesh)
+
+    msf = openmc.capi.MeshSurfaceFilter(mesh)
+    assert msf.mesh == mesh
+    assert isinstance(msf.mesh, openmc.capi.CylindricalMesh)
+
+
 def test_restart(capi_init):
     # Finalize and re-init to make internal state consistent with XML.
     openmc.capi.hard_reset()
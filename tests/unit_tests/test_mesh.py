@@ -0,0 +1,81 @@
+import numpy as np
+import openmc
+import pytest
+
+
+def test_regular_mesh_xml():
+    mesh = openmc.Mesh(mesh_id=10)
+    mesh.dimension = [2, 3, 4]
+    mesh.lower_left = [-1.0, -2.0, -3.0]
+    mesh.upper_right = [1.0, 2.0, 3.0]
+
+    new_mesh = openmc.Mesh.from_xml_element(mesh.to_xml_element())
+    assert new_mesh.id == 10
+    assert new_mesh.type == 'regular'
+    assert list(new_mesh.dimension) == [2, 3, 4]
+    assert new_mesh.lower_left == pytest.approx(mesh.lower_left)
+    assert new_mesh.upper_right == pytest.approx(mesh.upper_right)
+    assert new_mesh.width is None
+
+
+def test_rectilinear_mesh_xml():
+    mesh = openmc.Mesh(mesh_id=11)
+    mesh.type = 'rectilinear'
+    mesh.x_grid = [-10.0, 0.0, 1.0, 10.0]
+    mesh.y_grid = [0.0, 5.0]
+    mesh.z_grid = np.linspace(-2.0, 7.0, 5)
+    assert mesh.dimension == (3, 1, 4)
+    assert mesh.num_mesh_cells == 12
+
+    elem = mesh.to_xml_element()
+    assert elem.get('type') == 'rectilinear'
+    assert elem.find('dimension') is None
+
+    new_mesh = openmc.Mesh.from_xml_element(elem)
+    assert new_mesh.id == 11
+    assert new_mesh.type == 'rectilinear'
+    assert new_mesh.dimension == (3, 1, 4)
+    for name in ('x_grid', 'y_grid', 'z_grid'):
+        assert getattr(new_mesh, name) == pytest.approx(getattr(mesh, name))
+    assert len(list(new_mesh.indices)) == 12
+
+
+def test_cylindrical_mesh_xml():
+    mesh = openmc.Mesh(mesh_id=12)
+    mesh.type = 'cylindrical'
+    mesh.r_grid = [0.0, 0.5, 1.5, 3.0]
+    mesh.phi_grid = [0.0, np.pi/2, np.pi, 2*np.pi]
+    mesh.z_grid = [-5.0, 5.0]
+    mesh.origin = [1.0, -1.0, 0.0]
+    assert mesh.dimension == (3, 3, 1)
+
+    new_mesh = openmc.Mesh.from_xml_element(mesh.to_xml_element())
+    assert new_mesh.id == 12
+    assert new_mesh.type == 'cylindrical'
+    assert new_mesh.dimension == (3, 3, 1)
+    for name in ('r_grid', 'phi_grid', 'z_grid', 'origin'):
+        assert getattr(new_mesh, name) == pytest.approx(getattr(mesh, name))
+
+    # Without azimuthal surfaces, the mesh covers every angle with one element
+    mesh = openmc.Mesh(mesh_id=13)
+    mesh.type = 'cylindrical'
+    mesh.r_grid = [0.0, 1.0]
+    mesh.z_grid = [0.0, 1.0, 2.0]
+    assert mesh.dimension == (1, 1, 2)
+
+    elem = mesh.to_xml_element()
+    assert elem.find('phi_grid') is None
+    assert elem.find('origin') is None
+    new_mesh = openmc.Mesh.from_xml_element(elem)
+    assert new_mesh.phi_grid is None
+    assert new_mesh.origin is None
+    assert new_mesh.dimension == (1, 1, 2)
+
+
+def test_mesh_grid_check():
+    mesh = openmc.Mesh()
+    mesh.type = 'rectilinear'
+    with pytest.raises(ValueError):
+        mesh.x_grid = [0.0]
+    with pytest.raises(ValueError):
+        mesh.type = 'spherical'
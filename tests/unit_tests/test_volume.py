@@ -0,0 +1,90 @@
+import xml.etree.ElementTree as ET
+
+import h5py
+import numpy as np
+import openmc
+import pytest
+
+
+@pytest.fixture
+def volume_calc():
+    cells = [openmc.Cell(), openmc.Cell()]
+    vol = openmc.VolumeCalculation(cells, 10000, (-1., -2., -3.),
+                                   (1., 2., 3.))
+    vol.estimator = 'ray'
+    vol.set_trigger([0.01, 0.02], 'rel_err')
+    return vol
+
+
+def write_volume_file(filename, vol, iterations):
+    """Write a volume file in the format produced by OpenMC."""
+    with h5py.File(filename, 'w') as f:
+        f.attrs['filetype'] = np.string_('volume')
+        f.attrs['version'] = [1, 1]
+        f.attrs['domain_type'] = np.string_(vol.domain_type)
+        f.attrs['samples'] = vol.samples
+        f.attrs['lower_left'] = vol.lower_left
+        f.attrs['upper_right'] = vol.upper_right
+        f.attrs['estimator'] = np.string_(vol.estimator)
+        f.attrs['iterations'] = iterations
+        f.attrs['threshold'] = vol.threshold
+        f.attrs['trigger_type'] = np.string_(vol.trigger_type)
+        for i, uid in enumerate(vol.ids):
+            group = f.create_group('domain_{}'.format(uid))
+            group.create_dataset('volume', data=[1.0 + i, 0.01])
+            group.create_dataset('nuclides', data=[np.string_('H1')])
+            group.create_dataset('atoms', data=[[1.0e24, 1.0e22]])
+
+
+def test_export_to_xml(volume_calc):
+    elem = volume_calc.to_xml_element()
+    assert elem.find('domain_type').text == 'cell'
+    assert elem.find('samples').text == '10000'
+    assert elem.find('estimator').text == 'ray'
+    trigger = elem.find('threshold')
+    assert trigger.get('type') == 'rel_err'
+    assert [float(x) for x in trigger.get('threshold').split()] == \
+        [0.01, 0.02]
+
+    # A single threshold applies to every domain
+    volume_calc.set_trigger(1.0e-3, 'std_dev')
+    elem = volume_calc.to_xml_element()
+    assert elem.find('threshold').get('type') == 'std_dev'
+    assert float(elem.find('threshold').get('threshold')) == 1.0e-3
+
+    # The hit estimator is the default and is not written
+    volume_calc.estimator = 'hit'
+    assert volume_calc.to_xml_element().find('estimator') is None
+
+
+def test_from_hdf5(run_in_tmpdir, volume_calc):
+    write_volume_file('volume_1.h5', volume_calc, 7)
+    vol = openmc.VolumeCalculation.from_hdf5('volume_1.h5')
+
+    assert vol.ids == volume_calc.ids
+    assert vol.domain_type == 'cell'
+    assert vol.samples == 10000
+    assert vol.estimator == 'ray'
+    assert vol.iterations == 7
+    assert vol.trigger_type == 'rel_err'
+    assert np.all(vol.threshold == [0.01, 0.02])
+    for i, uid in enumerate(vol.ids):
+        assert vol.volumes[uid].n == 1.0 + i
+        assert vol.atoms[uid]['H1'].n == 1.0e24
+
+    # Loading the results again gives back the same XML input
+    assert ET.tostring(vol.to_xml_element()) == \
+        ET.tostring(volume_calc.to_xml_element())
+
+    # Results can also be loaded into an existing calculation
+    volume_calc.load_results('volume_1.h5')
+    assert volume_calc.iterations == 7
+    assert volume_calc.volumes[volume_calc.ids[1]].n == 2.0
+
+
+def test_scalar_threshold(run_in_tmpdir, volume_calc):
+    volume_calc.set_trigger(0.5, 'variance')
+    write_volume_file('volume_1.h5', volume_calc, 2)
+    vol = openmc.VolumeCalculation.from_hdf5('volume_1.h5')
+    assert vol.threshold == 0.5
+    assert vol.trigger_type == 'variance'